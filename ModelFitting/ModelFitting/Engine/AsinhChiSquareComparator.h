@@ -49,6 +49,12 @@ public:
     return m_u0 * std::asinh(val);
   }
 
+  /// Returns the weighted difference between the data and the model a residual was computed from,
+  /// i.e. the square root of its unmodified \f$\chi^2\f$
+  double inverse(double residual) const {
+    return m_u0 * std::sinh(residual / m_u0);
+  }
+
 private:
 
   double m_u0;
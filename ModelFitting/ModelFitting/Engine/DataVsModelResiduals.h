@@ -115,6 +115,11 @@ public:
   
   /// Updates the values where the iterator points with the residuals
   void populateResidualBlock(IterType output_iter) override;
+
+  /// Returns the model the data is compared with
+  const ModelType& getModel() const {
+    return m_model;
+  }
   
 private:
   
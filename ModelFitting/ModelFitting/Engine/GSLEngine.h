@@ -66,6 +66,13 @@ public:
   LeastSquareSummary solveProblem(EngineParameterManager& parameter_manager,
                                   ResidualEstimator& residual_estimator) override;
 
+  /// Solves the minimization problem providing the Jacobian to the library, with
+  /// the forward differences computed concurrently on the replicas of the problem.
+  /// Without replicas, the library approximates the Jacobian itself.
+  LeastSquareSummary solveProblem(EngineParameterManager& parameter_manager,
+                                  ResidualEstimator& residual_estimator,
+                                  const std::vector<ProblemReplica>& replicas) override;
+
 private:
   int m_itmax;
   double m_xtol, m_gtol, m_ftol, m_delta;
@@ -26,6 +26,7 @@
 #include "ModelFitting/Engine/EngineParameterManager.h"
 #include "ModelFitting/Engine/ResidualEstimator.h"
 #include "ModelFitting/Engine/LeastSquareSummary.h"
+#include "ModelFitting/Engine/ParallelJacobian.h"
 
 namespace ModelFitting {
 
@@ -55,6 +56,10 @@ namespace ModelFitting {
  * - After the minimization is done, the engine must guarantee that the managed
  *   parameters have been updated with the results of the minimization by using
  *   the EngineParameterManager::updateEngineValues() method
+ * - The last call to ResidualEstimator::populateResiduals() must be done with
+ *   these final values, and its output returned as LeastSquareSummary::residuals.
+ *   Any model rendered by the residual block providers then matches the solution,
+ *   and can be reused by the caller without evaluating it again
  */
 class LeastSquareEngine {
   
@@ -67,6 +72,14 @@ public:
   /// estimator.
   virtual LeastSquareSummary solveProblem(EngineParameterManager& parameter_manager,
                                           ResidualEstimator& residual_estimator) = 0;
+
+  /// Solves the problem, computing the columns of the Jacobian concurrently on the given
+  /// replicas of the problem. Engines without support for it ignore the replicas.
+  virtual LeastSquareSummary solveProblem(EngineParameterManager& parameter_manager,
+                                          ResidualEstimator& residual_estimator,
+                                          const std::vector<ProblemReplica>&) {
+    return solveProblem(parameter_manager, residual_estimator);
+  }
 };
 
 } // end of namespace ModelFitting
@@ -46,6 +46,9 @@ struct LeastSquareSummary {
   // 1-sigma margin of error for all the parameters
   std::vector<double> parameter_sigmas {};
 
+  /// Residuals evaluated at the solution, in the order of the ResidualEstimator
+  std::vector<double> residuals {};
+
   /// Info of the minimization process, as provided by the underlying framework.
   ///
   /// WARNING: Using this result will make your code compatible with only one
@@ -65,6 +65,13 @@ public:
   /// by levmar (for more info see http://users.ics.forth.gr/~lourakis/levmar).
   LeastSquareSummary solveProblem(EngineParameterManager& parameter_manager,
                                   ResidualEstimator& residual_estimator) override;
+
+  /// Solves the minimization problem providing the Jacobian to the library, with
+  /// the forward differences computed concurrently on the replicas of the problem.
+  /// Without replicas, the library approximates the Jacobian itself.
+  LeastSquareSummary solveProblem(EngineParameterManager& parameter_manager,
+                                  ResidualEstimator& residual_estimator,
+                                  const std::vector<ProblemReplica>& replicas) override;
   
 private:
   
@@ -0,0 +1,167 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/**
+ * @file ParallelJacobian.h
+ */
+
+#ifndef MODELFITTING_PARALLELJACOBIAN_H
+#define MODELFITTING_PARALLELJACOBIAN_H
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "ModelFitting/Engine/EngineParameterManager.h"
+#include "ModelFitting/Engine/ResidualEstimator.h"
+
+namespace ModelFitting {
+
+/**
+ * @brief
+ * An independent copy of a minimization problem
+ *
+ * @details
+ * The parameters and models of a replica must not be shared with the original problem, nor with any
+ * other replica, so they can be evaluated concurrently.
+ */
+struct ProblemReplica {
+  EngineParameterManager& parameter_manager;
+  ResidualEstimator& residual_estimator;
+};
+
+/**
+ * @class ParallelJacobian
+ *
+ * @brief
+ * Forward difference approximation of the Jacobian, with the columns computed concurrently
+ *
+ * @details
+ * Each column perturbs a single parameter and evaluates the residuals again. The columns are
+ * distributed between the problem and its replicas. Each replica is evaluated by its own thread,
+ * started at construction and kept until destruction, so the same threads serve every Jacobian of a fit.
+ *
+ * Optionally, like the finite difference approximation of levmar, a few consecutive Jacobians can be
+ * obtained with a Broyden rank-one update of the previous one, which costs no evaluation at all.
+ */
+class ParallelJacobian {
+
+public:
+
+  /// Receives the value of a parameter, and returns the step used for its column
+  using StepFunction = std::function<double(double)>;
+
+  /**
+   * @param parameter_manager
+   *    Parameters of the problem. They are left set to the evaluated point.
+   * @param residual_estimator
+   *    Residuals of the problem
+   * @param replicas
+   *    Independent copies of the problem
+   * @param step
+   *    Step used for the differences
+   * @param secant_updates
+   *    Maximum number of consecutive Jacobians obtained with a secant update instead of finite differences.
+   *    Only used by compute(p, jac). 0 always uses finite differences.
+   */
+  ParallelJacobian(EngineParameterManager& parameter_manager, ResidualEstimator& residual_estimator,
+                   const std::vector<ProblemReplica>& replicas, StepFunction step, std::size_t secant_updates = 0);
+
+  /// Stops the threads
+  ~ParallelJacobian();
+
+  ParallelJacobian(const ParallelJacobian&) = delete;
+  ParallelJacobian& operator=(const ParallelJacobian&) = delete;
+
+  /**
+   * Keep the residuals evaluated by the engine at a point, so a Jacobian at the same point does not evaluate
+   * them again, and the secant update can use them
+   */
+  void setResiduals(const double* p, const double* hx);
+
+  /**
+   * Compute the Jacobian at the given point, using the residuals kept by setResiduals if they are
+   * at the same point. It is a secant update of the previous one when allowed.
+   * @param p
+   *    Engine values of the parameters
+   * @param jac
+   *    Output, row major, with as many rows as residuals and one column per parameter
+   */
+  void compute(const double* p, double* jac);
+
+  /**
+   * Compute the Jacobian at the given point by finite differences
+   * @param p
+   *    Engine values of the parameters
+   * @param hx
+   *    Residuals at p. If null, they are computed as well
+   * @param jac
+   *    Output, row major, with as many rows as residuals and one column per parameter
+   */
+  void compute(const double* p, const double* hx, double* jac);
+
+  /// The next Jacobian is computed by finite differences
+  void restart();
+
+  /// True if the last Jacobian was a secant update
+  bool isSecantUpdate() const {
+    return m_updates > 0;
+  }
+
+  /// Number of evaluations of the residuals done for the Jacobians
+  std::size_t numberOfEvaluations() const {
+    return m_evaluations;
+  }
+
+private:
+  void runTasks(const ProblemReplica& problem);
+  void workerLoop(std::size_t problem_index);
+
+  std::vector<ProblemReplica> m_problems;
+  std::size_t m_nparams, m_nresiduals;
+  StepFunction m_step;
+  std::size_t m_secant_updates;
+
+  // Residuals kept by setResiduals
+  std::vector<double> m_point, m_residuals;
+  bool m_has_residuals = false;
+
+  // Previous Jacobian, and the point and residuals it was computed at, for the secant update
+  std::vector<double> m_jacobian, m_jacobian_point, m_jacobian_residuals;
+  std::size_t m_updates = 0;
+  std::size_t m_evaluations = 0;
+
+  // Finite differences being computed, shared with the workers
+  const double* m_task_point = nullptr;
+  double* m_task_jacobian = nullptr;
+  std::vector<double> m_steps, m_f0;
+  std::size_t m_ntasks = 0;
+  std::atomic<std::size_t> m_next_task{0};
+
+  std::vector<std::thread> m_workers;
+  std::mutex m_mutex;
+  std::condition_variable m_start, m_done;
+  std::size_t m_generation = 0, m_busy = 0;
+  bool m_stop = false;
+  std::exception_ptr m_error;
+};
+
+} // end of namespace ModelFitting
+
+#endif /* MODELFITTING_PARALLELJACOBIAN_H */
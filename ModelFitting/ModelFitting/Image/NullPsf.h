@@ -33,10 +33,11 @@ namespace ModelFitting {
 template <typename ImageType>
 class NullPsf {
 public:
-  NullPsf() : m_kernel(ImageTraits<ImageType>::factory(1, 1)) {}
+  /// A frame binned by some factor can pass it as the pixel scale, so the models are rasterized on its grid
+  NullPsf(double pixel_scale = 1.0) : m_pixel_scale(pixel_scale), m_kernel(ImageTraits<ImageType>::factory(1, 1)) {}
 
   double getPixelScale() const {
-    return 1.0;
+    return m_pixel_scale;
   }
 
   std::size_t getSize() const {
@@ -51,6 +52,7 @@ public:
   }
 
 private:
+  double m_pixel_scale;
   ImageType m_kernel;
 
 };
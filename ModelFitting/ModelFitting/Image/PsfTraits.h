@@ -32,11 +32,16 @@ namespace ModelFitting {
  *
  * PSF types that have this concept should specialize the trait with has_context = true
  * and the appropiate context_t
+ *
+ * PSF types that can convolve several images at once (prepareBatch and convolveBatch methods)
+ * should set has_batch = true, and the appropiate batch_context_t
  */
 template <typename PsfType>
 struct PsfTraits {
   using context_t = std::false_type;
+  using batch_context_t = std::false_type;
   static constexpr bool has_context = false;
+  static constexpr bool has_batch = false;
 };
 
 } // end namespace ModelFitting
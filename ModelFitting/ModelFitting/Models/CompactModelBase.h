@@ -44,6 +44,9 @@ protected:
 
   void renormalize(ImageType& image, double flux) const;
 
+  /// Same as above, for when the sum of the image has been accumulated while rasterizing
+  void renormalize(ImageType& image, double flux, double total) const;
+
   // Jacobian transform
   Mat22 m_jacobian;
   Mat22 m_inv_jacobian;
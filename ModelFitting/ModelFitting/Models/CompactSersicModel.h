@@ -9,6 +9,7 @@
 #define _MODELFITTING_MODELS_COMPACTSERSICMODEL_H_
 
 #include "ModelFitting/Models/CompactModelBase.h"
+#include "ModelFitting/Models/SersicProfileTable.h"
 
 namespace ModelFitting {
 
@@ -17,13 +18,19 @@ class CompactSersicModel : public CompactModelBase<ImageType> {
 
 public:
 
+  /**
+   * @param lut_tolerance
+   *    Maximum relative error of the tabulated profile used outside of the sharp radius.
+   *    If it is not positive, the profile is evaluated exactly for every pixel.
+   */
   CompactSersicModel(double sharp_radius,
       std::shared_ptr<BasicParameter> i0, std::shared_ptr<BasicParameter> k, std::shared_ptr<BasicParameter> n,
       std::shared_ptr<BasicParameter> x_scale, std::shared_ptr<BasicParameter> y_scale,
       std::shared_ptr<BasicParameter> rotation, double width, double height,
       std::shared_ptr<BasicParameter> x, std::shared_ptr<BasicParameter> y,
       std::shared_ptr<BasicParameter> flux,
-      std::tuple<double, double, double, double> transform
+      std::tuple<double, double, double, double> transform,
+      double lut_tolerance = 1e-3
   );
 
   virtual ~CompactSersicModel() = default;
@@ -62,6 +69,8 @@ private:
   using CompactModelBase<ImageType>::m_jacobian;
 
   float m_sharp_radius_squared;
+  // Shared table of the profile, null if it is evaluated exactly
+  std::shared_ptr<const SersicProfileTable> m_table;
 
   // Sersic parameters
   std::shared_ptr<BasicParameter> m_i0;
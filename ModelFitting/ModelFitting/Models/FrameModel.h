@@ -25,6 +25,7 @@
 
 #include <vector>
 #include <cmath>
+#include <algorithm>
 #include "ModelFitting/Models/ConstantModel.h"
 #include "ModelFitting/Models/PointModel.h"
 #include "ModelFitting/Models/ExtendedModel.h"
@@ -70,6 +71,18 @@ public:
   void convolve(size_t, ImageType& image) {
     PsfType::convolve(image);
   }
+
+  /**
+   * Convolve all the images, one at a time
+   * @param images
+   *    The images to convolve, one per extended model
+   */
+  template <typename ImageType>
+  void convolveAll(std::vector<ImageType>& images) {
+    for (auto& image : images) {
+      PsfType::convolve(image);
+    }
+  }
 };
 
 /**
@@ -116,10 +129,64 @@ public:
     PsfType::convolve(image, context);
   }
 
+  /**
+   * Convolve all the images, one at a time, each with its own context
+   * @param images
+   *    The images to convolve, one per extended model
+   */
+  template <typename ImageType>
+  void convolveAll(std::vector<ImageType>& images) {
+    for (size_t i = 0; i < images.size(); ++i) {
+      convolve(i, images[i]);
+    }
+  }
+
 private:
   std::vector<typename PsfTraits<PsfType>::context_t> m_psf_contexts;
 };
 
+/**
+ * Adapter class for PSF types that can convolve several images in one go (see prepareBatch
+ * and convolveBatch methods on PSF types). All extended models are stacked and convolved
+ * together, and the batch context (i.e. the PSF transform) is kept for as long as the
+ * number and size of the extended models do not change.
+ * @tparam PsfType
+ *  The wrapped PSF type
+ */
+template <typename PsfType>
+class FrameModelPsfBatchContainer: public PsfType {
+public:
+
+  /**
+   * Constructor
+   * @param n_extended_models
+   *    Ignored for this implementation, as the context is sized on the first convolution
+   */
+  FrameModelPsfBatchContainer(std::size_t n_extended_models);
+
+  /**
+   * Constructor
+   * @param psf
+   *    Wrapped PSF
+   * @param n_extended_models
+   *    Ignored for this implementation, as the context is sized on the first convolution
+   */
+  FrameModelPsfBatchContainer(PsfType psf, std::size_t n_extended_models);
+
+  /**
+   * Convolve all the images with a single batched convolution
+   * @tparam ImageType
+   *    The type of the images to be convolved. It has to be readable/writable
+   * @param images
+   *    The images to convolve, one per extended model
+   */
+  template <typename ImageType>
+  void convolveAll(std::vector<ImageType>& images);
+
+private:
+  typename PsfTraits<PsfType>::batch_context_t m_batch_context;
+};
+
 
 template <typename PsfType, typename ImageType>
 class FrameModel {
@@ -131,21 +198,33 @@ private:
   // each model will have its own context.
   // Otherwise, the PSF will be just wrapped by FrameModelPsfContainer, which
   // forwards directly the calls.
+  // If the PSF supports batched convolutions, FrameModelPsfBatchContainer takes precedence,
+  // and all the extended models are convolved together.
   using psf_container_t = typename std::conditional<
-    PsfTraits<PsfType>::has_context,
-    FrameModelPsfContextContainer<PsfType>,
-    FrameModelPsfContainer<PsfType>
+    PsfTraits<PsfType>::has_batch,
+    FrameModelPsfBatchContainer<PsfType>,
+    typename std::conditional<
+      PsfTraits<PsfType>::has_context,
+      FrameModelPsfContextContainer<PsfType>,
+      FrameModelPsfContainer<PsfType>
+    >::type
   >::type;
 
 public:
 
   using const_iterator = typename ImageTraits<ImageType>::iterator;
   
+  /**
+   * Constructor
+   * @param binning
+   *    Each pixel of the frame covers binning x binning pixels of the grid the model positions
+   *    refer to. The pixel scale is expected to be already multiplied by this factor
+   */
   FrameModel(double pixel_scale, std::size_t width, std::size_t height,
              std::vector<ConstantModel> constant_model_list,
              std::vector<PointModel> point_model_list,
              std::vector<std::shared_ptr<ExtendedModel<ImageType>>> extended_model_list,
-             PsfType psf);
+             PsfType psf, std::size_t binning = 1);
   
   FrameModel(double pixel_scale, std::size_t width, std::size_t height,
              std::vector<ConstantModel> constant_model_list,
@@ -161,6 +240,10 @@ public:
   
   const ImageType& getImage();
 
+  /// The image rendered by the last call to getImage() or begin(), without evaluating the models again.
+  /// Null if the image has not been rendered yet
+  const ImageType* getRenderedImage() const;
+
   void rasterToImage(ImageType&);
   
   const_iterator begin();
@@ -172,6 +255,7 @@ public:
 private:
   
   double m_pixel_scale;
+  std::size_t m_binning;
   std::size_t m_width;
   std::size_t m_height;
   std::vector<ConstantModel> m_constant_model_list;
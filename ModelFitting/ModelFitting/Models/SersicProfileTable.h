@@ -0,0 +1,98 @@
+/*
+ * SersicProfileTable.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef _MODELFITTING_MODELS_SERSICPROFILETABLE_H_
+#define _MODELFITTING_MODELS_SERSICPROFILETABLE_H_
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ModelFitting {
+
+/**
+ * @class SersicProfileTable
+ * @brief
+ *  Sersic profile \f$ e^{-k r^{1/n}} \f$ tabulated over \f$ v = \ln(k r^{1/n}) \f$, and linearly
+ *  interpolated between bins.
+ *
+ * @details
+ *  As a function of v the profile is \f$ e^{-e^v} \f$, which depends neither on k nor on the Sersic
+ *  index, so the same table serves every model. It only depends on the tolerance, and get() builds it
+ *  once for each. For a pixel, \f$ v = \ln k + \ln(r^2) / 2n \f$, so only a logarithm is evaluated
+ *  instead of a power and an exponential.
+ *
+ *  The bin size is chosen from a bound of the curvature of the profile, so the relative interpolation
+ *  error stays below half the requested tolerance. The other half is left for the single precision
+ *  rounding of v, which the tail of the profile amplifies by \f$ e^v \f$. Below \f$ e^v = \f$ tolerance the profile is within the
+ *  tolerance of 1, and it is clamped. Above \f$ e^v = 88 \f$ it underflows a float.
+ *
+ *  The lookup has no branches and reads a contiguous array, so a loop over a row of pixels can be
+ *  vectorized by the compiler.
+ */
+class SersicProfileTable {
+public:
+
+  /**
+   * Constructor
+   * @param tolerance
+   *    Maximum relative error of the tabulated profile
+   */
+  explicit SersicProfileTable(double tolerance) {
+    double u_max = 88.;
+    m_v_min = std::log(tolerance);
+    double v_max = std::log(u_max);
+    // Linear interpolation error is bounded by step^2 / 8 * |f''|. Relative to f, the second
+    // derivative of exp(-exp(v)) is e^2v - e^v, below u_max^2
+    double step = std::sqrt(4. * tolerance) / u_max;
+    std::size_t nbins = static_cast<std::size_t>(std::ceil((v_max - m_v_min) / step));
+    step = (v_max - m_v_min) / nbins;
+    m_inv_step = 1. / step;
+    m_last = nbins;
+    // One extra bin so the interpolation at v_max does not need to be special-cased
+    m_values.resize(nbins + 2);
+    for (std::size_t i = 0; i <= nbins; ++i) {
+      m_values[i] = std::exp(-std::exp(m_v_min + i * step));
+    }
+    m_values[nbins + 1] = m_values[nbins];
+  }
+
+  /// Table for the given tolerance, built on first use and shared afterwards
+  static std::shared_ptr<const SersicProfileTable> get(double tolerance) {
+    static std::mutex mutex;
+    static std::map<double, std::shared_ptr<const SersicProfileTable>> tables;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& table = tables[tolerance];
+    if (!table) {
+      table = std::make_shared<SersicProfileTable>(tolerance);
+    }
+    return table;
+  }
+
+  /// Number of tabulated values
+  std::size_t size() const {
+    return m_values.size();
+  }
+
+  /// Profile for \f$ v = \ln(k r^{1/n}) \f$
+  float operator()(float v) const {
+    float pos = std::min(std::max((v - m_v_min) * m_inv_step, 0.f), m_last);
+    int i = static_cast<int>(pos);
+    float frac = pos - i;
+    return m_values[i] + frac * (m_values[i + 1] - m_values[i]);
+  }
+
+private:
+  float m_v_min, m_inv_step, m_last;
+  std::vector<float> m_values;
+};
+
+} // end of namespace ModelFitting
+
+#endif /* _MODELFITTING_MODELS_SERSICPROFILETABLE_H_ */
@@ -26,6 +26,7 @@
 #include <functional>    // for std::function of the parameter observer
 #include <map>           // for std::map
 #include <memory>
+#include <vector>
 
 namespace ModelFitting {
 
@@ -39,6 +40,12 @@ namespace ModelFitting {
  *    It includes the parameter value and a list of observers, which
  *    are being notified of any value change. The observers can be any
  *    function which are being called with new value when it changes.
+ *
+ *    Parameters computed from others (see DependentParameter) register themselves
+ *    as dependents. A change only marks them as stale, and they are recomputed
+ *    when their value is requested. Observed dependents are refreshed right after
+ *    the change, or at the end of the enclosing ParameterUpdateBatch, so each one
+ *    is recomputed a single time even if several of its inputs changed.
  */
 class BasicParameter {
 
@@ -75,6 +82,14 @@ public:
 
   bool isObserved() const;
 
+  /**
+   * @brief Register a parameter computed from the value of this one
+   * @details The dependent must remove itself with removeDependent before being destroyed
+   */
+  void addDependent(BasicParameter* dependent);
+
+  void removeDependent(BasicParameter* dependent);
+
 protected:
   typedef std::function<void(void)> GetValueHook;
 
@@ -90,12 +105,62 @@ protected:
    */
   virtual void setValue(const double new_value);
 
+  /// Call the observers with the current value
+  void notifyObservers();
+
 protected:
   double m_value;
 
+  /// The inputs of the parameter changed, and m_value has not been recomputed yet
+  bool m_stale = false;
+
 private:
   std::map<std::size_t, ParameterObserver> m_observer_map;
   std::size_t m_last_obs_id = 0;
+
+  /// The dependents are registered on a given instance, not on its value, so a copy of the list is always empty
+  class DependentList : public std::vector<BasicParameter*> {
+  public:
+    DependentList() = default;
+    DependentList(const DependentList&) : std::vector<BasicParameter*>() {}
+    DependentList& operator=(const DependentList&) {
+      return *this;
+    }
+  };
+
+  DependentList m_dependents;
+
+  /// Mark as stale, recursively, the dependents that are not already, adding them to the list
+  void markDependentsStale(std::vector<BasicParameter*>& stale);
+
+  friend class ParameterUpdateBatch;
+};
+
+/**
+ * @class ParameterUpdateBatch
+ * @brief
+ *    Defers the refresh of the observed dependent parameters until the end of its scope
+ *
+ * @details
+ *    While an instance is alive, changes done on the same thread only mark the dependent
+ *    parameters as stale. On destruction, the observed ones are recomputed once and their
+ *    observers notified. Nested batches are merged into the outermost one.
+ */
+class ParameterUpdateBatch {
+public:
+  ParameterUpdateBatch();
+
+  ~ParameterUpdateBatch();
+
+  ParameterUpdateBatch(const ParameterUpdateBatch&) = delete;
+  ParameterUpdateBatch& operator=(const ParameterUpdateBatch&) = delete;
+
+  /// Recompute the given stale parameters which are observed
+  static void refresh(const std::vector<BasicParameter*>& stale);
+
+private:
+  std::vector<BasicParameter*> m_stale;
+  bool m_owner;
 };
 
 }
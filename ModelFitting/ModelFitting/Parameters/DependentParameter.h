@@ -42,6 +42,9 @@ namespace ModelFitting {
  *    DependentParameter creation should be achieved using the factory method
  *    createDependentParameter(...) provide after the end of this class.
  *
+ *    The value is cached, and only recomputed when it is requested after any of
+ *    the input parameters changed.
+ *
  */
 
 template<typename... Parameters>
@@ -61,14 +64,19 @@ public:
   : BasicParameter {calculator(parameters->getValue()...)},
   m_calculator {new ValueCalculator{std::move(calculator)}},
   m_params {new std::array<std::shared_ptr<BasicParameter>, PARAM_NO>{{parameters...}}} {
-    inputParameterLoop(parameters...);
-    //m_get_value_hook = std::bind(&DependentParameter::getValueHook, this);
+    for (auto& param : *m_params) {
+      param->addDependent(this);
+    }
   }
 
-  virtual ~DependentParameter() = default;
+  virtual ~DependentParameter() {
+    for (auto& param : *m_params) {
+      param->removeDependent(this);
+    }
+  }
 
   double getValue() const override {
-    if (!this->isObserved()) {
+    if (m_stale) {
       const_cast<DependentParameter*>(this)->update((*m_params)[0]->getValue());
     }
     return m_value;
@@ -82,27 +90,10 @@ private:
   // Array of the input parameter
   std::shared_ptr<std::array<std::shared_ptr<BasicParameter>, PARAM_NO>> m_params;
 
-  /* The two following methods represent the mechanism to loop over
-   * the arbitrary number of variadic elements, the first one is called
-   * as long as there is more than one elements in the list and the
-   * second one is called when there is only one left.
-   */
-  template<typename First, typename ... Rest>
-  void inputParameterLoop(First& first, Rest&... rest) {
-    addParameterObserver(PARAM_NO - sizeof...(rest) - 1, first);
-    inputParameterLoop(rest...);
-  }
-
-  template<typename Last>
-  void inputParameterLoop(Last& last) {
-    addParameterObserver(PARAM_NO - 1, last);
-  }
-
-  /* The two update methods below are called by the observer function
-   * passed to the param.addObserver() method. They are used to transform
-   * the array of input parameter values to a series of doubles
-   * (val1, val2, ...) which is require to call the setValue (of the
-   * BasicParameter class)
+  /* The two update methods below are called when the value is requested
+   * while stale. They are used to transform the array of input parameter
+   * values to a series of doubles (val1, val2, ...) which is required to
+   * call the calculator
    */
   template <typename... ParamValues>
   void update(ParamValues... values) {
@@ -110,20 +101,11 @@ private:
   }
 
   void update(decltype(std::declval<Parameters>()->getValue())... values) {
-    /* Beware that it is the updated value (m_calculator(values...)) that
-     * is passed to the setValue
-     */
-    BasicParameter::setValue((*m_calculator)(values...));
-  }
-
-  template<typename Param>
-  void addParameterObserver(int i, Param& param) {
-    param->addObserver([this](double v){
-      // Do not bother updating live if there are no observers
-      if (this->isObserved()) {
-          this->update((*m_params)[0]->getValue());
-      }
-    });
+    // The dependents were already marked as stale when the inputs changed,
+    // so only the observers of this parameter need to know
+    m_value = (*m_calculator)(values...);
+    m_stale = false;
+    notifyObservers();
   }
 };
 
@@ -23,9 +23,12 @@
 #include <gsl/gsl_multifit_nlinear.h>
 #include <gsl/gsl_blas.h>
 #include <ElementsKernel/Exception.h>
+#include <cmath>
 #include <iostream>
+#include <memory>
 #include "ModelFitting/Engine/LeastSquareEngineManager.h"
 #include "ModelFitting/Engine/GSLEngine.h"
+#include "ModelFitting/Engine/ParallelJacobian.h"
 
 
 namespace ModelFitting {
@@ -106,9 +109,25 @@ public:
 
 LeastSquareSummary GSLEngine::solveProblem(ModelFitting::EngineParameterManager& parameter_manager,
                                            ModelFitting::ResidualEstimator& residual_estimator) {
+  return solveProblem(parameter_manager, residual_estimator, {});
+}
+
+LeastSquareSummary GSLEngine::solveProblem(ModelFitting::EngineParameterManager& parameter_manager,
+                                           ModelFitting::ResidualEstimator& residual_estimator,
+                                           const std::vector<ProblemReplica>& replicas) {
+  // Same step as GSL_MULTIFIT_NLINEAR_FWDIFF
+  std::unique_ptr<ParallelJacobian> jacobian;
+  if (!replicas.empty()) {
+    double delta = m_delta;
+    jacobian.reset(new ParallelJacobian(parameter_manager, residual_estimator, replicas, [delta](double x) {
+      double h = delta * std::abs(x);
+      return (h == 0.) ? delta : h;
+    }));
+  }
+
   // Create a tuple which keeps the references to the given manager and estimator
   // If we capture, we can not use the lambda for the function pointer
-  auto adata = std::tie(parameter_manager, residual_estimator);
+  auto adata = std::tie(parameter_manager, residual_estimator, jacobian);
 
   // Only type supported by GSL
   const gsl_multifit_nlinear_type *type = gsl_multifit_nlinear_trust;
@@ -152,11 +171,39 @@ LeastSquareSummary GSLEngine::solveProblem(ModelFitting::EngineParameterManager&
     pm.updateEngineValues(GslVectorConstIterator{x});
     ResidualEstimator& re = std::get<1>(*extra_ptr);
     re.populateResiduals(GslVectorIterator{f});
+    // GSL asks for the Jacobian at a point it has just evaluated
+    auto& jacobian = std::get<2>(*extra_ptr);
+    if (jacobian) {
+      std::vector<double> point(x->size), residuals(f->size);
+      for (size_t i = 0; i < x->size; ++i) {
+        point[i] = gsl_vector_get(x, i);
+      }
+      for (size_t i = 0; i < f->size; ++i) {
+        residuals[i] = gsl_vector_get(f, i);
+      }
+      jacobian->setResiduals(point.data(), residuals.data());
+    }
     return GSL_SUCCESS;
   };
+
+  // Jacobian, used only when there are replicas of the problem
+  auto jacobian_function = [](const gsl_vector *x, void *extra, gsl_matrix *J) -> int {
+    auto *extra_ptr = (decltype(adata) *) extra;
+    auto& jacobian = std::get<2>(*extra_ptr);
+    std::vector<double> point(x->size);
+    for (size_t i = 0; i < x->size; ++i) {
+      point[i] = gsl_vector_get(x, i);
+    }
+    std::vector<double> values(J->size1 * J->size2);
+    jacobian->compute(point.data(), values.data());
+    gsl_matrix_const_view view = gsl_matrix_const_view_array(values.data(), J->size1, J->size2);
+    gsl_matrix_memcpy(J, &view.matrix);
+    return GSL_SUCCESS;
+  };
+
   gsl_multifit_nlinear_fdf fdf;
   fdf.f = function;
-  fdf.df = nullptr;
+  fdf.df = replicas.empty() ? nullptr : static_cast<decltype(fdf.df)>(jacobian_function);
   fdf.fvv = nullptr;
   fdf.n = residual_estimator.numberOfResiduals();
   fdf.p = parameter_manager.numberOfParameters();
@@ -192,6 +239,16 @@ LeastSquareSummary GSLEngine::solveProblem(ModelFitting::EngineParameterManager&
     parameter_manager.numberOfParameters() * parameter_manager.numberOfParameters());
 
   LeastSquareSummary summary;
+
+  // The last evaluation done by the solver may have been a rejected step
+  gsl_vector *solution = gsl_multifit_nlinear_position(workspace);
+  for (size_t i = 0; i < param_values.size(); ++i) {
+    param_values[i] = gsl_vector_get(solution, i);
+  }
+  parameter_manager.updateEngineValues(param_values.begin());
+  summary.residuals.resize(residual_estimator.numberOfResiduals());
+  residual_estimator.populateResiduals(summary.residuals.begin());
+
   summary.success_flag = (ret == GSL_SUCCESS);
   summary.iteration_no = gsl_multifit_nlinear_niter(workspace);
   summary.parameter_sigmas = {};
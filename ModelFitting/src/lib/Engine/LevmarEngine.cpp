@@ -20,13 +20,17 @@
  * @author Nikolaos Apostolakos
  */
 
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <memory>
 #include <mutex>
 
 #include <levmar.h>
 #include <ElementsKernel/Exception.h>
 #include "ModelFitting/Engine/LeastSquareEngineManager.h"
 #include "ModelFitting/Engine/LevmarEngine.h"
+#include "ModelFitting/Engine/ParallelJacobian.h"
 
 
 namespace ModelFitting {
@@ -54,8 +58,24 @@ namespace {
 
 LeastSquareSummary LevmarEngine::solveProblem(EngineParameterManager& parameter_manager,
                                               ResidualEstimator& residual_estimator) {
+  return solveProblem(parameter_manager, residual_estimator, {});
+}
+
+LeastSquareSummary LevmarEngine::solveProblem(EngineParameterManager& parameter_manager,
+                                              ResidualEstimator& residual_estimator,
+                                              const std::vector<ProblemReplica>& replicas) {
+  // Same step as the levmar finite difference approximation. Like it, the Jacobian is refined with
+  // secant updates, and only computed again by differences every max(parameters, 10) iterations
+  std::unique_ptr<ParallelJacobian> jacobian;
+  if (!replicas.empty()) {
+    double delta = m_opts[4];
+    jacobian.reset(new ParallelJacobian(parameter_manager, residual_estimator, replicas, [delta](double p) {
+      return std::max(std::abs(1E-4 * p), delta);
+    }, std::max<std::size_t>(parameter_manager.numberOfParameters(), 10)));
+  }
+
   // Create a tuple which keeps the references to the given manager and estimator
-  auto adata = std::tie(parameter_manager, residual_estimator);
+  auto adata = std::tie(parameter_manager, residual_estimator, jacobian);
 
   // The function which is called by the levmar loop
   auto levmar_res_func = [](double *p, double *hx, int, int, void *extra) {
@@ -67,12 +87,30 @@ LeastSquareSummary LevmarEngine::solveProblem(EngineParameterManager& parameter_
     pm.updateEngineValues(p);
     ResidualEstimator& re = std::get<1>(*extra_ptr);
     re.populateResiduals(hx);
+    // levmar asks for the Jacobian at the last accepted point, which it has just evaluated
+    auto& jacobian = std::get<2>(*extra_ptr);
+    if (jacobian) {
+      jacobian->setResiduals(p, hx);
+    }
 
 #ifdef LINSOLVERS_RETAIN_MEMORY
     levmar_mutex.lock();
 #endif
     };
 
+  // The Jacobian function, used only when there are replicas of the problem
+  auto levmar_jac_func = [](double *p, double *jac, int, int, void *extra) {
+#ifdef LINSOLVERS_RETAIN_MEMORY
+    levmar_mutex.unlock();
+#endif
+    auto* extra_ptr = (decltype(adata)*)extra;
+    std::get<2>(*extra_ptr)->compute(p, jac);
+
+#ifdef LINSOLVERS_RETAIN_MEMORY
+    levmar_mutex.lock();
+#endif
+  };
+
   // Create the vector which will be used for keeping the parameter values
   // and initialize it to the current values of the parameters
   std::vector<double> param_values (parameter_manager.numberOfParameters());
@@ -87,18 +125,46 @@ LeastSquareSummary LevmarEngine::solveProblem(EngineParameterManager& parameter_
   levmar_mutex.lock();
 #endif
   // Call the levmar library
-  auto res = dlevmar_dif(levmar_res_func, // The function called from the levmar algorithm
-                         param_values.data(), // The pointer where the parameter values are
-                         NULL, // We don't use any measurement vector
-                         parameter_manager.numberOfParameters(), // The number of free parameters
-                         residual_estimator.numberOfResiduals(), // The number of residuals
-                         m_itmax, // The maximum number of iterations
-                         m_opts.data(), // The minimization options
-                         info.data(), // Where the information of the minimization is stored
-                         NULL, // Working memory is allocated internally
-                         covariance_matrix.data(),
-                         &adata // No additional data needed
-                        );
+  int res;
+  if (replicas.empty()) {
+    res = dlevmar_dif(levmar_res_func, // The function called from the levmar algorithm
+                      param_values.data(), // The pointer where the parameter values are
+                      NULL, // We don't use any measurement vector
+                      parameter_manager.numberOfParameters(), // The number of free parameters
+                      residual_estimator.numberOfResiduals(), // The number of residuals
+                      m_itmax, // The maximum number of iterations
+                      m_opts.data(), // The minimization options
+                      info.data(), // Where the information of the minimization is stored
+                      NULL, // Working memory is allocated internally
+                      covariance_matrix.data(),
+                      &adata // No additional data needed
+                     );
+  }
+  else {
+    // The analytic Jacobian variant only uses the first four options, without delta
+    res = dlevmar_der(levmar_res_func, levmar_jac_func, param_values.data(), NULL,
+                      parameter_manager.numberOfParameters(), residual_estimator.numberOfResiduals(),
+                      m_itmax, m_opts.data(), info.data(), NULL, covariance_matrix.data(), &adata);
+
+    // levmar updates its own approximation when it stops improving, but it can not tell ours to do so.
+    // Continue from where it stopped with a Jacobian computed by differences
+    while (res != -1 && (info[6] == 4 || info[6] == 5) && jacobian->isSecantUpdate() && info[5] < m_itmax) {
+      jacobian->restart();
+      std::array<double, 10> restart_info;
+      res = dlevmar_der(levmar_res_func, levmar_jac_func, param_values.data(), NULL,
+                        parameter_manager.numberOfParameters(), residual_estimator.numberOfResiduals(),
+                        int(m_itmax - info[5]), m_opts.data(), restart_info.data(), NULL, covariance_matrix.data(),
+                        &adata);
+      for (int i : {5, 7, 8, 9}) {
+        restart_info[i] += info[i];
+      }
+      restart_info[0] = info[0];
+      info = restart_info;
+    }
+
+    // Report the evaluations done for the Jacobian, as the finite difference variant does
+    info[7] += jacobian->numberOfEvaluations();
+  }
 #ifdef LINSOLVERS_RETAIN_MEMORY
   levmar_mutex.unlock();
 #endif
@@ -106,6 +172,11 @@ LeastSquareSummary LevmarEngine::solveProblem(EngineParameterManager& parameter_
   // Create and return the summary object
   LeastSquareSummary summary {};
 
+  // The last evaluation done by levmar may have been a rejected step
+  parameter_manager.updateEngineValues(param_values.begin());
+  summary.residuals.resize(residual_estimator.numberOfResiduals());
+  residual_estimator.populateResiduals(summary.residuals.begin());
+
   auto converted_covariance_matrix = parameter_manager.convertCovarianceMatrixToWorldSpace(covariance_matrix);
   for (unsigned int i=0; i<parameter_manager.numberOfParameters(); i++) {
     summary.parameter_sigmas.push_back(sqrt(converted_covariance_matrix[i*(parameter_manager.numberOfParameters()+1)]));
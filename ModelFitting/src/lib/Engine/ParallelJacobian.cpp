@@ -0,0 +1,220 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/**
+ * @file ParallelJacobian.cpp
+ */
+
+#include <algorithm>
+#include "ModelFitting/Engine/ParallelJacobian.h"
+
+namespace ModelFitting {
+
+ParallelJacobian::ParallelJacobian(EngineParameterManager& parameter_manager, ResidualEstimator& residual_estimator,
+                                   const std::vector<ProblemReplica>& replicas, StepFunction step,
+                                   std::size_t secant_updates)
+  : m_nparams(parameter_manager.numberOfParameters()), m_nresiduals(residual_estimator.numberOfResiduals()),
+    m_step(std::move(step)), m_secant_updates(secant_updates) {
+  m_problems.reserve(replicas.size() + 1);
+  m_problems.push_back(ProblemReplica{parameter_manager, residual_estimator});
+  for (auto& replica : replicas) {
+    m_problems.push_back(replica);
+  }
+  // The calling thread evaluates the problem itself
+  for (std::size_t w = 1; w < m_problems.size(); ++w) {
+    m_workers.emplace_back(&ParallelJacobian::workerLoop, this, w);
+  }
+}
+
+ParallelJacobian::~ParallelJacobian() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_start.notify_all();
+  for (auto& worker : m_workers) {
+    worker.join();
+  }
+}
+
+void ParallelJacobian::workerLoop(std::size_t problem_index) {
+  std::size_t generation = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_start.wait(lock, [this, generation]() { return m_stop || m_generation != generation; });
+      if (m_stop) {
+        return;
+      }
+      generation = m_generation;
+    }
+
+    std::exception_ptr error;
+    try {
+      runTasks(m_problems[problem_index]);
+    }
+    catch (...) {
+      error = std::current_exception();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (error && !m_error) {
+      m_error = error;
+    }
+    if (--m_busy == 0) {
+      m_done.notify_one();
+    }
+  }
+}
+
+void ParallelJacobian::runTasks(const ProblemReplica& problem) {
+  // The columns first receive the perturbed residuals, and are differenced once all tasks are done.
+  // The extra task, if any, computes the residuals at the point
+  std::vector<double> point(m_task_point, m_task_point + m_nparams);
+  std::vector<double> residuals(m_nresiduals);
+  for (std::size_t t = m_next_task++; t < m_ntasks; t = m_next_task++) {
+    if (t == m_nparams) {
+      problem.parameter_manager.updateEngineValues(point.begin());
+      problem.residual_estimator.populateResiduals(m_f0.begin());
+      continue;
+    }
+    point[t] = m_task_point[t] + m_steps[t];
+    problem.parameter_manager.updateEngineValues(point.begin());
+    problem.residual_estimator.populateResiduals(residuals.begin());
+    for (std::size_t i = 0; i < m_nresiduals; ++i) {
+      m_task_jacobian[i * m_nparams + t] = residuals[i];
+    }
+    point[t] = m_task_point[t];
+  }
+}
+
+void ParallelJacobian::compute(const double* p, const double* hx, double* jac) {
+  m_steps.resize(m_nparams);
+  for (std::size_t j = 0; j < m_nparams; ++j) {
+    // Use the step as represented after the addition
+    double perturbed = p[j] + m_step(p[j]);
+    m_steps[j] = perturbed - p[j];
+  }
+
+  m_ntasks = m_nparams;
+  if (!hx) {
+    m_f0.resize(m_nresiduals);
+    ++m_ntasks;
+  }
+  m_task_point = p;
+  m_task_jacobian = jac;
+  m_next_task = 0;
+  m_evaluations += m_ntasks;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_busy = m_workers.size();
+    m_error = nullptr;
+    ++m_generation;
+  }
+  m_start.notify_all();
+
+  // The workers use the task data until they are all done, even if this thread fails
+  std::exception_ptr error;
+  try {
+    runTasks(m_problems.front());
+  }
+  catch (...) {
+    error = std::current_exception();
+  }
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this]() { return m_busy == 0; });
+    if (!error) {
+      error = m_error;
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+
+  // Leave the problem on the evaluated point
+  m_problems.front().parameter_manager.updateEngineValues(p);
+
+  if (!hx) {
+    hx = m_f0.data();
+  }
+  for (std::size_t i = 0; i < m_nresiduals; ++i) {
+    for (std::size_t j = 0; j < m_nparams; ++j) {
+      jac[i * m_nparams + j] = (jac[i * m_nparams + j] - hx[i]) / m_steps[j];
+    }
+  }
+}
+
+void ParallelJacobian::setResiduals(const double* p, const double* hx) {
+  m_point.assign(p, p + m_nparams);
+  m_residuals.assign(hx, hx + m_nresiduals);
+  m_has_residuals = true;
+}
+
+void ParallelJacobian::compute(const double* p, double* jac) {
+  const double* hx = nullptr;
+  if (m_has_residuals && std::equal(m_point.begin(), m_point.end(), p)) {
+    hx = m_residuals.data();
+  }
+
+  // Broyden update: J += (f(p) - f(p0) - J dp) dp^T / (dp^T dp)
+  if (hx && m_updates < m_secant_updates && !m_jacobian.empty()) {
+    std::vector<double> dp(m_nparams);
+    double dp_norm = 0.;
+    for (std::size_t j = 0; j < m_nparams; ++j) {
+      dp[j] = p[j] - m_jacobian_point[j];
+      dp_norm += dp[j] * dp[j];
+    }
+    if (dp_norm > 0.) {
+      for (std::size_t i = 0; i < m_nresiduals; ++i) {
+        double* row = m_jacobian.data() + i * m_nparams;
+        double r = hx[i] - m_jacobian_residuals[i];
+        for (std::size_t j = 0; j < m_nparams; ++j) {
+          r -= row[j] * dp[j];
+        }
+        r /= dp_norm;
+        for (std::size_t j = 0; j < m_nparams; ++j) {
+          row[j] += r * dp[j];
+        }
+      }
+      ++m_updates;
+      std::copy(m_jacobian.begin(), m_jacobian.end(), jac);
+      m_jacobian_point.assign(p, p + m_nparams);
+      m_jacobian_residuals.assign(hx, hx + m_nresiduals);
+      return;
+    }
+  }
+
+  compute(p, hx, jac);
+  m_updates = 0;
+  if (m_secant_updates > 0) {
+    m_jacobian.assign(jac, jac + m_nresiduals * m_nparams);
+    m_jacobian_point.assign(p, p + m_nparams);
+    if (hx) {
+      m_jacobian_residuals.assign(hx, hx + m_nresiduals);
+    } else {
+      m_jacobian_residuals = m_f0;
+    }
+  }
+}
+
+void ParallelJacobian::restart() {
+  m_jacobian.clear();
+  m_updates = 0;
+}
+
+} // end of namespace ModelFitting
@@ -21,21 +21,52 @@
  *     Author: Pierre Dubath
  */
 
+#include <algorithm>
 #include "ModelFitting/Parameters/BasicParameter.h"
 
 namespace ModelFitting {
 
 using namespace std;
 
+namespace {
+thread_local std::vector<BasicParameter*>* current_batch = nullptr;
+}
+
 BasicParameter::~BasicParameter() = default;
 
 void BasicParameter::setValue(const double new_value) {
   m_value = new_value;
+  notifyObservers();
+
+  if (m_dependents.empty()) {
+    return;
+  }
+  if (current_batch) {
+    markDependentsStale(*current_batch);
+  }
+  else {
+    std::vector<BasicParameter*> stale;
+    markDependentsStale(stale);
+    ParameterUpdateBatch::refresh(stale);
+  }
+}
+
+void BasicParameter::notifyObservers() {
   for (auto& observer : m_observer_map) {
     observer.second(m_value);
   }
 }
 
+void BasicParameter::markDependentsStale(std::vector<BasicParameter*>& stale) {
+  for (auto dependent : m_dependents) {
+    if (!dependent->m_stale) {
+      dependent->m_stale = true;
+      stale.push_back(dependent);
+      dependent->markDependentsStale(stale);
+    }
+  }
+}
+
 std::size_t BasicParameter::addObserver(ParameterObserver observer) {
   m_last_obs_id += 1;
   m_observer_map.emplace(m_last_obs_id, std::move(observer));
@@ -50,4 +81,35 @@ bool BasicParameter::isObserved() const {
   return !m_observer_map.empty();
 }
 
+void BasicParameter::addDependent(BasicParameter* dependent) {
+  m_dependents.push_back(dependent);
+}
+
+void BasicParameter::removeDependent(BasicParameter* dependent) {
+  m_dependents.erase(std::remove(m_dependents.begin(), m_dependents.end(), dependent), m_dependents.end());
+}
+
+ParameterUpdateBatch::ParameterUpdateBatch() : m_owner(current_batch == nullptr) {
+  if (m_owner) {
+    current_batch = &m_stale;
+  }
+}
+
+ParameterUpdateBatch::~ParameterUpdateBatch() {
+  if (m_owner) {
+    current_batch = nullptr;
+    refresh(m_stale);
+  }
+}
+
+void ParameterUpdateBatch::refresh(const std::vector<BasicParameter*>& stale) {
+  // Requesting the value recomputes the parameter, pulling its inputs first, and notifies its observers.
+  // Parameters already refreshed as an input of a previous one are not stale anymore, and are skipped.
+  for (auto parameter : stale) {
+    if (parameter->m_stale && parameter->isObserved()) {
+      parameter->getValue();
+    }
+  }
+}
+
 }// namespace ModelFitting
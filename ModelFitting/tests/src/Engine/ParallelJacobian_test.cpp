@@ -0,0 +1,268 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/**
+ * @file ParallelJacobian_test.cpp
+ */
+
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <boost/test/unit_test.hpp>
+#include "AlexandriaKernel/memory_tools.h"
+#include "ElementsKernel/Exception.h"
+#include "ModelFitting/Parameters/EngineParameter.h"
+#include "ModelFitting/Parameters/NeutralConverter.h"
+#include "ModelFitting/Engine/ParallelJacobian.h"
+
+using namespace ModelFitting;
+using Euclid::make_unique;
+
+namespace {
+
+// Residuals a^2, a*b and sin(b)
+class TestResiduals : public ResidualBlockProvider {
+public:
+  TestResiduals(std::shared_ptr<EngineParameter> a, std::shared_ptr<EngineParameter> b) : m_a(a), m_b(b) {}
+
+  std::size_t numberOfResiduals() const override {
+    return 3;
+  }
+
+  void populateResidualBlock(IterType output_iter) override {
+    ++evaluations;
+    double a = m_a->getValue(), b = m_b->getValue();
+    if (a < 0 && b < 0) {
+      throw Elements::Exception() << "Invalid point";
+    }
+    *output_iter++ = a * a;
+    *output_iter++ = a * b;
+    *output_iter = std::sin(b);
+  }
+
+  std::atomic<int> evaluations{0};
+
+private:
+  std::shared_ptr<EngineParameter> m_a, m_b;
+};
+
+struct Problem {
+  std::shared_ptr<EngineParameter> a {std::make_shared<EngineParameter>(1., make_unique<NeutralConverter>())};
+  std::shared_ptr<EngineParameter> b {std::make_shared<EngineParameter>(1., make_unique<NeutralConverter>())};
+  EngineParameterManager parameter_manager;
+  ResidualEstimator residual_estimator;
+  TestResiduals* residuals;
+
+  Problem() {
+    parameter_manager.registerParameter(a);
+    parameter_manager.registerParameter(b);
+    auto provider = make_unique<TestResiduals>(a, b);
+    residuals = provider.get();
+    residual_estimator.registerBlockProvider(std::move(provider));
+  }
+};
+
+void checkJacobian(const double* p, const double* jac, double tolerance) {
+  double expected[6] = {
+    2 * p[0], 0.,
+    p[1], p[0],
+    0., std::cos(p[1])
+  };
+  for (int i = 0; i < 6; ++i) {
+    BOOST_CHECK_SMALL(jac[i] - expected[i], tolerance);
+  }
+}
+
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (ParallelJacobian_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( jacobian_test ) {
+  Problem main, replica1, replica2;
+  std::vector<ProblemReplica> replicas{
+    {replica1.parameter_manager, replica1.residual_estimator},
+    {replica2.parameter_manager, replica2.residual_estimator}
+  };
+
+  ParallelJacobian jacobian(main.parameter_manager, main.residual_estimator, replicas, [](double) {
+    return 1e-7;
+  });
+
+  double p[2] = {2., 0.5};
+  double jac[6];
+  jacobian.compute(p, nullptr, jac);
+
+  double expected[6] = {
+    2 * p[0], 0.,
+    p[1], p[0],
+    0., std::cos(p[1])
+  };
+  for (int i = 0; i < 6; ++i) {
+    BOOST_CHECK_SMALL(jac[i] - expected[i], 1e-5);
+  }
+
+  // The problem is left on the evaluated point
+  BOOST_CHECK_EQUAL(main.a->getValue(), p[0]);
+  BOOST_CHECK_EQUAL(main.b->getValue(), p[1]);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( no_replicas_test ) {
+  Problem main;
+
+  ParallelJacobian jacobian(main.parameter_manager, main.residual_estimator, {}, [](double) {
+    return 1e-7;
+  });
+
+  double p[2] = {-1., 2.};
+  double hx[3] = {1., -2., std::sin(2.)};
+  double jac[6];
+  jacobian.compute(p, hx, jac);
+
+  double expected[6] = {
+    2 * p[0], 0.,
+    p[1], p[0],
+    0., std::cos(p[1])
+  };
+  for (int i = 0; i < 6; ++i) {
+    BOOST_CHECK_SMALL(jac[i] - expected[i], 1e-5);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( repeated_test ) {
+  Problem main, replica;
+  ParallelJacobian jacobian(main.parameter_manager, main.residual_estimator,
+                            {{replica.parameter_manager, replica.residual_estimator}},
+                            [](double) { return 1e-7; });
+
+  // The same threads serve every Jacobian
+  for (double x : {0.5, 1., 1.5, 2.}) {
+    double p[2] = {x, -x};
+    double jac[6];
+    jacobian.compute(p, nullptr, jac);
+    checkJacobian(p, jac, 1e-5);
+  }
+  BOOST_CHECK_EQUAL(jacobian.numberOfEvaluations(), 4 * 3);
+  BOOST_CHECK_EQUAL(main.residuals->evaluations + replica.residuals->evaluations, 4 * 3);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( reuse_residuals_test ) {
+  Problem main, replica;
+  ParallelJacobian jacobian(main.parameter_manager, main.residual_estimator,
+                            {{replica.parameter_manager, replica.residual_estimator}},
+                            [](double) { return 1e-7; });
+
+  double p[2] = {2., 0.5};
+  double hx[3] = {4., 1., std::sin(0.5)};
+  double jac[6];
+
+  // Kept for a different point, so they are evaluated
+  double other[2] = {1., 1.};
+  jacobian.setResiduals(other, hx);
+  jacobian.compute(p, jac);
+  checkJacobian(p, jac, 1e-5);
+  BOOST_CHECK_EQUAL(jacobian.numberOfEvaluations(), 3);
+
+  // Kept for the same point, so only the columns are evaluated
+  jacobian.setResiduals(p, hx);
+  jacobian.compute(p, jac);
+  checkJacobian(p, jac, 1e-5);
+  BOOST_CHECK_EQUAL(jacobian.numberOfEvaluations(), 3 + 2);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( secant_test ) {
+  Problem main, replica;
+  ParallelJacobian jacobian(main.parameter_manager, main.residual_estimator,
+                            {{replica.parameter_manager, replica.residual_estimator}},
+                            [](double) { return 1e-7; }, 2);
+
+  auto residuals = [](const double* p, double* hx) {
+    hx[0] = p[0] * p[0];
+    hx[1] = p[0] * p[1];
+    hx[2] = std::sin(p[1]);
+  };
+
+  double p[2] = {2., 0.5}, hx[3], jac[6];
+  residuals(p, hx);
+  jacobian.setResiduals(p, hx);
+  jacobian.compute(p, jac);
+  BOOST_CHECK(!jacobian.isSecantUpdate());
+  BOOST_CHECK_EQUAL(jacobian.numberOfEvaluations(), 2);
+
+  // Small steps are updated without evaluating anything, and stay close to the true Jacobian
+  for (int i = 0; i < 2; ++i) {
+    p[0] += 1e-3;
+    p[1] -= 1e-3;
+    residuals(p, hx);
+    jacobian.setResiduals(p, hx);
+    jacobian.compute(p, jac);
+    BOOST_CHECK(jacobian.isSecantUpdate());
+    BOOST_CHECK_EQUAL(jacobian.numberOfEvaluations(), 2);
+    checkJacobian(p, jac, 1e-2);
+  }
+
+  // Up to the given number of updates
+  p[0] += 1e-3;
+  residuals(p, hx);
+  jacobian.setResiduals(p, hx);
+  jacobian.compute(p, jac);
+  BOOST_CHECK(!jacobian.isSecantUpdate());
+  BOOST_CHECK_EQUAL(jacobian.numberOfEvaluations(), 4);
+  checkJacobian(p, jac, 1e-5);
+
+  // Or until restarted
+  p[1] += 1e-3;
+  residuals(p, hx);
+  jacobian.setResiduals(p, hx);
+  jacobian.restart();
+  jacobian.compute(p, jac);
+  BOOST_CHECK(!jacobian.isSecantUpdate());
+  BOOST_CHECK_EQUAL(jacobian.numberOfEvaluations(), 6);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( error_test ) {
+  Problem main, replica1, replica2;
+  ParallelJacobian jacobian(main.parameter_manager, main.residual_estimator,
+                            {{replica1.parameter_manager, replica1.residual_estimator},
+                             {replica2.parameter_manager, replica2.residual_estimator}},
+                            [](double) { return 1e-7; });
+
+  double p[2] = {-1., -1.};
+  double jac[6];
+  BOOST_CHECK_THROW(jacobian.compute(p, nullptr, jac), Elements::Exception);
+
+  // The threads are still usable
+  double q[2] = {1., 1.};
+  jacobian.compute(q, nullptr, jac);
+  checkJacobian(q, jac, 1e-5);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,134 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * CompactSersicModel_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <vector>
+#include "ElementsKernel/Exception.h"
+#include "ModelFitting/Image/ImageTraits.h"
+#include "ModelFitting/Parameters/ManualParameter.h"
+#include "ModelFitting/Models/ExtendedModel.h"
+#include "ModelFitting/Models/CompactSersicModel.h"
+
+namespace {
+
+struct TestImage {
+  std::size_t width, height;
+  std::vector<double> data;
+};
+
+}
+
+namespace ModelFitting {
+
+template <>
+struct ImageTraits<TestImage> {
+  using iterator = std::vector<double>::iterator;
+  static TestImage factory(std::size_t width, std::size_t height) {
+    return TestImage{width, height, std::vector<double>(width * height)};
+  }
+  static std::size_t width(const TestImage& image) {
+    return image.width;
+  }
+  static std::size_t height(const TestImage& image) {
+    return image.height;
+  }
+  static double& at(TestImage& image, std::size_t x, std::size_t y) {
+    return image.data[x + y * image.width];
+  }
+  static double at(const TestImage& image, std::size_t x, std::size_t y) {
+    return image.data[x + y * image.width];
+  }
+  static iterator begin(TestImage& image) {
+    return image.data.begin();
+  }
+  static iterator end(TestImage& image) {
+    return image.data.end();
+  }
+};
+
+}
+
+using namespace ModelFitting;
+
+namespace {
+
+TestImage rasterize(double n, double radius, double aspect, double angle, std::size_t size, double lut_tolerance) {
+  auto param = [](double v) { return std::make_shared<ManualParameter>(v); };
+  double k = 2 * n - 1. / 3.;
+  auto k_param = param(k / std::pow(radius, 1. / n));
+  auto x = param(size / 2.), y = param(size / 2.);
+  CompactSersicModel<TestImage> model(3.0, param(1.), k_param, param(n), param(1.), param(aspect), param(angle),
+                                      size, size, x, y, param(1000.), std::make_tuple(1., 0., 0., 1.),
+                                      lut_tolerance);
+  return model.getRasterizedImage(1., size, size);
+}
+
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (CompactSersicModel_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (CompactSersicModel_tabulated_default_test) {
+  auto param = [](double v) { return std::make_shared<ManualParameter>(v); };
+  auto x = param(50.5), y = param(50.5);
+  // Same parameters as rasterize(4., 1., ...)
+  CompactSersicModel<TestImage> model(3.0, param(1.), param(2 * 4. - 1. / 3.), param(4.), param(1.), param(0.7), param(0.3),
+                                      101, 101, x, y, param(1000.), std::make_tuple(1., 0., 0., 1.));
+  auto by_default = model.getRasterizedImage(1., 101, 101);
+  auto tabulated = rasterize(4., 1., 0.7, 0.3, 101, 1e-3);
+
+  BOOST_CHECK(by_default.data == tabulated.data);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (CompactSersicModel_tolerance_test) {
+  const std::size_t size = 151;
+
+  for (double tolerance : {1e-2, 1e-3, 1e-4}) {
+    for (double n : {1., 4., 6.}) {
+      auto exact = rasterize(n, 8., 0.6, 0.5, size, 0.);
+      auto tabulated = rasterize(n, 8., 0.6, 0.5, size, tolerance);
+
+      // Each pixel is off by at most the tolerance of the profile, plus the renormalization
+      // of the flux, which is itself bounded by the tolerance
+      double max_error = 0;
+      for (std::size_t i = 0; i < exact.data.size(); ++i) {
+        if (exact.data[i] < 1e-20) {
+          continue;
+        }
+        max_error = std::max(max_error, std::abs(tabulated.data[i] - exact.data[i]) / exact.data[i]);
+      }
+      BOOST_CHECK_LE(max_error, 2 * tolerance + 1e-5);
+      // Otherwise the comparison is meaningless
+      BOOST_CHECK(tabulated.data != exact.data);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
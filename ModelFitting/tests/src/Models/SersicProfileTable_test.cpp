@@ -0,0 +1,76 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * SersicProfileTable_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include "ModelFitting/Models/SersicProfileTable.h"
+
+using namespace ModelFitting;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (SersicProfileTable_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (SersicProfileTable_tolerance_test) {
+  for (double tolerance : {1e-2, 1e-3, 1e-4}) {
+    SersicProfileTable table(tolerance);
+
+    for (double n : {0.5, 1., 4., 8.}) {
+      for (double k : {0.5, 2., 10.}) {
+        for (double r = 0.01; r <= 100.; r += 0.173) {
+          double expected = std::exp(-k * std::pow(r, 1. / n));
+          // Values far below float precision are not meaningful
+          if (expected < 1e-30) {
+            continue;
+          }
+          float v = std::log(k) + 0.5 / n * std::log(r * r);
+          BOOST_CHECK_CLOSE(table(v), expected, tolerance * 100 * 1.1);
+        }
+      }
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (SersicProfileTable_clamp_test) {
+  SersicProfileTable table(1e-3);
+  // Below the table the profile is within the tolerance of its value at the centre
+  BOOST_CHECK_CLOSE(table(-INFINITY), 1., 1e-3 * 100 * 1.1);
+  BOOST_CHECK_CLOSE(table(std::log(1e-4)), 1., 1e-3 * 100 * 1.1);
+  // Above the table it underflows a float
+  BOOST_CHECK_SMALL(table(std::log(200.)), 1e-37f);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (SersicProfileTable_shared_test) {
+  auto table = SersicProfileTable::get(1e-3);
+  BOOST_CHECK(table == SersicProfileTable::get(1e-3));
+  BOOST_CHECK(table != SersicProfileTable::get(1e-4));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
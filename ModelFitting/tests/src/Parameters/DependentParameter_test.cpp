@@ -128,4 +128,48 @@ BOOST_AUTO_TEST_CASE(observeDependOnDependent_test) {
   BOOST_CHECK_EQUAL(34.0, test_observer);
 }
 
+BOOST_AUTO_TEST_CASE(lazyUpdate_test) {
+  auto param1 = std::make_shared<ManualParameter>(4.0);
+  auto param2 = std::make_shared<ManualParameter>(2.0);
+
+  int calls = 0;
+  auto calculator = [&calls](double mp1, double mp2) {++calls; return mp1+mp2;};
+
+  auto dp = ModelFitting::createDependentParameter(calculator, param1, param2);
+  BOOST_CHECK_EQUAL(1, calls);
+
+  // Not recomputed until requested, and only once
+  param1->setValue(10.0);
+  param2->setValue(7.);
+  BOOST_CHECK_EQUAL(1, calls);
+  BOOST_CHECK_EQUAL(17.0, dp->getValue());
+  BOOST_CHECK_EQUAL(17.0, dp->getValue());
+  BOOST_CHECK_EQUAL(2, calls);
+}
+
+BOOST_AUTO_TEST_CASE(batchUpdate_test) {
+  auto param1 = std::make_shared<ManualParameter>(4.0);
+  auto param2 = std::make_shared<ManualParameter>(2.0);
+
+  int calls = 0;
+  auto calculator = [&calls](double mp1, double mp2) {++calls; return mp1+mp2;};
+
+  auto dp = ModelFitting::createDependentParameter(calculator, param1, param2);
+
+  int notifications = 0;
+  double test_observer = 0.0;
+  dp->addObserver([&](double v){++notifications; test_observer = v;});
+
+  {
+    ParameterUpdateBatch batch;
+    param1->setValue(10.0);
+    param2->setValue(7.);
+    BOOST_CHECK_EQUAL(0, notifications);
+  }
+
+  BOOST_CHECK_EQUAL(1, notifications);
+  BOOST_CHECK_EQUAL(2, calls);
+  BOOST_CHECK_EQUAL(17.0, test_observer);
+}
+
 BOOST_AUTO_TEST_SUITE_END ()
@@ -31,6 +31,8 @@
 #include "ElementsKernel/Real.h"
 #include "SEImplementation/Segmentation/BgConvolutionImageSource.h"
 #include "SEImplementation/Segmentation/BgDFTConvolutionImageSource.h"
+#include "SEFramework/Convolution/ConvolutionStrategy.h"
+#include "SEFramework/Convolution/SeparableConvolution.h"
 #include "SEFramework/Image/VectorImage.h"
 #include "SEUtils/IsClose.h"
 
@@ -112,19 +114,31 @@ public:
 
         logger.info() << "Comparing results";
         verifyResults(direct_result, dft_result);
+
+        logger.info() << "Timing Separable implementation";
+        auto separable_result = benchmark<BgConvolutionImageSource>(image, variance, kernel, repeat, measures, true);
+
+        logger.info() << "Comparing results";
+        verifyResults(direct_result, separable_result);
+
+        auto rank = decomposeKernel(*kernel).getRank();
+        auto strategy = chooseConvolutionStrategy(krn_size, krn_size, rank, img_size, img_size);
+        logger.info() << "Kernel rank " << rank << ", the chosen strategy would be "
+                      << (strategy == ConvolutionStrategy::DFT ? "DFT" :
+                          strategy == ConvolutionStrategy::SEPARABLE ? "Separable" : "Direct");
       }
     }
 
     return Elements::ExitCode::OK;
   }
 
-  template<typename BackgroundConvolution>
+  template<typename BackgroundConvolution, typename ...Args>
   std::shared_ptr<VectorImage<SeFloat>>
   benchmark(std::shared_ptr<VectorImage<SeFloat>>& image, std::shared_ptr<VectorImage<SeFloat>>& variance,
-            std::shared_ptr<VectorImage<SeFloat>>& kernel, int repeat, int measures) {
+            std::shared_ptr<VectorImage<SeFloat>>& kernel, int repeat, int measures, Args... extra) {
     auto conv_name = demangle(typeid(BackgroundConvolution).name());
 
-    auto bg_convolution = std::make_shared<BackgroundConvolution>(image, variance, 0.5, kernel);
+    auto bg_convolution = std::make_shared<BackgroundConvolution>(image, variance, 0.5, kernel, extra...);
 
     std::shared_ptr<VectorImage<SeFloat>> result;
 
@@ -33,6 +33,7 @@
 #include "SEFramework/Image/VectorImage.h"
 #include "SEFramework/Convolution/DirectConvolution.h"
 #include "SEFramework/Convolution/DFT.h"
+#include "SEFramework/Convolution/SeparableConvolution.h"
 #ifdef WITH_OPENCV
 #include "SEFramework/Convolution/OpenCVConvolution.h"
 #endif
@@ -126,6 +127,12 @@ public:
         logger.info() << "Compare OpenCV vs DFT Result";
         verifyResults(opencv_result, dft_result);
 #endif
+
+        logger.info() << "Timing Separable implementation";
+        auto separable_result = benchmark<SeparableConvolution<SeFloat>>(image, kernel, repeat, measures);
+
+        logger.info() << "Compare DFT vs Separable Result";
+        verifyResults(dft_result, separable_result);
       }
     }
 
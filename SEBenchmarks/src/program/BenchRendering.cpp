@@ -193,16 +193,13 @@ class BenchRendering : public Elements::Program {
 
 public:
 
-//  po::options_description defineSpecificProgramOptions() override {
-//    po::options_description config_options { "TestImage options" };
-//
-//    // Add the specific program options
-//    config_options.add_options()
-//        ("output", po::value<string>()->required(), "filename to save the created test image")
-//        ;
-//
-//    return config_options;
-//  }
+  po::options_description defineSpecificProgramOptions() override {
+    po::options_description options{};
+    options.add_options()
+      ("lut-tolerance", po::value<double>()->default_value(1e-3),
+       "Relative tolerance of the tabulated compact Sersic profile compared against the exact one");
+    return options;
+  }
 
 
 
@@ -265,7 +262,7 @@ public:
     return frame_model;
   }
 
-  FrameModel<DummyPsf<ImageInterfaceTypePtr>, ImageInterfaceTypePtr> makeCompactSersicFrameModel() {
+  FrameModel<DummyPsf<ImageInterfaceTypePtr>, ImageInterfaceTypePtr> makeCompactSersicFrameModel(double lut_tolerance) {
     std::vector<ConstantModel> constant_models;
     std::vector<std::shared_ptr<ModelFitting::ExtendedModel<ImageInterfaceTypePtr>>> extended_models;
     std::vector<PointModel> point_models;
@@ -286,7 +283,7 @@ public:
 
     extended_models.emplace_back(std::make_shared<ModelFitting::CompactSersicModel<ImageInterfaceTypePtr>>(
         3.0, i0, k, n,
-        xs, ys, rot, 256, 256, x_param, y_param, flux, std::make_tuple(1, 0, 0, 1)));
+        xs, ys, rot, 256, 256, x_param, y_param, flux, std::make_tuple(1, 0, 0, 1), lut_tolerance));
 
     double pixel_scale = 1.0f;
     int image_size = 256;
@@ -360,7 +357,8 @@ public:
     auto dummy_exp_frame_model = makeDummyFrameModel<DummyExpModel<ImageInterfaceTypePtr>>();
     auto dummy_sersic_frame_model = makeDummyFrameModel<DummySersicModel<ImageInterfaceTypePtr>>();
     auto sersic_frame_model = makeSersicFrameModel();
-    auto compact_frame_model = makeCompactSersicFrameModel();
+    auto compact_frame_model = makeCompactSersicFrameModel(args["lut-tolerance"].as<double>());
+    auto compact_exact_frame_model = makeCompactSersicFrameModel(0.);
 
     logger.info() << "Testing with empty frame";
     {
@@ -392,11 +390,30 @@ public:
       boost::timer::auto_cpu_timer t;
       measureRasterToImage(iterations, sersic_frame_model);
     }
-    logger.info() << "Testing with compact Sersic model";
-    {
-      boost::timer::auto_cpu_timer t;
-      measureRasterToImage(iterations, compact_frame_model);
+    std::shared_ptr<VectorImage<SeFloat>> compact_exact_image, compact_image;
+    logger.info() << "Testing with compact Sersic model (exact)";
+    boost::timer::cpu_timer exact_timer;
+    compact_exact_image = measureRasterToImage(iterations, compact_exact_frame_model);
+    exact_timer.stop();
+    logger.info() << exact_timer.format(3, "%ws wall, %ts CPU");
+
+    logger.info() << "Testing with compact Sersic model (tabulated)";
+    boost::timer::cpu_timer tabulated_timer;
+    compact_image = measureRasterToImage(iterations, compact_frame_model);
+    tabulated_timer.stop();
+    logger.info() << tabulated_timer.format(3, "%ws wall, %ts CPU");
+
+    logger.info() << "Speedup of the tabulated compact Sersic model: "
+                  << double(exact_timer.elapsed().wall) / tabulated_timer.elapsed().wall;
+
+    double max_diff = 0, max_value = 0;
+    for (int y = 0; y < compact_image->getHeight(); ++y) {
+      for (int x = 0; x < compact_image->getWidth(); ++x) {
+        max_value = std::max<double>(max_value, compact_exact_image->getValue(x, y));
+        max_diff = std::max<double>(max_diff, std::abs(compact_exact_image->getValue(x, y) - compact_image->getValue(x, y)));
+      }
     }
+    logger.info() << "Maximum difference of the tabulated compact Sersic model relative to the peak: " << max_diff / max_value;
 
     return Elements::ExitCode::OK;
   }
@@ -0,0 +1,139 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * EllipticalScan.h
+ */
+
+#ifndef _SEFRAMEWORK_SEFRAMEWORK_APERTURE_ELLIPTICALSCAN_H
+#define _SEFRAMEWORK_SEFRAMEWORK_APERTURE_ELLIPTICALSCAN_H
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include "SEUtils/PixelCoordinate.h"
+#include "SEUtils/Types.h"
+
+namespace SourceXtractor {
+
+/**
+ * @class EllipticalScan
+ * @brief
+ *  Traversal of the pixels covered by an elliptical aperture, without going through the virtual
+ *  Aperture interface for every pixel of the bounding box.
+ *
+ * @details
+ *  For each row the range of columns that may fall inside the ellipse is solved analytically, and
+ *  only those are tested. The terms of the radius that depend only on the row are computed once
+ *  per row. The pixels visited, and their squared radii, are the same as for EllipticalAperture.
+ */
+class EllipticalScan {
+public:
+
+  EllipticalScan(SeFloat cxx, SeFloat cyy, SeFloat cxy, SeFloat rad_max, SeFloat centroid_x, SeFloat centroid_y)
+    : m_cxx(cxx), m_cyy(cyy), m_cxy(cxy), m_rad_max(rad_max), m_centroid_x(centroid_x), m_centroid_y(centroid_y) {
+    // same extent as EllipticalAperture
+    SeFloat dx = m_rad_max * std::sqrt(1.0 / (m_cxx - m_cxy * m_cxy / (4.0 * m_cyy)));
+    SeFloat dy = m_rad_max * std::sqrt(1.0 / (m_cyy - m_cxy * m_cxy / (4.0 * m_cxx)));
+    m_min_pixel = PixelCoordinate(centroid_x - dx, centroid_y - dy);
+    m_max_pixel = PixelCoordinate(centroid_x + dx + 1, centroid_y + dy + 1);
+  }
+
+  /**
+   * Ellipse of an aperture defined on another frame, and seen through the given jacobian, as done
+   * by TransformedAperture. The coefficients are transformed once, so the squared radii may differ
+   * from TransformedAperture on the last bits.
+   */
+  static EllipticalScan transformed(SeFloat cxx, SeFloat cyy, SeFloat cxy, SeFloat rad_max,
+                                    SeFloat centroid_x, SeFloat centroid_y,
+                                    const std::tuple<double, double, double, double>& jacobian) {
+    double t0 = std::get<0>(jacobian), t1 = std::get<1>(jacobian);
+    double t2 = std::get<2>(jacobian), t3 = std::get<3>(jacobian);
+    double inv_det = 1. / (t0 * t3 - t2 * t1);
+    // pixel offsets are mapped back to the original frame with [a00 a01; a10 a11]
+    double a00 = t3 * inv_det, a01 = -t2 * inv_det;
+    double a10 = -t1 * inv_det, a11 = t0 * inv_det;
+    return EllipticalScan(
+      cxx * a00 * a00 + cyy * a10 * a10 + cxy * a00 * a10,
+      cxx * a01 * a01 + cyy * a11 * a11 + cxy * a01 * a11,
+      2 * cxx * a00 * a01 + 2 * cyy * a10 * a11 + cxy * (a00 * a11 + a01 * a10),
+      rad_max, centroid_x, centroid_y);
+  }
+
+  const PixelCoordinate& getMinPixel() const {
+    return m_min_pixel;
+  }
+
+  const PixelCoordinate& getMaxPixel() const {
+    return m_max_pixel;
+  }
+
+  SeFloat getCentroidX() const {
+    return m_centroid_x;
+  }
+
+  SeFloat getCentroidY() const {
+    return m_centroid_y;
+  }
+
+  /**
+   * Call callback(x, y, radius_squared) for every pixel inside the ellipse, row by row
+   */
+  template <typename Callback>
+  void scan(Callback&& callback) const {
+    const SeFloat rad_max2 = m_rad_max * m_rad_max;
+
+    for (int pixel_y = m_min_pixel.m_y; pixel_y <= m_max_pixel.m_y; ++pixel_y) {
+      SeFloat dist_y = SeFloat(pixel_y) - m_centroid_y;
+      SeFloat row_term = m_cyy * dist_y * dist_y;
+
+      int x_start, x_end;
+      std::tie(x_start, x_end) = getRowSpan(dist_y);
+
+      for (int pixel_x = x_start; pixel_x <= x_end; ++pixel_x) {
+        SeFloat dist_x = SeFloat(pixel_x) - m_centroid_x;
+        SeFloat radius2 = m_cxx * dist_x * dist_x + row_term + m_cxy * dist_x * dist_y;
+        if (radius2 < rad_max2) {
+          callback(pixel_x, pixel_y, radius2);
+        }
+      }
+    }
+  }
+
+private:
+  SeFloat m_cxx, m_cyy, m_cxy, m_rad_max;
+  SeFloat m_centroid_x, m_centroid_y;
+  PixelCoordinate m_min_pixel, m_max_pixel;
+
+  /// Columns where the ellipse may cross the row, with one pixel of margin for rounding
+  std::pair<int, int> getRowSpan(double dist_y) const {
+    if (m_cxx <= 0) {
+      return {m_min_pixel.m_x, m_max_pixel.m_x};
+    }
+    double b = m_cxy * dist_y;
+    double c = m_cyy * dist_y * dist_y - double(m_rad_max) * m_rad_max;
+    double sq = std::sqrt(std::max(b * b - 4 * m_cxx * c, 0.));
+    double lower = (-b - sq) / (2 * m_cxx), upper = (-b + sq) / (2 * m_cxx);
+    return {
+      std::max(m_min_pixel.m_x, static_cast<int>(std::floor(m_centroid_x + lower)) - 1),
+      std::min(m_max_pixel.m_x, static_cast<int>(std::ceil(m_centroid_x + upper)) + 1)
+    };
+  }
+};
+
+} // end SourceXtractor
+
+#endif // _SEFRAMEWORK_SEFRAMEWORK_APERTURE_ELLIPTICALSCAN_H
@@ -19,6 +19,7 @@
 #define _SEFRAMEWORK_SEFRAMEWORK_APERTURE_FLAGGING_H
 
 #include "SEFramework/Aperture/Aperture.h"
+#include "SEFramework/Aperture/EllipticalScan.h"
 #include "SEFramework/Aperture/NeighbourInfo.h"
 #include "SEFramework/Image/Image.h"
 #include "SEFramework/Source/SourceFlags.h"
@@ -34,6 +35,17 @@ Flags computeFlags(const std::shared_ptr<Aperture>& aperture,
                    const std::shared_ptr<Image<SeFloat>>& threshold_image,
                    SeFloat variance_threshold);
 
+/**
+ * Same as above, for an elliptical aperture. The images are read once as chunks
+ * covering the ellipse.
+ */
+Flags computeFlags(const EllipticalScan& ellipse,
+                   const std::vector<PixelCoordinate>& pix_list,
+                   const std::shared_ptr<Image<SeFloat>>& detection_img,
+                   const std::shared_ptr<Image<SeFloat>>& detection_variance,
+                   const std::shared_ptr<Image<SeFloat>>& threshold_image,
+                   SeFloat variance_threshold);
+
 } // end SourceXtractor
 
 #endif // _SEFRAMEWORK_SEFRAMEWORK_APERTURE_FLAGGING_H
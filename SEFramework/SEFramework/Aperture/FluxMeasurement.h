@@ -25,6 +25,7 @@
 #define _SEFRAMEWORK_SEFRAMEWORK_APERTURE_MEASUREFLUX_H
 
 #include "Aperture.h"
+#include "EllipticalScan.h"
 #include "SEFramework/Image/WriteableImage.h"
 #include "SEFramework/Source/SourceFlags.h"
 
@@ -63,6 +64,16 @@ FluxMeasurement measureFlux(const std::shared_ptr<Aperture> &aperture, SeFloat c
                             const std::shared_ptr<Image<SeFloat>> &variance_map, SeFloat variance_threshold,
                             bool use_symmetry);
 
+/**
+ * Measure the flux on an image within an ellipse. Equivalent to the above for an elliptical
+ * aperture, but the image and the variance map are read as chunks covering the ellipse, and the
+ * aperture is evaluated without virtual calls.
+ */
+FluxMeasurement measureFlux(const EllipticalScan &ellipse,
+                            const std::shared_ptr<Image<SeFloat>> &img,
+                            const std::shared_ptr<Image<SeFloat>> &variance_map, SeFloat variance_threshold,
+                            bool use_symmetry);
+
 /**
  * Fill the pixels that fall within the aperture with the given value. Useful for debugging.
  * @tparam T
@@ -43,8 +43,9 @@ public:
   bool isNeighbourObjectPixel(int x, int y) const;
 
 private:
-  std::shared_ptr<VectorImage<int>> m_neighbour_image;
+  std::vector<char> m_neighbour_mask;
   PixelCoordinate m_offset;
+  int m_width, m_height;
 };
 
 } // end SourceXtractor
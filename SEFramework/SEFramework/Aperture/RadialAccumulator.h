@@ -0,0 +1,85 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * RadialAccumulator.h
+ */
+
+#ifndef _SEFRAMEWORK_SEFRAMEWORK_APERTURE_RADIALACCUMULATOR_H
+#define _SEFRAMEWORK_SEFRAMEWORK_APERTURE_RADIALACCUMULATOR_H
+
+#include <vector>
+#include "SEUtils/Types.h"
+
+namespace SourceXtractor {
+
+/**
+ * @class RadialAccumulator
+ * @brief
+ *  Histogram of the flux in concentric rings of constant width around a center.
+ *
+ * @details
+ *  Each pixel is split into the same sub-pixel grid used by CircularAperture, and each sub-pixel
+ *  falls in the first ring whose outer radius contains it. The cumulative histogram is then the
+ *  flux that a CircularAperture of each outer radius would measure, obtained in a single pass over
+ *  the pixels instead of one pass per aperture.
+ *  Pixels that fall entirely within one ring are added without supersampling.
+ */
+class RadialAccumulator {
+public:
+
+  /**
+   * @param step_size
+   *    Width of the rings. The outer radius of the ring i is (i + 1) * step_size
+   * @param nbins
+   *    Number of rings. Flux beyond the last one is ignored
+   */
+  RadialAccumulator(double step_size, size_t nbins);
+
+  /**
+   * Accumulate a stamp
+   * @param stamp
+   *    Contiguous pixel values, row by row
+   * @param x0, y0
+   *    Image coordinates of the first pixel of the stamp
+   * @param width, height
+   *    Size of the stamp
+   * @param centroid_x, centroid_y
+   *    Center of the rings, in image coordinates
+   */
+  void add(const SeFloat *stamp, int x0, int y0, int width, int height, SeFloat centroid_x, SeFloat centroid_y);
+
+  /// Flux per ring
+  const std::vector<double>& getHistogram() const {
+    return m_histogram;
+  }
+
+  /// Flux within the outer radius of each ring
+  std::vector<double> getCumulative() const;
+
+private:
+  double m_step_size;
+  /// Squared outer radius of each ring, rounded as CircularAperture does
+  std::vector<SeFloat> m_radius_squared;
+  std::vector<double> m_histogram;
+
+  /// Index of the first ring that contains the given squared distance, or nbins
+  size_t getBin(SeFloat distance_squared) const;
+};
+
+} // end SourceXtractor
+
+#endif // _SEFRAMEWORK_SEFRAMEWORK_APERTURE_RADIALACCUMULATOR_H
@@ -26,9 +26,37 @@
 
 #include "SEFramework/Frame/Frame.h"
 #include "SEFramework/Image/FunctionalImage.h"
+#include "SEFramework/Image/VectorImage.h"
 
 namespace SourceXtractor {
 
+/**
+ * Low resolution grid a background map is interpolated from. It is enough to rebuild the map
+ */
+struct BackgroundMesh {
+  enum class Interpolation {
+    CONSTANT, ///< A single value
+    BICUBIC,  ///< ScaledImageSource over the grid
+    SPLINE    ///< SE2 SplineModel over the grid
+  };
+
+  Interpolation m_interpolation;
+  /// Size of a cell in pixels
+  int m_cell_width, m_cell_height;
+  /// One value per cell
+  std::shared_ptr<VectorImage<SeFloat>> m_values;
+
+  static std::shared_ptr<BackgroundMesh> create(Interpolation interpolation, int cell_width, int cell_height,
+                                                std::shared_ptr<VectorImage<SeFloat>> values) {
+    return std::make_shared<BackgroundMesh>(BackgroundMesh{interpolation, cell_width, cell_height, values});
+  }
+
+  /// A single cell covering the whole image
+  static std::shared_ptr<BackgroundMesh> constant(int width, int height, SeFloat value) {
+    return create(Interpolation::CONSTANT, width, height, VectorImage<SeFloat>::create(1, 1, std::vector<SeFloat>{value}));
+  }
+};
+
 
 class BackgroundModel {
 public:
@@ -68,10 +96,27 @@ public:
     return m_median_rms;
   }
 
+  /// Set the grids the maps were interpolated from, when the analyzer knows them
+  void setMeshes(std::shared_ptr<const BackgroundMesh> level_mesh, std::shared_ptr<const BackgroundMesh> variance_mesh) {
+    m_level_mesh = level_mesh;
+    m_variance_mesh = variance_mesh;
+  }
+
+  /// nullptr if unknown
+  std::shared_ptr<const BackgroundMesh> getLevelMesh() const {
+    return m_level_mesh;
+  }
+
+  /// nullptr if unknown. The values are the variance as given to the constructor
+  std::shared_ptr<const BackgroundMesh> getVarianceMesh() const {
+    return m_variance_mesh;
+  }
+
 private:
   std::shared_ptr<Image<SeFloat>> m_background_level;
   std::shared_ptr<Image<SeFloat>> m_background_variance;
   SeFloat m_scaling_factor, m_median_rms;
+  std::shared_ptr<const BackgroundMesh> m_level_mesh, m_variance_mesh;
 };
 
 class BackgroundAnalyzer {
@@ -24,7 +24,9 @@
 #define _SEFRAMEWORK_CONVOLUTION_CONVOLUTION_H
 
 #include "DirectConvolution.h"
+#include "SeparableConvolution.h"
 #include "DFT.h"
+#include "ConvolutionStrategy.h"
 
 namespace SourceXtractor {
 
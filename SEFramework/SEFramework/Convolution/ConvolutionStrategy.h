@@ -0,0 +1,106 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * @file SEFramework/Convolution/ConvolutionStrategy.h
+ * @date 19/10/26
+ */
+
+#ifndef _SEFRAMEWORK_CONVOLUTION_CONVOLUTIONSTRATEGY_H
+#define _SEFRAMEWORK_CONVOLUTION_CONVOLUTIONSTRATEGY_H
+
+#include <algorithm>
+#include <cmath>
+
+#include "SEFramework/FFT/FFT.h"
+
+namespace SourceXtractor {
+
+/**
+ * Available convolution strategies
+ */
+enum class ConvolutionStrategy {
+  DIRECT,     ///< Direct 2D convolution, see DirectConvolution
+  SEPARABLE,  ///< Sum of row and column 1D passes, see SeparableConvolution
+  DFT         ///< Discrete Fourier Transform, see DFTConvolution
+};
+
+/**
+ * Rough estimation of the number of floating point operations needed per output pixel
+ * @param strategy
+ *    Convolution strategy
+ * @param kernel_width
+ *    Width of the kernel
+ * @param kernel_height
+ *    Height of the kernel
+ * @param rank
+ *    Rank of the separable approximation of the kernel
+ * @param tile_width
+ *    Width of the area convolved in one go
+ * @param tile_height
+ *    Height of the area convolved in one go
+ * @param dft_tiles
+ *    Number of horizontally consecutive tiles transformed together by the DFT strategy
+ */
+inline double estimateConvolutionCost(ConvolutionStrategy strategy, int kernel_width, int kernel_height, int rank,
+                                      int tile_width, int tile_height, int dft_tiles = 1) {
+  double outputs = static_cast<double>(tile_width) * tile_height;
+  switch (strategy) {
+    case ConvolutionStrategy::DIRECT:
+      return 2. * kernel_width * kernel_height;
+    case ConvolutionStrategy::SEPARABLE: {
+      // The row pass is done also over the vertical margins
+      double row_pass = 2. * kernel_width * (tile_height + kernel_height - 1) * tile_width;
+      double column_pass = 2. * kernel_height * outputs;
+      return rank * (row_pass + column_pass) / outputs;
+    }
+    case ConvolutionStrategy::DFT: {
+      // Forward and inverse real transforms (~2.5 N log2 N each) plus the complex product
+      outputs *= dft_tiles;
+      double n = static_cast<double>(fftSmoothDimension(tile_width * dft_tiles + kernel_width - 1)) *
+                 fftSmoothDimension(tile_height + kernel_height - 1);
+      return (5. * n * std::log2(n) + 3. * n) / outputs;
+    }
+  }
+  return 0.;
+}
+
+/**
+ * Pick the cheapest convolution strategy for the given kernel and tile sizes
+ * @see estimateConvolutionCost
+ */
+inline ConvolutionStrategy chooseConvolutionStrategy(int kernel_width, int kernel_height, int rank,
+                                                     int tile_width, int tile_height, int dft_tiles = 1) {
+  // An all-zero kernel has no separable terms, its cost would be estimated as 0
+  if (rank <= 0) {
+    return ConvolutionStrategy::DIRECT;
+  }
+  ConvolutionStrategy best = ConvolutionStrategy::DIRECT;
+  double best_cost = estimateConvolutionCost(best, kernel_width, kernel_height, rank, tile_width, tile_height);
+  for (auto strategy : {ConvolutionStrategy::SEPARABLE, ConvolutionStrategy::DFT}) {
+    double cost = estimateConvolutionCost(strategy, kernel_width, kernel_height, rank,
+                                          tile_width, tile_height, dft_tiles);
+    if (cost < best_cost) {
+      best = strategy;
+      best_cost = cost;
+    }
+  }
+  return best;
+}
+
+} // end SourceXtractor
+
+#endif // _SEFRAMEWORK_CONVOLUTION_CONVOLUTIONSTRATEGY_H
@@ -63,6 +63,33 @@ public:
     friend class DFTConvolution<T, TPadding>;
   };
 
+  /**
+   * Context for convolving several images in one go, using a single batched ("howmany") transform.
+   * All images are padded to a common size, so they can share the kernel transform and the FFTW plans.
+   * The working buffers are not part of the context, but kept per thread (see convolveBatch), so a
+   * context can be kept alive for as long as the kernel and the image sizes do not change
+   * (i.e. across the iterations of a model fitting).
+   */
+  struct BatchConvolutionContext {
+  public:
+    /**
+     * @return
+     *    true if this context can be used to convolve howmany images no bigger than width x height
+     */
+    bool fits(std::size_t howmany, std::size_t width, std::size_t height) const {
+      return static_cast<int>(howmany) == m_howmany &&
+             static_cast<int>(width) <= m_max_width && static_cast<int>(height) <= m_max_height;
+    }
+
+  private:
+    int m_howmany, m_max_width, m_max_height;
+    int m_padded_width, m_padded_height, m_total_size, m_spectrum_size;
+    std::vector<complex_t> m_kernel_transform;
+    typename FFT<T>::plan_ptr_t m_fwd_plan, m_inv_plan;
+
+    friend class DFTConvolution<T, TPadding>;
+  };
+
   /**
    * Constructor
    * @param img
@@ -209,6 +236,109 @@ public:
     convolve(image_ptr, context, std::forward(padding_args)...);
   }
 
+  /**
+   * Pre-computes the kernel transform and the plans required to convolve, in one batch,
+   * up to `howmany` images of at most max_width x max_height pixels
+   * @param howmany
+   *    Number of images to be convolved together
+   * @param max_width
+   *    Maximum width of the images
+   * @param max_height
+   *    Maximum height of the images
+   * @return
+   *    A context than can be used by `convolveBatch`
+   */
+  std::unique_ptr<BatchConvolutionContext> prepareBatch(std::size_t howmany, std::size_t max_width,
+                                                        std::size_t max_height) const {
+    auto context = Euclid::make_unique<BatchConvolutionContext>();
+
+    context->m_howmany = howmany;
+    context->m_max_width = max_width;
+    context->m_max_height = max_height;
+
+    // The same plan is executed many times, so it pays off to use sizes that FFTW handles the best
+    context->m_padded_width = fftSmoothDimension(max_width + m_kernel->getWidth() - 1);
+    context->m_padded_height = fftSmoothDimension(max_height + m_kernel->getHeight() - 1);
+    context->m_total_size = context->m_padded_width * context->m_padded_height;
+
+    // A real to complex transform only has height * (width / 2 + 1) meaningful positions
+    context->m_spectrum_size = context->m_padded_height * (context->m_padded_width / 2 + 1);
+
+    auto& real_buffer = getThreadRealBuffer(context->m_total_size * context->m_howmany);
+    auto& complex_buffer = getThreadComplexBuffer(context->m_total_size * context->m_howmany);
+
+    context->m_fwd_plan = FFT<T>::createForwardPlan(context->m_howmany,
+                                                    context->m_padded_width, context->m_padded_height,
+                                                    real_buffer, complex_buffer);
+    context->m_inv_plan = FFT<T>::createInversePlan(context->m_howmany,
+                                                    context->m_padded_width, context->m_padded_height,
+                                                    complex_buffer, real_buffer);
+
+    // The kernel is transformed only once, and shared by all the images in the batch
+    auto kernel_plan = FFT<T>::createForwardPlan(1, context->m_padded_width, context->m_padded_height,
+                                                 real_buffer, complex_buffer);
+    padKernel(context->m_padded_width, context->m_padded_height, real_buffer.begin());
+    FFT<T>::executeForward(kernel_plan, real_buffer, complex_buffer);
+    context->m_kernel_transform.assign(complex_buffer.begin(), complex_buffer.begin() + context->m_spectrum_size);
+
+    return context;
+  }
+
+  /**
+   * Convolve all the images with the stored kernel, using a single batched forward and inverse transform
+   * @tparam ImagePtr
+   *    A (shared) pointer to a WriteableImage
+   * @param images
+   *    The images to convolve. There must be exactly as many as the context was prepared for.
+   * @param context
+   *    The prepared context
+   */
+  template <typename ImagePtr>
+  void convolveBatch(std::vector<ImagePtr>& images, std::unique_ptr<BatchConvolutionContext>& context) const {
+    assert(static_cast<int>(images.size()) == context->m_howmany);
+
+    const int total_size = context->m_total_size;
+    auto& real_buffer = getThreadRealBuffer(total_size * context->m_howmany);
+    auto& complex_buffer = getThreadComplexBuffer(total_size * context->m_howmany);
+
+    // Stack the padded images
+    for (std::size_t i = 0; i < images.size(); ++i) {
+      assert(images[i]->getWidth() <= context->m_max_width);
+      assert(images[i]->getHeight() <= context->m_max_height);
+      auto padded = TPadding::create(images[i], context->m_padded_width, context->m_padded_height);
+      dumpImage(padded, real_buffer.begin() + i * total_size);
+    }
+
+    FFT<T>::executeForward(context->m_fwd_plan, real_buffer, complex_buffer);
+
+    // Multiply each transform by the kernel transform
+    for (std::size_t i = 0; i < images.size(); ++i) {
+      complex_t *spectrum = complex_buffer.data() + i * total_size;
+      for (int j = 0; j < context->m_spectrum_size; ++j) {
+        const auto& a = spectrum[j];
+        const auto& b = context->m_kernel_transform[j];
+        T re = a.real() * b.real() - a.imag() * b.imag();
+        T im = a.real() * b.imag() + a.imag() * b.real();
+        spectrum[j] = complex_t(re, im);
+      }
+    }
+
+    FFT<T>::executeInverse(context->m_inv_plan, complex_buffer, real_buffer);
+
+    // Copy to the outputs, removing the pad
+    for (std::size_t i = 0; i < images.size(); ++i) {
+      auto& image = images[i];
+      const T *result = real_buffer.data() + i * total_size;
+      int wpad = (context->m_padded_width - image->getWidth()) / 2;
+      int hpad = (context->m_padded_height - image->getHeight()) / 2;
+      for (int y = 0; y < image->getHeight(); ++y) {
+        for (int x = 0; x < image->getWidth(); ++x) {
+          image->setValue(x, y, result[x + wpad + (y + hpad) * context->m_padded_width] / total_size);
+        }
+      }
+    }
+  }
+
   /**
    * @return
    *    The convolution kernel
@@ -236,6 +366,26 @@ protected:
     }
   }
 
+  /**
+   * Batched convolutions use per-thread working buffers, so the contexts can be shared and kept
+   * alive without holding (potentially big) buffers for each one of them.
+   */
+  static std::vector<real_t>& getThreadRealBuffer(std::size_t size) {
+    static thread_local std::vector<real_t> buffer;
+    if (buffer.size() < size) {
+      buffer.resize(size);
+    }
+    return buffer;
+  }
+
+  static std::vector<complex_t>& getThreadComplexBuffer(std::size_t size) {
+    static thread_local std::vector<complex_t> buffer;
+    if (buffer.size() < size) {
+      buffer.resize(size);
+    }
+    return buffer;
+  }
+
 private:
   std::shared_ptr<const Image<T>> m_kernel;
 };
@@ -33,7 +33,7 @@ template <typename T = SeFloat, class TPadding = PaddedImage<T, Reflect101Coordi
 class DirectConvolution {
 public:
   DirectConvolution(std::shared_ptr<const Image<T>> img)
-    : m_kernel{MirrorImage<T>::create(img)} {
+    : m_kernel{VectorImage<T>::create(MirrorImage<T>::create(img))} {
   }
 
   virtual ~DirectConvolution() = default;
@@ -42,22 +42,33 @@ public:
   void convolve(std::shared_ptr<WriteableImage<T>> image, Args... padding_args) const {
     auto padded_width = image->getWidth() + m_kernel->getWidth() - 1;
     auto padded_height = image->getHeight() + m_kernel->getHeight() - 1;
-    auto lpad = m_kernel->getWidth() / 2;
     auto tpad = m_kernel->getHeight() / 2;
 
     auto padded = VectorImage<T>::create(
       TPadding::create(image, padded_width, padded_height, std::forward<Args>(padding_args)...)
     );
 
+    // Accumulate one kernel row at a time over a whole image row, so the inner loop
+    // runs over contiguous memory and can be vectorized
+    const int width = image->getWidth();
+    const auto& kernel_data = m_kernel->getData();
+    const auto& padded_data = padded->getData();
+    std::vector<T> acc(width);
+
     for (int iy = tpad; iy < padded->getHeight() - tpad; ++iy) {
-      for (int ix = lpad; ix < padded->getWidth() - lpad; ++ix) {
-        T acc = 0;
-        for (int ky = 0; ky < m_kernel->getHeight(); ++ky) {
-          for (int kx = 0; kx < m_kernel->getWidth(); ++kx) {
-            acc += m_kernel->getValue(kx, ky) * padded->getValue(ix - lpad + kx, iy - tpad + ky);
+      std::fill(acc.begin(), acc.end(), 0);
+      for (int ky = 0; ky < m_kernel->getHeight(); ++ky) {
+        const T *padded_row = padded_data.data() + (iy - tpad + ky) * padded_width;
+        for (int kx = 0; kx < m_kernel->getWidth(); ++kx) {
+          const T kv = kernel_data[kx + ky * m_kernel->getWidth()];
+          const T *in = padded_row + kx;
+          for (int ix = 0; ix < width; ++ix) {
+            acc[ix] += kv * in[ix];
           }
         }
-        image->setValue(ix - lpad, iy - tpad, acc);
+      }
+      for (int ix = 0; ix < width; ++ix) {
+        image->setValue(ix, iy - tpad, acc[ix]);
       }
     }
   }
@@ -75,7 +86,7 @@ public:
   }
 
 private:
-  std::shared_ptr<const Image<T>> m_kernel;
+  std::shared_ptr<const VectorImage<T>> m_kernel;
 };
 
 } // end SourceXtractor
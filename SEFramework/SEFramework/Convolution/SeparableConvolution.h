@@ -0,0 +1,261 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * @file SEFramework/Convolution/SeparableConvolution.h
+ * @date 19/10/26
+ */
+
+#ifndef _SEFRAMEWORK_CONVOLUTION_SEPARABLECONVOLUTION_H
+#define _SEFRAMEWORK_CONVOLUTION_SEPARABLECONVOLUTION_H
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+#include "SEFramework/Image/MirrorImage.h"
+#include "SEFramework/Image/PaddedImage.h"
+#include "SEFramework/Image/VectorImage.h"
+
+namespace SourceXtractor {
+
+/**
+ * Low rank approximation of a 2D kernel, as a sum of outer products of a column (vertical) and a row
+ * (horizontal) 1D kernel: K(x, y) ~ sum_i column_i(y) * row_i(x).
+ * Gaussian or top-hat filters are exactly separable (rank 1), so they can be applied with two
+ * 1D passes instead of a 2D one.
+ */
+template <typename T>
+struct SeparableKernel {
+  std::vector<std::vector<T>> m_columns;
+  std::vector<std::vector<T>> m_rows;
+
+  int getRank() const {
+    return m_columns.size();
+  }
+};
+
+/**
+ * Decompose a kernel using its Singular Value Decomposition (one sided Jacobi, as kernels are small).
+ * @param kernel
+ *    The kernel to decompose
+ * @param tolerance
+ *    Singular values are dropped as long as the (relative) norm of the residual stays below this value
+ * @return
+ *    The low rank approximation. Its rank is 0 if the kernel is all zeros.
+ */
+template <typename T>
+SeparableKernel<T> decomposeKernel(const Image<T>& kernel, double tolerance = 1e-4) {
+  const int height = kernel.getHeight();
+  const int width = kernel.getWidth();
+
+  // u is overwritten with U * Sigma, stored by columns; v accumulates the rotations
+  std::vector<std::vector<double>> u(width, std::vector<double>(height));
+  std::vector<std::vector<double>> v(width, std::vector<double>(width, 0.));
+  for (int x = 0; x < width; ++x) {
+    for (int y = 0; y < height; ++y) {
+      u[x][y] = kernel.getValue(x, y);
+    }
+    v[x][x] = 1.;
+  }
+
+  for (int sweep = 0; sweep < 60; ++sweep) {
+    bool rotated = false;
+    for (int p = 0; p < width - 1; ++p) {
+      for (int q = p + 1; q < width; ++q) {
+        double alpha = std::inner_product(u[p].begin(), u[p].end(), u[p].begin(), 0.);
+        double beta = std::inner_product(u[q].begin(), u[q].end(), u[q].begin(), 0.);
+        double gamma = std::inner_product(u[p].begin(), u[p].end(), u[q].begin(), 0.);
+        if (std::abs(gamma) <= 1e-15 * std::sqrt(alpha * beta)) {
+          continue;
+        }
+        rotated = true;
+        double zeta = (beta - alpha) / (2. * gamma);
+        double t = std::copysign(1., zeta) / (std::abs(zeta) + std::sqrt(1. + zeta * zeta));
+        double c = 1. / std::sqrt(1. + t * t);
+        double s = c * t;
+        for (int y = 0; y < height; ++y) {
+          double up = u[p][y], uq = u[q][y];
+          u[p][y] = c * up - s * uq;
+          u[q][y] = s * up + c * uq;
+        }
+        for (int x = 0; x < width; ++x) {
+          double vp = v[p][x], vq = v[q][x];
+          v[p][x] = c * vp - s * vq;
+          v[q][x] = s * vp + c * vq;
+        }
+      }
+    }
+    if (!rotated) {
+      break;
+    }
+  }
+
+  // Singular values are the norms of the columns of u
+  std::vector<double> sigma2(width);
+  std::vector<int> order(width);
+  for (int i = 0; i < width; ++i) {
+    sigma2[i] = std::inner_product(u[i].begin(), u[i].end(), u[i].begin(), 0.);
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&sigma2](int a, int b) { return sigma2[a] > sigma2[b]; });
+
+  double total = std::accumulate(sigma2.begin(), sigma2.end(), 0.);
+  double residual = total;
+
+  SeparableKernel<T> separable;
+  // The rank can not exceed the smallest dimension, anything beyond is rounding noise
+  const std::size_t max_rank = std::min(width, height);
+  for (int i : order) {
+    if (separable.m_columns.size() >= max_rank || residual <= tolerance * tolerance * total || sigma2[i] <= 0.) {
+      break;
+    }
+    residual -= sigma2[i];
+    separable.m_columns.emplace_back(u[i].begin(), u[i].end());
+    separable.m_rows.emplace_back(v[i].begin(), v[i].end());
+  }
+  return separable;
+}
+
+/**
+ * Apply a 1D kernel along the rows: out(x, y) += sum_k kernel(k) * in(x + k, y)
+ * The inner loop runs over contiguous memory, so it can be vectorized by the compiler.
+ */
+template <typename T>
+void separableRowPass(const T *in, int in_stride, T *out, int out_stride, int out_width, int height,
+                      const std::vector<T>& kernel) {
+  for (int y = 0; y < height; ++y) {
+    const T *in_row = in + y * in_stride;
+    T *out_row = out + y * out_stride;
+    for (std::size_t k = 0; k < kernel.size(); ++k) {
+      const T kv = kernel[k];
+      const T *in_k = in_row + k;
+      for (int x = 0; x < out_width; ++x) {
+        out_row[x] += kv * in_k[x];
+      }
+    }
+  }
+}
+
+/**
+ * Apply a 1D kernel along the columns: out(x, y) += sum_k kernel(k) * in(x, y + k)
+ * The inner loop runs over contiguous memory, so it can be vectorized by the compiler.
+ */
+template <typename T>
+void separableColumnPass(const T *in, int in_stride, T *out, int out_stride, int width, int out_height,
+                         const std::vector<T>& kernel) {
+  for (int y = 0; y < out_height; ++y) {
+    T *out_row = out + y * out_stride;
+    for (std::size_t k = 0; k < kernel.size(); ++k) {
+      const T kv = kernel[k];
+      const T *in_row = in + (y + k) * in_stride;
+      for (int x = 0; x < width; ++x) {
+        out_row[x] += kv * in_row[x];
+      }
+    }
+  }
+}
+
+/**
+ * Correlate `in` with a separable kernel, accumulating into `out`. `in` must have
+ * (out_width + kernel width - 1) x (out_height + kernel height - 1) pixels.
+ * @param scratch
+ *    Working buffer, resized as needed
+ */
+template <typename T>
+void separableCorrelate(const SeparableKernel<T>& kernel, const T *in, int in_stride,
+                        T *out, int out_stride, int out_width, int out_height, std::vector<T>& scratch) {
+  if (kernel.getRank() == 0) {
+    return;
+  }
+  const int in_height = out_height + kernel.m_columns.front().size() - 1;
+  for (int i = 0; i < kernel.getRank(); ++i) {
+    scratch.assign(out_width * in_height, 0);
+    separableRowPass(in, in_stride, scratch.data(), out_width, out_width, in_height, kernel.m_rows[i]);
+    separableColumnPass(scratch.data(), out_width, out, out_stride, out_width, out_height, kernel.m_columns[i]);
+  }
+}
+
+/**
+ * Convolution strategy that applies a low rank approximation of the kernel as a sequence of
+ * row and column passes. For a kernel of rank r and size w x h, each pixel costs r * (w + h)
+ * operations, instead of w * h for the direct convolution.
+ * @tparam T
+ *  The pixel type
+ * @tparam TPadding
+ *  The padding strategy
+ */
+template <typename T = SeFloat, class TPadding = PaddedImage<T, Reflect101Coordinates>>
+class SeparableConvolution {
+public:
+  /**
+   * Constructor
+   * @param img
+   *    Convolution kernel
+   * @param tolerance
+   *    Relative error allowed for the low rank approximation of the kernel
+   */
+  SeparableConvolution(std::shared_ptr<const Image<T>> img, double tolerance = 1e-4)
+    : m_kernel{MirrorImage<T>::create(img)}, m_separable{decomposeKernel(*m_kernel, tolerance)} {
+  }
+
+  virtual ~SeparableConvolution() = default;
+
+  template <typename ...Args>
+  void convolve(std::shared_ptr<WriteableImage<T>> image, Args... padding_args) const {
+    auto padded_width = image->getWidth() + m_kernel->getWidth() - 1;
+    auto padded_height = image->getHeight() + m_kernel->getHeight() - 1;
+
+    auto padded = VectorImage<T>::create(
+      TPadding::create(image, padded_width, padded_height, std::forward<Args>(padding_args)...)
+    );
+
+    std::vector<T> output(image->getWidth() * image->getHeight()), scratch;
+    separableCorrelate(m_separable, padded->getData().data(), padded_width,
+                       output.data(), image->getWidth(), image->getWidth(), image->getHeight(), scratch);
+
+    for (int y = 0; y < image->getHeight(); ++y) {
+      for (int x = 0; x < image->getWidth(); ++x) {
+        image->setValue(x, y, output[x + y * image->getWidth()]);
+      }
+    }
+  }
+
+  std::size_t getWidth() const {
+    return m_kernel->getWidth();
+  }
+
+  std::size_t getHeight() const {
+    return m_kernel->getHeight();
+  }
+
+  int getRank() const {
+    return m_separable.getRank();
+  }
+
+  std::shared_ptr<const Image<T>> getKernel() const {
+    return m_kernel;
+  }
+
+private:
+  std::shared_ptr<const Image<T>> m_kernel;
+  SeparableKernel<T> m_separable;
+};
+
+} // end SourceXtractor
+
+#endif // _SEFRAMEWORK_CONVOLUTION_SEPARABLECONVOLUTION_H
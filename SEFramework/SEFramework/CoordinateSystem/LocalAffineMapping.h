@@ -0,0 +1,105 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * LocalAffineMapping.h
+ */
+
+#ifndef _SEFRAMEWORK_COORDINATESYSTEM_LOCALAFFINEMAPPING_H_
+#define _SEFRAMEWORK_COORDINATESYSTEM_LOCALAFFINEMAPPING_H_
+
+#include <algorithm>
+#include <cmath>
+#include "SEFramework/CoordinateSystem/CoordinateSystem.h"
+
+namespace SourceXtractor {
+
+/**
+ * @class LocalAffineMapping
+ * @brief
+ *  Linear approximation of the pixel to pixel mapping between two coordinate systems
+ *  within a box around a given position.
+ *
+ * @details
+ *  The linear terms are obtained by central differences over the half extent of the box, and the
+ *  error of the approximation is measured against the exact mapping at the corners and the middle
+ *  of the edges. Mapping a pixel is then two multiply-adds instead of a round trip through the world
+ *  coordinates.
+ */
+class LocalAffineMapping {
+public:
+
+  /**
+   * @param from
+   *    Coordinate system of the input pixel coordinates
+   * @param to
+   *    Coordinate system of the output pixel coordinates
+   * @param center
+   *    Center of the box, in the from coordinate system
+   * @param half_width, half_height
+   *    Half extent of the box where the mapping is to be used
+   */
+  LocalAffineMapping(const CoordinateSystem& from, const CoordinateSystem& to, const ImageCoordinate& center,
+                     double half_width, double half_height) : m_center(center), m_max_error(0.) {
+    half_width = std::max(half_width, 1.);
+    half_height = std::max(half_height, 1.);
+
+    auto exact = [&from, &to](double x, double y) {
+      return to.worldToImage(from.imageToWorld(ImageCoordinate(x, y)));
+    };
+
+    m_origin = exact(center.m_x, center.m_y);
+    auto left = exact(center.m_x - half_width, center.m_y);
+    auto right = exact(center.m_x + half_width, center.m_y);
+    auto bottom = exact(center.m_x, center.m_y - half_height);
+    auto top = exact(center.m_x, center.m_y + half_height);
+
+    m_dx_dx = (right.m_x - left.m_x) / (2 * half_width);
+    m_dy_dx = (right.m_y - left.m_y) / (2 * half_width);
+    m_dx_dy = (top.m_x - bottom.m_x) / (2 * half_height);
+    m_dy_dy = (top.m_y - bottom.m_y) / (2 * half_height);
+
+    for (int i = -1; i <= 1; ++i) {
+      for (int j = -1; j <= 1; ++j) {
+        double x = center.m_x + i * half_width, y = center.m_y + j * half_height;
+        auto expected = exact(x, y);
+        auto approximated = (*this)(x, y);
+        m_max_error = std::max(m_max_error, std::max(std::abs(expected.m_x - approximated.m_x),
+                                                     std::abs(expected.m_y - approximated.m_y)));
+      }
+    }
+  }
+
+  ImageCoordinate operator()(double x, double y) const {
+    double dx = x - m_center.m_x, dy = y - m_center.m_y;
+    return ImageCoordinate(m_origin.m_x + m_dx_dx * dx + m_dx_dy * dy,
+                           m_origin.m_y + m_dy_dx * dx + m_dy_dy * dy);
+  }
+
+  /// Largest difference, in pixels of the output system, with the exact mapping at the sampled positions
+  double getMaxError() const {
+    return m_max_error;
+  }
+
+private:
+  ImageCoordinate m_center, m_origin;
+  double m_dx_dx, m_dx_dy, m_dy_dx, m_dy_dy;
+  double m_max_error;
+};
+
+} // end of namespace SourceXtractor
+
+#endif /* _SEFRAMEWORK_COORDINATESYSTEM_LOCALAFFINEMAPPING_H_ */
@@ -25,6 +25,7 @@
 
 #include <complex>
 #include <memory>
+#include <vector>
 #include <fftw3.h>
 
 
@@ -169,6 +170,17 @@ struct FFT {
  */
 int fftRoundDimension(int size);
 
+/**
+ * Round up a size to the next integer of the form 2^a 3^b 5^c 7^d. Unlike fftRoundDimension, this
+ * never picks sizes with factors 11 or 13, nor falls back to multiples of 512, so it is better suited
+ * for the batched transforms, where the plan is executed many times for the same dimensions.
+ * @param size
+ *  The size to round up
+ * @return
+ *  The smallest 7-smooth integer greater or equal to size
+ */
+int fftSmoothDimension(int size);
+
 } // end SourceXtractor
 
 #endif // _SEFRAMEWORK_FFT_FFT_H
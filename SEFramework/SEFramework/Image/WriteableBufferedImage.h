@@ -24,6 +24,9 @@
 #ifndef _SEFRAMEWORK_IMAGE_WRITEABLEBUFFEREDIMAGE_H_
 #define _SEFRAMEWORK_IMAGE_WRITEABLEBUFFEREDIMAGE_H_
 
+#include <algorithm>
+#include <functional>
+
 #include "SEFramework/Image/WriteableImage.h"
 #include "SEFramework/Image/BufferedImage.h"
 
@@ -59,6 +62,47 @@ public:
     m_current_tile->setValue(x, y, value);
   }
 
+  virtual void fillRow(int x, int y, int length, T value) override {
+    assert(x >= 0 && y >=0 && x + length <= BufferedImage<T>::m_source->getWidth() && y < BufferedImage<T>::m_source->getHeight());
+
+    // Fill the part of the row inside each tile at once
+    int end = x + length;
+    while (x < end) {
+      if (m_current_tile == nullptr || !m_current_tile->isPixelInTile(x, y)) {
+        m_current_tile = BufferedImage<T>::m_tile_manager->getTileForPixel(x, y, BufferedImage<T>::m_source);
+      }
+      m_current_tile->setModified(true);
+
+      auto& tile_image = *m_current_tile->getImage();
+      int tile_x = x - m_current_tile->getPosX();
+      int tile_end = std::min(end - m_current_tile->getPosX(), tile_image.getWidth());
+      auto row = tile_image.getData().begin() + (y - m_current_tile->getPosY()) * tile_image.getWidth();
+      std::fill(row + tile_x, row + tile_end, value);
+      x += tile_end - tile_x;
+    }
+  }
+
+  virtual void addToRow(int x, int y, int length, const T* values) override {
+    assert(x >= 0 && y >=0 && x + length <= BufferedImage<T>::m_source->getWidth() && y < BufferedImage<T>::m_source->getHeight());
+
+    // Add the part of the row inside each tile at once
+    int end = x + length;
+    while (x < end) {
+      if (m_current_tile == nullptr || !m_current_tile->isPixelInTile(x, y)) {
+        m_current_tile = BufferedImage<T>::m_tile_manager->getTileForPixel(x, y, BufferedImage<T>::m_source);
+      }
+      m_current_tile->setModified(true);
+
+      auto& tile_image = *m_current_tile->getImage();
+      int tile_x = x - m_current_tile->getPosX();
+      int tile_end = std::min(end - m_current_tile->getPosX(), tile_image.getWidth());
+      auto row = tile_image.getData().begin() + (y - m_current_tile->getPosY()) * tile_image.getWidth();
+      std::transform(row + tile_x, row + tile_end, values, row + tile_x, std::plus<T>());
+      values += tile_end - tile_x;
+      x += tile_end - tile_x;
+    }
+  }
+
 };
 
 }
@@ -34,6 +34,20 @@ public:
 
   virtual void setValue(int x, int y, T value) = 0;
   //virtual void setValues(int x, int y, int width, int height, T* values) = 0;
+
+  /// Sets the pixels from (x, y) to (x + length - 1, y) to value
+  virtual void fillRow(int x, int y, int length, T value) {
+    for (int i = 0; i < length; ++i) {
+      setValue(x + i, y, value);
+    }
+  }
+
+  /// Adds values[i] to the pixel (x + i, y), for i from 0 to length - 1
+  virtual void addToRow(int x, int y, int length, const T* values) {
+    for (int i = 0; i < length; ++i) {
+      setValue(x + i, y, this->getValue(x + i, y) + values[i]);
+    }
+  }
 };
 
 }
@@ -156,6 +156,9 @@ public:
 
   SourceToRowConverter getSourceToRowConverter(const std::vector<std::string>& enabled_optional);
 
+  /// Properties read by the converter returned by getSourceToRowConverter()
+  std::vector<PropertyId> getOutputPropertyIds(const std::vector<std::string>& enabled_optional);
+
   void printPropertyColumnMap(const std::vector<std::string>& properties={});
 
 private:
@@ -167,15 +170,24 @@ private:
       m_convert_func = [converter](const SourceInterface& source, std::size_t index){
         return converter(source.getProperty<PropertyType>(index));
       };
+      m_property_id_func = [](std::size_t index) {
+        return PropertyId::create<PropertyType>(index);
+      };
     }
     Euclid::Table::Row::cell_type operator()(const SourceInterface& source) {
       return m_convert_func(source, index);
     }
+    PropertyId getPropertyId() const {
+      return m_property_id_func(index);
+    }
     std::size_t index = 0;
   private:
     std::function<Euclid::Table::Row::cell_type(const SourceInterface&, std::size_t index)> m_convert_func;
+    std::function<PropertyId(std::size_t index)> m_property_id_func;
   };
 
+  std::vector<std::type_index> getOutputPropertyTypes(const std::vector<std::string>& enabled_properties);
+
   struct ColInfo {
     std::string unit;
     std::string description;
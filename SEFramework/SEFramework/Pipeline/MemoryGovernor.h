@@ -0,0 +1,101 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * MemoryGovernor.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef _SEFRAMEWORK_PIPELINE_MEMORYGOVERNOR_H_
+#define _SEFRAMEWORK_PIPELINE_MEMORYGOVERNOR_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "SEFramework/Source/SourceInterface.h"
+#include "SEFramework/Source/SourceGroupInterface.h"
+
+namespace SourceXtractor {
+
+/**
+ * @class MemoryGovernor
+ * @brief
+ *  Process-wide account of the memory held by the pipeline stages between the detection and the output.
+ *
+ * @details
+ *  Each stage charges the estimated size of the sources or rows it keeps, and releases it once they are
+ *  handed over downstream. Producers call waitForBudget before admitting more work, so they block while the
+ *  budget is exceeded and some other thread is still going to free memory.
+ *  The stages keep the amount they charged, and release that same amount.
+ *  The image tiles are not accounted here, they have their own limit on the TileManager.
+ */
+class MemoryGovernor {
+public:
+
+  using SourceSizeEstimator = std::function<std::size_t(const SourceInterface&)>;
+
+  MemoryGovernor();
+
+  virtual ~MemoryGovernor() = default;
+
+  static std::shared_ptr<MemoryGovernor> getInstance();
+
+  /// Set the budget in bytes. 0 means there is no limit, and only the usage is tracked
+  void setLimit(std::size_t limit);
+
+  std::size_t getLimit() const;
+
+  std::size_t getUsed() const;
+
+  /// Highest usage seen so far
+  std::size_t getPeak() const;
+
+  bool isOverBudget() const;
+
+  void charge(std::size_t bytes);
+
+  void release(std::size_t bytes);
+
+  /**
+   * Block until the usage is within the budget, or until can_proceed returns true.
+   * can_proceed must return true when the caller has nothing pending that other threads may release,
+   * otherwise it could wait forever. Its state must change before the matching call to release.
+   * Returns immediately when there is no limit.
+   */
+  void waitForBudget(std::function<bool()> can_proceed);
+
+  void setSourceSizeEstimator(SourceSizeEstimator estimator);
+
+  std::size_t estimate(const SourceInterface& source) const;
+
+  std::size_t estimate(const SourceGroupInterface& group) const;
+
+private:
+  // Only needed to wait for a release, the counters are updated without it
+  std::mutex m_mutex;
+  std::condition_variable m_released;
+  std::atomic<std::size_t> m_limit, m_used, m_peak;
+  // Accessed with std::atomic_load and std::atomic_store
+  std::shared_ptr<const SourceSizeEstimator> m_estimator;
+};
+
+} /* namespace SourceXtractor */
+
+#endif /* _SEFRAMEWORK_PIPELINE_MEMORYGOVERNOR_H_ */
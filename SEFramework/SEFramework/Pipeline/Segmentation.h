@@ -80,6 +80,9 @@ public:
   /// Processes a Frame notifying Observers with a Source object for each detection
   void processFrame(std::shared_ptr<DetectionImageFrame> frame) const;
 
+  /// Sets up the Frame as processFrame would, without running the detection
+  void prepareFrame(std::shared_ptr<DetectionImageFrame> frame) const;
+
 protected:
   void publishSource(std::shared_ptr<SourceInterface> source) const {
     Observable<std::shared_ptr<SourceInterface>>::notifyObservers(source);
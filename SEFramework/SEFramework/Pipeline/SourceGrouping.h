@@ -25,6 +25,7 @@
 
 #include <memory>
 #include <list>
+#include <unordered_map>
 
 #include "SEUtils/Observable.h"
 
@@ -121,6 +122,8 @@ private:
   std::shared_ptr<GroupingCriteria> m_grouping_criteria;
   std::shared_ptr<SourceGroupFactory> m_group_factory;
   std::list<std::shared_ptr<SourceGroupInterface>> m_source_groups;
+  // Bytes charged to the MemoryGovernor for each group in m_source_groups
+  std::unordered_map<const SourceGroupInterface*, std::size_t> m_group_charges;
 
 }; /* End of SourceGrouping class */
 
@@ -24,7 +24,7 @@
 #define _SEFRAMEWORK_PROPERTY_PROPERTYHOLDER_H
 
 #include <memory>
-#include <unordered_map>
+#include <vector>
 
 #include "SEFramework/Property/PropertyId.h"
 #include "SEFramework/Property/Property.h"
@@ -36,7 +36,9 @@ namespace SourceXtractor {
  * @class PropertyHolder
  * @brief A class providing a simple implementation of a container of properties.
  *
- * @details This class is used to provide a common implementation for objects that have properties
+ * @details This class is used to provide a common implementation for objects that have properties.
+ * Properties are stored in a flat array indexed by the slot of their PropertyId, which grows
+ * up to the highest slot set.
  *
  */
 
@@ -69,7 +71,7 @@ public:
 
 private:
 
-  std::unordered_map<PropertyId, std::unique_ptr<Property>> m_properties;
+  std::vector<std::unique_ptr<Property>> m_properties;
 
 }; /* End of ObjectWithProperties class */
 
@@ -23,6 +23,8 @@
 #ifndef _SEFRAMEWORK_PROPERTY_PROPERTYID_H
 #define _SEFRAMEWORK_PROPERTY_PROPERTYID_H
 
+#include <array>
+#include <atomic>
 #include <typeindex>
 #include <string>
 #include <functional>
@@ -35,6 +37,9 @@ namespace SourceXtractor {
  * @class PropertyId
  * @brief Identifier used to set and retrieve properties.
  *
+ * @details Each distinct pair of type and index is assigned a dense slot number the first time
+ * it is created, which is normally when the plugins register their tasks and outputs. Property
+ * holders use it to index a flat array instead of hashing the type.
  */
 
 class PropertyId {
@@ -43,13 +48,15 @@ public:
   /// An optional index parameter is used to make the distinction between several properties of the same type.
   template<typename T>
   static PropertyId create(unsigned int index = 0) {
-    return PropertyId(typeid(T), index);
+    static SlotCache slot_cache{typeid(T)};
+    return PropertyId(typeid(T), index, slot_cache.get(index));
   }
 
   /// Equality operator is needed to be use PropertyId as key in unordered_map
   bool operator==(PropertyId other) const {
-    // A PropertyId is equal to another if both their type_id and index are the same
-    return m_type_id == other.m_type_id && m_index == other.m_index;
+    // A PropertyId is equal to another if both their type_id and index are the same, which is
+    // the case if and only if they have the same slot
+    return m_slot == other.m_slot;
   }
 
   /// Less than operator needed to use PropertyId as key in a std::map
@@ -71,6 +78,14 @@ public:
     return m_index;
   }
 
+  /// Dense number identifying the type and index
+  unsigned int getSlot() const {
+    return m_slot;
+  }
+
+  /// Number of slots assigned so far
+  static unsigned int getSlotCount();
+
   std::string getString() const {
     std::stringstream property_name;
     property_name << m_type_id.name() << " [ " << m_index << " ] ";
@@ -78,10 +93,42 @@ public:
   }
 
 private:
-  PropertyId(std::type_index type_id, unsigned int index) : m_type_id(type_id), m_index(index) {}
+  PropertyId(std::type_index type_id, unsigned int index, unsigned int slot)
+    : m_type_id(type_id), m_index(index), m_slot(slot) {}
+
+  /// Returns the slot of the pair, assigning a new one if needed. Thread safe
+  static unsigned int registerSlot(std::type_index type_id, unsigned int index);
+
+  /// Remembers the slots of the first indexes of a type, so most lookups avoid the registry lock
+  class SlotCache {
+  public:
+    explicit SlotCache(std::type_index type_id) : m_type_id(type_id) {
+      for (auto& slot : m_slots) {
+        slot = NO_SLOT;
+      }
+    }
+
+    unsigned int get(unsigned int index) {
+      if (index >= m_slots.size()) {
+        return registerSlot(m_type_id, index);
+      }
+      unsigned int slot = m_slots[index].load(std::memory_order_relaxed);
+      if (slot == NO_SLOT) {
+        slot = registerSlot(m_type_id, index);
+        m_slots[index].store(slot, std::memory_order_relaxed);
+      }
+      return slot;
+    }
+
+  private:
+    static constexpr unsigned int NO_SLOT = ~0u;
+    std::type_index m_type_id;
+    std::array<std::atomic<unsigned int>, 32> m_slots;
+  };
 
   std::type_index m_type_id;
   unsigned int m_index;
+  unsigned int m_slot;
 
 
   friend struct std::hash<SourceXtractor::PropertyId>;
@@ -97,10 +144,7 @@ template <>
 struct hash<SourceXtractor::PropertyId>
 {
   std::size_t operator()(const SourceXtractor::PropertyId& id) const {
-    std::size_t hash = 0;
-    boost::hash_combine(hash, id.m_type_id);
-    boost::hash_combine(hash, id.m_index);
-    return hash;
+    return id.m_slot;
   }
 };
 
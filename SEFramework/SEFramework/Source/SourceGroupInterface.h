@@ -70,6 +70,10 @@ public:
       return *m_source;
     }
 
+    SourceInterface& getTaskSource() override {
+      return m_source->getTaskSource();
+    }
+
     using SourceInterface::getProperty;
     using SourceInterface::setProperty;
     using SourceInterface::setIndexedProperty;
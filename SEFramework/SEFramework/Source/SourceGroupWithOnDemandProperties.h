@@ -103,6 +103,11 @@ public:
   const Property& getProperty(const PropertyId& property_id) const override;
 
   void setProperty(std::unique_ptr<Property> property, const PropertyId& property_id) override;
+
+  /// The properties that are not computed by group tasks come from the wrapped source
+  SourceInterface& getTaskSource() override {
+    return m_source->getTaskSource();
+  }
   
   bool operator<(const EntangledSource& other) const;
 
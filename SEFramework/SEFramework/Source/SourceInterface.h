@@ -78,6 +78,12 @@ public:
   virtual const Property& getProperty(const PropertyId& property_id) const = 0;
   virtual void setProperty(std::unique_ptr<Property> property, const PropertyId& property_id) = 0;
 
+  /// Returns the source on which the SourceTasks compute the properties requested through this one.
+  /// Sources forwarding those requests to another source return the latter
+  virtual SourceInterface& getTaskSource() {
+    return *this;
+  }
+
 }; /* End of SourceInterface class */
 
 } /* namespace SourceXtractor */
@@ -0,0 +1,105 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * ExecutionPlan.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef _SEFRAMEWORK_TASK_EXECUTIONPLAN_H_
+#define _SEFRAMEWORK_TASK_EXECUTIONPLAN_H_
+
+#include <functional>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include "SEFramework/Property/PropertyId.h"
+#include "SEFramework/Source/SourceInterface.h"
+#include "SEFramework/Task/SourceTask.h"
+#include "SEFramework/Task/TaskProvider.h"
+
+namespace SourceXtractor {
+
+/**
+ * @class ExecutionPlan
+ * @brief Orders the tasks needed to compute a set of properties, so independent tasks can run concurrently
+ *
+ * @details The tasks that declare their dependencies form a graph, which is split into stages: the tasks
+ * of a stage only depend on properties computed by previous stages. Every other task gets a stage of its own,
+ * since it may read anything.
+ *
+ * Running the plan is only an optimization: the properties are still computed on demand, so a property
+ * that is missing from the plan is computed when first read. A task that declares its dependencies may only
+ * read those while its stage runs: computing any other property on demand would race with the other tasks.
+ */
+class ExecutionPlan {
+public:
+
+  /// Runs body(0) ... body(n - 1), and returns once all of them are done
+  using ParallelFor = std::function<void(std::size_t n, const std::function<void(std::size_t)>& body)>;
+
+  /// Runs the iterations one after the other on the calling thread
+  static void serialFor(std::size_t n, const std::function<void(std::size_t)>& body);
+
+  /**
+   * @param task_provider
+   *    Provides the tasks that compute each property
+   * @param properties
+   *    Properties to compute
+   * @throw Elements::Exception
+   *    If the declared dependencies form a cycle
+   */
+  ExecutionPlan(const TaskProvider& task_provider, const std::vector<PropertyId>& properties);
+
+  /**
+   * Computes the planned properties of the source. The tasks of a stage are given to parallel_for, and see
+   * the source returned by getTaskSource() through a proxy that serializes the accesses to its properties
+   * @throw Elements::Exception
+   *    If a task of a concurrent stage reads a property it does not declare
+   */
+  void execute(SourceInterface& source, const ParallelFor& parallel_for = serialFor) const;
+
+  /// Properties computed by each stage, in order
+  std::vector<std::vector<PropertyId>> getStages() const;
+
+  /// Largest number of tasks that can run at the same time
+  std::size_t getMaxConcurrency() const;
+
+private:
+
+  struct Step {
+    PropertyId m_property_id;
+    std::shared_ptr<const SourceTask> m_task;
+    // Properties the task may read, only filled for concurrent stages
+    std::unordered_set<PropertyId> m_dependencies;
+  };
+
+  struct Stage {
+    // Only tasks with declared dependencies run concurrently
+    bool m_concurrent;
+    std::vector<Step> m_steps;
+  };
+
+  class StepSource;
+
+  std::vector<Stage> m_stages;
+};
+
+} // end of namespace SourceXtractor
+
+#endif /* _SEFRAMEWORK_TASK_EXECUTIONPLAN_H_ */
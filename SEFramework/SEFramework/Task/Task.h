@@ -23,6 +23,10 @@
 #ifndef _SEFRAMEWORK_TASK_TASK_H
 #define _SEFRAMEWORK_TASK_TASK_H
 
+#include <vector>
+
+#include "SEFramework/Property/PropertyId.h"
+
 namespace SourceXtractor {
 
 /**
@@ -41,6 +45,24 @@ public:
    */
   virtual ~Task() = default;
 
+  /**
+   * @brief Tells if getDependencies() lists every property read by the task
+   *
+   * @details Tasks that do not declare their dependencies are still computed on demand, but
+   * the ExecutionPlan runs them one at a time, in the order they are requested.
+   * A task that declares them may run at the same time as other tasks of the same source, so it must not
+   * read or set properties while holding a lock that the tasks computing those properties could take.
+   * Reading a property missing from the declaration makes the ExecutionPlan fail
+   */
+  virtual bool declaresDependencies() const {
+    return false;
+  }
+
+  /// Properties read by the task, only meaningful if declaresDependencies() returns true
+  virtual std::vector<PropertyId> getDependencies() const {
+    return {};
+  }
+
 
 private:
 
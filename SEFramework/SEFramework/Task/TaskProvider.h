@@ -23,8 +23,11 @@
 #ifndef _SEFRAMEWORK_TASK_TASKPROVIDER_H
 #define _SEFRAMEWORK_TASK_TASKPROVIDER_H
 
+#include <array>
+#include <atomic>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "ElementsKernel/Exception.h"
 
@@ -46,8 +49,7 @@ public:
   /// Destructor
   virtual ~TaskProvider() = default;
 
-  TaskProvider(std::shared_ptr<TaskFactoryRegistry> task_factory_registry)
-    : m_task_factory_registry(task_factory_registry) {}
+  TaskProvider(std::shared_ptr<TaskFactoryRegistry> task_factory_registry);
 
   /// Template version of getTask() that includes casting the returned pointer to the appropriate type
   template<class T>
@@ -59,9 +61,22 @@ protected:
   virtual std::shared_ptr<const Task> getTask(const PropertyId& property_id) const;
 
 private:
+  static constexpr std::size_t RESOLVED_CHUNK_SIZE = 256;
+  static constexpr std::size_t MAX_RESOLVED_CHUNKS = 1024;
+  using ResolvedChunk = std::array<std::atomic<const std::shared_ptr<Task>*>, RESOLVED_CHUNK_SIZE>;
+
+  /// Returns the already resolved task for the slot, or nullptr if it has not been resolved yet
+  const std::shared_ptr<Task>* findResolved(unsigned int slot) const;
+
   std::shared_ptr<TaskFactoryRegistry> m_task_factory_registry;
   std::unordered_map<PropertyId, std::shared_ptr<Task>> m_tasks;
 
+  // Once resolved, the entries of m_tasks are published on a table indexed by the slot of their PropertyId.
+  // Every source asks for the same properties, so after the first few sources the lookups
+  // neither take the lock nor hash
+  std::array<std::atomic<ResolvedChunk*>, MAX_RESOLVED_CHUNKS> m_resolved;
+  std::vector<std::unique_ptr<ResolvedChunk>> m_resolved_chunks;
+
 }; /* End of TaskProvider class */
 
 
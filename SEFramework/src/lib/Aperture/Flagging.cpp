@@ -17,6 +17,8 @@
 
 
 
+#include <algorithm>
+#include "SEFramework/Image/ImageChunk.h"
 #include "SEFramework/Aperture/Flagging.h"
 
 namespace SourceXtractor {
@@ -79,4 +81,53 @@ Flags computeFlags(const std::shared_ptr<Aperture>& aperture,
   return flag;
 }
 
+Flags computeFlags(const EllipticalScan& ellipse,
+                   const std::vector<PixelCoordinate>& pix_list,
+                   const std::shared_ptr<Image<SeFloat>>& detection_img,
+                   const std::shared_ptr<Image<SeFloat>>& detection_variance,
+                   const std::shared_ptr<Image<SeFloat>>& threshold_image,
+                   SeFloat variance_threshold) {
+  const auto& min_pixel = ellipse.getMinPixel();
+  const auto& max_pixel = ellipse.getMaxPixel();
+
+  NeighbourInfo neighbour_info(min_pixel, max_pixel, pix_list, threshold_image);
+
+  // read the variance of the part of the aperture inside the image
+  int clip_min_x = std::max(min_pixel.m_x, 0);
+  int clip_min_y = std::max(min_pixel.m_y, 0);
+  int clip_max_x = std::min(max_pixel.m_x, detection_img->getWidth() - 1);
+  int clip_max_y = std::min(max_pixel.m_y, detection_img->getHeight() - 1);
+  std::shared_ptr<ImageChunk<SeFloat>> variance_chunk;
+  if (clip_max_x >= clip_min_x && clip_max_y >= clip_min_y) {
+    variance_chunk = detection_variance->getChunk(clip_min_x, clip_min_y,
+                                                  clip_max_x - clip_min_x + 1, clip_max_y - clip_min_y + 1);
+  }
+
+  Flags flag = Flags::NONE;
+  SeFloat total_area = 0.0;
+  SeFloat bad_area = 0;
+  SeFloat full_area = 0;
+
+  ellipse.scan([&](int pixel_x, int pixel_y, SeFloat) {
+    if (pixel_x >= clip_min_x && pixel_y >= clip_min_y && pixel_x <= clip_max_x && pixel_y <= clip_max_y) {
+      total_area += 1;
+      full_area += neighbour_info.isNeighbourObjectPixel(pixel_x, pixel_y);
+      bad_area += (variance_chunk->getValue(pixel_x - clip_min_x, pixel_y - clip_min_y) > variance_threshold);
+    }
+    else {
+      flag |= Flags::BOUNDARY;
+    }
+  });
+
+  // check/set the bad area flag
+  if (total_area > 0 && bad_area / total_area > BADAREA_THRESHOLD_APER)
+    flag |= Flags::BIASED;
+
+  // check/set the crowded area flag
+  if (total_area > 0 && full_area / total_area > CROWD_THRESHOLD_APER)
+    flag |= Flags::NEIGHBORS;
+
+  return flag;
+}
+
 } // end of namespace SourceXtractor
@@ -21,6 +21,8 @@
  *      Author: Alejandro Alvarez
  */
 
+#include <algorithm>
+#include "SEFramework/Image/ImageChunk.h"
 #include "SEFramework/Aperture/FluxMeasurement.h"
 
 
@@ -106,4 +108,64 @@ FluxMeasurement measureFlux(const std::shared_ptr<Aperture> &aperture, SeFloat c
   return measurement;
 }
 
+FluxMeasurement measureFlux(const EllipticalScan &ellipse,
+                            const std::shared_ptr<Image<SeFloat>> &img,
+                            const std::shared_ptr<Image<SeFloat>> &variance_map, SeFloat variance_threshold,
+                            bool use_symmetry) {
+  const auto& min_pixel = ellipse.getMinPixel();
+  const auto& max_pixel = ellipse.getMaxPixel();
+
+  FluxMeasurement measurement;
+
+  // Skip if the full source is outside the frame
+  if (max_pixel.m_x < 0 || max_pixel.m_y < 0 || min_pixel.m_x >= img->getWidth() ||
+      min_pixel.m_y >= img->getHeight()) {
+    measurement.m_flags = Flags::OUTSIDE;
+    return measurement;
+  }
+
+  int clip_min_x = std::max(min_pixel.m_x, 0);
+  int clip_min_y = std::max(min_pixel.m_y, 0);
+  int clip_max_x = std::min(max_pixel.m_x, img->getWidth() - 1);
+  int clip_max_y = std::min(max_pixel.m_y, img->getHeight() - 1);
+  auto img_chunk = img->getChunk(clip_min_x, clip_min_y, clip_max_x - clip_min_x + 1, clip_max_y - clip_min_y + 1);
+  auto variance_chunk = variance_map->getChunk(clip_min_x, clip_min_y,
+                                               clip_max_x - clip_min_x + 1, clip_max_y - clip_min_y + 1);
+
+  SeFloat centroid_x = ellipse.getCentroidX(), centroid_y = ellipse.getCentroidY();
+
+  ellipse.scan([&](int pixel_x, int pixel_y, SeFloat) {
+    SeFloat pixel_value = 0;
+    SeFloat pixel_variance = 0;
+
+    measurement.m_total_area += 1;
+
+    // make sure the pixel is inside the image
+    if (pixel_x >= clip_min_x && pixel_y >= clip_min_y && pixel_x <= clip_max_x && pixel_y <= clip_max_y) {
+      SeFloat variance_tmp = variance_chunk->getValue(pixel_x - clip_min_x, pixel_y - clip_min_y);
+      if (variance_tmp > variance_threshold) {
+        measurement.m_bad_area += 1;
+        if (use_symmetry) {
+          std::tie(pixel_value, pixel_variance) = getMirrorPixel(
+            centroid_x, centroid_y, pixel_x, pixel_y, img, variance_map, variance_threshold);
+        }
+      }
+      else {
+        pixel_value = img_chunk->getValue(pixel_x - clip_min_x, pixel_y - clip_min_y);
+        pixel_variance = variance_tmp;
+      }
+
+      measurement.m_flux += pixel_value;
+      measurement.m_variance += pixel_variance;
+    } else {
+      measurement.m_flags |= Flags::BOUNDARY;
+    }
+  });
+
+  // check/set the bad area flag
+  bool is_biased = measurement.m_total_area > 0 && measurement.m_bad_area / measurement.m_total_area > BADAREA_THRESHOLD_APER;
+  measurement.m_flags |= Flags::BIASED * is_biased;
+  return measurement;
+}
+
 } // end SourceXtractor
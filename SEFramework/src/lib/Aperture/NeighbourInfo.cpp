@@ -21,6 +21,9 @@
  *      Author: Alejandro Alvarez
  */
 
+#include <algorithm>
+#include <cassert>
+#include "SEFramework/Image/ImageChunk.h"
 #include "SEFramework/Aperture/NeighbourInfo.h"
 
 namespace SourceXtractor {
@@ -29,30 +32,35 @@ NeighbourInfo::NeighbourInfo(const PixelCoordinate& min_pixel, const PixelCoordi
                              const std::vector<SourceXtractor::PixelCoordinate>& pixel_list,
                              const std::shared_ptr<SourceXtractor::Image<SourceXtractor::SeFloat>>& threshold_image)
   : m_offset{min_pixel} {
-  auto width = max_pixel.m_x - min_pixel.m_x + 1;
-  auto height = max_pixel.m_y - min_pixel.m_y + 1;
-  m_neighbour_image = VectorImage<int>::create(width, height);
+  m_width = max_pixel.m_x - min_pixel.m_x + 1;
+  m_height = max_pixel.m_y - min_pixel.m_y + 1;
+  m_neighbour_mask.resize(m_width * m_height, false);
 
-  for (auto& pixel_coord : pixel_list) {
-    auto act_x = pixel_coord.m_x - m_offset.m_x;
-    auto act_y = pixel_coord.m_y - m_offset.m_y;
+  // pixels above the threshold, read in one go from the part of the box inside the image
+  int clip_min_x = std::max(min_pixel.m_x, 0);
+  int clip_min_y = std::max(min_pixel.m_y, 0);
+  int clip_max_x = std::min(max_pixel.m_x, threshold_image->getWidth() - 1);
+  int clip_max_y = std::min(max_pixel.m_y, threshold_image->getHeight() - 1);
+  if (clip_max_x < clip_min_x || clip_max_y < clip_min_y) {
+    return;
+  }
 
-    if (act_x >= 0 && act_y >= 0 && act_x < width && act_y < height) {
-      m_neighbour_image->setValue(act_x, act_y, -1);
+  auto chunk = threshold_image->getChunk(clip_min_x, clip_min_y,
+                                         clip_max_x - clip_min_x + 1, clip_max_y - clip_min_y + 1);
+  for (int chunk_y = 0; chunk_y < chunk->getHeight(); ++chunk_y) {
+    char *mask_row = &m_neighbour_mask[(clip_min_x - m_offset.m_x) + (clip_min_y - m_offset.m_y + chunk_y) * m_width];
+    for (int chunk_x = 0; chunk_x < chunk->getWidth(); ++chunk_x) {
+      mask_row[chunk_x] = chunk->getValue(chunk_x, chunk_y) > 0;
     }
   }
 
-  for (int act_y = 0; act_y < height; ++act_y) {
-    for (int act_x = 0; act_x < width; ++act_x) {
-      int offset_x = act_x + m_offset.m_x;
-      int offset_y = act_y + m_offset.m_y;
+  // the pixels of the source itself are not neighbours
+  for (auto& pixel_coord : pixel_list) {
+    auto act_x = pixel_coord.m_x - m_offset.m_x;
+    auto act_y = pixel_coord.m_y - m_offset.m_y;
 
-      // set surrounding pixels that do not belong to the image and are above the threshold to 1, all others to 0
-      if (threshold_image->isInside(offset_x, offset_y)) {
-        bool is_above_threshold = threshold_image->getValue(offset_x, offset_y) > 0;
-        bool belongs = m_neighbour_image->getValue(act_x, act_y) == -1;
-        m_neighbour_image->setValue(act_x, act_y, is_above_threshold && !belongs);
-      }
+    if (act_x >= 0 && act_y >= 0 && act_x < m_width && act_y < m_height) {
+      m_neighbour_mask[act_x + act_y * m_width] = false;
     }
   }
 }
@@ -60,9 +68,8 @@ NeighbourInfo::NeighbourInfo(const PixelCoordinate& min_pixel, const PixelCoordi
 bool NeighbourInfo::isNeighbourObjectPixel(int x, int y) const {
   int act_x = x - m_offset.m_x;
   int act_y = y - m_offset.m_y;
-  assert(act_x >= 0 && act_y >= 0 && act_x < m_neighbour_image->getWidth() &&
-         act_y < m_neighbour_image->getHeight());
-  return m_neighbour_image->getValue(act_x, act_y);
+  assert(act_x >= 0 && act_y >= 0 && act_x < m_width && act_y < m_height);
+  return m_neighbour_mask[act_x + act_y * m_width];
 }
 
 } // end SourceXtractor
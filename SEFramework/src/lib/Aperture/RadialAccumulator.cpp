@@ -0,0 +1,118 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * RadialAccumulator.cpp
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include "SEFramework/Aperture/RadialAccumulator.h"
+
+namespace SourceXtractor {
+
+// same supersampling as CircularAperture
+static const int SUPERSAMPLE_NB = 10;
+
+RadialAccumulator::RadialAccumulator(double step_size, size_t nbins)
+  : m_step_size(step_size), m_radius_squared(nbins), m_histogram(nbins, 0.) {
+  for (size_t i = 0; i < nbins; ++i) {
+    SeFloat radius = step_size * (i + 1);
+    m_radius_squared[i] = radius * radius;
+  }
+}
+
+size_t RadialAccumulator::getBin(SeFloat distance_squared) const {
+  size_t nbins = m_radius_squared.size();
+  // initial guess, corrected for the rounding of the radii
+  size_t bin = std::min(static_cast<size_t>(std::sqrt(distance_squared) / m_step_size), nbins);
+  while (bin > 0 && distance_squared <= m_radius_squared[bin - 1]) {
+    --bin;
+  }
+  while (bin < nbins && distance_squared > m_radius_squared[bin]) {
+    ++bin;
+  }
+  return bin;
+}
+
+void RadialAccumulator::add(const SeFloat *stamp, int x0, int y0, int width, int height,
+                            SeFloat centroid_x, SeFloat centroid_y) {
+  const size_t nbins = m_histogram.size();
+  if (nbins == 0) {
+    return;
+  }
+
+  // sub-pixel offsets, and their bins for the current pixel
+  SeFloat offsets[SUPERSAMPLE_NB];
+  for (int sub = 0; sub < SUPERSAMPLE_NB; ++sub) {
+    offsets[sub] = SeFloat(sub - SUPERSAMPLE_NB / 2) / SUPERSAMPLE_NB;
+  }
+  const double sub_weight = 1.0 / (SUPERSAMPLE_NB * SUPERSAMPLE_NB);
+  const SeFloat max_radius_squared = m_radius_squared.back();
+  // the sub-pixels are within this distance of the pixel center
+  const SeFloat pixel_reach = .75;
+
+  for (int iy = 0; iy < height; ++iy) {
+    const SeFloat *row = stamp + iy * width;
+    SeFloat dy = SeFloat(y0 + iy) - centroid_y;
+
+    for (int ix = 0; ix < width; ++ix) {
+      SeFloat value = row[ix];
+      if (value == 0) {
+        continue;
+      }
+      SeFloat dx = SeFloat(x0 + ix) - centroid_x;
+      SeFloat distance = std::sqrt(dx * dx + dy * dy);
+
+      // entirely outside of the last ring
+      SeFloat inner = distance > pixel_reach ? distance - pixel_reach : 0;
+      if (inner * inner > max_radius_squared) {
+        continue;
+      }
+
+      // entirely within one ring
+      size_t inner_bin = getBin(inner * inner);
+      SeFloat outer = distance + pixel_reach;
+      if (inner_bin < nbins && outer * outer <= m_radius_squared[inner_bin]) {
+        m_histogram[inner_bin] += value;
+        continue;
+      }
+
+      // split between rings
+      double sub_value = value * sub_weight;
+      for (int sub_y = 0; sub_y < SUPERSAMPLE_NB; ++sub_y) {
+        SeFloat dy2 = dy + offsets[sub_y];
+        SeFloat dy2_squared = dy2 * dy2;
+        for (int sub_x = 0; sub_x < SUPERSAMPLE_NB; ++sub_x) {
+          SeFloat dx2 = dx + offsets[sub_x];
+          size_t bin = getBin(dx2 * dx2 + dy2_squared);
+          if (bin < nbins) {
+            m_histogram[bin] += sub_value;
+          }
+        }
+      }
+    }
+  }
+}
+
+std::vector<double> RadialAccumulator::getCumulative() const {
+  std::vector<double> cumulative(m_histogram.size());
+  std::partial_sum(m_histogram.begin(), m_histogram.end(), cumulative.begin());
+  return cumulative;
+}
+
+} // end SourceXtractor
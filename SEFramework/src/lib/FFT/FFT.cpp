@@ -21,6 +21,7 @@
  */
 
 #include <fftw3.h>
+#include <algorithm>
 #include <map>
 #include <boost/thread/shared_mutex.hpp>
 #include "SEFramework/FFT/FFT.h"
@@ -151,6 +152,23 @@ int fftRoundDimension(int size) {
 }
 
 
+int fftSmoothDimension(int size) {
+  static const int factors[] = {2, 3, 5, 7};
+
+  for (int candidate = std::max(size, 1);; ++candidate) {
+    int remainder = candidate;
+    for (int factor : factors) {
+      while (remainder % factor == 0) {
+        remainder /= factor;
+      }
+    }
+    if (remainder == 1) {
+      return candidate;
+    }
+  }
+}
+
+
 template <typename T>
 auto FFT<T>::createForwardPlan(int howmany, int width, int height, std::vector<T> &in, std::vector<complex_t> &out) -> plan_ptr_t {
   // Make sure the buffers are big enough
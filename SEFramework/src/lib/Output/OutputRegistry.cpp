@@ -33,7 +33,7 @@ using namespace Euclid::Table;
 
 namespace SourceXtractor {
 
-auto OutputRegistry::getSourceToRowConverter(const std::vector<std::string>& enabled_properties) -> SourceToRowConverter {
+std::vector<std::type_index> OutputRegistry::getOutputPropertyTypes(const std::vector<std::string>& enabled_properties) {
   std::vector<std::type_index> out_prop_list {};
   for (auto& prop : enabled_properties) {
     if (m_output_properties.count(prop) == 0) {
@@ -46,6 +46,11 @@ auto OutputRegistry::getSourceToRowConverter(const std::vector<std::string>& ena
       }
     }
   }
+  return out_prop_list;
+}
+
+auto OutputRegistry::getSourceToRowConverter(const std::vector<std::string>& enabled_properties) -> SourceToRowConverter {
+  auto out_prop_list = getOutputPropertyTypes(enabled_properties);
   return [this, out_prop_list](const SourceInterface& source) {
     std::vector<ColumnInfo::info_type> info_list {};
     std::vector<Row::cell_type> cell_values {};
@@ -67,6 +72,23 @@ auto OutputRegistry::getSourceToRowConverter(const std::vector<std::string>& ena
   };
 }
 
+std::vector<PropertyId> OutputRegistry::getOutputPropertyIds(const std::vector<std::string>& enabled_properties) {
+  std::vector<PropertyId> property_ids {};
+  for (const auto& property : getOutputPropertyTypes(enabled_properties)) {
+    auto names = m_property_to_names_map.find(property);
+    if (names == m_property_to_names_map.end()) {
+      continue;
+    }
+    for (const auto& name : names->second) {
+      auto property_id = m_name_to_converter_map.at(name).second.getPropertyId();
+      if (std::find(property_ids.begin(), property_ids.end(), property_id) == property_ids.end()) {
+        property_ids.emplace_back(property_id);
+      }
+    }
+  }
+  return property_ids;
+}
+
 void OutputRegistry::printPropertyColumnMap(const std::vector<std::string>& properties) {
   std::set<std::string> properties_set {properties.begin(), properties.end()};
   for (auto& prop : m_output_properties) {
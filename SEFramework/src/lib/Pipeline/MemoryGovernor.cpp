@@ -0,0 +1,113 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * MemoryGovernor.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <algorithm>
+
+#include "SEFramework/Pipeline/MemoryGovernor.h"
+
+namespace SourceXtractor {
+
+// Rough cost of a source whose size is unknown: the property map and a handful of small properties
+static const std::size_t DEFAULT_SOURCE_SIZE = 4096;
+
+MemoryGovernor::MemoryGovernor() : m_limit(0), m_used(0), m_peak(0) {
+}
+
+std::shared_ptr<MemoryGovernor> MemoryGovernor::getInstance() {
+  static std::shared_ptr<MemoryGovernor> instance = std::make_shared<MemoryGovernor>();
+  return instance;
+}
+
+void MemoryGovernor::setLimit(std::size_t limit) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_limit = limit;
+  m_released.notify_all();
+}
+
+std::size_t MemoryGovernor::getLimit() const {
+  return m_limit;
+}
+
+std::size_t MemoryGovernor::getUsed() const {
+  return m_used;
+}
+
+std::size_t MemoryGovernor::getPeak() const {
+  return m_peak;
+}
+
+bool MemoryGovernor::isOverBudget() const {
+  std::size_t limit = m_limit;
+  return limit > 0 && m_used > limit;
+}
+
+void MemoryGovernor::charge(std::size_t bytes) {
+  std::size_t used = (m_used += bytes);
+  std::size_t peak = m_peak;
+  while (peak < used && !m_peak.compare_exchange_weak(peak, used)) {
+  }
+}
+
+void MemoryGovernor::release(std::size_t bytes) {
+  std::size_t used = m_used;
+  while (!m_used.compare_exchange_weak(used, used - std::min(bytes, used))) {
+  }
+
+  // Only a waiter can be interested, and there are none without a limit. The lock makes sure a waiter
+  // is either already waiting, or will see the new usage
+  if (m_limit > 0) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_released.notify_all();
+  }
+}
+
+void MemoryGovernor::waitForBudget(std::function<bool()> can_proceed) {
+  if (m_limit == 0) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_released.wait(lock, [this, &can_proceed]() {
+    return m_limit == 0 || m_used <= m_limit || can_proceed();
+  });
+}
+
+void MemoryGovernor::setSourceSizeEstimator(SourceSizeEstimator estimator) {
+  std::atomic_store(&m_estimator, std::make_shared<const SourceSizeEstimator>(std::move(estimator)));
+}
+
+std::size_t MemoryGovernor::estimate(const SourceInterface& source) const {
+  auto estimator = std::atomic_load(&m_estimator);
+  if (estimator && *estimator) {
+    return (*estimator)(source);
+  }
+  return DEFAULT_SOURCE_SIZE;
+}
+
+std::size_t MemoryGovernor::estimate(const SourceGroupInterface& group) const {
+  std::size_t total = 0;
+  for (auto& source : group) {
+    total += estimate(source);
+  }
+  return total;
+}
+
+} /* namespace SourceXtractor */
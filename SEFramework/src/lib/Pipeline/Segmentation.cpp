@@ -29,9 +29,7 @@ Segmentation::Segmentation(std::shared_ptr<DetectionImageFrame::ImageFilter> ima
 }
 
 void Segmentation::processFrame(std::shared_ptr<DetectionImageFrame> frame) const {
-  if (m_filter_image_processing != nullptr) {
-    frame->setFilter(m_filter_image_processing);
-  }
+  prepareFrame(frame);
 
   if (m_labelling != nullptr) {
     LabellingListener listener(*this, frame);
@@ -43,4 +41,10 @@ void Segmentation::processFrame(std::shared_ptr<DetectionImageFrame> frame) cons
   Observable<ProcessSourcesEvent>::notifyObservers(ProcessSourcesEvent(select_all_criteria));
 }
 
+void Segmentation::prepareFrame(std::shared_ptr<DetectionImageFrame> frame) const {
+  if (m_filter_image_processing != nullptr) {
+    frame->setFilter(m_filter_image_processing);
+  }
+}
+
 }
@@ -21,6 +21,7 @@
  */
 
 #include "SEFramework/Pipeline/SourceGrouping.h"
+#include "SEFramework/Pipeline/MemoryGovernor.h"
 
 
 namespace SourceXtractor {
@@ -31,6 +32,11 @@ SourceGrouping::SourceGrouping(std::shared_ptr<GroupingCriteria> grouping_criter
 }
 
 void SourceGrouping::handleMessage(const std::shared_ptr<SourceInterface>& source) {
+  // The source is kept until its group is processed
+  auto memory_governor = MemoryGovernor::getInstance();
+  auto source_size = memory_governor->estimate(*source);
+  memory_governor->charge(source_size);
+
   // Pointer which points to the group of the source
   std::shared_ptr<SourceGroupInterface> matched_group = nullptr;
   
@@ -52,6 +58,8 @@ void SourceGrouping::handleMessage(const std::shared_ptr<SourceInterface>& sourc
         matched_group->addSource(source);
       } else {
         matched_group->merge(**group_it);
+        m_group_charges[matched_group.get()] += m_group_charges[group_it->get()];
+        m_group_charges.erase(group_it->get());
         groups_to_remove.emplace_back(group_it);
       }
     }
@@ -63,6 +71,7 @@ void SourceGrouping::handleMessage(const std::shared_ptr<SourceInterface>& sourc
     matched_group->addSource(source);
     m_source_groups.emplace_back(matched_group);
   }
+  m_group_charges[matched_group.get()] += source_size;
   
   for (auto& group_it : groups_to_remove) {
     m_source_groups.erase(group_it);
@@ -84,8 +93,13 @@ void SourceGrouping::handleMessage(const ProcessSourcesEvent& process_event) {
   }
 
   // For each SourceGroup that we put in groups_to_process,
+  auto memory_governor = MemoryGovernor::getInstance();
   for (auto& group : groups_to_process) {
-    // we remove it from our list of stored SourceGroups and notify our observers
+    // we remove it from our list of stored SourceGroups and notify our observers,
+    // which take over its memory charge
+    auto charge = m_group_charges.find(group->get());
+    memory_governor->release(charge->second);
+    m_group_charges.erase(charge);
     notifyObservers(*group);
     m_source_groups.erase(group);
   }
@@ -27,10 +27,10 @@
 namespace SourceXtractor {
 
 const Property& PropertyHolder::getProperty(const PropertyId& property_id) const {
-  auto iter = m_properties.find(property_id);
-  if (iter != m_properties.end()) {
+  auto slot = property_id.getSlot();
+  if (slot < m_properties.size() && m_properties[slot]) {
     // Returns the property if it is found
-    return *iter->second;
+    return *m_properties[slot];
   } else {
     // If we don't have that property throws an exception
     throw PropertyNotFoundException(property_id);
@@ -38,11 +38,16 @@ const Property& PropertyHolder::getProperty(const PropertyId& property_id) const
 }
 
 void PropertyHolder::setProperty(std::unique_ptr<Property> property, const PropertyId& property_id) {
-  m_properties[property_id] = std::move(property);
+  auto slot = property_id.getSlot();
+  if (slot >= m_properties.size()) {
+    m_properties.resize(slot + 1);
+  }
+  m_properties[slot] = std::move(property);
 }
 
 bool PropertyHolder::isPropertySet(const PropertyId& property_id) const {
-  return m_properties.find(property_id) != m_properties.end();
+  auto slot = property_id.getSlot();
+  return slot < m_properties.size() && m_properties[slot];
 }
 
 void PropertyHolder::clear() {
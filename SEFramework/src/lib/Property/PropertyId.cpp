@@ -20,10 +20,43 @@
  * @author mschefer
  */
 
+#include <map>
+#include <mutex>
 
 #include "SEFramework/Property/PropertyId.h"
 
 namespace SourceXtractor {
 
+namespace {
+
+struct SlotRegistry {
+  std::mutex m_mutex;
+  std::map<std::pair<std::type_index, unsigned int>, unsigned int> m_slots;
+  std::atomic<unsigned int> m_count{0};
+};
+
+// Constructed on first use, as ids may be created while initializing other static objects
+SlotRegistry& getSlotRegistry() {
+  static SlotRegistry registry;
+  return registry;
+}
 
 }
+
+constexpr unsigned int PropertyId::SlotCache::NO_SLOT;
+
+unsigned int PropertyId::registerSlot(std::type_index type_id, unsigned int index) {
+  auto& registry = getSlotRegistry();
+  std::lock_guard<std::mutex> lock(registry.m_mutex);
+  auto inserted = registry.m_slots.emplace(std::make_pair(type_id, index), registry.m_count.load());
+  if (inserted.second) {
+    ++registry.m_count;
+  }
+  return inserted.first->second;
+}
+
+unsigned int PropertyId::getSlotCount() {
+  return getSlotRegistry().m_count;
+}
+
+} // SEFramework namespace
@@ -0,0 +1,199 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * ExecutionPlan.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "ElementsKernel/Exception.h"
+
+#include "SEFramework/Task/ExecutionPlan.h"
+
+namespace SourceXtractor {
+
+namespace {
+
+struct Node {
+  PropertyId m_property_id;
+  std::shared_ptr<const Task> m_task;
+  std::vector<std::size_t> m_dependencies;
+  bool m_visiting;
+};
+
+}
+
+// The tasks of a stage share the source, so its properties are read and written one at a time.
+// A task only reads its declared dependencies, which the previous stages have already set, so nothing is
+// computed while holding the lock. Reading any other property would compute it on demand, racing with the
+// task of the stage computing it, so it is rejected instead
+class ExecutionPlan::StepSource : public SourceInterface {
+public:
+  StepSource(SourceInterface& source, std::mutex& mutex, const Step& step)
+    : m_source(source), m_mutex(mutex), m_step(step) {}
+
+  const Property& getProperty(const PropertyId& property_id) const override {
+    if (m_step.m_dependencies.count(property_id) == 0) {
+      throw Elements::Exception() << "The task computing " << m_step.m_property_id.getString() << " reads "
+                                  << property_id.getString() << " without declaring it";
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_source.getProperty(property_id);
+  }
+
+  void setProperty(std::unique_ptr<Property> property, const PropertyId& property_id) override {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_source.setProperty(std::move(property), property_id);
+  }
+
+private:
+  SourceInterface& m_source;
+  std::mutex& m_mutex;
+  const Step& m_step;
+};
+
+void ExecutionPlan::serialFor(std::size_t n, const std::function<void(std::size_t)>& body) {
+  for (std::size_t i = 0; i < n; ++i) {
+    body(i);
+  }
+}
+
+ExecutionPlan::ExecutionPlan(const TaskProvider& task_provider, const std::vector<PropertyId>& properties) {
+  // Depth first traversal of the declared dependencies. A task that computes several properties is a single node
+  std::vector<Node> nodes;
+  std::vector<std::size_t> order;
+  std::unordered_map<const Task*, std::size_t> node_index;
+
+  std::function<int(const PropertyId&)> visit = [&](const PropertyId& property_id) -> int {
+    std::shared_ptr<const Task> task;
+    try {
+      task = task_provider.getTask<Task>(property_id);
+    } catch (const std::out_of_range&) {
+      // No factory for the property, so it is set when the source is created
+    }
+    if (!task) {
+      return -1;
+    }
+
+    auto found = node_index.find(task.get());
+    if (found != node_index.end()) {
+      if (nodes[found->second].m_visiting) {
+        throw Elements::Exception() << "Cyclic dependency between the tasks computing " << property_id.getString();
+      }
+      return found->second;
+    }
+
+    auto index = nodes.size();
+    node_index.emplace(task.get(), index);
+    nodes.emplace_back(Node{property_id, task, {}, true});
+    if (task->declaresDependencies() && std::dynamic_pointer_cast<const SourceTask>(task)) {
+      for (auto& dependency : task->getDependencies()) {
+        auto dependency_index = visit(dependency);
+        if (dependency_index >= 0) {
+          nodes[index].m_dependencies.push_back(dependency_index);
+        }
+      }
+    }
+    nodes[index].m_visiting = false;
+    order.push_back(index);
+    return index;
+  };
+
+  for (auto& property_id : properties) {
+    visit(property_id);
+  }
+
+  // Each task goes after the tasks it depends on. A declared task joins the first concurrent stage
+  // where its dependencies are ready, any other gets a stage of its own
+  std::vector<std::size_t> node_stage(nodes.size());
+  for (auto index : order) {
+    auto& node = nodes[index];
+    auto source_task = std::dynamic_pointer_cast<const SourceTask>(node.m_task);
+    bool concurrent = source_task && node.m_task->declaresDependencies();
+
+    auto stage = m_stages.size();
+    if (concurrent) {
+      stage = 0;
+      for (auto dependency : node.m_dependencies) {
+        stage = std::max(stage, node_stage[dependency] + 1);
+      }
+      while (stage < m_stages.size() && !m_stages[stage].m_concurrent) {
+        ++stage;
+      }
+    }
+    if (stage == m_stages.size()) {
+      m_stages.emplace_back(Stage{concurrent, {}});
+    }
+    std::unordered_set<PropertyId> dependencies;
+    if (concurrent) {
+      auto declared = node.m_task->getDependencies();
+      dependencies.insert(declared.begin(), declared.end());
+    }
+    m_stages[stage].m_steps.emplace_back(Step{node.m_property_id, source_task, std::move(dependencies)});
+    node_stage[index] = stage;
+  }
+}
+
+void ExecutionPlan::execute(SourceInterface& source, const ParallelFor& parallel_for) const {
+  for (auto& stage : m_stages) {
+    if (!stage.m_concurrent || stage.m_steps.size() == 1) {
+      for (auto& step : stage.m_steps) {
+        source.getProperty(step.m_property_id);
+      }
+    }
+    else {
+      // The tasks of the stage are run directly, since the on demand path checks and sets the property
+      // without the lock. The tasks reading these properties run in later stages, so they are normally
+      // not set yet. If a task with undeclared dependencies asked for one earlier, it is computed again
+      auto& task_source = source.getTaskSource();
+      std::mutex mutex;
+      parallel_for(stage.m_steps.size(), [&task_source, &mutex, &stage](std::size_t i) {
+        StepSource step_source(task_source, mutex, stage.m_steps[i]);
+        stage.m_steps[i].m_task->computeProperties(step_source);
+      });
+    }
+  }
+}
+
+std::vector<std::vector<PropertyId>> ExecutionPlan::getStages() const {
+  std::vector<std::vector<PropertyId>> stages;
+  for (auto& stage : m_stages) {
+    stages.emplace_back();
+    for (auto& step : stage.m_steps) {
+      stages.back().push_back(step.m_property_id);
+    }
+  }
+  return stages;
+}
+
+std::size_t ExecutionPlan::getMaxConcurrency() const {
+  std::size_t concurrency = 1;
+  for (auto& stage : m_stages) {
+    if (stage.m_concurrent) {
+      concurrency = std::max(concurrency, stage.m_steps.size());
+    }
+  }
+  return concurrency;
+}
+
+} // end of namespace SourceXtractor
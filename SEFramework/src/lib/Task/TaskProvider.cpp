@@ -30,7 +30,33 @@ namespace {
   std::mutex task_provider_mutex;
 }
 
+constexpr std::size_t TaskProvider::RESOLVED_CHUNK_SIZE;
+constexpr std::size_t TaskProvider::MAX_RESOLVED_CHUNKS;
+
+TaskProvider::TaskProvider(std::shared_ptr<TaskFactoryRegistry> task_factory_registry)
+  : m_task_factory_registry(task_factory_registry) {
+  for (auto& chunk : m_resolved) {
+    chunk.store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+const std::shared_ptr<Task>* TaskProvider::findResolved(unsigned int slot) const {
+  auto chunk_index = slot / RESOLVED_CHUNK_SIZE;
+  if (chunk_index >= MAX_RESOLVED_CHUNKS) {
+    return nullptr;
+  }
+  auto chunk = m_resolved[chunk_index].load(std::memory_order_acquire);
+  if (!chunk) {
+    return nullptr;
+  }
+  return (*chunk)[slot % RESOLVED_CHUNK_SIZE].load(std::memory_order_acquire);
+}
+
 std::shared_ptr<const Task> TaskProvider::getTask(const PropertyId& property_id) const {
+  if (auto resolved = findResolved(property_id.getSlot())) {
+    return *resolved;
+  }
+
   std::lock_guard<std::mutex> lock(task_provider_mutex);
 
   // tries to find the Task for the property
@@ -43,8 +69,25 @@ std::shared_ptr<const Task> TaskProvider::getTask(const PropertyId& property_id)
     auto& task_factory = m_task_factory_registry->getFactory(property_id.getTypeId());
     auto task = task_factory.createTask(property_id);
 
-    // Put it in the cache
-    const_cast<TaskProvider&>(*this).m_tasks[property_id] = task;
+    // Put it in the cache, and publish it. The nodes of the map never move, so the table can point to them
+    auto& self = const_cast<TaskProvider&>(*this);
+    auto& entry = self.m_tasks[property_id];
+    entry = task;
+
+    auto slot = property_id.getSlot();
+    auto chunk_index = slot / RESOLVED_CHUNK_SIZE;
+    if (chunk_index < MAX_RESOLVED_CHUNKS) {
+      auto chunk = self.m_resolved[chunk_index].load(std::memory_order_relaxed);
+      if (!chunk) {
+        self.m_resolved_chunks.emplace_back(new ResolvedChunk);
+        chunk = self.m_resolved_chunks.back().get();
+        for (auto& resolved : *chunk) {
+          resolved.store(nullptr, std::memory_order_relaxed);
+        }
+        self.m_resolved[chunk_index].store(chunk, std::memory_order_release);
+      }
+      (*chunk)[slot % RESOLVED_CHUNK_SIZE].store(&entry, std::memory_order_release);
+    }
 
     return task;
   } else {
@@ -0,0 +1,124 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <map>
+
+#include "SEFramework/Aperture/EllipticalAperture.h"
+#include "SEFramework/Aperture/EllipticalScan.h"
+#include "SEFramework/Aperture/FluxMeasurement.h"
+#include "SEFramework/Aperture/TransformedAperture.h"
+#include "SEFramework/Image/VectorImage.h"
+
+using namespace SourceXtractor;
+
+typedef std::map<std::pair<int, int>, SeFloat> PixelMap;
+
+static PixelMap scanAperture(const Aperture& aperture, SeFloat centroid_x, SeFloat centroid_y) {
+  PixelMap pixels;
+  auto min_pixel = aperture.getMinPixel(centroid_x, centroid_y);
+  auto max_pixel = aperture.getMaxPixel(centroid_x, centroid_y);
+  for (int y = min_pixel.m_y; y <= max_pixel.m_y; ++y) {
+    for (int x = min_pixel.m_x; x <= max_pixel.m_x; ++x) {
+      if (aperture.getArea(centroid_x, centroid_y, x, y) > 0) {
+        pixels[std::make_pair(x, y)] = aperture.getRadiusSquared(centroid_x, centroid_y, x, y);
+      }
+    }
+  }
+  return pixels;
+}
+
+static PixelMap scanEllipse(const EllipticalScan& ellipse) {
+  PixelMap pixels;
+  ellipse.scan([&pixels](int x, int y, SeFloat radius_squared) {
+    pixels[std::make_pair(x, y)] = radius_squared;
+  });
+  return pixels;
+}
+
+BOOST_AUTO_TEST_SUITE (EllipticalScan_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( SameAsAperture_test ) {
+  const SeFloat cxx = 0.12, cyy = 0.3, cxy = -0.15;
+
+  for (SeFloat radius : {1.f, 3.5f, 6.f, 12.3f}) {
+    EllipticalAperture aperture(cxx, cyy, cxy, radius);
+    EllipticalScan ellipse(cxx, cyy, cxy, radius, 40.3, 37.8);
+
+    BOOST_CHECK_EQUAL(aperture.getMinPixel(40.3, 37.8).m_x, ellipse.getMinPixel().m_x);
+    BOOST_CHECK_EQUAL(aperture.getMaxPixel(40.3, 37.8).m_y, ellipse.getMaxPixel().m_y);
+
+    auto expected = scanAperture(aperture, 40.3, 37.8);
+    auto scanned = scanEllipse(ellipse);
+    BOOST_CHECK(!expected.empty());
+    BOOST_CHECK(expected == scanned);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( Transformed_test ) {
+  auto jacobian = std::make_tuple(1.7, 0.2, -0.3, 1.2);
+  TransformedAperture aperture(std::make_shared<EllipticalAperture>(0.2, 0.1, 0.05, 5.), jacobian);
+  auto ellipse = EllipticalScan::transformed(0.2, 0.1, 0.05, 5., 20.5, 21.2, jacobian);
+
+  auto expected = scanAperture(aperture, 20.5, 21.2);
+  auto scanned = scanEllipse(ellipse);
+
+  // Only pixels right on the edge may differ
+  BOOST_CHECK_GT(expected.size(), 50);
+  BOOST_CHECK_LE(std::abs(int(expected.size()) - int(scanned.size())), 2);
+  for (auto& pixel : scanned) {
+    auto i = expected.find(pixel.first);
+    if (i != expected.end()) {
+      BOOST_CHECK_CLOSE(i->second, pixel.second, 1e-3);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( MeasureFlux_test ) {
+  auto image = VectorImage<SeFloat>::create(20, 20);
+  auto variance = VectorImage<SeFloat>::create(20, 20);
+  for (int y = 0; y < 20; ++y) {
+    for (int x = 0; x < 20; ++x) {
+      image->setValue(x, y, x + 2 * y);
+      variance->setValue(x, y, (x == 5 && y == 15) ? 10. : 0.5);
+    }
+  }
+
+  // Crosses the border of the image, and has one bad pixel
+  auto aperture = std::make_shared<EllipticalAperture>(0.1, 0.08, 0.02, 3.);
+  EllipticalScan ellipse(0.1, 0.08, 0.02, 3., 4., 16.);
+
+  auto expected = measureFlux(aperture, 4., 16., image, variance, 1., true);
+  auto measured = measureFlux(ellipse, image, variance, 1., true);
+
+  BOOST_CHECK_EQUAL(expected.m_flux, measured.m_flux);
+  BOOST_CHECK_EQUAL(expected.m_variance, measured.m_variance);
+  BOOST_CHECK_EQUAL(expected.m_total_area, measured.m_total_area);
+  BOOST_CHECK_EQUAL(expected.m_bad_area, measured.m_bad_area);
+  BOOST_CHECK(expected.m_flags == measured.m_flags);
+  BOOST_CHECK((measured.m_flags & Flags::BOUNDARY) == Flags::BOUNDARY);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,79 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <numeric>
+#include <random>
+
+#include "SEFramework/Aperture/CircularAperture.h"
+#include "SEFramework/Aperture/RadialAccumulator.h"
+
+using namespace SourceXtractor;
+
+BOOST_AUTO_TEST_SUITE (RadialAccumulator_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( SameAsApertures_test ) {
+  const int width = 31, height = 27;
+  const SeFloat centroid_x = 15.3, centroid_y = 12.8;
+  const size_t nbins = 20;
+  const double step_size = 0.6;
+
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<SeFloat> dist(-1, 10);
+  std::vector<SeFloat> stamp(width * height);
+  for (auto& v : stamp) {
+    v = dist(gen);
+  }
+
+  RadialAccumulator accumulator(step_size, nbins);
+  accumulator.add(stamp.data(), 0, 0, width, height, centroid_x, centroid_y);
+  auto cumulative = accumulator.getCumulative();
+  BOOST_REQUIRE_EQUAL(cumulative.size(), nbins);
+
+  for (size_t i = 0; i < nbins; ++i) {
+    CircularAperture aperture(step_size * (i + 1));
+    double expected = 0;
+    for (int y = 0; y < height; ++y) {
+      for (int x = 0; x < width; ++x) {
+        expected += aperture.getArea(centroid_x, centroid_y, x, y) * stamp[x + y * width];
+      }
+    }
+    BOOST_CHECK_CLOSE(expected, cumulative[i], 1e-3);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( Outside_test ) {
+  std::vector<SeFloat> stamp(25, 1.);
+
+  RadialAccumulator accumulator(0.5, 4);
+  accumulator.add(stamp.data(), 0, 0, 5, 5, 2, 2);
+  auto& histogram = accumulator.getHistogram();
+
+  // The central pixel is split between the first two rings
+  BOOST_CHECK_GT(histogram[0], 0.);
+  // Flux beyond a radius of 2 is not counted
+  BOOST_CHECK_LT(std::accumulate(histogram.begin(), histogram.end(), 0.), 25.);
+  BOOST_CHECK_GT(accumulator.getCumulative().back(), 9.);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
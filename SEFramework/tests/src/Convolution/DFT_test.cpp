@@ -101,4 +101,46 @@ BOOST_FIXTURE_TEST_CASE ( Convolve_not_squared_test, DFT_Fixture ) {
   }
 }
 
+BOOST_FIXTURE_TEST_CASE ( Convolve_batch_test, DFT_Fixture ) {
+  std::vector<std::shared_ptr<VectorImage<SeFloat>>> batch{
+    VectorImage<SeFloat>::create(5, 3, std::vector<SeFloat>{
+      0.0, 0.5, 0.0, 0.0, 0.0,
+      0.0, 0.0, 1.0, 0.0, 0.0,
+      0.0, 0.0, 0.0, 0.0, 0.0,
+    }),
+    VectorImage<SeFloat>::create(4, 4, std::vector<SeFloat>{
+      1.0, 0.0, 0.0, 0.0,
+      0.0, 2.0, 0.0, 0.0,
+      0.0, 0.0, 0.0, 1.0,
+      0.0, 0.0, 0.0, 0.0,
+    }),
+  };
+
+  // Convolve copies one at a time as a reference
+  std::vector<std::shared_ptr<VectorImage<SeFloat>>> expected;
+  for (auto& img : batch) {
+    expected.emplace_back(VectorImage<SeFloat>::create(*img));
+    dft.convolve(expected.back());
+  }
+
+  auto context = dft.prepareBatch(batch.size(), 5, 4);
+  BOOST_CHECK(context->fits(2, 5, 4));
+  BOOST_CHECK(!context->fits(3, 5, 4));
+  BOOST_CHECK(!context->fits(2, 6, 4));
+
+  dft.convolveBatch(batch, context);
+
+  for (size_t i = 0; i < batch.size(); ++i) {
+    for (auto x = 0; x < expected[i]->getWidth(); ++x) {
+      for (auto y = 0; y < expected[i]->getHeight(); ++y) {
+        auto ev = expected[i]->getValue(x, y);
+        auto iv = batch[i]->getValue(x, y);
+        if (!isClose(ev, iv, 1e-5, 1e-4)) {
+          BOOST_ERROR("Mismatch for " << i << " at " << x << 'x' << y << ": " << ev << " != " << iv);
+        }
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,134 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * @file SeparableConvolution_test.cpp
+ * @date 19/10/26
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <random>
+#include "SEFramework/Convolution/DirectConvolution.h"
+#include "SEFramework/Convolution/SeparableConvolution.h"
+#include "SEFramework/Convolution/ConvolutionStrategy.h"
+#include "SEUtils/IsClose.h"
+
+using namespace SourceXtractor;
+
+static std::shared_ptr<VectorImage<SeFloat>> generateImage(int width, int height) {
+  std::default_random_engine random_generator;
+  std::uniform_real_distribution<SeFloat> random_dist{0, 1};
+
+  auto img = VectorImage<SeFloat>::create(width, height);
+  for (auto& v : img->getData()) {
+    v = random_dist(random_generator);
+  }
+  return img;
+}
+
+static std::shared_ptr<VectorImage<SeFloat>> generateGaussian(int size, double sigma) {
+  auto img = VectorImage<SeFloat>::create(size, size);
+  int c = size / 2;
+  for (int y = 0; y < size; ++y) {
+    for (int x = 0; x < size; ++x) {
+      img->setValue(x, y, std::exp(-((x - c) * (x - c) + (y - c) * (y - c)) / (2 * sigma * sigma)));
+    }
+  }
+  return img;
+}
+
+static void checkSame(const VectorImage<SeFloat>& expected, const VectorImage<SeFloat>& image) {
+  for (auto x = 0; x < expected.getWidth(); ++x) {
+    for (auto y = 0; y < expected.getHeight(); ++y) {
+      auto ev = expected.getValue(x, y);
+      auto iv = image.getValue(x, y);
+      if (!isClose(ev, iv, 1e-4, 1e-5)) {
+        BOOST_ERROR("Mismatch at " << x << 'x' << y << ": " << ev << " != " << iv);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE (SeparableConvolution_test)
+
+BOOST_AUTO_TEST_CASE ( Decompose_gaussian_test ) {
+  auto kernel = generateGaussian(7, 1.5);
+  auto separable = decomposeKernel(*kernel);
+  BOOST_CHECK_EQUAL(separable.getRank(), 1);
+
+  for (int y = 0; y < 7; ++y) {
+    for (int x = 0; x < 7; ++x) {
+      SeFloat v = separable.m_columns[0][y] * separable.m_rows[0][x];
+      BOOST_CHECK_SMALL(v - kernel->getValue(x, y), 1e-5f);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE ( Decompose_full_rank_test ) {
+  auto kernel = generateImage(5, 3);
+  auto separable = decomposeKernel(*kernel, 0);
+  BOOST_CHECK_EQUAL(separable.getRank(), 3);
+
+  for (int y = 0; y < 3; ++y) {
+    for (int x = 0; x < 5; ++x) {
+      SeFloat v = 0;
+      for (int i = 0; i < separable.getRank(); ++i) {
+        v += separable.m_columns[i][y] * separable.m_rows[i][x];
+      }
+      BOOST_CHECK_SMALL(v - kernel->getValue(x, y), 1e-5f);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE ( Convolve_gaussian_test ) {
+  auto kernel = generateGaussian(9, 2.);
+  DirectConvolution<SeFloat> direct(kernel);
+  SeparableConvolution<SeFloat> separable(kernel);
+  BOOST_CHECK_EQUAL(separable.getRank(), 1);
+
+  auto image = generateImage(64, 48);
+  auto expected = VectorImage<SeFloat>::create(*image);
+  direct.convolve(expected);
+  separable.convolve(image);
+
+  checkSame(*expected, *image);
+}
+
+BOOST_AUTO_TEST_CASE ( Convolve_full_rank_test ) {
+  auto kernel = generateImage(5, 5);
+  DirectConvolution<SeFloat> direct(kernel);
+  SeparableConvolution<SeFloat> separable(kernel, 0);
+
+  auto image = generateImage(32, 40);
+  auto expected = VectorImage<SeFloat>::create(*image);
+  direct.convolve(expected);
+  separable.convolve(image);
+
+  checkSame(*expected, *image);
+}
+
+BOOST_AUTO_TEST_CASE ( Strategy_test ) {
+  // Small separable kernels are better applied with 1D passes
+  BOOST_CHECK(chooseConvolutionStrategy(5, 5, 1, 256, 256) == ConvolutionStrategy::SEPARABLE);
+  // Small, full rank, kernels are better applied directly
+  BOOST_CHECK(chooseConvolutionStrategy(3, 3, 3, 256, 256) == ConvolutionStrategy::DIRECT);
+  // Big, full rank, kernels are better applied on Fourier space
+  BOOST_CHECK(chooseConvolutionStrategy(15, 15, 15, 256, 256) == ConvolutionStrategy::DFT);
+  // A zero kernel has rank 0, and must not look free to apply with 1D passes
+  BOOST_CHECK(chooseConvolutionStrategy(5, 5, 0, 256, 256) == ConvolutionStrategy::DIRECT);
+}
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,93 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+
+#include "SEFramework/CoordinateSystem/LocalAffineMapping.h"
+
+using namespace SourceXtractor;
+
+// Rotation, scale and shift, optionally with a quadratic distortion
+class TestCoordinateSystem : public CoordinateSystem {
+public:
+  TestCoordinateSystem(double angle, double scale, double shift, double distortion = 0.)
+    : m_cos(std::cos(angle) * scale), m_sin(std::sin(angle) * scale), m_shift(shift), m_distortion(distortion) {}
+
+  WorldCoordinate imageToWorld(ImageCoordinate c) const override {
+    double x = c.m_x + m_distortion * c.m_x * c.m_x;
+    return WorldCoordinate(m_cos * x - m_sin * c.m_y + m_shift, m_sin * x + m_cos * c.m_y + m_shift);
+  }
+
+  ImageCoordinate worldToImage(WorldCoordinate w) const override {
+    double a = w.m_alpha - m_shift, d = w.m_delta - m_shift;
+    double det = m_cos * m_cos + m_sin * m_sin;
+    double x = (m_cos * a + m_sin * d) / det;
+    double y = (-m_sin * a + m_cos * d) / det;
+    if (m_distortion != 0.) {
+      x = (-1 + std::sqrt(1 + 4 * m_distortion * x)) / (2 * m_distortion);
+    }
+    return ImageCoordinate(x, y);
+  }
+
+private:
+  double m_cos, m_sin, m_shift, m_distortion;
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (LocalAffineMapping_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( linear_test ) {
+  TestCoordinateSystem from(0.3, 1., 10.), to(-0.2, 0.5, -4.);
+  LocalAffineMapping affine(from, to, ImageCoordinate(120, 80), 32, 16);
+
+  BOOST_CHECK_SMALL(affine.getMaxError(), 1e-8);
+  for (double y = 64; y <= 96; y += 3) {
+    for (double x = 88; x <= 152; x += 5) {
+      auto expected = to.worldToImage(from.imageToWorld(ImageCoordinate(x, y)));
+      auto mapped = affine(x, y);
+      BOOST_CHECK_SMALL(mapped.m_x - expected.m_x, 1e-8);
+      BOOST_CHECK_SMALL(mapped.m_y - expected.m_y, 1e-8);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( distortion_test ) {
+  TestCoordinateSystem from(0.1, 1., 0., 1e-3), to(0.1, 1., 0.);
+  LocalAffineMapping affine(from, to, ImageCoordinate(100, 100), 32, 32);
+
+  // Central differences are exact for a quadratic, so the largest error is at the edges
+  double max_error = 0.;
+  for (double y = 68; y <= 132; y += 4) {
+    for (double x = 68; x <= 132; x += 4) {
+      auto expected = to.worldToImage(from.imageToWorld(ImageCoordinate(x, y)));
+      auto mapped = affine(x, y);
+      max_error = std::max(max_error, std::max(std::abs(mapped.m_x - expected.m_x), std::abs(mapped.m_y - expected.m_y)));
+    }
+  }
+  BOOST_CHECK_GT(affine.getMaxError(), 0.5);
+  BOOST_CHECK_CLOSE(affine.getMaxError(), max_error, 1e-6);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -84,5 +84,16 @@ BOOST_AUTO_TEST_CASE (FFT_float_symmetric_double_test) {
 
 //-----------------------------------------------------------------------------
 
+BOOST_AUTO_TEST_CASE (FFT_smooth_dimension_test) {
+  BOOST_CHECK_EQUAL(fftSmoothDimension(1), 1);
+  BOOST_CHECK_EQUAL(fftSmoothDimension(7), 7);
+  BOOST_CHECK_EQUAL(fftSmoothDimension(11), 12);
+  BOOST_CHECK_EQUAL(fftSmoothDimension(13), 14);
+  BOOST_CHECK_EQUAL(fftSmoothDimension(97), 98);
+  BOOST_CHECK_EQUAL(fftSmoothDimension(1025), 1029);
+}
+
+//-----------------------------------------------------------------------------
+
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -23,6 +23,7 @@
 
 #include <boost/test/unit_test.hpp>
 #include "SEFramework/Image/BufferedImage.h"
+#include "SEFramework/Image/WriteableBufferedImage.h"
 #include "SEUtils/TestUtils.h"
 
 using namespace SourceXtractor;
@@ -65,6 +66,49 @@ public:
   }
 };
 
+template<typename T>
+class WriteableImageSourceMock : public ImageSource<T>, public std::enable_shared_from_this<WriteableImageSourceMock<T>> {
+private:
+  std::shared_ptr<VectorImage<T>> m_img;
+
+public:
+  WriteableImageSourceMock(const std::shared_ptr<VectorImage<T>> &img) : m_img(img) {}
+
+  virtual ~WriteableImageSourceMock() = default;
+
+  std::string getRepr() const override {
+    return "WriteableImageSourceMock(" + m_img->getRepr() + ")";
+  }
+
+  void saveTile(ImageTile<T> &tile) override {
+    auto& tile_image = *tile.getImage();
+    for (int iy = 0; iy < tile_image.getHeight(); ++iy) {
+      for (int ix = 0; ix < tile_image.getWidth(); ++ix) {
+        m_img->setValue(tile.getPosX() + ix, tile.getPosY() + iy, tile_image.getValue(ix, iy));
+      }
+    }
+  }
+
+  int getWidth() const override {
+    return m_img->getWidth();
+  }
+
+  int getHeight() const override {
+    return m_img->getHeight();
+  }
+
+  std::shared_ptr<ImageTile<T>> getImageTile(int x, int y, int width, int height) const override {
+    auto self = std::const_pointer_cast<WriteableImageSourceMock<T>>(this->shared_from_this());
+    auto tile = std::make_shared<ImageTile<T>>(self, x, y, width, height);
+    for (int iy = y; iy < y + height; ++iy) {
+      for (int ix = x; ix < x + width; ++ix) {
+        tile->setValue(ix, iy, m_img->getValue(ix, iy));
+      }
+    }
+    return tile;
+  }
+};
+
 struct BufferedImageFixture {
   std::shared_ptr<ImageSource<SeFloat>> m_img_source;
 
@@ -224,5 +268,26 @@ BOOST_FIXTURE_TEST_CASE(ChunkCrossMultipleXY_test, BufferedImageFixture) {
 
 //-----------------------------------------------------------------------------
 
+/**
+ * Fill and add to rows that cross multiple tiles
+ */
+BOOST_FIXTURE_TEST_CASE(WriteRowCrossMultipleX_test, BufferedImageFixture) {
+  auto image = WriteableBufferedImage<SeFloat>::create(
+    std::make_shared<WriteableImageSourceMock<SeFloat>>(VectorImage<SeFloat>::create(8, 2)));
+
+  image->fillRow(1, 0, 6, 2);
+  std::vector<SeFloat> values{1, 2, 3, 4, 5, 6, 7};
+  image->addToRow(1, 1, 7, values.data());
+  image->addToRow(3, 0, 2, values.data());
+
+  auto chunk = image->getChunk(0, 0, 8, 2);
+  BOOST_CHECK(compareImages(
+    VectorImage<SeFloat>::create(8, 2,
+                                 std::vector<SeFloat>{0, 2, 2, 3, 4, 2, 2, 0,
+                                                      0, 1, 2, 3, 4, 5, 6, 7}), chunk));
+}
+
+//-----------------------------------------------------------------------------
+
 BOOST_AUTO_TEST_SUITE_END ()
 
@@ -0,0 +1,160 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * MemoryGovernor_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "SEFramework/Property/Property.h"
+#include "SEFramework/Source/SimpleSource.h"
+#include "SEFramework/Source/SimpleSourceGroup.h"
+#include "SEFramework/Pipeline/MemoryGovernor.h"
+
+using namespace SourceXtractor;
+
+struct SizeProperty : public Property {
+  std::size_t m_size;
+  SizeProperty(std::size_t size) : m_size(size) {}
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (MemoryGovernor_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (charge_release_test) {
+  MemoryGovernor governor;
+  governor.setLimit(100);
+
+  governor.charge(60);
+  BOOST_CHECK(!governor.isOverBudget());
+  governor.charge(60);
+  BOOST_CHECK(governor.isOverBudget());
+  BOOST_CHECK_EQUAL(governor.getUsed(), 120);
+
+  governor.release(60);
+  BOOST_CHECK(!governor.isOverBudget());
+  BOOST_CHECK_EQUAL(governor.getUsed(), 60);
+  BOOST_CHECK_EQUAL(governor.getPeak(), 120);
+
+  // Releasing more than charged does not wrap around
+  governor.release(1000);
+  BOOST_CHECK_EQUAL(governor.getUsed(), 0);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (unlimited_test) {
+  MemoryGovernor governor;
+  governor.charge(1000000);
+  BOOST_CHECK(!governor.isOverBudget());
+  governor.waitForBudget([]() { return false; });
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (wait_for_release_test) {
+  MemoryGovernor governor;
+  governor.setLimit(100);
+  governor.charge(200);
+
+  std::atomic_bool released(false);
+  std::thread releaser([&governor, &released]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    released = true;
+    governor.release(150);
+  });
+
+  governor.waitForBudget([]() { return false; });
+  BOOST_CHECK(released);
+  BOOST_CHECK_EQUAL(governor.getUsed(), 50);
+  releaser.join();
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (nothing_pending_test) {
+  MemoryGovernor governor;
+  governor.setLimit(100);
+  governor.charge(200);
+
+  // Over budget, but the caller has nothing that could be released
+  governor.waitForBudget([]() { return true; });
+  BOOST_CHECK(governor.isOverBudget());
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (concurrent_test) {
+  MemoryGovernor governor;
+  governor.setLimit(100);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&governor]() {
+      for (int i = 0; i < 10000; ++i) {
+        governor.charge(10);
+        governor.waitForBudget([]() { return true; });
+        governor.release(10);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  BOOST_CHECK_EQUAL(governor.getUsed(), 0);
+  BOOST_CHECK_GE(governor.getPeak(), 10);
+  BOOST_CHECK_LE(governor.getPeak(), 40);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (estimate_test) {
+  MemoryGovernor governor;
+
+  auto group = std::make_shared<SimpleSourceGroup>();
+  auto source_a = std::make_shared<SimpleSource>();
+  auto source_b = std::make_shared<SimpleSource>();
+  source_a->setProperty<SizeProperty>(10);
+  source_b->setProperty<SizeProperty>(32);
+  group->addSource(source_a);
+  group->addSource(source_b);
+
+  // Some fixed cost per source by default
+  BOOST_CHECK_GT(governor.estimate(*source_a), 0);
+  BOOST_CHECK_EQUAL(governor.estimate(*group), 2 * governor.estimate(*source_a));
+
+  governor.setSourceSizeEstimator([](const SourceInterface& source) {
+    return source.getProperty<SizeProperty>().m_size;
+  });
+  BOOST_CHECK_EQUAL(governor.estimate(*source_a), 10);
+  BOOST_CHECK_EQUAL(governor.estimate(*group), 42);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -27,6 +27,7 @@
 #include "SEFramework/Source/SimpleSourceGroupFactory.h"
 
 #include "SEFramework/Pipeline/SourceGrouping.h"
+#include "SEFramework/Pipeline/MemoryGovernor.h"
 
 #include <memory>
 #include <utility>
@@ -159,6 +160,28 @@ BOOST_FIXTURE_TEST_CASE( process_sources_test, SourceGroupingFixture ) {
 
 //-----------------------------------------------------------------------------
 
+BOOST_FIXTURE_TEST_CASE( memory_charge_test, SourceGroupingFixture ) {
+  source_a->setProperty<SimpleIntProperty>(1);
+  source_b->setProperty<SimpleIntProperty>(2);
+
+  auto memory_governor = MemoryGovernor::getInstance();
+  auto used_before = memory_governor->getUsed();
+
+  source_grouping->handleMessage(source_a);
+  source_grouping->handleMessage(source_b);
+  BOOST_CHECK_EQUAL(memory_governor->getUsed(),
+                    used_before + memory_governor->estimate(*source_a) + memory_governor->estimate(*source_b));
+
+  // Once processed, the groups are not held anymore by the grouping. What was charged is released,
+  // even if the estimate changed in the meantime
+  memory_governor->setSourceSizeEstimator([](const SourceInterface&) { return 1; });
+  source_grouping->handleMessage(ProcessSourcesEvent { select_all_criteria } );
+  BOOST_CHECK_EQUAL(memory_governor->getUsed(), used_before);
+  memory_governor->setSourceSizeEstimator(nullptr);
+}
+
+//-----------------------------------------------------------------------------
+
 BOOST_AUTO_TEST_SUITE_END ()
 
 
@@ -56,6 +56,28 @@ BOOST_AUTO_TEST_CASE( example_test ) {
 
 //-----------------------------------------------------------------------------
 
+BOOST_AUTO_TEST_CASE( slot_test ) {
+  auto a0 = PropertyId::create<ExamplePropertyA>();
+  auto a1 = PropertyId::create<ExamplePropertyA>(1);
+  auto a100 = PropertyId::create<ExamplePropertyA>(100);
+  auto b0 = PropertyId::create<ExamplePropertyB>();
+
+  // Distinct identifiers get distinct slots, also above the cached indexes
+  BOOST_CHECK_NE(a0.getSlot(), a1.getSlot());
+  BOOST_CHECK_NE(a0.getSlot(), a100.getSlot());
+  BOOST_CHECK_NE(a0.getSlot(), b0.getSlot());
+  BOOST_CHECK_NE(a1.getSlot(), b0.getSlot());
+
+  // The same identifier always gets the same slot
+  BOOST_CHECK_EQUAL(PropertyId::create<ExamplePropertyA>(1).getSlot(), a1.getSlot());
+  BOOST_CHECK_EQUAL(PropertyId::create<ExamplePropertyA>(100).getSlot(), a100.getSlot());
+  BOOST_CHECK(PropertyId::create<ExamplePropertyA>(100) == a100);
+
+  BOOST_CHECK_LT(a100.getSlot(), PropertyId::getSlotCount());
+}
+
+//-----------------------------------------------------------------------------
+
 BOOST_AUTO_TEST_SUITE_END ()
 
 
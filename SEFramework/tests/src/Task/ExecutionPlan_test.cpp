@@ -0,0 +1,199 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * ExecutionPlan_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <atomic>
+#include <future>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "ElementsKernel/Exception.h"
+
+#include "SEFramework/Property/Property.h"
+#include "SEFramework/Source/SourceWithOnDemandProperties.h"
+#include "SEFramework/Task/ExecutionPlan.h"
+#include "SEFramework/Task/SourceTask.h"
+#include "SEFramework/Task/TaskProvider.h"
+
+using namespace SourceXtractor;
+
+class ValueProperty : public Property {
+public:
+  explicit ValueProperty(int value) : m_value(value) {}
+  int m_value;
+};
+
+static PropertyId valueId(unsigned int index) {
+  return PropertyId::create<ValueProperty>(index);
+}
+
+// Sets its property to one plus the values it reads, and counts how many times it runs
+class ValueTask : public SourceTask {
+public:
+  ValueTask(unsigned int output, std::vector<PropertyId> dependencies, bool declared,
+            std::vector<PropertyId> undeclared)
+    : m_output(output), m_dependencies(dependencies), m_declared(declared), m_undeclared(undeclared), m_runs(0) {}
+
+  void computeProperties(SourceInterface& source) const override {
+    ++m_runs;
+    int value = 1;
+    for (auto& property_id : m_dependencies) {
+      value += dynamic_cast<const ValueProperty&>(source.getProperty(property_id)).m_value;
+    }
+    for (auto& property_id : m_undeclared) {
+      value += dynamic_cast<const ValueProperty&>(source.getProperty(property_id)).m_value;
+    }
+    source.setIndexedProperty<ValueProperty>(m_output, value);
+  }
+
+  bool declaresDependencies() const override {
+    return m_declared;
+  }
+
+  std::vector<PropertyId> getDependencies() const override {
+    return m_declared ? m_dependencies : std::vector<PropertyId>{};
+  }
+
+  unsigned int m_output;
+  std::vector<PropertyId> m_dependencies;
+  bool m_declared;
+  std::vector<PropertyId> m_undeclared;
+  mutable std::atomic<int> m_runs;
+};
+
+class ValueTaskProvider : public TaskProvider {
+public:
+  ValueTaskProvider() : TaskProvider(nullptr) {}
+
+  void addTask(unsigned int output, std::vector<unsigned int> dependencies, bool declared,
+               std::vector<unsigned int> undeclared = {}) {
+    std::vector<PropertyId> dependency_ids, undeclared_ids;
+    for (auto index : dependencies) {
+      dependency_ids.push_back(valueId(index));
+    }
+    for (auto index : undeclared) {
+      undeclared_ids.push_back(valueId(index));
+    }
+    m_value_tasks[output] = std::make_shared<ValueTask>(output, dependency_ids, declared, undeclared_ids);
+  }
+
+  std::map<unsigned int, std::shared_ptr<ValueTask>> m_value_tasks;
+
+protected:
+  std::shared_ptr<const Task> getTask(const PropertyId& property_id) const override {
+    auto task = m_value_tasks.find(property_id.getIndex());
+    if (property_id.getTypeId() != typeid(ValueProperty) || task == m_value_tasks.end()) {
+      return nullptr;
+    }
+    return task->second;
+  }
+};
+
+struct ExecutionPlanFixture {
+  std::shared_ptr<ValueTaskProvider> provider = std::make_shared<ValueTaskProvider>();
+
+  ExecutionPlanFixture() {
+    // 0 and 4 do not declare their dependencies
+    provider->addTask(0, {}, false);
+    provider->addTask(1, {0}, true);
+    provider->addTask(2, {0}, true);
+    provider->addTask(3, {1, 2}, true);
+    provider->addTask(4, {}, false);
+    provider->addTask(5, {}, true);
+  }
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (ExecutionPlan_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE( stages_test, ExecutionPlanFixture ) {
+  ExecutionPlan plan(*provider, {valueId(3), valueId(4), valueId(5), valueId(42)});
+
+  // The undeclared tasks get a stage of their own, the declared ones join the first stage they can
+  std::vector<std::vector<PropertyId>> expected {
+    {valueId(0)}, {valueId(1), valueId(2), valueId(5)}, {valueId(3)}, {valueId(4)}
+  };
+  auto stages = plan.getStages();
+  BOOST_REQUIRE_EQUAL(stages.size(), expected.size());
+  for (std::size_t i = 0; i < stages.size(); ++i) {
+    BOOST_CHECK(stages[i] == expected[i]);
+  }
+  BOOST_CHECK_EQUAL(plan.getMaxConcurrency(), 3);
+}
+
+BOOST_FIXTURE_TEST_CASE( cycle_test, ExecutionPlanFixture ) {
+  std::vector<PropertyId> properties {valueId(6)};
+  provider->addTask(6, {7}, true);
+  provider->addTask(7, {6}, true);
+  BOOST_CHECK_THROW(ExecutionPlan(*provider, properties), Elements::Exception);
+
+  // The same dependencies are fine if one of the tasks does not declare them
+  provider->addTask(7, {6}, false);
+  BOOST_CHECK_NO_THROW(ExecutionPlan(*provider, properties));
+}
+
+BOOST_FIXTURE_TEST_CASE( execute_test, ExecutionPlanFixture ) {
+  ExecutionPlan plan(*provider, {valueId(3), valueId(4), valueId(5)});
+
+  std::atomic<int> concurrent_stages(0);
+  auto parallel_for = [&concurrent_stages](std::size_t n, const std::function<void(std::size_t)>& body) {
+    ++concurrent_stages;
+    std::vector<std::future<void>> iterations;
+    for (std::size_t i = 0; i < n; ++i) {
+      iterations.emplace_back(std::async(std::launch::async, body, i));
+    }
+    for (auto& iteration : iterations) {
+      iteration.get();
+    }
+  };
+
+  SourceWithOnDemandProperties source(provider);
+  plan.execute(source, parallel_for);
+  BOOST_CHECK_EQUAL(concurrent_stages, 1);
+
+  for (auto& task : provider->m_value_tasks) {
+    BOOST_CHECK_EQUAL(task.second->m_runs, 1);
+  }
+
+  std::map<unsigned int, int> expected {{0, 1}, {1, 2}, {2, 2}, {3, 5}, {4, 1}, {5, 1}};
+  for (auto& value : expected) {
+    BOOST_CHECK_EQUAL(source.getProperty<ValueProperty>(value.first).m_value, value.second);
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE( undeclared_dependency_test, ExecutionPlanFixture ) {
+  // 1 reads 2, computed by the same stage, without declaring it
+  provider->addTask(1, {0}, true, {2});
+  ExecutionPlan plan(*provider, {valueId(3)});
+
+  SourceWithOnDemandProperties source(provider);
+  BOOST_CHECK_THROW(plan.execute(source), Elements::Exception);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
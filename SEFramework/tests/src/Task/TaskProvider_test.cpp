@@ -20,7 +20,9 @@
  * @author mschefer
  */
 
+#include <future>
 #include <memory>
+#include <vector>
 
 #include <boost/test/unit_test.hpp>
 
@@ -86,6 +88,23 @@ BOOST_FIXTURE_TEST_CASE( TaskProvider_test, TaskProviderFixture ) {
   BOOST_CHECK(example_task);
 }
 
+BOOST_FIXTURE_TEST_CASE( TaskProvider_cached_test, TaskProviderFixture ) {
+  registry->registerTaskFactory<ExampleTaskFactory, ExampleProperty>();
+
+  // Once resolved, the same task is returned for the property from any thread
+  auto task = provider->getTask<SourceTask>(PropertyId::create<ExampleProperty>());
+  BOOST_REQUIRE(task);
+  std::vector<std::future<std::shared_ptr<const SourceTask>>> lookups;
+  for (int i = 0; i < 4; ++i) {
+    lookups.emplace_back(std::async(std::launch::async, [this]() {
+      return provider->getTask<SourceTask>(PropertyId::create<ExampleProperty>());
+    }));
+  }
+  for (auto& lookup : lookups) {
+    BOOST_CHECK_EQUAL(lookup.get(), task);
+  }
+}
+
 BOOST_FIXTURE_TEST_CASE( TaskProvider_notfound_test, TaskProviderFixture ) {
   registry->registerTaskFactory<ExampleTaskFactory, ExampleProperty>();
 
@@ -20,6 +20,7 @@
 
 #include "SEFramework/Image/VectorImage.h"
 #include "SEFramework/Image/WriteableImage.h"
+#include "SEImplementation/Background/SlidingMedian.h"
 
 namespace SourceXtractor {
 
@@ -35,6 +36,9 @@ namespace SourceXtractor {
  *  replaced also by the median of the variances contained within the box.
  *
  *  There is no padding. At the edges whe box size is *symmetrically* clipped to the number of available pixels.
+ *
+ *  The box slides along each row keeping its values sorted (see SlidingMedian), instead of being
+ *  copied and sorted again for every pixel.
  */
 template<typename T>
 class MedianFilter {
@@ -75,19 +79,19 @@ public:
     auto out_img = VectorImage<T>::create(image.getWidth(), image.getHeight());
     auto out_var = VectorImage<T>::create(image.getWidth(), image.getHeight());
 
+    SlidingMedian<T>::filter(image.getWidth(), image.getHeight(), m_box_width, m_box_height,
+      [&image](int x, int y) { return image.getValue(x, y); },
+      [&out_img](int x, int y, T median) { out_img->at(x, y) = median; });
+    SlidingMedian<T>::filter(image.getWidth(), image.getHeight(), m_box_width, m_box_height,
+      [&variance](int x, int y) { return variance.getValue(x, y); },
+      [&out_var](int x, int y, T median) { out_var->at(x, y) = median; });
+
     for (int y = 0; y < image.getHeight(); ++y) {
       for (int x = 0; x < image.getWidth(); ++x) {
-        auto box = getBox(image, x, y);
-        auto median = getMedian(box);
         auto value = image.getValue(x, y);
-        if (std::abs(median - value) >= threshold) {
-          out_img->setValue(x, y, median);
-          auto var_box = getBox(variance, x, y);
-          out_var->setValue(x, y, getMedian(var_box));
-        }
-        else {
-          out_img->setValue(x, y, value);
-          out_var->setValue(x, y, variance.getValue(x, y));
+        if (!(std::abs(out_img->at(x, y) - value) >= threshold)) {
+          out_img->at(x, y) = value;
+          out_var->at(x, y) = variance.getValue(x, y);
         }
       }
     }
@@ -97,57 +101,6 @@ public:
 
 private:
   int m_box_width, m_box_height;
-
-  /**
-   * Convenience method to compute the median of a vector
-   * @param data
-   *    The vector on which to compute the median. *It will be modified*.
-   */
-  static T getMedian(std::vector<T>& data) {
-    std::sort(data.begin(), data.end());
-    auto nitems = data.size();
-    if (nitems % 2 == 1)
-      return data[nitems / 2];
-    return (data[nitems / 2] + data[nitems / 2 - 1]) / 2;
-  }
-
-  /**
-   * Symmetrically clip the size of the smoothing box depending on the number of available pixels.
-   * This is a 1-D version that is applied to X and Y separately.
-   * @param position
-   *    Coordinate where the box will be centered
-   * @param box_size
-   *    Size of the smoothing box
-   * @param image_size
-   *    Image size
-   * @return
-   *    As many pixels as could be read safely from the image, up to box_size
-   */
-  static int clip(int position, int box_size, int image_size) {
-    box_size /= 2;
-    if (box_size > position)
-      return position;
-    if (box_size > image_size - position - 1)
-      return image_size - position - 1;
-    return box_size;
-  }
-
-  /**
-   * Get the pixel values contained within a box centered at x,y
-   */
-  std::vector<T> getBox(const Image<T>& img, int x, int y) const {
-    int hw = clip(x, m_box_width, img.getWidth());
-    int hh = clip(y, m_box_height, img.getHeight());
-    std::vector<T> data;
-    auto inserter = std::back_inserter(data);
-    for (int iy = -hh; iy < hh + 1; ++iy) {
-      for (int ix = -hw; ix < hw + 1; ++ix) {
-        *inserter = img.getValue(x + ix, y + iy);
-        ++inserter;
-      }
-    }
-    return data;
-  }
 };
 
 } // end of namespace SourceXtractor
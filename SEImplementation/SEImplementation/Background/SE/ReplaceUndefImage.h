@@ -18,12 +18,17 @@
 #ifndef SOURCEXTRACTORPLUSPLUS_REPLACEUNDEFIMAGE_H
 #define SOURCEXTRACTORPLUSPLUS_REPLACEUNDEFIMAGE_H
 
+#include <vector>
 #include "SEFramework/Image/VectorImage.h"
 
 namespace SourceXtractor {
 
 /**
  * Replace undefined (i.e. masked) values with the average of the closest defined pixel values
+ * @details
+ *  The squared distance to the closest defined pixel is computed once for the whole image with an
+ *  exact Euclidean distance transform, so only the pixels lying at that distance need to be visited
+ *  when a value is requested.
  * @tparam T
  *  Pixel type
  */
@@ -62,6 +67,7 @@ public:
 private:
   std::shared_ptr<VectorImage<T>> m_image;
   T m_invalid;
+  std::vector<long long> m_distance;
 };
 
 extern template class ReplaceUndefImage<SeFloat>;
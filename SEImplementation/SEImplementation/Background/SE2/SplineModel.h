@@ -42,6 +42,14 @@ public:
   void gridToFits(boost::filesystem::path& fitsName, const bool overwrite=true);
   void toFits(boost::filesystem::path& fitsName, const bool overwrite=true);
   PIXTYPE  getValue(size_t x, size_t y);
+
+  /**
+   * Evaluates the spline over the window [xStart, xStart+width) x [yStart, yStart+height)
+   * into tile, which is filled row by row. The basis along x is computed once for the window,
+   * and only the columns inside it are evaluated.
+   * Unlike getValue, it does not touch any cached state, so it can be called concurrently.
+   */
+  void splineTile(PIXTYPE *tile, const size_t xStart, const size_t yStart, const size_t width, const size_t height) const;
   //void splineLine(PIXTYPE *line, const size_t y, const size_t xStart, const size_t width);
   PIXTYPE& getMedian();
   PIXTYPE * getData();
@@ -52,6 +60,7 @@ public:
   size_t  getNGridPoints();
 private:
   void splineLine(PIXTYPE *line, const size_t y, const size_t xStart, const size_t width);
+  void interpolateNodes(float *node, float *dnode, const size_t y) const;
   PIXTYPE* makeSplineDeriv(const size_t* nGrid, PIXTYPE* gridData);
   PIXTYPE* loadModelFromFits(const boost::filesystem::path);
   PIXTYPE  computeMedian(PIXTYPE* gridData, const size_t nGridPoints);
@@ -25,9 +25,12 @@
 #ifndef TYPEDSPLINEMODELWRAPPER_H
 #define	TYPEDSPLINEMODELWRAPPER_H
 
+#include <algorithm>
+#include <vector>
 #include <boost/filesystem.hpp>
 #include "SEFramework/Image/ImageBase.h"
 #include "SEFramework/Image/ImageSource.h"
+#include "SEFramework/Image/VectorImage.h"
 #include "SEImplementation/Background/SE2/SplineModel.h"
 
 namespace SourceXtractor {
@@ -78,18 +81,26 @@ public:
 
   std::shared_ptr<ImageTile<T>> getImageTile(int x, int y, int width, int height) const override {
     auto tile = std::make_shared<ImageTile<T>>(x, y, width, height);
-    // Splines are calculated and cached per row. We fill
-    // the tile with the Y axis on the outer loop, so we can
-    // benefit from that caching
-    // @see SplineModel::getValue
-    for (auto j = y; j < y + height; ++j) {
-      for (auto i = x; i < x + width; ++i) {
-        tile->setValue(i, j, getValue(i, j));
-      }
-    }
+    // Evaluate only the window of the tile. This does not use the row cache
+    // of SplineModel::getValue, so tiles can be generated concurrently
+    std::vector<PIXTYPE> buffer(width * height);
+    m_spline_model->splineTile(buffer.data(), x, y, width, height);
+    std::copy(buffer.begin(), buffer.end(), tile->getImage()->getData().begin());
     return tile;
   }
 
+  /// Returns the values of the grid nodes the spline goes through
+  std::shared_ptr<VectorImage<T>> getGridValues() const {
+    auto n_grid = m_spline_model->getNGrid();
+    auto data = m_spline_model->getData();
+    return VectorImage<T>::create(n_grid[0], n_grid[1], data, data + n_grid[0] * n_grid[1]);
+  }
+
+  /// Returns the size of the cells of the grid, in pixels
+  const size_t* getGridCellSize() const {
+    return m_spline_model->getGridCellSize();
+  }
+
   void gridToFits(boost::filesystem::path path) const {
     m_spline_model->gridToFits(path);
   }
@@ -0,0 +1,124 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * SlidingMedian.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef _SEIMPLEMENTATION_BACKGROUND_SLIDINGMEDIAN_H_
+#define _SEIMPLEMENTATION_BACKGROUND_SLIDINGMEDIAN_H_
+
+#include <algorithm>
+#include <vector>
+
+namespace SourceXtractor {
+
+/**
+ * @class SlidingMedian
+ * @brief
+ *  Keeps the values of a moving window sorted, so the median is available without sorting the
+ *  whole window again every time it moves.
+ *
+ * @details
+ *  Smoothing boxes over background meshes are small, so a sorted vector is cheaper than a pair of
+ *  heaps: a binary search plus a short contiguous move per update. The median of an even number of
+ *  values is the mean of the two central ones.
+ */
+template <typename T>
+class SlidingMedian {
+public:
+
+  void clear() {
+    m_sorted.clear();
+  }
+
+  void add(T value) {
+    m_sorted.insert(std::upper_bound(m_sorted.begin(), m_sorted.end(), value), value);
+  }
+
+  void remove(T value) {
+    auto i = std::lower_bound(m_sorted.begin(), m_sorted.end(), value);
+    if (i != m_sorted.end() && !(value < *i)) {
+      m_sorted.erase(i);
+    }
+  }
+
+  std::size_t size() const {
+    return m_sorted.size();
+  }
+
+  T median() const {
+    auto nitems = m_sorted.size();
+    if (nitems % 2 == 1)
+      return m_sorted[nitems / 2];
+    return (m_sorted[nitems / 2] + m_sorted[nitems / 2 - 1]) / 2;
+  }
+
+  /**
+   * Half size of a box of box_size pixels centered at position, symmetrically clipped to the
+   * number of available pixels. As position moves forward, both ends of the clipped box
+   * move forward too, so the window only ever gains pixels on one side and loses them on the other.
+   */
+  static int clip(int position, int box_size, int image_size) {
+    box_size /= 2;
+    if (box_size > position)
+      return position;
+    if (box_size > image_size - position - 1)
+      return image_size - position - 1;
+    return box_size;
+  }
+
+  /**
+   * Median filter of a width x height grid using boxes symmetrically clipped at the edges.
+   * @param getter
+   *    Called as getter(x, y) to read a value
+   * @param callback
+   *    Called as callback(x, y, median) for every position, in row-major order
+   */
+  template <typename Getter, typename Callback>
+  static void filter(int width, int height, int box_width, int box_height, Getter getter, Callback callback) {
+    SlidingMedian<T> window;
+    for (int y = 0; y < height; ++y) {
+      int hh = clip(y, box_height, height);
+      window.clear();
+      // Columns [left, right) are in the window
+      int left = 0, right = 0;
+      for (int x = 0; x < width; ++x) {
+        int hw = clip(x, box_width, width);
+        for (; right <= x + hw; ++right) {
+          for (int iy = y - hh; iy <= y + hh; ++iy) {
+            window.add(getter(right, iy));
+          }
+        }
+        for (; left < x - hw; ++left) {
+          for (int iy = y - hh; iy <= y + hh; ++iy) {
+            window.remove(getter(left, iy));
+          }
+        }
+        callback(x, y, window.median());
+      }
+    }
+  }
+
+private:
+  std::vector<T> m_sorted;
+};
+
+} // end of namespace SourceXtractor
+
+#endif /* _SEIMPLEMENTATION_BACKGROUND_SLIDINGMEDIAN_H_ */
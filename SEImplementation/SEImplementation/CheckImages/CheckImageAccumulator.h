@@ -0,0 +1,94 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * CheckImageAccumulator.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef _SEIMPLEMENTATION_CHECKIMAGES_CHECKIMAGEACCUMULATOR_H_
+#define _SEIMPLEMENTATION_CHECKIMAGES_CHECKIMAGEACCUMULATOR_H_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "SEFramework/Image/VectorImage.h"
+#include "SEFramework/Image/WriteableImage.h"
+
+namespace SourceXtractor {
+
+/**
+ * @class CheckImageAccumulator
+ * @brief Adds stamps into a check image, i.e. for the models
+ *
+ * @details
+ *  The image is split in blocks, each with its own lock and an in-memory buffer allocated when
+ *  a stamp first touches it. Threads adding stamps on different areas do not wait for each other,
+ *  nor for the global lock. The buffers are charged to the MemoryGovernor, and added into the image
+ *  once they exceed the given memory, when they are a good part of an exceeded pipeline budget,
+ *  or when flush is called. The global lock is taken once per row while adding them.
+ */
+class CheckImageAccumulator {
+public:
+
+  static constexpr int BLOCK_SIZE = 256;
+  static constexpr std::size_t BLOCK_BYTES = BLOCK_SIZE * BLOCK_SIZE * sizeof(SeFloat);
+
+  /**
+   * Constructor
+   * @param image
+   *    Check image to add into
+   * @param max_memory
+   *    Maximum number of bytes held in blocks before adding them into the image. At least one block is kept
+   */
+  CheckImageAccumulator(std::shared_ptr<WriteableImage<SeFloat>> image, std::size_t max_memory);
+
+  /// Releases the memory charge of the blocks that were not flushed
+  virtual ~CheckImageAccumulator();
+
+  /// Add the stamp with its top left corner at (x, y). The pixels falling outside the image are ignored
+  void addStamp(const VectorImage<SeFloat>& stamp, int x, int y);
+
+  /// Add length values starting at (x, y), so a stamp can be added while it is being traversed for
+  /// something else. The pixels falling outside the image are ignored
+  void addRow(const SeFloat* values, int length, int x, int y);
+
+  /// Add everything accumulated so far into the image
+  void flush();
+
+private:
+  struct Block {
+    std::mutex m_mutex;
+    std::vector<SeFloat> m_data;
+  };
+
+  void accumulateRow(const SeFloat* values, int length, int x, int y);
+  void flushIfOverMemory();
+  void flushBlock(int block_x, int block_y);
+
+  std::shared_ptr<WriteableImage<SeFloat>> m_image;
+  int m_blocks_x, m_blocks_y;
+  std::unique_ptr<Block[]> m_blocks;
+  std::atomic<std::size_t> m_allocated_blocks;
+  std::size_t m_max_blocks;
+};
+
+} /* namespace SourceXtractor */
+
+#endif /* _SEIMPLEMENTATION_CHECKIMAGES_CHECKIMAGEACCUMULATOR_H_ */
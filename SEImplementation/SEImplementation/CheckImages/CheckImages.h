@@ -39,6 +39,8 @@
 #include "SEFramework/Frame/Frame.h"
 
 #include "SEImplementation/Image/LockedWriteableImage.h"
+#include "SEImplementation/CheckImages/LabelCheckImageWriter.h"
+#include "SEImplementation/CheckImages/CheckImageAccumulator.h"
 
 
 namespace SourceXtractor {
@@ -75,6 +77,19 @@ public:
     }
   }
 
+  /// Asynchronous writers for the label images, which receive whole footprints
+  std::shared_ptr<LabelCheckImageWriter> getSegmentationWriter() const {
+    return m_segmentation_writer;
+  }
+
+  std::shared_ptr<LabelCheckImageWriter> getPartitionWriter() const {
+    return m_partition_writer;
+  }
+
+  std::shared_ptr<LabelCheckImageWriter> getGroupWriter() const {
+    return m_group_writer;
+  }
+
   std::shared_ptr<WriteableImage<unsigned int>> getAutoApertureImage() const {
     if (m_auto_aperture_image != nullptr) {
       return LockedWriteableImage<unsigned int>::create(m_auto_aperture_image);
@@ -105,6 +120,9 @@ public:
 
   std::shared_ptr<WriteableImage<MeasurementImage::PixelType>> getModelFittingImage(unsigned int frame_number);
 
+  /// Adds the model stamps into the model fitting check image of the frame, without taking the global lock
+  std::shared_ptr<CheckImageAccumulator> getModelFittingAccumulator(unsigned int frame_number);
+
   std::shared_ptr<WriteableImage<MeasurementImage::PixelType>> getPsfImage(unsigned int frame_number);
 
   void setBackgroundCheckImage(std::shared_ptr<Image<SeFloat>> background_image) {
@@ -146,6 +164,9 @@ private:
 
   static std::unique_ptr<CheckImages> m_instance;
 
+  /// Must be called with m_access_mutex locked
+  std::shared_ptr<WriteableImage<MeasurementImage::PixelType>> getModelFittingCheckImage(unsigned int frame_number);
+
   struct FrameInfo {
     std::string m_label;
     int m_width, m_height;
@@ -160,9 +181,13 @@ private:
   std::shared_ptr<WriteableImage<unsigned int>> m_auto_aperture_image;
   std::shared_ptr<WriteableImage<unsigned int>> m_aperture_image;
   std::shared_ptr<WriteableImage<SeFloat>> m_moffat_image;
+  std::shared_ptr<LabelCheckImageWriter> m_segmentation_writer, m_partition_writer, m_group_writer;
   std::map<unsigned int, decltype(m_aperture_image)> m_measurement_aperture_images;
   std::map<unsigned int, decltype(m_auto_aperture_image)> m_measurement_auto_aperture_images;
   std::map<unsigned int, std::shared_ptr<WriteableImage<MeasurementImage::PixelType>>> m_check_image_model_fitting, m_check_image_psf;
+  std::map<unsigned int, std::shared_ptr<CheckImageAccumulator>> m_model_fitting_accumulators;
+  // Memory, in bytes, each accumulator can hold before adding into its image
+  size_t m_accumulator_max_memory;
 
   std::shared_ptr<DetectionImage> m_detection_image;
   std::shared_ptr<Image<SeFloat>> m_background_image;
@@ -0,0 +1,111 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * LabelCheckImageWriter.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef _SEIMPLEMENTATION_CHECKIMAGES_LABELCHECKIMAGEWRITER_H_
+#define _SEIMPLEMENTATION_CHECKIMAGES_LABELCHECKIMAGEWRITER_H_
+
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "SEUtils/PixelCoordinate.h"
+#include "SEFramework/Image/WriteableImage.h"
+
+namespace SourceXtractor {
+
+/**
+ * @class LabelCheckImageWriter
+ * @brief Writes the footprints of sources into a label check image from a dedicated thread
+ *
+ * @details
+ *  The pipeline threads only turn the footprint into horizontal spans and queue them. The writer
+ *  thread takes everything queued so far, and paints it row by row. The global lock is taken
+ *  once per row, so the measurement threads are not held for a whole batch.
+ *  The queue is bounded: when the writer falls behind, the pipeline threads wait.
+ *  When footprints overlap, the one queued last wins, as if they had been written directly.
+ *  If writing into the image fails, the writer thread discards whatever is queued afterwards, and
+ *  the error is rethrown to the pipeline threads by write() and flush().
+ */
+class LabelCheckImageWriter {
+public:
+
+  /// A run of pixels on the same row set to the same value
+  struct Span {
+    int m_x, m_y, m_length;
+    unsigned int m_value;
+  };
+
+  /**
+   * @param image
+   *    Image to write into
+   * @param max_queued_spans
+   *    Number of spans that can be waiting to be written before write() blocks
+   */
+  explicit LabelCheckImageWriter(std::shared_ptr<WriteableImage<unsigned int>> image,
+                                 std::size_t max_queued_spans = 1 << 16);
+
+  /// Writes whatever is still queued and stops the writer thread. An error that was never rethrown is logged
+  virtual ~LabelCheckImageWriter();
+
+  /**
+   * Queue the pixels to be set to value. Blocks while the queue is full, so it must not be called
+   * while holding MultithreadedMeasurement::g_global_mutex: the writer thread needs it to make room
+   * @throw
+   *    The error of the writer thread, if writing into the image failed
+   */
+  void write(const std::vector<PixelCoordinate>& pixels, unsigned int value);
+
+  /**
+   * Block until everything queued so far has been written into the image
+   * @throw
+   *    The error of the writer thread, if writing into the image failed
+   */
+  void flush();
+
+  /// Split a list of pixels into horizontal spans, sorted by row
+  static std::vector<Span> toSpans(const std::vector<PixelCoordinate>& pixels, unsigned int value);
+
+private:
+  void run();
+
+  std::shared_ptr<WriteableImage<unsigned int>> m_image;
+
+  std::size_t m_max_queued_spans;
+
+  std::mutex m_queue_mutex;
+  std::condition_variable m_queued, m_dequeued, m_written;
+  std::vector<Span> m_queue;
+  bool m_writing, m_stop;
+
+  // First error of the writer thread, and whether it reached a caller
+  std::exception_ptr m_error;
+  bool m_error_reported;
+
+  std::thread m_thread;
+};
+
+} /* namespace SourceXtractor */
+
+#endif /* _SEIMPLEMENTATION_CHECKIMAGES_LABELCHECKIMAGEWRITER_H_ */
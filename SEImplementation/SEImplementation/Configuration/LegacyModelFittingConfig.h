@@ -48,9 +48,14 @@ public:
     return m_least_squares_engine;
   }
 
+  unsigned int getCoarseLevels() const {
+    return m_coarse_levels;
+  }
+
 private:
   std::string m_least_squares_engine;
   int m_max_iterations;
+  unsigned int m_coarse_levels;
 
 };
 
@@ -47,9 +47,21 @@ public:
     return m_tile_size;
   }
 
+  // maximum memory held by the sources and rows in the pipeline in megabytes, 0 if unbounded
+  int getPipelineMaxMemory() const {
+    return m_pipeline_max_memory;
+  }
+
+  // maximum memory used to accumulate the model check images before adding them in megabytes
+  int getCheckImageMaxMemory() const {
+    return m_check_image_max_memory;
+  }
+
 private:
   int m_max_memory;
   int m_tile_size;
+  int m_pipeline_max_memory;
+  int m_check_image_max_memory;
 };
 
 
@@ -27,6 +27,7 @@
 #include <SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingModel.h>
 #include <SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingFrame.h>
 #include <SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingPrior.h>
+#include <SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingSeedCatalog.h>
 #include <Configuration/Configuration.h>
 
 namespace SourceXtractor {
@@ -56,11 +57,22 @@ public:
 
   unsigned int getMaxIterations() const { return m_max_iterations; }
   double getModifiedChiSquaredScale() const { return m_modified_chi_squared_scale; }
+  unsigned int getSplitGroupSize() const { return m_split_group_size; }
+  bool getJointRefinement() const { return m_joint_refinement; }
+  unsigned int getJacobianThreads() const { return m_jacobian_threads; }
+  unsigned int getCoarseLevels() const { return m_coarse_levels; }
+  /// Values of a previous run to start the fits from. Null if not configured
+  std::shared_ptr<FlexibleModelFittingSeedCatalog> getSeedCatalog() const { return m_seed_catalog; }
 
 private:
   std::string m_least_squares_engine;
   unsigned int m_max_iterations {0};
   double m_modified_chi_squared_scale {10.};
+  unsigned int m_split_group_size {0};
+  bool m_joint_refinement {false};
+  unsigned int m_jacobian_threads {0};
+  unsigned int m_coarse_levels {0};
+  std::shared_ptr<FlexibleModelFittingSeedCatalog> m_seed_catalog;
   
   std::map<int, std::shared_ptr<FlexibleModelFittingParameter>> m_parameters;
   std::map<int, std::shared_ptr<FlexibleModelFittingModel>> m_models;
@@ -0,0 +1,61 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * SnapshotConfig.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef _SEIMPLEMENTATION_CONFIGURATION_SNAPSHOTCONFIG_H_
+#define _SEIMPLEMENTATION_CONFIGURATION_SNAPSHOTCONFIG_H_
+
+#include "Configuration/Configuration.h"
+
+namespace SourceXtractor {
+
+/**
+ * @class SnapshotConfig
+ * @brief
+ *  Paths of the detection snapshot to save from this run, or to load instead of running the detection
+ */
+class SnapshotConfig : public Euclid::Configuration::Configuration {
+public:
+  SnapshotConfig(long manager_id);
+
+  virtual ~SnapshotConfig() = default;
+
+  std::map<std::string, OptionDescriptionList> getProgramOptions() override;
+
+  void initialize(const UserValues& args) override;
+
+  // empty if no snapshot is to be saved
+  const std::string& getSavePath() const {
+    return m_save_path;
+  }
+
+  // empty if the detection is to be run
+  const std::string& getLoadPath() const {
+    return m_load_path;
+  }
+
+private:
+  std::string m_save_path, m_load_path;
+};
+
+} /* namespace SourceXtractor */
+
+#endif /* _SEIMPLEMENTATION_CONFIGURATION_SNAPSHOTCONFIG_H_ */
@@ -44,7 +44,7 @@ public:
   void deblend(SourceGroupInterface& group) const override;
 
 private:
-  bool shouldClean(SourceInterface& source, SourceGroupInterface& group) const;
+  bool shouldClean(SourceInterface& source, const std::vector<double>& group_influence) const;
   SourceGroupInterface::iterator findMostInfluentialSource(
       SourceInterface& source, const std::vector<SourceGroupInterface::iterator>& candidates) const;
 
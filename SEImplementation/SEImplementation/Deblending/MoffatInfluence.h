@@ -0,0 +1,102 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * MoffatInfluence.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef _SEIMPLEMENTATION_DEBLENDING_MOFFATINFLUENCE_H_
+#define _SEIMPLEMENTATION_DEBLENDING_MOFFATINFLUENCE_H_
+
+#include <functional>
+#include <vector>
+
+#include "SEUtils/PixelCoordinate.h"
+
+namespace SourceXtractor {
+
+class MoffatModelFitting;
+
+/**
+ * @class MoffatInfluence
+ * @brief
+ *  For every pixel of every source of a group, sum the Moffat models of all the other sources
+ *
+ * @details
+ *  The pixels of the group are bucketed into a coarse grid, and each model is only evaluated on the
+ *  cells within the radius where its value falls below the threshold. The evaluation is done on
+ *  contiguous arrays of coordinates without virtual calls, so the compiler can vectorize it.
+ *
+ *  The contributions are added in the same order as the sources are given, so, without truncation,
+ *  the sums are identical to evaluating each MoffatModelEvaluator of the group pixel by pixel.
+ */
+class MoffatInfluence {
+public:
+
+  /// Parameters of a flattened Moffat profile, as fitted by MoffatModelFitting
+  struct Profile {
+    double m_x, m_y;
+    double m_i0, m_index, m_minkowski_exponent, m_top_offset;
+    double m_x_scale, m_y_scale;
+    double m_cos, m_sin;
+
+    explicit Profile(const MoffatModelFitting& model);
+
+    Profile(double x, double y, double i0, double index, double minkowski_exponent, double top_offset,
+            double x_scale, double y_scale, double rotation);
+
+    double getValue(double x, double y) const;
+
+    /**
+     * @return
+     *    A radius, in pixels, beyond which the value of the profile is below threshold.
+     *    Infinity if there is no such radius.
+     */
+    double getTruncationRadius(double threshold) const;
+  };
+
+  using PixelList = std::vector<PixelCoordinate>;
+
+  /**
+   * Constructor
+   * @param profiles
+   *    One profile per source
+   * @param pixels
+   *    The pixels of each source, in the same order as the profiles
+   * @param threshold
+   *    Contributions below this value are ignored. With 0, every model is evaluated everywhere
+   */
+  MoffatInfluence(const std::vector<Profile>& profiles,
+                  const std::vector<std::reference_wrapper<const PixelList>>& pixels,
+                  double threshold);
+
+  /**
+   * @return
+   *    The sum of the other models over each pixel of the given source
+   */
+  const std::vector<double>& getInfluence(std::size_t source) const {
+    return m_influence[source];
+  }
+
+private:
+  std::vector<std::vector<double>> m_influence;
+};
+
+} // end of namespace SourceXtractor
+
+#endif /* _SEIMPLEMENTATION_DEBLENDING_MOFFATINFLUENCE_H_ */
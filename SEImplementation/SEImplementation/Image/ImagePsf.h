@@ -76,12 +76,15 @@ private:
 namespace ModelFitting {
 
 /**
- * Specialization of PsfTraits, as DFTConvolution has the concept of context
+ * Specialization of PsfTraits, as DFTConvolution has the concept of context, and can convolve
+ * multiple images with a single batched transform
  */
 template<>
 struct PsfTraits<SourceXtractor::ImagePsf> {
   using context_t = typename std::unique_ptr<SourceXtractor::ImagePsf::ConvolutionContext>;
+  using batch_context_t = typename std::unique_ptr<SourceXtractor::ImagePsf::BatchConvolutionContext>;
   static constexpr bool has_context = true;
+  static constexpr bool has_batch = true;
 };
 
 } // end of ModelFitting
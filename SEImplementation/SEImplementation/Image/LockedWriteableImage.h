@@ -47,6 +47,14 @@ public:
     m_img->setValue(x, y, value);
   }
 
+  void fillRow(int x, int y, int length, T value) override {
+    m_img->fillRow(x, y, length, value);
+  }
+
+  void addToRow(int x, int y, int length, const T* values) override {
+    m_img->addToRow(x, y, length, values);
+  }
+
 private:
   std::shared_ptr<WriteableImage<T>> m_img;
   std::lock_guard<std::recursive_mutex> m_lock;
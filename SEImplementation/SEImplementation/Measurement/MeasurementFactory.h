@@ -27,6 +27,7 @@
 #include "SEFramework/Output/Output.h"
 #include "SEFramework/Pipeline/Measurement.h"
 #include "SEFramework/Configuration/Configurable.h"
+#include "SEFramework/Task/TaskProvider.h"
 
 namespace SourceXtractor {
 
@@ -39,8 +40,9 @@ class MeasurementFactory : public Configurable {
 
 public:
 
-  MeasurementFactory(std::shared_ptr<OutputRegistry> output_registry)
-      : m_output_registry(output_registry), m_threads_nb(0) {}
+  MeasurementFactory(std::shared_ptr<OutputRegistry> output_registry,
+                     std::shared_ptr<TaskProvider> task_provider = nullptr)
+      : m_output_registry(output_registry), m_task_provider(task_provider), m_threads_nb(0) {}
 
   std::unique_ptr<Measurement> getMeasurement() const;
 
@@ -52,6 +54,7 @@ public:
 private:
   std::vector<std::string> m_output_properties;
   std::shared_ptr<OutputRegistry> m_output_registry;
+  std::shared_ptr<TaskProvider> m_task_provider;
 
   unsigned int m_threads_nb;
 };
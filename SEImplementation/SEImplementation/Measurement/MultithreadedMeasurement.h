@@ -28,9 +28,11 @@
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <unordered_map>
 #include <atomic>
 
 #include "SEFramework/Pipeline/Measurement.h"
+#include "SEFramework/Task/ExecutionPlan.h"
 
 namespace SourceXtractor {
 
@@ -38,12 +40,16 @@ class MultithreadedMeasurement : public Measurement {
 public:
 
   using SourceToRowConverter = std::function<Euclid::Table::Row(const SourceInterface&)>;
-  MultithreadedMeasurement(SourceToRowConverter source_to_row, int worker_threads_nb)
+  MultithreadedMeasurement(SourceToRowConverter source_to_row, int worker_threads_nb,
+                           std::shared_ptr<const ExecutionPlan> execution_plan = nullptr)
       : m_source_to_row(source_to_row),
+        m_execution_plan(execution_plan),
         m_worker_threads_nb(worker_threads_nb),
         m_active_threads(0),
         m_group_counter(0),
-        m_input_done(false), m_abort_raised(false) {}
+        m_groups_in_flight(0),
+        m_input_done(false), m_abort_raised(false),
+        m_busy_workers(0) {}
 
   void handleMessage(const std::shared_ptr<SourceGroupInterface>& source_group) override;
 
@@ -59,7 +65,14 @@ private:
   void workerThreadLoop();
   void outputThreadLoop();
 
+  struct SharedLoop;
+  static void runSharedLoop(SharedLoop& loop);
+
+  /// ExecutionPlan::ParallelFor sharing the iterations with the workers that are waiting for input
+  void parallelFor(std::size_t n, const std::function<void(std::size_t)>& body);
+
   SourceToRowConverter m_source_to_row;
+  std::shared_ptr<const ExecutionPlan> m_execution_plan;
 
   std::shared_ptr<std::thread> m_output_thread;
 
@@ -70,9 +83,16 @@ private:
   std::mutex m_active_threads_mutex;
 
   int m_group_counter;
+  // Groups received and not yet sent downstream, which the worker and output threads will release
+  std::atomic_int m_groups_in_flight;
   std::atomic_bool m_input_done, m_abort_raised;
   std::condition_variable m_new_input;
   std::list<std::pair<int, std::shared_ptr<SourceGroupInterface>>> m_input_queue;
+  // Bytes charged to the MemoryGovernor for each group in flight, by order number
+  std::unordered_map<int, std::size_t> m_group_charges;
+  // Stages of the execution plan with iterations left, taken by the workers when the input queue is empty
+  std::list<std::shared_ptr<SharedLoop>> m_shared_loops;
+  int m_busy_workers;
   std::mutex m_input_queue_mutex;
 
   std::condition_variable m_new_output;
@@ -22,13 +22,38 @@
 #ifndef _SEIMPLEMENTATION_TABLEOUTPUT_H
 #define _SEIMPLEMENTATION_TABLEOUTPUT_H
 
+#include "NdArray/NdArray.h"
 #include "Table/Table.h"
 #include "Table/CastVisitor.h"
 
 #include "SEFramework/Output/Output.h"
+#include "SEFramework/Pipeline/MemoryGovernor.h"
 
 namespace SourceXtractor {
 
+/// Approximate number of bytes held by a cell of a row
+class CellSizeVisitor : public boost::static_visitor<size_t> {
+public:
+  template <typename T>
+  size_t operator()(const T&) const {
+    return sizeof(Euclid::Table::Row::cell_type);
+  }
+
+  size_t operator()(const std::string& value) const {
+    return sizeof(Euclid::Table::Row::cell_type) + value.capacity();
+  }
+
+  template <typename T>
+  size_t operator()(const std::vector<T>& value) const {
+    return sizeof(Euclid::Table::Row::cell_type) + value.size() * sizeof(T);
+  }
+
+  template <typename T>
+  size_t operator()(const Euclid::NdArray::NdArray<T>& value) const {
+    return sizeof(Euclid::Table::Row::cell_type) + value.size() * sizeof(T);
+  }
+};
+
 class TableOutput : public Output {
   
 public:
@@ -44,20 +69,33 @@ public:
     }
     m_total_rows_written += m_rows.size();
     m_rows.clear();
+    MemoryGovernor::getInstance()->release(m_rows_size);
+    m_rows_size = 0;
     return m_total_rows_written;
   }
   
   TableOutput(SourceToRowConverter source_to_row, TableHandler table_handler, SourceHandler source_handler,
               size_t flush_size)
     : m_source_to_row(source_to_row), m_table_handler(table_handler), m_source_handler(source_handler),
-      m_flush_size(flush_size), m_total_rows_written(0) {
+      m_flush_size(flush_size), m_total_rows_written(0), m_rows_size(0) {
   }
 
   void outputSource(const SourceInterface& source) override {
     if (m_source_handler)
       m_source_handler(source);
     m_rows.emplace_back(m_source_to_row(source));
-    if (m_flush_size > 0 && m_rows.size() % m_flush_size == 0) {
+
+    auto memory_governor = MemoryGovernor::getInstance();
+    size_t row_size = 0;
+    for (auto& cell : m_rows.back()) {
+      row_size += boost::apply_visitor(CellSizeVisitor{}, cell);
+    }
+    memory_governor->charge(row_size);
+    m_rows_size += row_size;
+
+    // Write earlier than asked if the buffered rows are a good part of an exceeded budget
+    bool spill = memory_governor->isOverBudget() && 4 * m_rows_size >= memory_governor->getUsed();
+    if ((m_flush_size > 0 && m_rows.size() % m_flush_size == 0) || spill) {
       flush();
     }
   }
@@ -69,6 +107,8 @@ private:
   std::vector<Euclid::Table::Row> m_rows {};
   size_t m_flush_size;
   size_t m_total_rows_written;
+  // Bytes charged to the MemoryGovernor for m_rows
+  size_t m_rows_size;
 };
 
 } /* namespace SourceXtractor */
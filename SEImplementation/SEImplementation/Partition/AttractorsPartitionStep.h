@@ -23,7 +23,6 @@
 #ifndef _SEIMPLEMENTATION_PARTITION_ATTRACTORSPARTITIONSTEP_H
 #define _SEIMPLEMENTATION_PARTITION_ATTRACTORSPARTITIONSTEP_H
 
-#include <unordered_map>
 #include <vector>
 
 #include "SEUtils/PixelCoordinate.h"
@@ -38,6 +37,10 @@ namespace SourceXtractor {
  * @class AttractorsPartitionStep
  * @brief Splits sources by identifying an attractor pixel by climbing the values gradient from every pixel.
  *
+ * @details
+ * The steepest ascent step of every pixel on the stamp is computed once, and the paths are
+ * followed iteratively with path compression. Attractors touching each other are merged with
+ * a union-find, so the cost is linear on the size of the stamp.
  */
 class AttractorsPartitionStep : public PartitionStep {
 public:
@@ -55,14 +58,22 @@ public:
 private:
   std::shared_ptr<SourceFactory> m_source_factory;
 
-  void attractPixels(
-      const std::vector<std::pair<PixelCoordinate, PixelCoordinate>>& pixels_with_origin,
-      std::unordered_map<PixelCoordinate, std::vector<PixelCoordinate>>& attractors,
-      std::function<DetectionImage::PixelType (PixelCoordinate)> value_function) const;
-
-  std::vector<std::vector<PixelCoordinate>> mergeAttractors(
-      const std::unordered_map<PixelCoordinate, std::vector<PixelCoordinate>>& attractors) const;
-
+  /**
+   * Groups the pixels of the source by attractor
+   * @param pixel_list
+   *    Pixel coordinates of the source
+   * @param bbox_min
+   *    Coordinates of the first pixel of the stamp
+   * @param values
+   *    Stamp values, row major
+   * @param width
+   *    Stamp width
+   * @param height
+   *    Stamp height
+   */
+  std::vector<std::vector<PixelCoordinate>> attractPixels(
+      const std::vector<PixelCoordinate>& pixel_list, PixelCoordinate bbox_min,
+      const std::vector<DetectionImage::PixelType>& values, int width, int height) const;
 
 }; /* End of AttractorsPartitionStep class */
 
@@ -23,14 +23,22 @@
 #ifndef _SEIMPLEMENTATION_PROPERTY_DETECTIONFRAMESOURCESTAMP_H
 #define _SEIMPLEMENTATION_PROPERTY_DETECTIONFRAMESOURCESTAMP_H
 
+#include <array>
+#include <memory>
+
 #include "SEFramework/Property/Property.h"
 #include "SEFramework/Image/Image.h"
+#include "SEImplementation/Plugin/DetectionFrameImages/DetectionFrameImages.h"
 
 namespace SourceXtractor {
 
 /**
  * @class DetectionFrameSourceStamp
  * @brief A copy of the rectangular region of the detection image just large enough to include the whole Source
+ *
+ * @details
+ * When created from the detection frame images, each layer is only read the first time it is requested,
+ * into a single arena for the whole stamp. The layers a measurement never looks at are not read.
  */
 
 class DetectionFrameSourceStamp : public Property {
@@ -45,33 +53,35 @@ public:
   DetectionFrameSourceStamp(std::shared_ptr<DetectionImage> stamp, std::shared_ptr<DetectionImage> filtered_stamp,
       std::shared_ptr<DetectionImage> thresholded_stamp, PixelCoordinate top_left,
       std::shared_ptr<WeightImage> variance_stamp, std::shared_ptr<DetectionImage> threshold_map_stamp) :
-        m_stamp(stamp), m_filtered_stamp(filtered_stamp), m_thresholded_stamp(thresholded_stamp),
-        m_threshold_map_stamp(threshold_map_stamp), m_variance_stamp(variance_stamp),
+        m_layers{{stamp, filtered_stamp, thresholded_stamp, variance_stamp, threshold_map_stamp}},
         m_top_left(top_left) {}
 
+  /// Stamp of width x height pixels starting at top_left, with the layers read on demand
+  DetectionFrameSourceStamp(const DetectionFrameImages& images, PixelCoordinate top_left, int width, int height);
+
   // Returns the stamp image
   const DetectionImage& getStamp() const {
-    return *m_stamp;
+    return getLayer(0);
   }
 
   // Returns the filtered stamp image
   const DetectionImage& getFilteredStamp() const {
-    return *m_filtered_stamp;
+    return getLayer(1);
   }
 
   // Returns the filtered and thresholded stamp image
   const DetectionImage& getThresholdedStamp() const {
-    return *m_thresholded_stamp;
+    return getLayer(2);
   }
 
   // Returns the threshold map stamp
   const DetectionImage& getThresholdMapStamp() const {
-    return *m_threshold_map_stamp;
+    return getLayer(4);
   }
 
   // Returns the stamp's associated weight image
   const DetectionImage& getVarianceStamp() const {
-    return *m_variance_stamp;
+    return getLayer(3);
   }
 
   PixelCoordinate getTopLeft() const {
@@ -79,9 +89,15 @@ public:
   }
 
 private:
-  std::shared_ptr<DetectionImage> m_stamp, m_filtered_stamp, m_thresholded_stamp;
-  std::shared_ptr<DetectionImage> m_threshold_map_stamp;
-  std::shared_ptr<WeightImage> m_variance_stamp;
+  static const int s_nlayers = 5;
+
+  /// State of the layers read on demand
+  struct LazyLayers;
+
+  const DetectionImage& getLayer(int index) const;
+
+  std::array<std::shared_ptr<DetectionImage>, s_nlayers> m_layers;
+  std::shared_ptr<LazyLayers> m_lazy;
   PixelCoordinate m_top_left;
 
 }; /* End of DetectionFrameSourceStamp class */
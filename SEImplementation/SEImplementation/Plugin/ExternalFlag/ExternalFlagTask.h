@@ -23,6 +23,9 @@
 #ifndef _SEIMPLEMENTATION_TASK_EXTERNALFLAGTASK_H
 #define _SEIMPLEMENTATION_TASK_EXTERNALFLAGTASK_H
 
+#include <atomic>
+#include <memory>
+
 #include "SEFramework/Task/SourceTask.h"
 #include "SEFramework/Image/Image.h"
 #include "SEFramework/Source/SourceWithOnDemandProperties.h"
@@ -54,10 +57,27 @@ public:
 
   void computeProperties(SourceInterface& source) const override;
 
+  bool declaresDependencies() const override {
+    return true;
+  }
+
+  std::vector<PropertyId> getDependencies() const override;
+
 private:
-  
+
+  /// Side of the square blocks of the flag image checked for being entirely zero
+  static const int s_block_size = 256;
+
+  /// true if all the blocks overlapping the given box contain only zeros
+  bool isZero(int min_x, int min_y, int max_x, int max_y) const;
+
   std::shared_ptr<FlagImage> m_flag_image;
   unsigned int m_flag_instance;
+
+  /// Per block state: 0 not checked yet, 1 all zeros, 2 some flag set. Written once per block,
+  /// so sources lying on clean blocks do not need to touch the flag image
+  int m_blocks_x, m_blocks_y;
+  std::unique_ptr<std::atomic<char>[]> m_block_state;
   
 };
 
@@ -41,10 +41,11 @@ class FlexibleModelFitting : public Property {
 public:
   virtual ~FlexibleModelFitting() = default;
 
-  FlexibleModelFitting(unsigned int iterations, SeFloat chi_squared, Flags flags,
+  FlexibleModelFitting(unsigned int iterations, SeFloat chi_squared, SeFloat source_chi_squared, Flags flags,
       std::unordered_map<int, double> parameter_values, std::unordered_map<int, double> parameter_sigmas) :
     m_iterations(iterations),
     m_chi_squared(chi_squared),
+    m_source_chi_squared(source_chi_squared),
     m_flags(flags),
     m_parameter_values(parameter_values),
     m_parameter_sigmas(parameter_sigmas) {}
@@ -57,6 +58,11 @@ public:
     return m_chi_squared;
   }
 
+  /// Reduced chi squared within the footprint of the source, with only its own free parameters
+  SeFloat getSourceReducedChiSquared() const {
+    return m_source_chi_squared;
+  }
+
   Flags getFlags() const {
     return m_flags;
   }
@@ -72,6 +78,7 @@ public:
 private:
   unsigned int m_iterations;
   SeFloat m_chi_squared;
+  SeFloat m_source_chi_squared;
   Flags m_flags;
   std::unordered_map<int, double> m_parameter_values;
   std::unordered_map<int, double> m_parameter_sigmas;
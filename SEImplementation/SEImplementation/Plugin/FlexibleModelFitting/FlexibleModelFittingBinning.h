@@ -0,0 +1,67 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * FlexibleModelFittingBinning.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef _SEIMPLEMENTATION_PLUGIN_FLEXIBLEMODELFITTING_FLEXIBLEMODELFITTINGBINNING_H_
+#define _SEIMPLEMENTATION_PLUGIN_FLEXIBLEMODELFITTING_FLEXIBLEMODELFITTINGBINNING_H_
+
+#include <memory>
+
+#include "SEFramework/Image/VectorImage.h"
+
+namespace SourceXtractor {
+
+/// Coarse stamps smaller than this, on either axis, are not worth fitting
+constexpr int MIN_BINNED_STAMP_SIZE = 16;
+
+/**
+ * Image and weights of a stamp, binned for a coarse fitting pass
+ */
+struct BinnedStamp {
+  std::shared_ptr<VectorImage<SeFloat>> m_image, m_weight;
+};
+
+/**
+ * Bin a stamp adding up blocks of binning x binning pixels, so the flux is preserved.
+ * The variances are added up as well, and the weight of a block is 0 if any of its pixels
+ * has a weight of 0. Pixels on the right and bottom edges that do not fill a block are dropped.
+ * @param weight
+ *    Weights as the inverse of the standard deviation of each pixel
+ */
+BinnedStamp binStamp(const VectorImage<SeFloat>& image, const VectorImage<SeFloat>& weight, int binning);
+
+/**
+ * Resample a PSF on a grid binning times coarser, keeping it centered: each coarse pixel integrates
+ * a box binning pixels wide centered on the matching fine pixel. The result has still an odd size,
+ * and the same sum as the original kernel.
+ */
+std::shared_ptr<VectorImage<SeFloat>> binPsf(const VectorImage<SeFloat>& psf, int binning);
+
+/**
+ * @return
+ *    How many times, up to max_levels, a stamp of the given size can be binned by 2
+ *    while staying at least MIN_BINNED_STAMP_SIZE pixels wide and high
+ */
+unsigned int coarseLevels(int width, int height, unsigned int max_levels);
+
+}
+
+#endif /* _SEIMPLEMENTATION_PLUGIN_FLEXIBLEMODELFITTING_FLEXIBLEMODELFITTINGBINNING_H_ */
@@ -53,6 +53,12 @@ public:
                             std::shared_ptr<CoordinateSystem> reference_coordinates,
                             std::shared_ptr<CoordinateSystem> coordinates, PixelCoordinate offset) const = 0;
 
+  /// Half size, in detection frame pixels, of the region around the source where the model is expected to have
+  /// some flux, given the current value of its parameters. The PSF is not taken into account.
+  virtual double getExtent(FlexibleModelFittingParameterManager& /*manager*/, const SourceInterface& /*source*/) const {
+    return 0;
+  }
+
 private:
 };
 
@@ -105,6 +111,8 @@ public:
                             std::shared_ptr<CoordinateSystem> reference_coordinates,
                             std::shared_ptr<CoordinateSystem> coordinates, PixelCoordinate offset) const;
 
+  double getExtent(FlexibleModelFittingParameterManager& manager, const SourceInterface& source) const override;
+
 private:
   std::shared_ptr<FlexibleModelFittingParameter> m_x;
   std::shared_ptr<FlexibleModelFittingParameter> m_y;
@@ -121,13 +129,15 @@ public:
                                   std::shared_ptr<FlexibleModelFittingParameter> flux,
                                   std::shared_ptr<FlexibleModelFittingParameter> effective_radius,
                                   std::shared_ptr<FlexibleModelFittingParameter> aspect_ratio,
-                                  std::shared_ptr<FlexibleModelFittingParameter> angle)
+                                  std::shared_ptr<FlexibleModelFittingParameter> angle,
+                                  double lut_tolerance = 1e-3)
       : m_x(x),
         m_y(y),
         m_flux(flux),
         m_effective_radius(effective_radius),
         m_aspect_ratio(aspect_ratio),
-        m_angle(angle) {}
+        m_angle(angle),
+        m_lut_tolerance(lut_tolerance) {}
 
   virtual ~FlexibleModelFittingDevaucouleursModel() {}
 
@@ -140,6 +150,8 @@ public:
                             std::shared_ptr<CoordinateSystem> reference_coordinates,
                             std::shared_ptr<CoordinateSystem> coordinates, PixelCoordinate offset) const;
 
+  double getExtent(FlexibleModelFittingParameterManager& manager, const SourceInterface& source) const override;
+
 private:
   std::shared_ptr<FlexibleModelFittingParameter> m_x;
   std::shared_ptr<FlexibleModelFittingParameter> m_y;
@@ -147,6 +159,8 @@ private:
   std::shared_ptr<FlexibleModelFittingParameter> m_effective_radius;
   std::shared_ptr<FlexibleModelFittingParameter> m_aspect_ratio;
   std::shared_ptr<FlexibleModelFittingParameter> m_angle;
+  // Relative error allowed when tabulating the profile, 0 to evaluate it exactly
+  double m_lut_tolerance;
 };
 
 class FlexibleModelFittingSersicModel : public FlexibleModelFittingModel {
@@ -157,14 +171,16 @@ public:
                                   std::shared_ptr<FlexibleModelFittingParameter> sersic_index,
                                   std::shared_ptr<FlexibleModelFittingParameter> effective_radius,
                                   std::shared_ptr<FlexibleModelFittingParameter> aspect_ratio,
-                                  std::shared_ptr<FlexibleModelFittingParameter> angle)
+                                  std::shared_ptr<FlexibleModelFittingParameter> angle,
+                                  double lut_tolerance = 1e-3)
       : m_x(x),
         m_y(y),
         m_flux(flux),
         m_sersic_index(sersic_index),
         m_effective_radius(effective_radius),
         m_aspect_ratio(aspect_ratio),
-        m_angle(angle) {}
+        m_angle(angle),
+        m_lut_tolerance(lut_tolerance) {}
 
   virtual ~FlexibleModelFittingSersicModel() {}
 
@@ -177,6 +193,8 @@ public:
                             std::shared_ptr<CoordinateSystem> reference_coordinates,
                             std::shared_ptr<CoordinateSystem> coordinates, PixelCoordinate offset) const;
 
+  double getExtent(FlexibleModelFittingParameterManager& manager, const SourceInterface& source) const override;
+
 private:
   std::shared_ptr<FlexibleModelFittingParameter> m_x;
   std::shared_ptr<FlexibleModelFittingParameter> m_y;
@@ -185,6 +203,8 @@ private:
   std::shared_ptr<FlexibleModelFittingParameter> m_effective_radius;
   std::shared_ptr<FlexibleModelFittingParameter> m_aspect_ratio;
   std::shared_ptr<FlexibleModelFittingParameter> m_angle;
+  // Relative error allowed when tabulating the profile, 0 to evaluate it exactly
+  double m_lut_tolerance;
 };
 
 class FlexibleModelFittingConstantModel : public FlexibleModelFittingModel {
@@ -0,0 +1,54 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * FlexibleModelFittingPartition.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef _SEIMPLEMENTATION_PLUGIN_FLEXIBLEMODELFITTING_FLEXIBLEMODELFITTINGPARTITION_H_
+#define _SEIMPLEMENTATION_PLUGIN_FLEXIBLEMODELFITTING_FLEXIBLEMODELFITTINGPARTITION_H_
+
+#include <vector>
+
+#include "SEUtils/PixelCoordinate.h"
+
+namespace SourceXtractor {
+
+/**
+ * Expected footprint of a model, as an inclusive bounding box in pixel coordinates
+ */
+struct FittingFootprint {
+  PixelCoordinate m_min, m_max;
+
+  bool overlaps(const FittingFootprint& other) const {
+    return !(m_min.m_x > other.m_max.m_x || m_max.m_x < other.m_min.m_x ||
+             m_min.m_y > other.m_max.m_y || m_max.m_y < other.m_min.m_y);
+  }
+};
+
+/**
+ * Split a set of footprints into the connected components of their overlap graph. Models
+ * on different components do not share any pixel, so they can be fitted independently.
+ * @return
+ *    The indexes of the footprints belonging to each component, ordered by their first member
+ */
+std::vector<std::vector<std::size_t>> partitionFootprints(const std::vector<FittingFootprint>& footprints);
+
+}
+
+#endif /* _SEIMPLEMENTATION_PLUGIN_FLEXIBLEMODELFITTING_FLEXIBLEMODELFITTINGPARTITION_H_ */
@@ -0,0 +1,91 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * FlexibleModelFittingSeedCatalog.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef _SEIMPLEMENTATION_PLUGIN_FLEXIBLEMODELFITTING_FLEXIBLEMODELFITTINGSEEDCATALOG_H_
+#define _SEIMPLEMENTATION_PLUGIN_FLEXIBLEMODELFITTING_FLEXIBLEMODELFITTINGSEEDCATALOG_H_
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace SourceXtractor {
+
+/**
+ * @class FlexibleModelFittingSeedCatalog
+ * @brief
+ *  Fitted values from a previous run, used as the starting point of the fit of the matching sources
+ *
+ * @details
+ *  Sources are matched either by their identifier, which is only meaningful if the detection did not
+ *  change, or by the closest position within a maximum distance.
+ */
+class FlexibleModelFittingSeedCatalog {
+public:
+
+  enum class MatchBy {
+    ID, POSITION
+  };
+
+  /// One row of the previous catalog
+  struct Seed {
+    unsigned int m_id;
+    double m_x, m_y;
+    /// Indexed by parameter id
+    std::unordered_map<int, double> m_values;
+  };
+
+  /**
+   * Constructor
+   * @param seeds
+   *    Rows of the previous catalog
+   * @param match_by
+   *    How to match the sources with the seeds
+   * @param max_distance
+   *    Maximum distance, in pixels, when matching by position
+   */
+  FlexibleModelFittingSeedCatalog(std::vector<Seed> seeds, MatchBy match_by, double max_distance);
+
+  /**
+   * @return
+   *    The values of the seed matching the given source, or nullptr if there is none.
+   *    The position must use the same convention as the catalog
+   */
+  const std::unordered_map<int, double>* find(unsigned int id, double x, double y) const;
+
+  std::size_t size() const {
+    return m_seeds.size();
+  }
+
+private:
+  std::int64_t cellKey(int cell_x, int cell_y) const;
+
+  std::vector<Seed> m_seeds;
+  MatchBy m_match_by;
+  double m_max_distance;
+  std::unordered_map<unsigned int, std::size_t> m_by_id;
+  /// Seeds bucketed in cells of max_distance side, so only the neighbouring cells need to be checked
+  std::unordered_map<std::int64_t, std::vector<std::size_t>> m_by_cell;
+};
+
+} // end of namespace SourceXtractor
+
+#endif /* _SEIMPLEMENTATION_PLUGIN_FLEXIBLEMODELFITTING_FLEXIBLEMODELFITTINGSEEDCATALOG_H_ */
@@ -24,6 +24,10 @@
 #ifndef _SEIMPLEMENTATION_PLUGIN_FLEXIBLEMODELFITTING_FLEXIBLEMODELFITTINGTASK_H_
 #define _SEIMPLEMENTATION_PLUGIN_FLEXIBLEMODELFITTING_FLEXIBLEMODELFITTINGTASK_H_
 
+#include <functional>
+#include <map>
+#include <unordered_map>
+
 #include "ModelFitting/Models/FrameModel.h"
 
 #include "SEImplementation/Image/ImagePsf.h"
@@ -35,6 +39,8 @@
 #include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingParameter.h"
 #include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingFrame.h"
 #include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingPrior.h"
+#include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingSeedCatalog.h"
+#include "SEImplementation/Plugin/MeasurementFrameGroupRectangle/MeasurementFrameGroupRectangle.h"
 
 namespace SourceXtractor {
 
@@ -46,7 +52,12 @@ public:
       std::vector<std::shared_ptr<FlexibleModelFittingParameter>> parameters,
       std::vector<std::shared_ptr<FlexibleModelFittingFrame>> frames,
       std::vector<std::shared_ptr<FlexibleModelFittingPrior>> priors,
-      double scale_factor=1.0
+      double scale_factor=1.0,
+      unsigned int split_group_size=0,
+      bool joint_refinement=false,
+      unsigned int jacobian_threads=0,
+      unsigned int coarse_levels=0,
+      std::shared_ptr<FlexibleModelFittingSeedCatalog> seed_catalog=nullptr
       );
 
   virtual ~FlexibleModelFittingTask();
@@ -55,26 +66,75 @@ public:
 
 private:
 
-  bool isFrameValid(SourceGroupInterface& group, int frame_index) const;
+  /// Sources fitted together, and the region of each frame used to fit them
+  struct FittingProblem {
+    std::vector<std::reference_wrapper<SourceInterface>> m_sources;
+    /// Indexed by frame number
+    std::map<int, MeasurementFrameGroupRectangle> m_regions;
+    /// Footprints of sources fitted on a different problem, ignored by the fit. Indexed by frame number
+    std::map<int, std::vector<MeasurementFrameGroupRectangle>> m_excluded;
+  };
+
+  /// Parameters, residuals and outcome of the fitting of one problem
+  struct FittingState;
+
+  /// Fitted parameter values for each source, used to initialize a refinement pass
+  using FittedValues = std::map<const SourceInterface*, std::unordered_map<int, double>>;
+
+  FittingProblem createGroupProblem(SourceGroupInterface& group) const;
+
+  /// Values of the sources of the group found on the seed catalog
+  FittedValues findSeeds(SourceGroupInterface& group) const;
+
+  /// Split the group into sets of sources whose expected footprints do not overlap. The footprints cover
+  /// the extent of the models, given the initial value of their parameters
+  std::vector<FittingProblem> partitionGroup(SourceGroupInterface& group, const FittingProblem& group_problem,
+      const FittedValues* initial_values) const;
 
-  std::shared_ptr<VectorImage<SeFloat>> createImageCopy(SourceGroupInterface& group, int frame_index) const;
-  std::shared_ptr<VectorImage<SeFloat>> createWeightImage(SourceGroupInterface& group, int frame_index) const;
+  void fitProblems(SourceGroupInterface& group, const std::vector<FittingProblem>& problems,
+      const FittedValues* initial_values, bool check_images, FittedValues* fitted_values) const;
+
+  /// Fit the problems on binned stamps, from the coarsest level, accumulating the solutions into values
+  void fitCoarseLevels(SourceGroupInterface& group, const std::vector<FittingProblem>& problems,
+      FittedValues& values) const;
+
+  /// Number of coarse levels a problem can be fitted on, given the size of its stamps
+  unsigned int coarseLevels(const FittingProblem& problem) const;
+
+  /// A replica of a problem is prepared with its original as shared_stamps, so that the stamps, which
+  /// are only read by the fit, are not copied again. Only the parameters and models are its own
+  void prepareProblem(SourceGroupInterface& group, const FittingProblem& problem, FittingState& state,
+      const FittedValues* initial_values, int binning = 1, const FittingState* shared_stamps = nullptr) const;
+  void solveProblem(FittingState& state) const;
+  void solveProblems(std::vector<std::unique_ptr<FittingState>>& states) const;
+  void finishProblem(SourceGroupInterface& group, const FittingProblem& problem, FittingState& state,
+      bool check_images, FittedValues* fitted_values) const;
+
+  bool isFrameValid(const FittingProblem& problem, int frame_index) const;
+
+  std::shared_ptr<VectorImage<SeFloat>> createImageCopy(SourceGroupInterface& group, const FittingProblem& problem,
+      int frame_index) const;
+  std::shared_ptr<VectorImage<SeFloat>> createWeightImage(SourceGroupInterface& group, const FittingProblem& problem,
+      int frame_index) const;
 
   ModelFitting::FrameModel<ImagePsf, std::shared_ptr<VectorImage<SourceXtractor::SeFloat>>> createFrameModel(
-      SourceGroupInterface& group,
-      double pixel_scale, FlexibleModelFittingParameterManager& manager, std::shared_ptr<FlexibleModelFittingFrame> frame) const;
+      SourceGroupInterface& group, const FittingProblem& problem,
+      double pixel_scale, FlexibleModelFittingParameterManager& manager, std::shared_ptr<FlexibleModelFittingFrame> frame,
+      int binning = 1) const;
 
-  void createParameters() const;
+  void createParameters(const FittingProblem& problem, FittingState& state) const;
+  /// Start the free parameters from a previous solution, if any
+  void setInitialValues(const FittingProblem& problem, FittingState& state, const FittedValues& initial_values) const;
 
-  void updateCheckImages(SourceGroupInterface& group,
-      double pixel_scale, FlexibleModelFittingParameterManager& manager) const;
+  /// Chi squared of the solution over the whole problem, and within the footprint of each source
+  struct ChiSquared;
 
-  SeFloat computeChiSquaredForFrame(std::shared_ptr<const Image<SeFloat>> image,
-      std::shared_ptr<const Image<SeFloat>> model, std::shared_ptr<const Image<SeFloat>> weights, int& data_points) const;
-  SeFloat computeChiSquared(SourceGroupInterface& group,
-      double pixel_scale, FlexibleModelFittingParameterManager& manager, int& total_data_points) const;
+  /// Computes the chi squared from the residuals returned with the solution. The same pass over the stamps
+  /// adds the models rendered for the solution to the check images
+  ChiSquared computeChiSquared(SourceGroupInterface& group, const FittingProblem& problem, const FittingState& state,
+      bool check_images) const;
 
-  void setDummyProperty(SourceGroupInterface& group, FlexibleModelFittingParameterManager& parameter_manager, Flags flags) const;
+  void setDummyProperty(const FittingProblem& problem, FlexibleModelFittingParameterManager& parameter_manager, Flags flags) const;
 
   // Task configuration
   std::string m_least_squares_engine;
@@ -86,6 +146,18 @@ private:
   std::vector<std::shared_ptr<FlexibleModelFittingPrior>> m_priors;
 
   double m_scale_factor;
+
+  /// Groups with at least this many sources are split into independent problems. 0 disables the split
+  unsigned int m_split_group_size;
+  /// Fit the whole group again after the independent problems, starting from their solution
+  bool m_joint_refinement;
+  /// Threads a group can use: to compute the Jacobian when it is fitted as a single problem, or else to solve
+  /// its independent problems concurrently. 0 or 1 fits on the measurement thread only
+  unsigned int m_jacobian_threads;
+  /// Fit first on stamps binned by 2, 4... up to this many levels, and seed each level with the previous one
+  unsigned int m_coarse_levels;
+  /// Values of a previous run to start the fits from, if any
+  std::shared_ptr<FlexibleModelFittingSeedCatalog> m_seed_catalog;
 };
 
 }
@@ -55,6 +55,11 @@ private:
   std::vector<std::shared_ptr<FlexibleModelFittingPrior>> m_priors;
 
   double m_scale_factor {1.0};
+  unsigned int m_split_group_size {0};
+  bool m_joint_refinement {false};
+  unsigned int m_jacobian_threads {0};
+  unsigned int m_coarse_levels {0};
+  std::shared_ptr<FlexibleModelFittingSeedCatalog> m_seed_catalog;
 };
 
 }
@@ -18,7 +18,9 @@
 #ifndef _SEIMPLEMENTATION_PLUGIN_GROWTHCURVE_GROWTHCURVE_H_
 #define _SEIMPLEMENTATION_PLUGIN_GROWTHCURVE_GROWTHCURVE_H_
 
+#include <algorithm>
 #include <vector>
+#include "SEFramework/Image/Image.h"
 #include "SEFramework/Property/Property.h"
 
 namespace SourceXtractor {
@@ -47,6 +49,53 @@ public:
     return m_step_size;
   }
 
+  /**
+   * Flux within the given radius, interpolated linearly between the two closest samples, or
+   * extrapolated from the first or last two
+   */
+  double getFlux(double radius) const {
+    if (m_growth_curve.size() < 2) {
+      return m_growth_curve.empty() ? 0. : m_growth_curve.front();
+    }
+    // sample i corresponds to the radius (i + 1) * step_size
+    double pos = radius / m_step_size - 1;
+    size_t i = pos > 0 ? std::min(static_cast<size_t>(pos), m_growth_curve.size() - 2) : 0;
+    double frac = pos - i;
+    return m_growth_curve[i] + frac * (m_growth_curve[i + 1] - m_growth_curve[i]);
+  }
+
+  /**
+   * Radius that contains the given flux. The accumulated flux is not strictly increasing, so this
+   * is interpolated from the first sample where the accumulated flux is >= the target flux and the
+   * previous one
+   */
+  SeFloat getRadius(double target_flux) const {
+    auto next = std::find_if(std::begin(m_growth_curve), std::end(m_growth_curve),
+                             [target_flux](double v) { return v >= target_flux; });
+    if (next == std::end(m_growth_curve)) {
+      --next;
+    }
+    size_t next_i = std::distance(std::begin(m_growth_curve), next);
+
+    SeFloat y0, y1;
+    DetectionImage::PixelType x0, x1;
+
+    x1 = *next;
+    y1 = (next_i + 1) * m_step_size;
+    if (next_i > 0) {
+      x0 = *(next - 1);
+      y0 = next_i * m_step_size;
+    }
+    else {
+      x0 = 0;
+      y0 = 0;
+    }
+
+    SeFloat slope = (y1 - y0) / (x1 - x0);
+    SeFloat target_radius = y0 + (target_flux - x0) * slope;
+    return std::min(target_radius, static_cast<SeFloat>(m_growth_curve.size() * m_step_size));
+  }
+
 private:
   std::vector<double> m_growth_curve;
   double m_max, m_step_size;
@@ -46,6 +46,12 @@ public:
 
   virtual void computeProperties(SourceInterface& source) const override;
 
+  bool declaresDependencies() const override {
+    return true;
+  }
+
+  std::vector<PropertyId> getDependencies() const override;
+
 
 private:
   SeFloat m_magnitude_zero_point;
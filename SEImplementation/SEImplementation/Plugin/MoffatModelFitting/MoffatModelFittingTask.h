@@ -33,17 +33,27 @@ namespace SourceXtractor {
 class MoffatModelFittingTask : public SourceTask {
 
 public:
-  MoffatModelFittingTask(const std::string& least_squares_engine, unsigned int max_iterations)
-    : m_least_squares_engine(least_squares_engine), m_max_iterations(max_iterations) {}
+  MoffatModelFittingTask(const std::string& least_squares_engine, unsigned int max_iterations,
+                         unsigned int coarse_levels = 0)
+    : m_least_squares_engine(least_squares_engine), m_max_iterations(max_iterations),
+      m_coarse_levels(coarse_levels) {}
 
   virtual ~MoffatModelFittingTask() = default;
 
   virtual void computeProperties(SourceInterface& source) const override;
 
+  bool declaresDependencies() const override {
+    return true;
+  }
+
+  std::vector<PropertyId> getDependencies() const override;
+
 private:
 
   std::string m_least_squares_engine;
   unsigned int m_max_iterations;
+  /// Fit first on stamps binned by 2, 4... up to this many levels, and seed each level with the previous one
+  unsigned int m_coarse_levels;
 };
 
 }
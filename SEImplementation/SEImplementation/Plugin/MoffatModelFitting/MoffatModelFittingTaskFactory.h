@@ -47,6 +47,7 @@ public:
 private:
   std::string m_least_squares_engine{"levmar"};
   unsigned int m_max_iterations {0};
+  unsigned int m_coarse_levels {0};
 };
 
 }
@@ -36,6 +36,12 @@ public:
 
   virtual void computeProperties(SourceInterface& source) const override;
 
+  bool declaresDependencies() const override {
+    return true;
+  }
+
+  std::vector<PropertyId> getDependencies() const override;
+
 private:
 
 };
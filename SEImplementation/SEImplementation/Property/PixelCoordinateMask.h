@@ -0,0 +1,78 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * @file PixelCoordinateMask.h
+ */
+
+#ifndef _SEIMPLEMENTATION_PIXELCOORDINATEMASK_H
+#define _SEIMPLEMENTATION_PIXELCOORDINATEMASK_H
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include "SEUtils/PixelCoordinate.h"
+
+namespace SourceXtractor {
+
+/**
+ * @class PixelCoordinateMask
+ * @brief
+ *  Bitmap over the bounding box of a set of pixel coordinates, for constant time membership tests
+ *  where PixelCoordinateList::contains would scan the whole list.
+ */
+class PixelCoordinateMask {
+public:
+
+  explicit PixelCoordinateMask(const std::vector<PixelCoordinate>& coordinates)
+    : m_min_x(0), m_min_y(0), m_width(0), m_height(0) {
+    if (coordinates.empty()) {
+      return;
+    }
+    int max_x = std::numeric_limits<int>::min(), max_y = std::numeric_limits<int>::min();
+    m_min_x = m_min_y = std::numeric_limits<int>::max();
+    for (auto& coord : coordinates) {
+      m_min_x = std::min(m_min_x, coord.m_x);
+      m_min_y = std::min(m_min_y, coord.m_y);
+      max_x = std::max(max_x, coord.m_x);
+      max_y = std::max(max_y, coord.m_y);
+    }
+    m_width = max_x - m_min_x + 1;
+    m_height = max_y - m_min_y + 1;
+    m_mask.resize(m_width * m_height, false);
+    for (auto& coord : coordinates) {
+      m_mask[(coord.m_x - m_min_x) + (coord.m_y - m_min_y) * m_width] = true;
+    }
+  }
+
+  bool contains(int x, int y) const {
+    x -= m_min_x;
+    y -= m_min_y;
+    return x >= 0 && y >= 0 && x < m_width && y < m_height && m_mask[x + y * m_width];
+  }
+
+  bool contains(const PixelCoordinate& coord) const {
+    return contains(coord.m_x, coord.m_y);
+  }
+
+private:
+  int m_min_x, m_min_y, m_width, m_height;
+  std::vector<bool> m_mask;
+};
+
+} /* namespace SourceXtractor */
+
+#endif /* _SEIMPLEMENTATION_PIXELCOORDINATEMASK_H */
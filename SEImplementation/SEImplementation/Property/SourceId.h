@@ -40,6 +40,11 @@ public:
       : m_source_id(getNewId()), m_detection_id(m_source_id) {
   }
 
+  // Restores a source identifier from a previous run
+  SourceId(unsigned int source_id, unsigned int detection_id)
+      : m_source_id(source_id), m_detection_id(detection_id) {
+  }
+
   virtual ~SourceId() = default;
 
   unsigned int getSourceId() const {
@@ -25,6 +25,7 @@
 #ifndef _SEIMPLEMENTATION_SEGMENTATION_BGCONVOLUTIONIMAGESOURCE_H_
 #define _SEIMPLEMENTATION_SEGMENTATION_BGCONVOLUTIONIMAGESOURCE_H_
 
+#include "SEFramework/Convolution/SeparableConvolution.h"
 #include "SEFramework/Image/MirrorImage.h"
 #include "SEFramework/Image/VectorImage.h"
 #include "SEFramework/Image/ProcessingImageSource.h"
@@ -33,13 +34,28 @@ namespace SourceXtractor {
 
 /**
  * Implement an image source using direct convolution of the filter over the image.
- * This approach is normally faster for small kernels
+ * This approach is normally faster for small kernels.
+ * If the kernel is separable, or has a low rank approximation, it can be applied as a sequence of
+ * row and column passes, which is faster for most detection filters (i.e. gaussian or top-hat)
  */
 class BgConvolutionImageSource : public ProcessingImageSource<DetectionImage::PixelType> {
 public:
+  /**
+   * Constructor
+   * @param image
+   *    Image to filter
+   * @param variance
+   *    Variance map, pixels with a variance above the threshold are masked out
+   * @param threshold
+   *    Variance threshold
+   * @param kernel
+   *    Convolution kernel
+   * @param separable
+   *    If true, apply a low rank approximation of the kernel with 1D passes
+   */
   BgConvolutionImageSource(std::shared_ptr<Image<DetectionImage::PixelType>> image,
                            std::shared_ptr<DetectionImage> variance, SeFloat threshold,
-                           std::shared_ptr<VectorImage<SeFloat>> kernel);
+                           std::shared_ptr<VectorImage<SeFloat>> kernel, bool separable = false);
 
 protected:
 
@@ -52,6 +68,8 @@ private:
   std::shared_ptr<DetectionImage> m_variance;
   SeFloat m_threshold;
   std::shared_ptr<VectorImage<SeFloat>> m_kernel;
+  bool m_use_separable;
+  SeparableKernel<SeFloat> m_separable;
 };
 
 } // end namespace SourceXtractor
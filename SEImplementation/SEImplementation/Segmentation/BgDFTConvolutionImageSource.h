@@ -25,29 +25,48 @@
 #ifndef _SEIMPLEMENTATION_SEGMENTATION_BGDFTCONVOLUTIONIMAGESOURCE_H_
 #define _SEIMPLEMENTATION_SEGMENTATION_BGDFTCONVOLUTIONIMAGESOURCE_H_
 
-#include "SEFramework/Convolution/DFT.h"
-#include "SEFramework/Image/PaddedImage.h"
+#include <list>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+#include "SEFramework/FFT/FFT.h"
 #include "SEFramework/Image/VectorImage.h"
 #include "SEFramework/Image/ProcessingImageSource.h"
 
 namespace SourceXtractor {
 /**
- * Implement an image source using direct convolution of the filter over the image.
- * This approach is normally faster for big kernels
+ * Implement an image source using the Discrete Fourier Transform to convolve the filter over the image.
+ * This approach is normally faster for big kernels.
+ *
+ * The image is filtered in blocks of several horizontally consecutive tiles using overlap-save:
+ * each block is read (in bulk) together with a margin of half the kernel size, the masked image and the
+ * mask are convolved with a single batched transform, and only the part of the result not affected by the
+ * circular wrap-around is kept. Since Lutz requests the tiles row by row, the tiles computed ahead are kept
+ * until they are requested, so each pixel is transformed only once.
  */
 class BgDFTConvolutionImageSource : public ProcessingImageSource<DetectionImage::PixelType> {
 public:
+  /**
+   * Constructor
+   * @param image
+   *    Image to filter
+   * @param variance
+   *    Variance map, pixels with a variance above the threshold are masked out
+   * @param threshold
+   *    Variance threshold
+   * @param kernel
+   *    Convolution kernel
+   * @param tiles_per_block
+   *    How many tiles are filtered together with a single transform
+   */
   BgDFTConvolutionImageSource(std::shared_ptr<Image<DetectionImage::PixelType>> image,
                               std::shared_ptr<DetectionImage> variance, SeFloat threshold,
-                              std::shared_ptr<VectorImage<SeFloat>> kernel);
+                              std::shared_ptr<VectorImage<SeFloat>> kernel, int tiles_per_block = 4);
 
 protected:
-
-  // Constant padded
-  using PaddedType = PaddedImage<DetectionImage::PixelType>;
-
-  // Discrete Fourier Transform convolution, which is faster for big kernels
-  using ConvolutionType = DFTConvolution<DetectionImage::PixelType, PaddedType>;
+  using PixelType = DetectionImage::PixelType;
+  using complex_t = FFT<PixelType>::complex_t;
 
   std::string getRepr() const override;
 
@@ -56,9 +75,26 @@ protected:
                     int start_x, int start_y, int width, int height) const override;
 
 private:
+  using TileKey = std::tuple<int, int, int, int>;
+
+  /// Transform of the kernel for the given (padded) block size, computed only once per size
+  const std::vector<complex_t>& getKernelTransform(int fft_width, int fft_height) const;
+
+  /// Filter a block of tiles, starting with the given tile, and store those following it for later
+  void filterBlock(const std::shared_ptr<Image<DetectionImage::PixelType>>& image,
+                   VectorImage<DetectionImage::PixelType>& first_tile,
+                   int start_x, int start_y, int width, int height) const;
+
   std::shared_ptr<DetectionImage> m_variance;
   DetectionImage::PixelType m_threshold;
-  ConvolutionType m_convolution;
+  std::shared_ptr<VectorImage<SeFloat>> m_kernel;
+  DetectionImage::PixelType m_kernel_sum;
+  int m_tiles_per_block;
+
+  mutable std::mutex m_mutex;
+  mutable std::map<std::tuple<int, int>, std::vector<complex_t>> m_kernel_transforms;
+  mutable std::map<TileKey, std::shared_ptr<VectorImage<DetectionImage::PixelType>>> m_ready_tiles;
+  mutable std::list<TileKey> m_ready_order;
 };
 
 } // end namespace SourceXtractor
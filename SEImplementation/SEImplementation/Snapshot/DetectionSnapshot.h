@@ -0,0 +1,103 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * DetectionSnapshot.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef _SEIMPLEMENTATION_SNAPSHOT_DETECTIONSNAPSHOT_H_
+#define _SEIMPLEMENTATION_SNAPSHOT_DETECTIONSNAPSHOT_H_
+
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include "SEUtils/Observable.h"
+#include "SEFramework/Background/BackgroundAnalyzer.h"
+#include "SEFramework/Frame/Frame.h"
+#include "SEFramework/Source/SourceFactory.h"
+#include "SEFramework/Source/SourceGroupFactory.h"
+#include "SEFramework/Source/SourceGroupInterface.h"
+
+namespace SourceXtractor {
+
+/**
+ * @class DetectionSnapshotWriter
+ * @brief
+ *  Saves the state of the pipeline right before the measurement, so a later run can repeat the
+ *  measurement without the detection.
+ *
+ * @details
+ *  The snapshot holds the background model of the detection image, and for each group the
+ *  footprint and identifiers of its sources. Everything else about a source is recomputed from those
+ *  and the detection frame. Footprints are stored as runs of consecutive pixels, in the order of the
+ *  pixel lists. The background maps are stored as the meshes they are interpolated from when the
+ *  analyzer provides them, and at full resolution otherwise.
+ *
+ *  The file is written in the native byte order, with a mark the reader checks to refuse a file
+ *  written with a different one.
+ */
+class DetectionSnapshotWriter : public Observer<std::shared_ptr<SourceGroupInterface>> {
+public:
+
+  explicit DetectionSnapshotWriter(const std::string& path);
+
+  virtual ~DetectionSnapshotWriter() = default;
+
+  /// Must be called once, before any group
+  void writeBackground(const BackgroundModel& background_model);
+
+  void handleMessage(const std::shared_ptr<SourceGroupInterface>& group) override;
+
+  /// Marks the end of the groups, and closes the file
+  void close();
+
+private:
+  std::string m_path;
+  std::ofstream m_stream;
+};
+
+/**
+ * @class DetectionSnapshotReader
+ * @brief
+ *  Replays the groups saved by DetectionSnapshotWriter
+ */
+class DetectionSnapshotReader : public Observable<std::shared_ptr<SourceGroupInterface>> {
+public:
+
+  DetectionSnapshotReader(const std::string& path, std::shared_ptr<SourceFactory> source_factory,
+                          std::shared_ptr<SourceGroupFactory> group_factory);
+
+  virtual ~DetectionSnapshotReader() = default;
+
+  /// Must be called once, before processFrame. The size of the detection image must match the saved one
+  BackgroundModel readBackground(int width, int height);
+
+  /// Notifies the observers with each saved group, whose sources are attached to the given frame
+  void processFrame(std::shared_ptr<DetectionImageFrame> frame);
+
+private:
+  std::string m_path;
+  std::ifstream m_stream;
+  std::shared_ptr<SourceFactory> m_source_factory;
+  std::shared_ptr<SourceGroupFactory> m_group_factory;
+};
+
+} /* namespace SourceXtractor */
+
+#endif /* _SEIMPLEMENTATION_SNAPSHOT_DETECTIONSNAPSHOT_H_ */
@@ -25,7 +25,8 @@ from .model_fitting import (RangeType, Range, Unbounded, print_parameters, Const
                             DeVaucouleursModel, print_model_fitting_info, add_prior, set_max_iterations,
                             pixel_to_world_coordinate, radius_to_wc_angle, get_separation_angle, get_position_angle,
                             get_world_position_parameters, get_world_parameters,
-                            set_modified_chi_squared_scale, set_engine)
+                            set_modified_chi_squared_scale, set_engine, set_group_splitting, set_parallel_jacobian,
+                            set_coarse_to_fine, set_seed_catalog, set_sersic_profile_tolerance)
 
 from .aperture import *
 from .output import (add_output_column, print_output_columns)
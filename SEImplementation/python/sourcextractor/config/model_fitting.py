@@ -486,7 +486,9 @@ point_source_model_dict = {}
 sersic_model_dict = {}
 exponential_model_dict = {}
 de_vaucouleurs_model_dict = {}
-params_dict = {"max_iterations": 100, "modified_chi_squared_scale": 10, "engine": ""}
+params_dict = {"max_iterations": 100, "modified_chi_squared_scale": 10, "engine": "",
+               "split_group_size": 0, "joint_refinement": False, "jacobian_threads": 0, "coarse_levels": 0,
+               "seed_catalog": "", "seed_match": "position", "seed_max_distance": 1., "sersic_lut_tolerance": 1e-3}
 
 
 def set_max_iterations(iterations):
@@ -522,6 +524,81 @@ def set_engine(engine):
     params_dict["engine"] = engine
 
 
+def set_group_splitting(min_group_size, joint_refinement=False):
+    """
+    Parameters
+    ----------
+    min_group_size : int
+        Groups with at least this many sources are split into sets of sources whose expected footprints do not
+        overlap, and each set is fitted independently. The footprint of a source covers its detection, and the
+        extent of its models given the initial value of their parameters, plus the PSF. 0 disables the splitting.
+    joint_refinement : bool
+        If True, the whole group is fitted again afterwards, starting from the values found for each set.
+    """
+    params_dict["split_group_size"] = min_group_size
+    params_dict["joint_refinement"] = joint_refinement
+
+
+def set_parallel_jacobian(threads):
+    """
+    Parameters
+    ----------
+    threads : int
+        When a group is fitted as a single problem, compute the columns of the Jacobian on this many threads.
+        Each thread works on its own copy of the models of the group, while the images are shared. 0 or 1
+        disables it, letting the engine approximate the Jacobian itself. When a group is split, this is also the
+        number of threads used to fit its independent sets, so that the measurement threads are not oversubscribed.
+    """
+    params_dict["jacobian_threads"] = threads
+
+
+def set_coarse_to_fine(levels):
+    """
+    Parameters
+    ----------
+    levels : int
+        Fit first on stamps binned by 2**levels, then 2**(levels-1)... down to the full resolution, each level
+        starting from the solution of the previous one. Fewer levels are used when a binned stamp would be
+        smaller than 16 pixels. 0 disables it.
+    """
+    params_dict["coarse_levels"] = levels
+
+
+def set_seed_catalog(path, match_by='position', max_distance=1.):
+    """
+    Parameters
+    ----------
+    path : str
+        Output catalog of a previous run, in FITS or ASCII format. The fit of each matching source starts from the
+        values of the columns added with add_output_column, instead of the initial values of the free parameters.
+        Only columns with one value per source are used.
+    match_by : str
+        'id' to match with the source_id column, which is only meaningful if the detection did not change, or
+        'position' to match with the closest pixel_centroid_x and pixel_centroid_y.
+    max_distance : float
+        Maximum distance, in pixels, when matching by position.
+    """
+    if match_by not in ('id', 'position'):
+        raise ValueError('match_by must be either id or position')
+    params_dict["seed_catalog"] = path
+    params_dict["seed_match"] = match_by
+    params_dict["seed_max_distance"] = max_distance
+
+
+def set_sersic_profile_tolerance(tolerance):
+    """
+    Parameters
+    ----------
+    tolerance : float
+        Maximum relative error allowed when rendering the Sersic and de Vaucouleurs profiles away from their centre
+        from a table, instead of evaluating the profile for every pixel. Defaults to 1e-3. 0 always evaluates the
+        profile exactly.
+    """
+    if tolerance < 0:
+        raise ValueError('tolerance can not be negative')
+    params_dict["sersic_lut_tolerance"] = tolerance
+
+
 class ModelBase(cpp.Id):
     """
     Base class for all models.
@@ -17,11 +17,86 @@
 
 #include "SEImplementation/Background/SE/ReplaceUndefImage.h"
 
+#include <cmath>
+#include <limits>
+
 namespace SourceXtractor {
 
+namespace {
+
+// Marks the pixels with no defined value. Large enough to never win against a real distance,
+// small enough to keep the arithmetic finite
+const double NO_DISTANCE = 1e20;
+
+/**
+ * Lower envelope of the parabolas rooted at each sample, as described by
+ * Felzenszwalb & Huttenlocher, "Distance Transforms of Sampled Functions".
+ * Squared distances are integers well within the mantissa of a double, so the result is exact.
+ */
+void distanceTransform(const std::vector<double>& f, std::vector<double>& d,
+                       std::vector<int>& v, std::vector<double>& z) {
+  int n = f.size();
+  if (n == 0)
+    return;
+  int k = 0;
+  v[0] = 0;
+  z[0] = -std::numeric_limits<double>::infinity();
+  z[1] = std::numeric_limits<double>::infinity();
+  for (int q = 1; q < n; ++q) {
+    double s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2. * (q - v[k]));
+    // z[0] is -inf, so k never goes below 0
+    while (s <= z[k]) {
+      --k;
+      s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2. * (q - v[k]));
+    }
+    ++k;
+    v[k] = q;
+    z[k] = s;
+    z[k + 1] = std::numeric_limits<double>::infinity();
+  }
+  k = 0;
+  for (int q = 0; q < n; ++q) {
+    while (z[k + 1] < q) {
+      ++k;
+    }
+    d[q] = (q - v[k]) * static_cast<double>(q - v[k]) + f[v[k]];
+  }
+}
+
+}
+
 template<typename T>
 ReplaceUndefImage<T>::ReplaceUndefImage(const std::shared_ptr<VectorImage<T>>& image, T invalid)
   : m_image{image}, m_invalid{invalid} {
+  int width = m_image->getWidth(), height = m_image->getHeight();
+  int size = std::max(width, height);
+  std::vector<double> grid(width * height), f(size), d(size), z(size + 1);
+  std::vector<int> v(size);
+
+  // Columns first
+  f.resize(height);
+  d.resize(height);
+  for (int x = 0; x < width; ++x) {
+    for (int y = 0; y < height; ++y) {
+      f[y] = (m_image->getValue(x, y) != m_invalid) ? 0. : NO_DISTANCE;
+    }
+    distanceTransform(f, d, v, z);
+    for (int y = 0; y < height; ++y) {
+      grid[x + y * width] = d[y];
+    }
+  }
+
+  // Then rows
+  f.resize(width);
+  d.resize(width);
+  m_distance.resize(width * height);
+  for (int y = 0; y < height; ++y) {
+    std::copy(grid.begin() + y * width, grid.begin() + (y + 1) * width, f.begin());
+    distanceTransform(f, d, v, z);
+    for (int x = 0; x < width; ++x) {
+      m_distance[x + y * width] = (d[x] < NO_DISTANCE / 2) ? std::llround(d[x]) : -1;
+    }
+  }
 }
 
 template<typename T>
@@ -45,30 +120,40 @@ T ReplaceUndefImage<T>::getValue(int x, int y) const {
   if (v != m_invalid)
     return v;
 
-  auto min_distance = std::numeric_limits<T>::max();
+  auto distance = m_distance[x + y * m_image->getWidth()];
+  if (distance < 0)
+    return 0;
 
   T acc = 0;
   size_t count = 0;
 
-  for (int iy = 0; iy < m_image->getHeight(); ++iy) {
-    for (int ix = 0; ix < m_image->getWidth(); ++ix) {
-      v = m_image->getValue(ix, iy);
-      if (v != m_invalid) {
-        auto dx = x - ix;
-        auto dy = y - iy;
-        auto distance = dx * dx + dy * dy;
-        // This pixel is closer than the last close one, so restart
-        if (distance < min_distance) {
-          acc = v;
-          count = 1;
-          min_distance = distance;
-        }
-        // This pixel is as close as the closest one, so take it into account
-        else if (distance - min_distance <= std::numeric_limits<T>::epsilon()) {
-          acc += v;
+  // Visit, in row-major order, the pixels that lie exactly at the closest distance,
+  // so the sum is accumulated in the same order as a full scan would
+  int radius = static_cast<int>(std::sqrt(static_cast<double>(distance)));
+  while (static_cast<long long>(radius + 1) * (radius + 1) <= distance)
+    ++radius;
+  for (int dy = -radius; dy <= radius; ++dy) {
+    int iy = y + dy;
+    if (iy < 0 || iy >= m_image->getHeight())
+      continue;
+    long long remainder = distance - static_cast<long long>(dy) * dy;
+    int dx = static_cast<int>(std::sqrt(static_cast<double>(remainder)));
+    while (static_cast<long long>(dx) * dx > remainder)
+      --dx;
+    while (static_cast<long long>(dx + 1) * (dx + 1) <= remainder)
+      ++dx;
+    if (static_cast<long long>(dx) * dx != remainder)
+      continue;
+    for (int ix : {x - dx, x + dx}) {
+      if (ix >= 0 && ix < m_image->getWidth()) {
+        v = m_image->getValue(ix, iy);
+        if (v != m_invalid) {
+          acc = (count == 0) ? v : acc + v;
           ++count;
         }
       }
+      if (dx == 0)
+        break;
     }
   }
 
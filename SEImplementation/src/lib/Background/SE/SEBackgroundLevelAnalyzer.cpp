@@ -133,6 +133,7 @@ BackgroundModel SEBackgroundLevelAnalyzer::analyzeBackground(
   SeFloat scaling = 99999;
 
   std::shared_ptr<Image<DetectionImage::PixelType>> final_bg, final_var;
+  std::shared_ptr<BackgroundMesh> level_mesh, variance_mesh;
 
   if (variance_map) {
     // Create histogram model for the variance image
@@ -146,30 +147,39 @@ BackgroundModel SEBackgroundLevelAnalyzer::analyzeBackground(
     // Compute scaling
     scaling = computeScaling(var, weight);
     // Transform RMS to variance
-    final_var = MultiplyImage<DetectionImage::PixelType>::create(var, var);
+    auto var_grid = VectorImage<DetectionImage::PixelType>::create(
+      MultiplyImage<DetectionImage::PixelType>::create(var, var));
     final_var = BufferedImage<DetectionImage::PixelType>::create(
       std::make_shared<ScaledImageSource<DetectionImage::PixelType>>(
-        final_var, image->getWidth(), image->getHeight(),
+        var_grid, image->getWidth(), image->getHeight(),
         ScaledImageSource<DetectionImage::PixelType>::InterpolationType::BICUBIC
       )
     );
+    variance_mesh = BackgroundMesh::create(BackgroundMesh::Interpolation::BICUBIC,
+                                           m_cell_size[0], m_cell_size[1], var_grid);
   }
   else {
     final_var = ConstantImage<DetectionImage::PixelType>::create(image->getWidth(), image->getHeight(),
                                                                  median_sigma * median_sigma);
+    variance_mesh = BackgroundMesh::constant(image->getWidth(), image->getHeight(), median_sigma * median_sigma);
   }
 
   bck_model_logger.info() << "Background for image: " << image->getRepr() << " median: " << median
                           << " rms: " << median_sigma << "!";
 
+  auto mode_grid = VectorImage<DetectionImage::PixelType>::create(mode);
   final_bg = BufferedImage<DetectionImage::PixelType>::create(
     std::make_shared<ScaledImageSource<DetectionImage::PixelType>>(
-      mode, image->getWidth(), image->getHeight(),
+      mode_grid, image->getWidth(), image->getHeight(),
       ScaledImageSource<DetectionImage::PixelType>::InterpolationType::BICUBIC
     )
   );
+  level_mesh = BackgroundMesh::create(BackgroundMesh::Interpolation::BICUBIC,
+                                      m_cell_size[0], m_cell_size[1], mode_grid);
 
-  return BackgroundModel(final_bg, final_var, scaling, median_sigma);
+  BackgroundModel background_model(final_bg, final_var, scaling, median_sigma);
+  background_model.setMeshes(level_mesh, variance_mesh);
+  return background_model;
 }
 
 } // end of namespace SourceXtractor
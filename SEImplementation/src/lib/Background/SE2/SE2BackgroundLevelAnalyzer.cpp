@@ -117,22 +117,34 @@ BackgroundModel SE2BackgroundLevelAnalyzer::fromSE2Modeller(std::shared_ptr<Dete
   bck_model_logger.debug() << "\tMedian variance value: " << medianVariance;
   bck_model_logger.debug() << "\tScaling value: "<< sigFac;
 
+  // keep the spline grids, which are enough to rebuild the maps
+  auto splineMesh = [](const TypedSplineModelWrapper<SeFloat>& model) {
+    auto cell_size = model.getGridCellSize();
+    return BackgroundMesh::create(BackgroundMesh::Interpolation::SPLINE, cell_size[0], cell_size[1],
+                                  model.getGridValues());
+  };
+
   // check for the weight type
   if (m_weight_type == WeightImageConfig::WeightType::WEIGHT_TYPE_NONE) {
     bck_model_logger.debug() << "\tConstant variance image at value: "<< splModelVarPtr->getMedian();
     // create a background model using the splines and the variance with a constant image from the median value
-    return BackgroundModel(BufferedImage<SeFloat>::create(splModelBckPtr),
+    BackgroundModel background_model(BufferedImage<SeFloat>::create(splModelBckPtr),
                            ConstantImage<SeFloat>::create(image->getWidth(), image->getHeight(), splModelVarPtr->getMedian()),
                            99999, std::sqrt(medianVariance));
+    background_model.setMeshes(splineMesh(*splModelBckPtr),
+                               BackgroundMesh::constant(image->getWidth(), image->getHeight(), splModelVarPtr->getMedian()));
+    return background_model;
   }
   else {
     bck_model_logger.debug() << "\tVariable background and variance.";
     // return the variable background model
-    return BackgroundModel(
+    BackgroundModel background_model(
         BufferedImage<SeFloat>::create(splModelBckPtr),
         BufferedImage<SeFloat>::create(splModelVarPtr),
         sigFac, std::sqrt(medianVariance)
     );
+    background_model.setMeshes(splineMesh(*splModelBckPtr), splineMesh(*splModelVarPtr));
+    return background_model;
   }
 }
 
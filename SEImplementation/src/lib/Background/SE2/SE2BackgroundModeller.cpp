@@ -28,6 +28,7 @@
 
 #include "ElementsKernel/Exception.h"
 #include "SEImplementation/Background/Utils.h"
+#include "SEImplementation/Background/SlidingMedian.h"
 #include "SEImplementation/Background/SE2/BackgroundDefine.h"
 #include "SEImplementation/Background/SE2/SE2BackgroundUtils.h"
 #include "SEImplementation/Background/SE2/TypedSplineModelWrapper.h"
@@ -428,10 +429,8 @@ void SE2BackgroundModeller::filterMedian(PIXTYPE* bckVals, PIXTYPE* sigmaVals, c
   PIXTYPE  *back, *sigma, *sigmat;
   PIXTYPE* backFilt=NULL;
   PIXTYPE* sigmaFilt=NULL;
-  PIXTYPE* bmask=NULL;
-  PIXTYPE* smask=NULL;
-  PIXTYPE allSigmaMed, median; //allBckMed
-  int    i,nx,ny,npx,npx2,npy,npy2,x,y;
+  PIXTYPE allSigmaMed; //allBckMed
+  int    i,nx,ny;
   int np;
 
   // check whether something needs to be done at all
@@ -447,15 +446,6 @@ void SE2BackgroundModeller::filterMedian(PIXTYPE* bckVals, PIXTYPE* sigmaVals, c
   ny = (int)gridSize[1];
   np = nx*ny;
 
-  // store the filter size
-  npx = (int)filterSize[0]/2;
-  npy = (int)filterSize[1]/2;
-  npy *= nx;
-
-  // allocate space for the work area
-  bmask  = new PIXTYPE[(2*npx+1)*(2*npy+1)];
-  smask  = new PIXTYPE[(2*npx+1)*(2*npy+1)];
-
   // allocate space for filtered arrays
   backFilt  = new PIXTYPE[np];
   sigmaFilt = new PIXTYPE[np];
@@ -464,55 +454,23 @@ void SE2BackgroundModeller::filterMedian(PIXTYPE* bckVals, PIXTYPE* sigmaVals, c
   back  = bckVals;
   sigma = sigmaVals;
 
-  // go over all y
-  for (int py=0; py<np; py+=nx)
+  // compute the medians within the filter box, which
+  // is symmetrically limited at the edges
+  SlidingMedian<PIXTYPE>::filter(nx, ny, (int)filterSize[0], (int)filterSize[1],
+    [back, nx](int x, int y) { return back[x+y*nx]; },
+    [backFilt, nx](int x, int y, PIXTYPE median) { backFilt[x+y*nx] = median; });
+  SlidingMedian<PIXTYPE>::filter(nx, ny, (int)filterSize[0], (int)filterSize[1],
+    [sigma, nx](int x, int y) { return sigma[x+y*nx]; },
+    [sigmaFilt, nx](int x, int y, PIXTYPE median) { sigmaFilt[x+y*nx] = median; });
+
+  // check whether the median is above the threshold,
+  // otherwise use the original value
+  for (int index=0; index<np; index++)
   {
-    // limit the filter box in y
-    npy2 = np - py - nx;
-    if (npy2>npy)
-      npy2 = npy;
-    if (npy2>py)
-      npy2 = py;
-
-    // go over all x
-    for (int px=0; px<nx; px++)
+    if (!(fabs((backFilt[index]-back[index]))>=(PIXTYPE)filterThresh))
     {
-      // limit the filter box in x
-      npx2 = nx - px - 1;
-      if (npx2>npx)
-        npx2 = npx;
-      if (npx2>px)
-        npx2 = px;
-
-      // store all values in the box
-      // in an array
-      i=0;
-      for (int dpy = -npy2; dpy<=npy2; dpy+=nx)
-      {
-        y = py+dpy;
-        for (int dpx = -npx2; dpx <= npx2; dpx++)
-        {
-          x = px+dpx;
-          bmask[i] = back[x+y];
-          smask[i++] = sigma[x+y];
-        }
-      }
-
-      // compute the median, check
-      // whether the median is above the threshold
-      median = SE2BackgroundUtils::fqMedian(bmask, i);
-      if (fabs((median-back[px+py]))>=(PIXTYPE)filterThresh)
-      {
-        // use the median values
-        backFilt[px+py] = median;
-        sigmaFilt[px+py] = SE2BackgroundUtils::fqMedian(smask, i);
-      }
-      else
-      {
-        // use the original value
-        backFilt[px+py] = back[px+py];
-        sigmaFilt[px+py] = sigma[px+py];
-      }
+      backFilt[index] = back[index];
+      sigmaFilt[index] = sigma[index];
     }
   }
 
@@ -550,8 +508,6 @@ void SE2BackgroundModeller::filterMedian(PIXTYPE* bckVals, PIXTYPE* sigmaVals, c
   // release memory
   delete [] sigmaFilt;
   delete [] backFilt;
-  delete [] bmask;
-  delete [] smask;
 
   return;
 }
@@ -31,6 +31,8 @@
 #include "SEImplementation/Background/SE2/SE2BackgroundUtils.h"
 #include "SEImplementation/Background/SE2/SplineModel.h"
 #include <iostream>
+#include <algorithm>
+#include <vector>
 //////////
 //#define	QMALLOC(ptr, typ, nel) ptr = (typ *)malloc((size_t)(nel)*sizeof(typ))
 
@@ -283,9 +285,64 @@ PIXTYPE  SplineModel::getValue(size_t x, size_t y){
   return rValue;
 }
 
+void SplineModel::interpolateNodes (float *node, float *dnode, const size_t y) const {
+  int x, yl, nbx, nbxm1, nby, ystep;
+  float dy, dy3, cdy, cdy3, temp, *nodep, *dnodep, *u;
+  const PIXTYPE *blo, *bhi, *dblo, *dbhi;
+
+  nbx = itsNGrid[0];
+  nbxm1 = nbx - 1;
+  nby = itsNGrid[1];
+
+  dy = (float) y / itsGridCellSize[1] - 0.5;
+  dy -= (yl = (int) dy);
+  if (yl < 0) {
+    yl = 0;
+    dy -= 1.0;
+  } else if (yl >= nby - 1) {
+    yl = nby - 2;
+    dy += 1.0;
+  }
+
+  /*-- Interpolation along y for each node */
+  cdy = 1 - dy;
+  dy3 = (dy * dy * dy - dy);
+  cdy3 = (cdy * cdy * cdy - cdy);
+  ystep = nbx * yl;
+  blo = itsGridData + ystep;
+  bhi = blo + nbx;
+  dblo = itsDerivData + ystep;
+  dbhi = dblo + nbx;
+  nodep = node;
+  for (x = nbx; x--;)
+    *(nodep++) = cdy * *(blo++) + dy * *(bhi++) + cdy3 * *(dblo++) + dy3 * *(dbhi++);
+
+  /*-- Computation of 2nd derivatives along x */
+  if (nbx > 1) {
+    std::vector<float> ubuf(nbxm1); /* temporary array */
+    u = ubuf.data();
+    dnodep = dnode;
+    *dnodep = *u = 0.0; /* "natural" lower boundary condition */
+    nodep = node + 1;
+    for (x = nbxm1; --x; nodep++) {
+      temp = -1 / (*(dnodep++) + 4);
+      *dnodep = temp;
+      temp *= *(u++) - 6 * (*(nodep + 1) + *(nodep - 1) - 2 * *nodep);
+      *u = temp;
+    }
+    *(++dnodep) = 0.0; /* "natural" upper boundary condition */
+    for (x = nbx - 2; x--;) {
+      temp = *(dnodep--);
+      *dnodep = (*dnodep * temp + *(u--)) / 6.0;
+    }
+  }
+}
+
 void SplineModel::splineLine (PIXTYPE *line, const size_t y, const size_t xStart, const size_t width) {
-  int i, j, x, yl, nbx, nbxm1, nby, nx, ystep, changepoint;
-  float dx, dx0, dy, dy3, cdx, cdy, cdy3, temp, xstep, *node, *nodep, *dnode, *blo, *bhi, *dblo, *dbhi, *u;
+  int i, j, x, nbx, nbxm1, nby, nx, changepoint;
+  float dx, dx0, cdx, xstep;
+  const float *node, *dnode, *blo, *bhi, *dblo, *dbhi;
+  std::vector<float> nodeBuf, dnodeBuf;
   PIXTYPE *backline;
 
   backline = line;
@@ -295,53 +352,11 @@ void SplineModel::splineLine (PIXTYPE *line, const size_t y, const size_t xStart
   nby = itsNGrid[1];
 
   if (nby > 1) {
-    dy = (float) y / itsGridCellSize[1] - 0.5;
-    dy -= (yl = (int) dy);
-    if (yl < 0) {
-      yl = 0;
-      dy -= 1.0;
-    } else if (yl >= nby - 1) {
-      yl = nby - 2;
-      dy += 1.0;
-    }
-
-    /*-- Interpolation along y for each node */
-    cdy = 1 - dy;
-    dy3 = (dy * dy * dy - dy);
-    cdy3 = (cdy * cdy * cdy - cdy);
-    ystep = nbx * yl;
-    blo = itsGridData + ystep;
-    bhi = blo + nbx;
-    dblo = itsDerivData + ystep;
-    dbhi = dblo + nbx;
-    //QMALLOC(node, float, nbx);  /* Interpolated background */
-    node = new float[nbx]; /* Interpolated background */
-    nodep = node;
-    for (x = nbx; x--;)
-      *(nodep++) = cdy * *(blo++) + dy * *(bhi++) + cdy3 * *(dblo++) + dy3 * *(dbhi++);
-
-    /*-- Computation of 2nd derivatives along x */
-    //QMALLOC(dnode, float, nbx); /* 2nd derivative along x */
-    dnode = new float[nbx]; /* 2nd derivative along x */
-    if (nbx > 1) {
-      //QMALLOC(u, float, nbxm1); /* temporary array */
-      u = new float[nbxm1]; /* temporary array */
-      *dnode = *u = 0.0; /* "natural" lower boundary condition */
-      nodep = node + 1;
-      for (x = nbxm1; --x; nodep++) {
-        temp = -1 / (*(dnode++) + 4);
-        *dnode = temp;
-        temp *= *(u++) - 6 * (*(nodep + 1) + *(nodep - 1) - 2 * *nodep);
-        *u = temp;
-      }
-      *(++dnode) = 0.0; /* "natural" upper boundary condition */
-      for (x = nbx - 2; x--;) {
-        temp = *(dnode--);
-        *dnode = (*dnode * temp + *(u--)) / 6.0;
-      }
-      delete[] u;
-      dnode--;
-    }
+    nodeBuf.resize(nbx);  /* Interpolated background */
+    dnodeBuf.resize(nbx); /* 2nd derivative along x */
+    interpolateNodes(nodeBuf.data(), dnodeBuf.data(), y);
+    node = nodeBuf.data();
+    dnode = dnodeBuf.data();
   } else {
     /*-- No interpolation and no new 2nd derivatives needed along y */
     node = itsGridData;
@@ -396,12 +411,72 @@ void SplineModel::splineLine (PIXTYPE *line, const size_t y, const size_t xStart
       //*(line++) -= (*(backline++) = (PIXTYPE)*node);
       *(backline++) = (PIXTYPE) *node;
 
+  return;
+}
+
+void SplineModel::splineTile (PIXTYPE *tile, const size_t xStart, const size_t yStart,
+                              const size_t width, const size_t height) const {
+  int i, x, nbx, nbxm1, nby, nx, changepoint, lower;
+  size_t j, row, col;
+  float dx, dx0, cdx, xstep;
+  const float *node, *dnode;
+
+  nbx = itsNGrid[0];
+  nbxm1 = nbx - 1;
+  nby = itsNGrid[1];
+
+  /*-- Basis along x for the columns of the window; same walk as in splineLine */
+  std::vector<int> colNode(width, 0);
+  std::vector<float> colDx(width, 0.0);
+  if (nbx > 1) {
+    nx = itsGridCellSize[0];
+    xstep = 1.0 / nx;
+    changepoint = nx / 2;
+    dx = (xstep - 1) / 2;
+    dx0 = ((nx + 1) % 2) * xstep / 2;
+    lower = 0;
+    for (x = i = 0, j = 0; j < xStart + width; j++, i++, dx += xstep) {
+      if (i == changepoint && x > 0 && x < nbxm1) {
+        lower++;
+        dx = dx0;
+      }
+      if (j >= xStart) {
+        colNode[j - xStart] = lower;
+        colDx[j - xStart] = dx;
+      }
+      if (i == nx) {
+        x++;
+        i = 0;
+      }
+    }
+  }
+
+  std::vector<float> nodeBuf, dnodeBuf;
   if (nby > 1) {
-    delete[] node;
-    delete[] dnode;
+    nodeBuf.resize(nbx);
+    dnodeBuf.resize(nbx);
+    node = nodeBuf.data();
+    dnode = dnodeBuf.data();
+  } else {
+    node = itsGridData;
+    dnode = itsDerivData;
   }
 
-  return;
+  for (row = 0; row < height; row++) {
+    if (nby > 1)
+      interpolateNodes(nodeBuf.data(), dnodeBuf.data(), yStart + row);
+
+    PIXTYPE *backline = tile + row * width;
+    if (nbx > 1) {
+      for (col = 0; col < width; col++) {
+        const float *blo = node + colNode[col], *dblo = dnode + colNode[col];
+        dx = colDx[col];
+        cdx = 1 - dx;
+        backline[col] = (PIXTYPE) (cdx * (blo[0] + (cdx * cdx - 1) * dblo[0]) + dx * (blo[1] + (dx * dx - 1) * dblo[1]));
+      }
+    } else
+      std::fill(backline, backline + width, (PIXTYPE) *node);
+  }
 }
 
 PIXTYPE* SplineModel::makeSplineDeriv (const size_t* nGrid, PIXTYPE* gridData) {
@@ -54,7 +54,10 @@ BackgroundModel SimpleBackgroundAnalyzer::analyzeBackground(
   auto background_variance_map = ConstantImage<SeFloat>::create(image->getWidth(), image->getHeight(), background_variance);
   bck_model_logger.debug() << "bg: " << background_level << " var: " << background_variance;
 
-  return BackgroundModel(background_level_map, background_variance_map, 1.0, std::sqrt(background_variance));
+  BackgroundModel background_model(background_level_map, background_variance_map, 1.0, std::sqrt(background_variance));
+  background_model.setMeshes(BackgroundMesh::constant(image->getWidth(), image->getHeight(), background_level),
+                             BackgroundMesh::constant(image->getWidth(), image->getHeight(), background_variance));
+  return background_model;
 }
 
 
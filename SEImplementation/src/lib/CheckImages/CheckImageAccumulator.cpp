@@ -0,0 +1,126 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * CheckImageAccumulator.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <algorithm>
+
+#include "SEFramework/Pipeline/MemoryGovernor.h"
+#include "SEImplementation/Measurement/MultithreadedMeasurement.h"
+
+#include "SEImplementation/CheckImages/CheckImageAccumulator.h"
+
+namespace SourceXtractor {
+
+constexpr int CheckImageAccumulator::BLOCK_SIZE;
+constexpr std::size_t CheckImageAccumulator::BLOCK_BYTES;
+
+CheckImageAccumulator::CheckImageAccumulator(std::shared_ptr<WriteableImage<SeFloat>> image, std::size_t max_memory)
+  : m_image(image),
+    m_blocks_x((image->getWidth() + BLOCK_SIZE - 1) / BLOCK_SIZE),
+    m_blocks_y((image->getHeight() + BLOCK_SIZE - 1) / BLOCK_SIZE),
+    m_blocks(new Block[m_blocks_x * m_blocks_y]),
+    m_allocated_blocks(0), m_max_blocks(std::max<std::size_t>(max_memory / BLOCK_BYTES, 1)) {
+}
+
+CheckImageAccumulator::~CheckImageAccumulator() {
+  MemoryGovernor::getInstance()->release(m_allocated_blocks * BLOCK_BYTES);
+}
+
+void CheckImageAccumulator::addStamp(const VectorImage<SeFloat>& stamp, int x, int y) {
+  for (int iy = 0; iy < stamp.getHeight(); ++iy) {
+    accumulateRow(stamp.getData().data() + iy * stamp.getWidth(), stamp.getWidth(), x, y + iy);
+  }
+  flushIfOverMemory();
+}
+
+void CheckImageAccumulator::addRow(const SeFloat* values, int length, int x, int y) {
+  accumulateRow(values, length, x, y);
+  flushIfOverMemory();
+}
+
+void CheckImageAccumulator::accumulateRow(const SeFloat* values, int length, int x, int y) {
+  int min_x = std::max(x, 0), max_x = std::min(x + length, m_image->getWidth());
+  if (y < 0 || y >= m_image->getHeight() || min_x >= max_x) {
+    return;
+  }
+
+  int block_y = y / BLOCK_SIZE;
+  int block_min_y = block_y * BLOCK_SIZE;
+  for (int block_x = min_x / BLOCK_SIZE; block_x <= (max_x - 1) / BLOCK_SIZE; ++block_x) {
+    auto& block = m_blocks[block_y * m_blocks_x + block_x];
+    int block_min_x = block_x * BLOCK_SIZE;
+
+    std::lock_guard<std::mutex> lock(block.m_mutex);
+    if (block.m_data.empty()) {
+      block.m_data.resize(BLOCK_SIZE * BLOCK_SIZE);
+      MemoryGovernor::getInstance()->charge(BLOCK_BYTES);
+      ++m_allocated_blocks;
+    }
+    auto* row = block.m_data.data() + (y - block_min_y) * BLOCK_SIZE;
+    for (int ix = std::max(min_x, block_min_x); ix < std::min(max_x, block_min_x + BLOCK_SIZE); ++ix) {
+      row[ix - block_min_x] += values[ix - x];
+    }
+  }
+}
+
+void CheckImageAccumulator::flushIfOverMemory() {
+  // Add into the image earlier if the blocks are a good part of an exceeded budget
+  auto memory_governor = MemoryGovernor::getInstance();
+  std::size_t allocated = m_allocated_blocks;
+  bool spill = memory_governor->isOverBudget() && 4 * allocated * BLOCK_BYTES >= memory_governor->getUsed();
+  if (allocated > m_max_blocks || spill) {
+    flush();
+  }
+}
+
+void CheckImageAccumulator::flushBlock(int block_x, int block_y) {
+  std::vector<SeFloat> data;
+  {
+    auto& block = m_blocks[block_y * m_blocks_x + block_x];
+    std::lock_guard<std::mutex> lock(block.m_mutex);
+    if (block.m_data.empty()) {
+      return;
+    }
+    data.swap(block.m_data);
+    --m_allocated_blocks;
+  }
+
+  int block_min_x = block_x * BLOCK_SIZE, block_min_y = block_y * BLOCK_SIZE;
+  int width = std::min(BLOCK_SIZE, m_image->getWidth() - block_min_x);
+  int height = std::min(BLOCK_SIZE, m_image->getHeight() - block_min_y);
+
+  // The lock is released between rows, so the threads waiting for it are not held for the whole block
+  for (int iy = 0; iy < height; ++iy) {
+    std::lock_guard<std::recursive_mutex> lock(MultithreadedMeasurement::g_global_mutex);
+    m_image->addToRow(block_min_x, block_min_y + iy, width, data.data() + iy * BLOCK_SIZE);
+  }
+  MemoryGovernor::getInstance()->release(BLOCK_BYTES);
+}
+
+void CheckImageAccumulator::flush() {
+  for (int block_y = 0; block_y < m_blocks_y; ++block_y) {
+    for (int block_x = 0; block_x < m_blocks_x; ++block_x) {
+      flushBlock(block_x, block_y);
+    }
+  }
+}
+
+} /* namespace SourceXtractor */
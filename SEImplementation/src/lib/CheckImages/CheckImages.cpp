@@ -27,6 +27,7 @@
 #include "SEImplementation/Configuration/MeasurementImageConfig.h"
 #include "SEImplementation/Configuration/MeasurementFrameConfig.h"
 #include "SEImplementation/Configuration/CheckImagesConfig.h"
+#include "SEImplementation/Configuration/MemoryConfig.h"
 
 #include "SEImplementation/CheckImages/CheckImages.h"
 
@@ -34,7 +35,7 @@ namespace SourceXtractor {
 
 std::unique_ptr<CheckImages> CheckImages::m_instance;
 
-CheckImages::CheckImages() {
+CheckImages::CheckImages() : m_accumulator_max_memory(64 * 1024 * 1024) {
 }
 
 void CheckImages::reportConfigDependencies(Euclid::Configuration::ConfigManager &manager) const {
@@ -42,6 +43,7 @@ void CheckImages::reportConfigDependencies(Euclid::Configuration::ConfigManager
   manager.registerConfiguration<DetectionImageConfig>();
   manager.registerConfiguration<MeasurementImageConfig>();
   manager.registerConfiguration<MeasurementFrameConfig>();
+  manager.registerConfiguration<MemoryConfig>();
 }
 
 std::shared_ptr<WriteableImage<SeFloat>> CheckImages::getWriteableCheckImage(std::string id, int width, int height) {
@@ -82,22 +84,27 @@ void CheckImages::configure(Euclid::Configuration::ConfigManager& manager) {
   m_aperture_filename = config.getApertureFilename();
   m_moffat_filename = config.getMoffatFilename();
   m_psf_filename = config.getPsfFilename();
+  m_accumulator_max_memory =
+      static_cast<size_t>(manager.getConfiguration<MemoryConfig>().getCheckImageMaxMemory()) * 1024 * 1024;
 
   m_coordinate_system = manager.getConfiguration<DetectionImageConfig>().getCoordinateSystem();
 
   if (m_segmentation_filename != "") {
     m_segmentation_image = FitsWriter::newImage<unsigned int>(m_segmentation_filename.native(),
         m_detection_image->getWidth(), m_detection_image->getHeight(), m_coordinate_system);
+    m_segmentation_writer = std::make_shared<LabelCheckImageWriter>(m_segmentation_image);
   }
 
   if (m_partition_filename != "") {
     m_partition_image = FitsWriter::newImage<unsigned int>(m_partition_filename.native(),
         m_detection_image->getWidth(), m_detection_image->getHeight(), m_coordinate_system);
+    m_partition_writer = std::make_shared<LabelCheckImageWriter>(m_partition_image);
   }
 
   if (m_group_filename != "") {
     m_group_image = FitsWriter::newImage<unsigned int>(m_group_filename.native(),
         m_detection_image->getWidth(), m_detection_image->getHeight(), m_coordinate_system);
+    m_group_writer = std::make_shared<LabelCheckImageWriter>(m_group_image);
   }
 
   if (m_auto_aperture_filename != "") {
@@ -195,7 +202,27 @@ CheckImages::getModelFittingImage(unsigned int frame_number) {
   }
 
   std::lock_guard<std::mutex> lock{m_access_mutex};
+  return LockedWriteableImage<MeasurementImage::PixelType>::create(getModelFittingCheckImage(frame_number));
+}
+
+std::shared_ptr<CheckImageAccumulator> CheckImages::getModelFittingAccumulator(unsigned int frame_number) {
+  if (m_model_fitting_image_filename.empty() && m_residual_filename.empty()) {
+    return nullptr;
+  }
 
+  std::lock_guard<std::mutex> lock{m_access_mutex};
+
+  auto i = m_model_fitting_accumulators.find(frame_number);
+  if (i == m_model_fitting_accumulators.end()) {
+    i = m_model_fitting_accumulators.emplace(
+      frame_number, std::make_shared<CheckImageAccumulator>(
+        getModelFittingCheckImage(frame_number), m_accumulator_max_memory)).first;
+  }
+  return i->second;
+}
+
+std::shared_ptr<WriteableImage<MeasurementImage::PixelType>>
+CheckImages::getModelFittingCheckImage(unsigned int frame_number) {
   auto i = m_check_image_model_fitting.find(frame_number);
   if (i == m_check_image_model_fitting.end()) {
     auto& frame_info = m_measurement_frames.at(frame_number);
@@ -220,7 +247,7 @@ CheckImages::getModelFittingImage(unsigned int frame_number) {
     }
     i = m_check_image_model_fitting.emplace(std::make_pair(frame_number, writeable_image)).first;
   }
-  return LockedWriteableImage<MeasurementImage::PixelType>::create(i->second);
+  return i->second;
 }
 
 std::shared_ptr<WriteableImage<MeasurementImage::PixelType>> CheckImages::getPsfImage(unsigned int frame_number) {
@@ -251,8 +278,20 @@ std::shared_ptr<WriteableImage<MeasurementImage::PixelType>> CheckImages::getPsf
 }
 
 void CheckImages::saveImages() {
+  // Wait for the label writers before anything is written to disk
+  for (auto& writer : {m_segmentation_writer, m_partition_writer, m_group_writer}) {
+    if (writer) {
+      writer->flush();
+    }
+  }
+
   std::lock_guard<std::mutex> lock(m_access_mutex);
 
+  // The models must be complete before computing the residuals
+  for (auto& accumulator : m_model_fitting_accumulators) {
+    accumulator.second->flush();
+  }
+
   // if possible, save the background image
   if (m_background_image != nullptr && m_model_background_filename != "") {
     FitsWriter::writeFile(*m_background_image, m_model_background_filename.native(), m_coordinate_system);
@@ -30,17 +30,15 @@
 namespace SourceXtractor {
 
 void DetectionIdCheckImage::handleMessage(const std::shared_ptr<SourceInterface>& source) {
-  auto check_image = CheckImages::getInstance().getSegmentationImage();
-  if (check_image != nullptr) {
-    auto coordinates = source->getProperty<PixelCoordinateList>();
+  auto writer = CheckImages::getInstance().getSegmentationWriter();
+  if (writer != nullptr) {
+    auto& coordinates = source->getProperty<PixelCoordinateList>();
 
     // get the ID for each detected source
     const auto& source_id = source->getProperty<SourceId>().getDetectionId();
 
-    // iterate over the pixels and set the detection_id value
-    for (auto& coord : coordinates.getCoordinateList()) {
-      check_image->setValue(coord.m_x, coord.m_y, source_id);
-    }
+    // queue the pixels to be set to the detection_id value
+    writer->write(coordinates.getCoordinateList(), source_id);
   }
 }
 
@@ -32,18 +32,16 @@
 namespace SourceXtractor {
 
 void GroupIdCheckImage::handleMessage(const std::shared_ptr<SourceGroupInterface>& group) {
-  auto check_image = CheckImages::getInstance().getGroupImage();
-  if (check_image) {
+  auto writer = CheckImages::getInstance().getGroupWriter();
+  if (writer) {
     // get the ID of the group
     auto group_id = group->getProperty<GroupInfo>().getGroupId();
 
     for (auto& source : *group) {
       auto& coordinates = source.getProperty<PixelCoordinateList>();
 
-      // iterate over the pixels and set the group_id value
-      for (auto& coord : coordinates.getCoordinateList()) {
-        check_image->setValue(coord.m_x, coord.m_y, group_id);
-      }
+      // queue the pixels to be set to the group_id value
+      writer->write(coordinates.getCoordinateList(), group_id);
     }
   }
 }
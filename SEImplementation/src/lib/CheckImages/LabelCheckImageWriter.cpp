@@ -0,0 +1,155 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * LabelCheckImageWriter.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <algorithm>
+
+#include "ElementsKernel/Logging.h"
+
+#include "SEImplementation/Measurement/MultithreadedMeasurement.h"
+
+#include "SEImplementation/CheckImages/LabelCheckImageWriter.h"
+
+namespace SourceXtractor {
+
+static Elements::Logging logger = Elements::Logging::getLogger("CheckImages");
+
+LabelCheckImageWriter::LabelCheckImageWriter(std::shared_ptr<WriteableImage<unsigned int>> image,
+                                             std::size_t max_queued_spans)
+  : m_image(image), m_max_queued_spans(max_queued_spans), m_writing(false), m_stop(false),
+    m_error_reported(false) {
+  m_thread = std::thread(&LabelCheckImageWriter::run, this);
+}
+
+LabelCheckImageWriter::~LabelCheckImageWriter() {
+  {
+    std::lock_guard<std::mutex> lock(m_queue_mutex);
+    m_stop = true;
+  }
+  m_queued.notify_one();
+  m_thread.join();
+
+  // Throwing from here would terminate the program if the stack is already being unwound
+  if (m_error && !m_error_reported) {
+    try {
+      std::rethrow_exception(m_error);
+    }
+    catch (const std::exception& e) {
+      logger.error() << "Failed to write a label check image: " << e.what();
+    }
+    catch (...) {
+      logger.error() << "Failed to write a label check image";
+    }
+  }
+}
+
+std::vector<LabelCheckImageWriter::Span> LabelCheckImageWriter::toSpans(
+    const std::vector<PixelCoordinate>& pixels, unsigned int value) {
+  std::vector<PixelCoordinate> sorted(pixels);
+  std::sort(sorted.begin(), sorted.end(), [](const PixelCoordinate& a, const PixelCoordinate& b) {
+    return a.m_y < b.m_y || (a.m_y == b.m_y && a.m_x < b.m_x);
+  });
+
+  std::vector<Span> spans;
+  for (auto& pixel : sorted) {
+    if (!spans.empty()) {
+      auto& last = spans.back();
+      if (last.m_y == pixel.m_y && last.m_x + last.m_length >= pixel.m_x) {
+        last.m_length = std::max(last.m_length, pixel.m_x - last.m_x + 1);
+        continue;
+      }
+    }
+    spans.emplace_back(Span{pixel.m_x, pixel.m_y, 1, value});
+  }
+  return spans;
+}
+
+void LabelCheckImageWriter::write(const std::vector<PixelCoordinate>& pixels, unsigned int value) {
+  auto spans = toSpans(pixels, value);
+  {
+    // A footprint larger than the whole queue is let in once the queue is empty
+    std::unique_lock<std::mutex> lock(m_queue_mutex);
+    m_dequeued.wait(lock, [this, &spans]() {
+      return m_queue.empty() || m_queue.size() + spans.size() <= m_max_queued_spans;
+    });
+    if (m_error) {
+      m_error_reported = true;
+      std::rethrow_exception(m_error);
+    }
+    m_queue.insert(m_queue.end(), spans.begin(), spans.end());
+  }
+  m_queued.notify_one();
+}
+
+void LabelCheckImageWriter::flush() {
+  std::unique_lock<std::mutex> lock(m_queue_mutex);
+  m_written.wait(lock, [this]() { return m_queue.empty() && !m_writing; });
+  if (m_error) {
+    m_error_reported = true;
+    std::rethrow_exception(m_error);
+  }
+}
+
+void LabelCheckImageWriter::run() {
+  std::vector<Span> batch;
+  std::unique_lock<std::mutex> lock(m_queue_mutex);
+  while (true) {
+    m_queued.wait(lock, [this]() { return m_stop || !m_queue.empty(); });
+    if (m_queue.empty()) {
+      break;
+    }
+    batch.clear();
+    batch.swap(m_queue);
+    m_writing = true;
+    lock.unlock();
+    m_dequeued.notify_all();
+
+    // Paint in scanline order, so the tiles are visited once per batch. The sort is stable, so
+    // within a row overlapping spans keep the order in which they were queued
+    std::stable_sort(batch.begin(), batch.end(), [](const Span& a, const Span& b) {
+      return a.m_y < b.m_y;
+    });
+    // The lock is released between rows, so the measurement threads waiting for it are not held
+    // for the whole batch. Once a write has failed, the rest is discarded
+    std::exception_ptr error;
+    try {
+      for (auto row = batch.begin(); row != batch.end() && !m_error;) {
+        auto row_end = std::find_if(row, batch.end(), [row](const Span& span) { return span.m_y != row->m_y; });
+        std::lock_guard<std::recursive_mutex> image_lock(MultithreadedMeasurement::g_global_mutex);
+        for (; row != row_end; ++row) {
+          m_image->fillRow(row->m_x, row->m_y, row->m_length, row->m_value);
+        }
+      }
+    }
+    catch (...) {
+      error = std::current_exception();
+    }
+
+    lock.lock();
+    if (error && !m_error) {
+      m_error = error;
+    }
+    m_writing = false;
+    m_written.notify_all();
+  }
+}
+
+} /* namespace SourceXtractor */
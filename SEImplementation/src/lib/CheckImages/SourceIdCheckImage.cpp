@@ -30,18 +30,16 @@
 namespace SourceXtractor {
 
 void SourceIdCheckImage::handleMessage(const std::shared_ptr<SourceGroupInterface>& group) {
-  auto check_image = CheckImages::getInstance().getPartitionImage();
-  if (check_image != nullptr) {
+  auto writer = CheckImages::getInstance().getPartitionWriter();
+  if (writer != nullptr) {
     for (auto& source : *group) {
-      auto coordinates = source.getProperty<PixelCoordinateList>();
+      auto& coordinates = source.getProperty<PixelCoordinateList>();
 
       // get the ID for each (multithresholded) source
       const auto& source_id = source.getProperty<SourceID>().getId();
 
-      // iterate over the pixels and set the source-id value
-      for (auto& coord : coordinates.getCoordinateList()) {
-        check_image->setValue(coord.m_x, coord.m_y, source_id);
-      }
+      // queue the pixels to be set to the source-id value
+      writer->write(coordinates.getCoordinateList(), source_id);
     }
   }
 }
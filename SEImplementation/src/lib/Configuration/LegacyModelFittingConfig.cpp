@@ -31,8 +31,9 @@ namespace SourceXtractor {
 
 static const std::string MFIT_MAX_ITERATIONS {"model-fitting-iterations"};
 static const std::string MFIT_ENGINE {"model-fitting-engine"};
+static const std::string MFIT_COARSE_LEVELS {"model-fitting-coarse-levels"};
 
-LegacyModelFittingConfig::LegacyModelFittingConfig(long manager_id) : Configuration(manager_id), m_max_iterations(1000) {
+LegacyModelFittingConfig::LegacyModelFittingConfig(long manager_id) : Configuration(manager_id), m_max_iterations(1000), m_coarse_levels(0) {
 }
 
 auto LegacyModelFittingConfig::getProgramOptions() -> std::map<std::string, OptionDescriptionList> {
@@ -43,7 +44,9 @@ auto LegacyModelFittingConfig::getProgramOptions() -> std::map<std::string, Opti
         {MFIT_MAX_ITERATIONS.c_str(), po::value<int>()->default_value(1000),
          "Maximum number of iterations allowed for model fitting"},
         {MFIT_ENGINE.c_str(), po::value<std::string>()->default_value(default_engine),
-         "Least squares engine"}
+         "Least squares engine"},
+        {MFIT_COARSE_LEVELS.c_str(), po::value<int>()->default_value(0),
+         "Fit first on stamps binned up to 2^levels times, and seed each level with the previous one"}
       }
   }};
 }
@@ -54,6 +57,11 @@ void LegacyModelFittingConfig::initialize(const UserValues& args) {
     throw Elements::Exception() << "Invalid " << MFIT_MAX_ITERATIONS << " value: " << m_max_iterations;
   }
   m_least_squares_engine = args.at(MFIT_ENGINE).as<std::string>();
+  int coarse_levels = args.at(MFIT_COARSE_LEVELS).as<int>();
+  if (coarse_levels < 0) {
+    throw Elements::Exception() << "Invalid " << MFIT_COARSE_LEVELS << " value: " << coarse_levels;
+  }
+  m_coarse_levels = coarse_levels;
 }
 
 } /* namespace SourceXtractor */
@@ -30,26 +30,42 @@ namespace SourceXtractor {
 
 static const std::string MAX_TILE_MEMORY {"tile-memory-limit"};
 static const std::string TILE_SIZE {"tile-size"};
+static const std::string MAX_PIPELINE_MEMORY {"pipeline-memory-limit"};
+static const std::string MAX_CHECK_IMAGE_MEMORY {"check-image-memory-limit"};
 
-MemoryConfig::MemoryConfig(long manager_id) : Configuration(manager_id), m_max_memory(512), m_tile_size(256) {
+MemoryConfig::MemoryConfig(long manager_id) : Configuration(manager_id), m_max_memory(512), m_tile_size(256),
+                                                    m_pipeline_max_memory(0), m_check_image_max_memory(64) {
 }
 
 auto MemoryConfig::getProgramOptions() -> std::map<std::string, OptionDescriptionList> {
   return { {"Memory usage", {
       {MAX_TILE_MEMORY.c_str(), po::value<int>()->default_value(512), "Maximum memory used for image tiles cache in megabytes"},
       {TILE_SIZE.c_str(), po::value<int>()->default_value(256), "Image tiles size in pixels"},
+      {MAX_PIPELINE_MEMORY.c_str(), po::value<int>()->default_value(0),
+          "Maximum memory held by the sources waiting to be measured or written in megabytes, "
+          "detection is held back when exceeded (0 for no limit)"},
+      {MAX_CHECK_IMAGE_MEMORY.c_str(), po::value<int>()->default_value(64),
+          "Maximum memory used to accumulate the model check images before adding them in megabytes"},
   }}};
 }
 
 void MemoryConfig::initialize(const UserValues& args) {
   m_max_memory = args.at(MAX_TILE_MEMORY).as<int>();
   m_tile_size = args.at(TILE_SIZE).as<int>();
+  m_pipeline_max_memory = args.at(MAX_PIPELINE_MEMORY).as<int>();
+  m_check_image_max_memory = args.at(MAX_CHECK_IMAGE_MEMORY).as<int>();
   if (m_max_memory <= 0) {
     throw Elements::Exception() << "Invalid " << MAX_TILE_MEMORY << " value: " << m_max_memory;
   }
   if (m_tile_size <= 0) {
     throw Elements::Exception() << "Invalid " << TILE_SIZE << " value: " << m_tile_size;
   }
+  if (m_pipeline_max_memory < 0) {
+    throw Elements::Exception() << "Invalid " << MAX_PIPELINE_MEMORY << " value: " << m_pipeline_max_memory;
+  }
+  if (m_check_image_max_memory <= 0) {
+    throw Elements::Exception() << "Invalid " << MAX_CHECK_IMAGE_MEMORY << " value: " << m_check_image_max_memory;
+  }
 }
 
 } /* namespace SourceXtractor */
@@ -21,6 +21,9 @@
 
 #include "ElementsKernel/Logging.h"
 #include "ModelFitting/Engine/LeastSquareEngineManager.h"
+#include "Table/AsciiReader.h"
+#include "Table/CastVisitor.h"
+#include "Table/FitsReader.h"
 #include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingParameter.h"
 #include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingConverterFactory.h"
 #include "SEImplementation/PythonConfig/ObjectInfo.h"
@@ -28,6 +31,8 @@
 #include "SEImplementation/Configuration/ModelFittingConfig.h"
 #include "SEUtils/Python.h"
 
+#include <cmath>
+#include <fstream>
 #include <string>
 #include <boost/python/extract.hpp>
 #include <boost/python/object.hpp>
@@ -101,6 +106,86 @@ class PyObjectHolder {
     std::shared_ptr<py::object> m_obj_ptr;
 };
 
+/**
+ * Read the output catalog of a previous run, keeping the columns with the fitted values
+ */
+static std::shared_ptr<FlexibleModelFittingSeedCatalog> readSeedCatalog(
+    const std::string& path, FlexibleModelFittingSeedCatalog::MatchBy match_by, double max_distance,
+    const std::vector<std::pair<std::string, std::vector<int>>>& outputs,
+    const std::map<int, std::shared_ptr<FlexibleModelFittingParameter>>& parameters) {
+  using Euclid::Table::CastVisitor;
+
+  char magic[6] = {0};
+  std::ifstream(path, std::ios::binary).read(magic, sizeof(magic));
+  bool is_fits = (std::string(magic, sizeof(magic)) == "SIMPLE");
+
+  Euclid::Table::Table table = is_fits ? Euclid::Table::FitsReader{path}.read()
+                                       : Euclid::Table::AsciiReader{path}.read();
+  auto column_info = table.getColumnInfo();
+
+  std::string id_column = "source_id", x_column = "pixel_centroid_x", y_column = "pixel_centroid_y";
+  std::unique_ptr<std::size_t> id_index, x_index, y_index;
+  if (match_by == FlexibleModelFittingSeedCatalog::MatchBy::ID) {
+    id_index = column_info->find(id_column);
+    if (!id_index) {
+      throw Elements::Exception() << "The seed catalog " << path << " has no " << id_column << " column";
+    }
+  }
+  else {
+    x_index = column_info->find(x_column);
+    y_index = column_info->find(y_column);
+    if (!x_index || !y_index) {
+      throw Elements::Exception() << "The seed catalog " << path << " has no "
+                                  << x_column << " or " << y_column << " column";
+    }
+  }
+
+  // Only the outputs with a single free parameter can seed the fit
+  std::vector<std::pair<std::size_t, int>> value_columns;
+  for (auto& output : outputs) {
+    if (output.second.size() != 1) {
+      logger.warn() << "The seed column " << output.first << " has more than one value per source, it is ignored";
+      continue;
+    }
+    auto parameter = parameters.find(output.second.front());
+    if (parameter == parameters.end() ||
+        !std::dynamic_pointer_cast<FlexibleModelFittingFreeParameter>(parameter->second)) {
+      logger.warn() << "The seed column " << output.first << " is not a free parameter, it is ignored";
+      continue;
+    }
+    auto index = column_info->find(output.first);
+    if (index) {
+      value_columns.emplace_back(*index, output.second.front());
+    }
+    else {
+      logger.warn() << "The seed catalog " << path << " has no " << output.first << " column";
+    }
+  }
+
+  std::vector<FlexibleModelFittingSeedCatalog::Seed> seeds;
+  seeds.reserve(table.size());
+  for (auto& row : table) {
+    FlexibleModelFittingSeedCatalog::Seed seed{0, 0., 0., {}};
+    if (id_index) {
+      seed.m_id = static_cast<unsigned int>(boost::apply_visitor(CastVisitor<double>{}, row[*id_index]));
+    }
+    else {
+      seed.m_x = boost::apply_visitor(CastVisitor<double>{}, row[*x_index]);
+      seed.m_y = boost::apply_visitor(CastVisitor<double>{}, row[*y_index]);
+    }
+    for (auto& column : value_columns) {
+      double value = boost::apply_visitor(CastVisitor<double>{}, row[column.first]);
+      if (std::isfinite(value)) {
+        seed.m_values[column.second] = value;
+      }
+    }
+    seeds.emplace_back(std::move(seed));
+  }
+
+  logger.info() << "Read " << seeds.size() << " seeds with " << value_columns.size() << " fitted values from " << path;
+  return std::make_shared<FlexibleModelFittingSeedCatalog>(std::move(seeds), match_by, max_distance);
+}
+
 ModelFittingConfig::ModelFittingConfig(long manager_id) : Configuration(manager_id) {
   declareDependency<PythonConfig>();
 }
@@ -215,6 +300,9 @@ void ModelFittingConfig::initializeInner() {
         m_parameters[x_coord_id], m_parameters[y_coord_id], m_parameters[flux_id]);
   }
   
+  auto parameters = getDependency<PythonConfig>().getInterpreter().getModelFittingParams();
+  double sersic_lut_tolerance = py::extract<double>(parameters["sersic_lut_tolerance"]);
+
   for (auto& p : getDependency<PythonConfig>().getInterpreter().getSersicModels()) {
     int x_coord_id = py::extract<int>(p.second.attr("x_coord").attr("id"));
     int y_coord_id = py::extract<int>(p.second.attr("y_coord").attr("id"));
@@ -226,7 +314,7 @@ void ModelFittingConfig::initializeInner() {
     m_models[p.first] = std::make_shared<FlexibleModelFittingSersicModel>(
         m_parameters[x_coord_id], m_parameters[y_coord_id], m_parameters[flux_id], m_parameters[n_id],
         m_parameters[effective_radius_id], m_parameters[aspect_ratio_id],
-        m_parameters[angle_id]);
+        m_parameters[angle_id], sersic_lut_tolerance);
   }
   
   for (auto& p : getDependency<PythonConfig>().getInterpreter().getExponentialModels()) {
@@ -250,7 +338,8 @@ void ModelFittingConfig::initializeInner() {
     int angle_id = py::extract<int>(p.second.attr("angle").attr("id"));
     m_models[p.first] = std::make_shared<FlexibleModelFittingDevaucouleursModel>(
         m_parameters[x_coord_id], m_parameters[y_coord_id], m_parameters[flux_id],
-        m_parameters[effective_radius_id], m_parameters[aspect_ratio_id], m_parameters[angle_id]);
+        m_parameters[effective_radius_id], m_parameters[aspect_ratio_id], m_parameters[angle_id],
+        sersic_lut_tolerance);
   }
   
   for (auto& p : getDependency<PythonConfig>().getInterpreter().getFrameModelsMap()) {
@@ -280,13 +369,25 @@ void ModelFittingConfig::initializeInner() {
   
   m_outputs = getDependency<PythonConfig>().getInterpreter().getModelFittingOutputColumns();
 
-  auto parameters = getDependency<PythonConfig>().getInterpreter().getModelFittingParams();
   m_least_squares_engine = py::extract<std::string>(parameters["engine"]);
   if (m_least_squares_engine.empty()) {
     m_least_squares_engine = ModelFitting::LeastSquareEngineManager::getDefault();
   }
   m_max_iterations = py::extract<int>(parameters["max_iterations"]);
   m_modified_chi_squared_scale = py::extract<double>(parameters["modified_chi_squared_scale"]);
+  m_split_group_size = py::extract<int>(parameters["split_group_size"]);
+  m_joint_refinement = py::extract<bool>(parameters["joint_refinement"]);
+  m_jacobian_threads = py::extract<int>(parameters["jacobian_threads"]);
+  m_coarse_levels = py::extract<int>(parameters["coarse_levels"]);
+
+  std::string seed_catalog = py::extract<std::string>(parameters["seed_catalog"]);
+  if (!seed_catalog.empty()) {
+    std::string seed_match = py::extract<std::string>(parameters["seed_match"]);
+    double seed_max_distance = py::extract<double>(parameters["seed_max_distance"]);
+    auto match_by = (seed_match == "id") ? FlexibleModelFittingSeedCatalog::MatchBy::ID
+                                         : FlexibleModelFittingSeedCatalog::MatchBy::POSITION;
+    m_seed_catalog = readSeedCatalog(seed_catalog, match_by, seed_max_distance, m_outputs, m_parameters);
+  }
 }
 
 const std::map<int, std::shared_ptr<FlexibleModelFittingParameter>>& ModelFittingConfig::getParameters() const {
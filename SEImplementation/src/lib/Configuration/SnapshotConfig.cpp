@@ -0,0 +1,55 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * SnapshotConfig.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "ElementsKernel/Exception.h"
+
+#include "SEImplementation/Configuration/SnapshotConfig.h"
+
+using namespace Euclid::Configuration;
+namespace po = boost::program_options;
+
+namespace SourceXtractor {
+
+static const std::string SNAPSHOT_SAVE {"snapshot-save"};
+static const std::string SNAPSHOT_LOAD {"snapshot-load"};
+
+SnapshotConfig::SnapshotConfig(long manager_id) : Configuration(manager_id) {
+}
+
+auto SnapshotConfig::getProgramOptions() -> std::map<std::string, OptionDescriptionList> {
+  return { {"Detection snapshot", {
+      {SNAPSHOT_SAVE.c_str(), po::value<std::string>()->default_value(""),
+          "Save the background and the detected groups into this file"},
+      {SNAPSHOT_LOAD.c_str(), po::value<std::string>()->default_value(""),
+          "Load the background and the detected groups from this file, and only run the measurements"},
+  }}};
+}
+
+void SnapshotConfig::initialize(const UserValues& args) {
+  m_save_path = args.at(SNAPSHOT_SAVE).as<std::string>();
+  m_load_path = args.at(SNAPSHOT_LOAD).as<std::string>();
+  if (!m_save_path.empty() && !m_load_path.empty()) {
+    throw Elements::Exception() << SNAPSHOT_SAVE << " and " << SNAPSHOT_LOAD << " can not be used together";
+  }
+}
+
+} /* namespace SourceXtractor */
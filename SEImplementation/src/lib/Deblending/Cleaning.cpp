@@ -24,6 +24,8 @@
 #include <vector>
 #include <set>
 #include <tuple>
+#include <limits>
+#include <functional>
 
 #include "SEFramework/Property/DetectionFrame.h"
 #include "SEImplementation/Property/SourceId.h"
@@ -34,10 +36,15 @@
 
 #include "SEImplementation/Plugin/DetectionFramePixelValues/DetectionFramePixelValues.h"
 
+#include "SEImplementation/Deblending/MoffatInfluence.h"
 #include "SEImplementation/Deblending/Cleaning.h"
 
 namespace SourceXtractor {
 
+// The contributions of the models below this fraction of the faintest pixel of the group are ignored.
+// It is divided among all the sources, so the total influence is underestimated at most by that much.
+static const double INFLUENCE_TOLERANCE = 1e-3;
+
 inline bool operator<(SourceGroupInterface::iterator a, SourceGroupInterface::iterator b) {
   return &(*a) < &(*b);
 }
@@ -50,9 +57,28 @@ void Cleaning::deblend(SourceGroupInterface& group) const {
   std::vector<SourceGroupInterface::iterator> sources_to_clean;
   std::vector<SourceGroupInterface::iterator> remaining_sources;
 
-  // iterate through all sources
+  std::vector<SourceGroupInterface::iterator> sources;
+  std::vector<MoffatInfluence::Profile> profiles;
+  std::vector<std::reference_wrapper<const MoffatInfluence::PixelList>> pixels;
+  double faintest = std::numeric_limits<double>::max();
   for (auto it = group.begin(); it != group.end(); ++it) {
-    if (shouldClean(*it, group)) {
+    sources.push_back(it);
+    profiles.emplace_back(it->getProperty<MoffatModelFitting>());
+    pixels.emplace_back(it->getProperty<PixelCoordinateList>().getCoordinateList());
+    const auto& pixel_values = it->getProperty<DetectionFramePixelValues>().getFilteredValues();
+    for (auto value : pixel_values) {
+      faintest = std::min<double>(faintest, value);
+    }
+  }
+
+  // The influence of the rest of the group over every pixel is computed once for the whole group
+  double threshold = (faintest > 0) ? faintest * INFLUENCE_TOLERANCE / sources.size() : 0;
+  MoffatInfluence influence(profiles, pixels, threshold);
+
+  // iterate through all sources
+  for (std::size_t i = 0; i < sources.size(); ++i) {
+    auto it = sources[i];
+    if (shouldClean(*it, influence.getInfluence(i))) {
       sources_to_clean.push_back(it);
     } else {
       remaining_sources.push_back(it);
@@ -86,25 +112,7 @@ void Cleaning::deblend(SourceGroupInterface& group) const {
   }
 }
 
-bool Cleaning::shouldClean(SourceInterface& source, SourceGroupInterface& group) const {
-  const auto& pixel_list = source.getProperty<PixelCoordinateList>().getCoordinateList();
-
-  std::vector<double> group_influence(pixel_list.size());
-
-  // iterate through all other sources in the group
-  for (auto it = group.begin(); it != group.end(); ++it) {
-    if (&(*it) == &source) { // skip self
-      continue;
-    }
-
-    auto &model = it->getProperty<MoffatModelEvaluator>();
-    int i = 0;
-    for (auto pixel : pixel_list) {
-      auto pixel_value = model.getValue(pixel.m_x, pixel.m_y);
-      group_influence[i++] += pixel_value;
-    }
-  }
-
+bool Cleaning::shouldClean(SourceInterface& source, const std::vector<double>& group_influence) const {
   unsigned int still_valid_pixels = 0;
   const auto& pixel_values = source.getProperty<DetectionFramePixelValues>().getFilteredValues();
   int i = 0;
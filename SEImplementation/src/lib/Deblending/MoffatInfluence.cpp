@@ -0,0 +1,172 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * MoffatInfluence.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include "SEImplementation/Plugin/MoffatModelFitting/MoffatModelFitting.h"
+#include "SEImplementation/Deblending/MoffatInfluence.h"
+
+namespace SourceXtractor {
+
+namespace {
+
+// Size, in pixels, of the cells of the grid used to find the pixels close to a model
+const int CELL_SIZE = 16;
+
+}
+
+MoffatInfluence::Profile::Profile(const MoffatModelFitting& model)
+  : Profile(model.getX(), model.getY(), model.getMoffatI0(), model.getMoffatIndex(),
+            model.getMinkowksiExponent(), model.getTopOffset(), model.getXScale(), model.getYScale(),
+            model.getMoffatRotation()) {
+}
+
+MoffatInfluence::Profile::Profile(double x, double y, double i0, double index, double minkowski_exponent,
+                                  double top_offset, double x_scale, double y_scale, double rotation)
+  : m_x(x), m_y(y), m_i0(i0), m_index(index), m_minkowski_exponent(minkowski_exponent),
+    m_top_offset(top_offset), m_x_scale(x_scale), m_y_scale(y_scale),
+    m_cos(std::cos(rotation)), m_sin(std::sin(rotation)) {
+}
+
+// Same sequence of operations as the ExtendedModel built by MoffatModelEvaluator:
+// translation, rotation, scaling and the FlattenedMoffatComponent
+double MoffatInfluence::Profile::getValue(double x, double y) const {
+  x -= m_x;
+  y -= m_y;
+  double new_x = (x * m_cos - y * m_sin) / m_x_scale;
+  double new_y = (x * m_sin + y * m_cos) / m_y_scale;
+  double z = std::pow(std::pow(std::fabs(new_x), m_minkowski_exponent) + std::pow(std::fabs(new_y), m_minkowski_exponent),
+                      1 / m_minkowski_exponent) - m_top_offset;
+  if (z < 0) {
+    return m_i0;
+  }
+  return m_i0 * std::pow(1 + z * z, -m_index);
+}
+
+double MoffatInfluence::Profile::getTruncationRadius(double threshold) const {
+  if (m_i0 <= threshold) {
+    return 0;
+  }
+  if (!(threshold > 0) || !(m_index > 0) || !(m_minkowski_exponent > 0)) {
+    return std::numeric_limits<double>::infinity();
+  }
+  // Beyond z_max, i0 * (1 + z^2)^-n < threshold
+  double z_max = std::sqrt(std::pow(m_i0 / threshold, 1 / m_index) - 1);
+  double norm_max = std::max(z_max + m_top_offset, 0.);
+  // Any Minkowski norm with exponent > 0 is at least the euclidean norm divided by sqrt(2),
+  // and the scaling can shrink the distances at most by the largest scale
+  return std::sqrt(2.) * norm_max * std::max(std::fabs(m_x_scale), std::fabs(m_y_scale));
+}
+
+MoffatInfluence::MoffatInfluence(const std::vector<Profile>& profiles,
+                                 const std::vector<std::reference_wrapper<const PixelList>>& pixels,
+                                 double threshold) {
+  m_influence.resize(pixels.size());
+
+  // Bounding box of the pixels of the group
+  int min_x = std::numeric_limits<int>::max(), min_y = std::numeric_limits<int>::max();
+  int max_x = std::numeric_limits<int>::min(), max_y = std::numeric_limits<int>::min();
+  std::size_t npixels = 0;
+  for (std::size_t i = 0; i < pixels.size(); ++i) {
+    const PixelList& list = pixels[i];
+    for (auto& pixel : list) {
+      min_x = std::min(min_x, pixel.m_x);
+      min_y = std::min(min_y, pixel.m_y);
+      max_x = std::max(max_x, pixel.m_x);
+      max_y = std::max(max_y, pixel.m_y);
+    }
+    npixels += list.size();
+    m_influence[i].resize(list.size());
+  }
+  if (npixels == 0) {
+    return;
+  }
+
+  // Sort the pixels by cell, so the pixels of a cell are contiguous
+  int cells_x = (max_x - min_x) / CELL_SIZE + 1;
+  int cells_y = (max_y - min_y) / CELL_SIZE + 1;
+  std::vector<std::size_t> cell_start(cells_x * cells_y + 1);
+  for (std::size_t i = 0; i < pixels.size(); ++i) {
+    const PixelList& list = pixels[i];
+    for (auto& pixel : list) {
+      ++cell_start[((pixel.m_y - min_y) / CELL_SIZE) * cells_x + (pixel.m_x - min_x) / CELL_SIZE + 1];
+    }
+  }
+  std::partial_sum(cell_start.begin(), cell_start.end(), cell_start.begin());
+
+  std::vector<double> xs(npixels), ys(npixels), sums(npixels);
+  std::vector<int> owners(npixels);
+  std::vector<std::size_t> indexes(npixels), fill(cell_start.begin(), cell_start.end() - 1);
+  for (std::size_t i = 0; i < pixels.size(); ++i) {
+    const PixelList& list = pixels[i];
+    for (std::size_t k = 0; k < list.size(); ++k) {
+      auto& pixel = list[k];
+      auto j = fill[((pixel.m_y - min_y) / CELL_SIZE) * cells_x + (pixel.m_x - min_x) / CELL_SIZE]++;
+      xs[j] = pixel.m_x;
+      ys[j] = pixel.m_y;
+      owners[j] = i;
+      indexes[j] = k;
+    }
+  }
+
+  // Add each model, in order, over the cells within its radius
+  for (std::size_t s = 0; s < profiles.size(); ++s) {
+    const auto& profile = profiles[s];
+    double radius = profile.getTruncationRadius(threshold);
+    if (!(radius > 0)) {
+      continue;
+    }
+    double radius2 = radius * radius;
+    auto cell_range = [radius](double center, int min, int ncells, int& first, int& last) {
+      first = static_cast<int>(std::max(std::floor((center - radius - min) / CELL_SIZE), 0.));
+      last = static_cast<int>(std::min(std::floor((center + radius - min) / CELL_SIZE), ncells - 1.));
+    };
+    int first_x, last_x, first_y, last_y;
+    cell_range(profile.m_x, min_x, cells_x, first_x, last_x);
+    cell_range(profile.m_y, min_y, cells_y, first_y, last_y);
+    if (first_x > last_x || first_y > last_y) {
+      continue;
+    }
+    int owner = s;
+
+    for (int cy = first_y; cy <= last_y; ++cy) {
+      // The cells of a row are contiguous too
+      auto begin = cell_start[cy * cells_x + first_x];
+      auto end = cell_start[cy * cells_x + last_x + 1];
+      for (auto j = begin; j < end; ++j) {
+        double dx = xs[j] - profile.m_x, dy = ys[j] - profile.m_y;
+        double value = profile.getValue(xs[j], ys[j]);
+        bool inside = (owners[j] != owner) && (dx * dx + dy * dy <= radius2);
+        sums[j] += inside ? value : 0.;
+      }
+    }
+  }
+
+  for (std::size_t j = 0; j < npixels; ++j) {
+    m_influence[owners[j]][indexes[j]] = sums[j];
+  }
+}
+
+} // end of namespace SourceXtractor
@@ -35,7 +35,16 @@ namespace SourceXtractor {
 std::unique_ptr<Measurement> MeasurementFactory::getMeasurement() const {
   if (m_threads_nb > 0) {
     auto source_to_row = m_output_registry->getSourceToRowConverter(m_output_properties);
-    return std::unique_ptr<Measurement>(new MultithreadedMeasurement(source_to_row, m_threads_nb));
+    // Independent tasks of a source can only run concurrently with the help of other workers
+    std::shared_ptr<const ExecutionPlan> execution_plan;
+    if (m_task_provider && m_threads_nb > 1) {
+      execution_plan = std::make_shared<ExecutionPlan>(
+          *m_task_provider, m_output_registry->getOutputPropertyIds(m_output_properties));
+      if (execution_plan->getMaxConcurrency() <= 1) {
+        execution_plan = nullptr;
+      }
+    }
+    return std::unique_ptr<Measurement>(new MultithreadedMeasurement(source_to_row, m_threads_nb, execution_plan));
   } else {
     return std::unique_ptr<Measurement>(new DummyMeasurement());
   }
@@ -22,11 +22,14 @@
  */
 
 #include <iostream>
+#include <algorithm>
 #include <chrono>
 #include <atomic>
 #include <ElementsKernel/Logging.h>
 #include <csignal>
+#include <exception>
 
+#include "SEFramework/Pipeline/MemoryGovernor.h"
 #include "SEImplementation/Plugin/SourceIDs/SourceID.h"
 #include "SEImplementation/Measurement/MultithreadedMeasurement.h"
 
@@ -36,6 +39,20 @@ static Elements::Logging logger = Elements::Logging::getLogger("Multithreading")
 
 std::recursive_mutex MultithreadedMeasurement::g_global_mutex;
 
+struct MultithreadedMeasurement::SharedLoop {
+  SharedLoop(std::size_t n, const std::function<void(std::size_t)>& body)
+    : m_n(n), m_body(body), m_next(0), m_done(0) {}
+
+  std::size_t m_n;
+  const std::function<void(std::size_t)>& m_body;
+  std::atomic<std::size_t> m_next;
+  // Protected by m_mutex
+  std::size_t m_done;
+  std::exception_ptr m_error;
+  std::mutex m_mutex;
+  std::condition_variable m_all_done;
+};
+
 void MultithreadedMeasurement::startThreads() {
   // Start worker threads
   m_active_threads = m_worker_threads_nb;
@@ -67,7 +84,17 @@ void MultithreadedMeasurement::waitForThreads() {
 }
 
 void MultithreadedMeasurement::handleMessage(const std::shared_ptr<SourceGroupInterface>& source_group) {
+  // Hold the producers while the pipeline is over its memory budget. The budget may be held by the
+  // stages downstream, so keep letting in one group per worker, otherwise the measurement would be
+  // serialized until they release it
+  auto memory_governor = MemoryGovernor::getInstance();
+  memory_governor->waitForBudget([this]() { return m_groups_in_flight < std::max(m_worker_threads_nb, 1); });
+  auto group_size = memory_governor->estimate(*source_group);
+  memory_governor->charge(group_size);
+  ++m_groups_in_flight;
+
   std::unique_lock<std::mutex> input_lock(m_input_queue_mutex);
+  m_group_charges[m_group_counter] = group_size;
 
   //Force computation of SourceID here, where the order is still deterministic
   for (auto& source : *source_group) {
@@ -114,31 +141,69 @@ void MultithreadedMeasurement::outputThreadStatic(MultithreadedMeasurement* meas
 }
 
 void MultithreadedMeasurement::workerThreadLoop() {
+  ExecutionPlan::ParallelFor parallel_for = ExecutionPlan::serialFor;
+  if (m_worker_threads_nb > 1) {
+    parallel_for = [this](std::size_t n, const std::function<void(std::size_t)>& body) {
+      parallelFor(n, body);
+    };
+  }
+
   while (true) {
     int order_number;
     std::shared_ptr<SourceGroupInterface> source_group;
+    std::shared_ptr<SharedLoop> shared_loop;
     {
       std::unique_lock<std::mutex> input_lock(m_input_queue_mutex);
 
-      // We should end the thread once we're done with all input
-      if (m_input_done && m_input_queue.empty()) {
+      // We should end the thread once we're done with all input. While other workers are busy
+      // we may still help them
+      if (m_input_done && m_input_queue.empty() && m_busy_workers == 0) {
         break;
       }
 
-      // If the queue is empty but we expect more data, wait
+      // If the queue is empty, help another worker with the tasks of its source, or wait for more data
       if (m_input_queue.empty()) {
-        m_new_input.wait_for(input_lock, std::chrono::milliseconds(100));
-        continue;
+        if (m_shared_loops.empty()) {
+          m_new_input.wait_for(input_lock, std::chrono::milliseconds(100));
+          continue;
+        }
+        shared_loop = m_shared_loops.front();
       }
+      else {
+        order_number = m_input_queue.front().first;
+        source_group = m_input_queue.front().second;
+        m_input_queue.pop_front();
+        ++m_busy_workers;
+      }
+    }
 
-      order_number = m_input_queue.front().first;
-      source_group = m_input_queue.front().second;
-      m_input_queue.pop_front();
+    if (shared_loop) {
+      runSharedLoop(*shared_loop);
+      // All the iterations are taken, so nobody else needs to see it
+      std::unique_lock<std::mutex> input_lock(m_input_queue_mutex);
+      m_shared_loops.remove(shared_loop);
+      continue;
     }
 
     // Trigger measurements
-    for (auto& source : *source_group) {
-      m_source_to_row(source);
+    try {
+      for (auto& source : *source_group) {
+        if (m_execution_plan) {
+          m_execution_plan->execute(source, parallel_for);
+        }
+        m_source_to_row(source);
+      }
+    }
+    catch (...) {
+      std::unique_lock<std::mutex> input_lock(m_input_queue_mutex);
+      --m_busy_workers;
+      throw;
+    }
+
+    {
+      std::unique_lock<std::mutex> input_lock(m_input_queue_mutex);
+      --m_busy_workers;
+      m_new_input.notify_all();
     }
 
     {
@@ -156,7 +221,51 @@ void MultithreadedMeasurement::workerThreadLoop() {
   }
 }
 
+void MultithreadedMeasurement::runSharedLoop(SharedLoop& loop) {
+  std::size_t i;
+  while ((i = loop.m_next++) < loop.m_n) {
+    std::exception_ptr error;
+    try {
+      loop.m_body(i);
+    }
+    catch (...) {
+      error = std::current_exception();
+    }
+    std::lock_guard<std::mutex> lock(loop.m_mutex);
+    if (error && !loop.m_error) {
+      loop.m_error = error;
+    }
+    if (++loop.m_done == loop.m_n) {
+      loop.m_all_done.notify_all();
+    }
+  }
+}
+
+void MultithreadedMeasurement::parallelFor(std::size_t n, const std::function<void(std::size_t)>& body) {
+  // Only the workers with nothing else to do join, so this never runs more threads than configured
+  auto loop = std::make_shared<SharedLoop>(n, body);
+  {
+    std::unique_lock<std::mutex> input_lock(m_input_queue_mutex);
+    m_shared_loops.push_back(loop);
+    m_new_input.notify_all();
+  }
+
+  runSharedLoop(*loop);
+  {
+    std::unique_lock<std::mutex> input_lock(m_input_queue_mutex);
+    m_shared_loops.remove(loop);
+  }
+
+  // The body is only used while iterations are left, so it is safe to return once they are done
+  std::unique_lock<std::mutex> loop_lock(loop->m_mutex);
+  loop->m_all_done.wait(loop_lock, [&loop]() { return loop->m_done == loop->m_n; });
+  if (loop->m_error) {
+    std::rethrow_exception(loop->m_error);
+  }
+}
+
 void MultithreadedMeasurement::outputThreadLoop() {
+  auto memory_governor = MemoryGovernor::getInstance();
   while (true) {
     {
       std::unique_lock<std::mutex> output_lock(m_output_queue_mutex);
@@ -168,6 +277,16 @@ void MultithreadedMeasurement::outputThreadLoop() {
 
       // Process the output queue
       while(!m_output_queue.empty()) {
+        // The observers take over the memory charge of the group
+        std::size_t group_size;
+        {
+          std::unique_lock<std::mutex> input_lock(m_input_queue_mutex);
+          auto charge = m_group_charges.find(m_output_queue.front().first);
+          group_size = charge->second;
+          m_group_charges.erase(charge);
+        }
+        --m_groups_in_flight;
+        memory_governor->release(group_size);
         notifyObservers(m_output_queue.front().second);
         m_output_queue.pop_front();
       }
@@ -20,8 +20,10 @@
  * @author mschefer
  */
 #include <limits>
+#include <vector>
 
 #include "SEFramework/Image/Image.h"
+#include "SEFramework/Image/ImageChunk.h"
 #include "SEFramework/Property/DetectionFrame.h"
 
 #include "SEImplementation/Property/PixelCoordinateList.h"
@@ -31,6 +33,23 @@
 
 namespace SourceXtractor {
 
+namespace {
+
+int findRoot(std::vector<int>& parent, int i) {
+  int root = i;
+  while (parent[root] != root) {
+    root = parent[root];
+  }
+  while (parent[i] != root) {
+    int next = parent[i];
+    parent[i] = root;
+    i = next;
+  }
+  return root;
+}
+
+} // end of anonymous namespace
+
 std::vector<std::shared_ptr<SourceInterface>> AttractorsPartitionStep::partition(std::shared_ptr<SourceInterface> source) const {
   auto& stamp = source->getProperty<DetectionFrameSourceStamp>().getStamp();
   auto& detection_frame = source->getProperty<DetectionFrame>();
@@ -38,26 +57,19 @@ std::vector<std::shared_ptr<SourceInterface>> AttractorsPartitionStep::partition
 
   auto bbox_min = bounds.getMin();
   auto bbox_max = bounds.getMax();
-
-  auto value_function = [bbox_min, bbox_max, &stamp](PixelCoordinate coord) {
-    if (coord.m_x < bbox_min.m_x || coord.m_x > bbox_max.m_x || coord.m_y < bbox_min.m_y || coord.m_y > bbox_max.m_y) {
-      return std::numeric_limits<DetectionImage::PixelType>::lowest();
+  int width = bbox_max.m_x - bbox_min.m_x + 1;
+  int height = bbox_max.m_y - bbox_min.m_y + 1;
+
+  std::vector<DetectionImage::PixelType> values(width * height);
+  auto chunk = stamp.getChunk(0, 0, width, height);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      values[x + y * width] = chunk->getValue(x, y);
     }
-    auto offset_coord = coord - bbox_min;
-    return stamp.getValue(offset_coord.m_x, offset_coord.m_y);
-  };
-
-  std::vector<std::pair<PixelCoordinate, PixelCoordinate>> pixel_coordinates;
-  auto& pixel_list = source->getProperty<PixelCoordinateList>().getCoordinateList();
-  pixel_coordinates.reserve(pixel_list.size());
-  for (auto& pixel : pixel_list) {
-    pixel_coordinates.emplace_back(pixel, pixel);
   }
 
-  std::unordered_map<PixelCoordinate, std::vector<PixelCoordinate>> attractors;
-
-  attractPixels(pixel_coordinates, attractors, value_function);
-  auto merged = mergeAttractors(attractors);
+  auto& pixel_list = source->getProperty<PixelCoordinateList>().getCoordinateList();
+  auto merged = attractPixels(pixel_list, bbox_min, values, width, height);
 
   // If we end up with a single group use the original group
   if (merged.size() == 1) {
@@ -75,82 +87,81 @@ std::vector<std::shared_ptr<SourceInterface>> AttractorsPartitionStep::partition
   }
 }
 
-void AttractorsPartitionStep::attractPixels(
-    const std::vector<std::pair<PixelCoordinate, PixelCoordinate>>& pixels_with_origin,
-    std::unordered_map<PixelCoordinate, std::vector<PixelCoordinate>>& attractors,
-    std::function<DetectionImage::PixelType  (PixelCoordinate)> value_function) const {
-
-  PixelCoordinate offsets[5] {
-    PixelCoordinate( 0,  0),
-    PixelCoordinate(-1,  0),
-    PixelCoordinate( 0, -1),
-    PixelCoordinate( 1,  0),
-    PixelCoordinate( 0,  1)
-  };
-
-  if (pixels_with_origin.size() == 0) {
-    return;
-  }
-
-  std::vector<std::pair<PixelCoordinate, PixelCoordinate>> pixels_to_be_processed;
-
-  for (auto& pixel_origin : pixels_with_origin) {
-    auto pixel = pixel_origin.first;
-    auto origin = pixel_origin.second;
-
-    DetectionImage::PixelType values[5];
-    for (int i=0; i<5; i++) {
-      values[i] = value_function(pixel + offsets[i]);
-    }
-
-    size_t max = 0;
-    for (int i=1; i<3; i++) {
-      if (values[i] > values[max]) {
-        max = i;
+std::vector<std::vector<PixelCoordinate>> AttractorsPartitionStep::attractPixels(
+    const std::vector<PixelCoordinate>& pixel_list, PixelCoordinate bbox_min,
+    const std::vector<DetectionImage::PixelType>& values, int width, int height) const {
+  const auto lowest = std::numeric_limits<DetectionImage::PixelType>::lowest();
+
+  // Steepest ascent step for every pixel of the stamp. Left and up only win on a strictly
+  // higher value, right and down also on ties, so plateaus are climbed without cycles.
+  std::vector<int> next(width * height);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      int index = x + y * width;
+      int neighbours[4] = {index - 1, index - width, index + 1, index + width};
+      DetectionImage::PixelType neighbour_values[4] = {
+        x > 0 ? values[index - 1] : lowest,
+        y > 0 ? values[index - width] : lowest,
+        x < width - 1 ? values[index + 1] : lowest,
+        y < height - 1 ? values[index + width] : lowest
+      };
+
+      int max = index;
+      auto max_value = values[index];
+      for (int i = 0; i < 2; ++i) {
+        if (neighbour_values[i] > max_value) {
+          max = neighbours[i];
+          max_value = neighbour_values[i];
+        }
       }
-    }
-    for (int i=3; i<5; i++) {
-      if (values[i] >= values[max]) {
-        max = i;
+      for (int i = 2; i < 4; ++i) {
+        if (neighbour_values[i] >= max_value) {
+          max = neighbours[i];
+          max_value = neighbour_values[i];
+        }
       }
+      next[index] = max;
     }
+  }
 
-    if (max == 0) {
-      // We are at the attractor pixel
-      attractors[pixel].push_back(origin);
-    } else {
-      pixels_to_be_processed.push_back(
-          std::pair<PixelCoordinate, PixelCoordinate>(pixel + offsets[max], origin));
+  // Follow the paths, compressing them so every pixel is visited a bounded number of times.
+  // Afterwards, next points directly to the attractor for every pixel of the source.
+  // The attractors themselves are merged when they are adjacent
+  std::vector<int> attractor_of(pixel_list.size());
+  std::vector<int> merge(width * height, -1);
+  for (size_t i = 0; i < pixel_list.size(); ++i) {
+    int index = (pixel_list[i].m_x - bbox_min.m_x) + (pixel_list[i].m_y - bbox_min.m_y) * width;
+    int attractor = findRoot(next, index);
+    attractor_of[i] = attractor;
+
+    if (merge[attractor] < 0) {
+      merge[attractor] = attractor;
+      int ax = attractor % width, ay = attractor / width;
+      for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+          int nx = ax + dx, ny = ay + dy;
+          if ((dx == 0 && dy == 0) || nx < 0 || nx >= width || ny < 0 || ny >= height) {
+            continue;
+          }
+          int neighbour = nx + ny * width;
+          if (merge[neighbour] >= 0) {
+            merge[findRoot(merge, neighbour)] = findRoot(merge, attractor);
+          }
+        }
+      }
     }
   }
-  attractPixels(pixels_to_be_processed, attractors, value_function);
-}
 
-std::vector<std::vector<PixelCoordinate>> AttractorsPartitionStep::mergeAttractors(
-    const std::unordered_map<PixelCoordinate, std::vector<PixelCoordinate>>& attractors) const {
+  // Groups are sorted by the first of their pixels on the source
+  std::vector<int> group_of(width * height, -1);
   std::vector<std::vector<PixelCoordinate>> merged;
-  std::vector<PixelCoordinate> bbox_min;
-  std::vector<PixelCoordinate> bbox_max;
-
-  for (auto& attractor : attractors) {
-    auto coord = attractor.first;
-    auto& pixels = attractor.second;
-    bool done = false;
-
-    for (size_t i=0; i < merged.size(); i++) {
-      if (coord.m_x >= bbox_min[i].m_x-1 && coord.m_x <= bbox_max[i].m_x+1 && coord.m_y >= bbox_min[i].m_y-1 && coord.m_y <= bbox_max[i].m_y+1) {
-        bbox_min[i] = PixelCoordinate(std::min(coord.m_x, bbox_min[i].m_x), std::min(coord.m_y, bbox_min[i].m_y));
-        bbox_max[i] = PixelCoordinate(std::max(coord.m_x, bbox_max[i].m_x), std::max(coord.m_y, bbox_max[i].m_y));
-        merged[i].insert(merged[i].begin(), pixels.begin(), pixels.end());
-        done = true;
-        break;
-      }
-    }
-    if (!done) {
-      merged.push_back(pixels);
-      bbox_min.push_back(coord);
-      bbox_max.push_back(coord);
+  for (size_t i = 0; i < pixel_list.size(); ++i) {
+    int root = findRoot(merge, attractor_of[i]);
+    if (group_of[root] < 0) {
+      group_of[root] = merged.size();
+      merged.emplace_back();
     }
+    merged[group_of[root]].push_back(pixel_list[i]);
   }
   return merged;
 }
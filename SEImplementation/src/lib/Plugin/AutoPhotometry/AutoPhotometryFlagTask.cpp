@@ -75,7 +75,8 @@ void AutoPhotometryFlagTask::computeProperties(SourceInterface& source) const {
   auto ell_aper = std::make_shared<EllipticalAperture>(cxx, cyy, cxy, kron_radius_auto);
 
   // get the neighbourhood information
-  Flags global_flag = computeFlags(ell_aper, centroid_x, centroid_y, pix_list, detection_image,
+  EllipticalScan ellipse(cxx, cyy, cxy, kron_radius_auto, centroid_x, centroid_y);
+  Flags global_flag = computeFlags(ellipse, pix_list, detection_image,
                                    detection_variance, threshold_image, variance_threshold);
 
   // set the source properties
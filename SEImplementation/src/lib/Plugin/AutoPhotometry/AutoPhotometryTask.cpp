@@ -77,8 +77,11 @@ void AutoPhotometryTask::computeProperties(SourceInterface &source) const {
     std::make_shared<EllipticalAperture>(cxx, cyy, cxy, kron_radius_auto),
     jacobian.asTuple());
 
-  auto measurement = measureFlux(ell_aper, centroid_x, centroid_y, measurement_image, variance_map, variance_threshold,
-                                 m_use_symmetry);
+  // the same ellipse, without virtual calls per pixel
+  auto ellipse = EllipticalScan::transformed(cxx, cyy, cxy, kron_radius_auto, centroid_x, centroid_y,
+                                             jacobian.asTuple());
+
+  auto measurement = measureFlux(ellipse, measurement_image, variance_map, variance_threshold, m_use_symmetry);
 
   // compute the derived quantities
   auto total_variance = measurement.m_variance;
@@ -0,0 +1,113 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * DetectionFrameSourceStamp.cpp
+ */
+
+#include <mutex>
+#include <vector>
+
+#include "SEFramework/Image/ImageChunk.h"
+#include "SEImplementation/Plugin/DetectionFrameSourceStamp/DetectionFrameSourceStamp.h"
+
+namespace SourceXtractor {
+
+using StampPixelType = DetectionImage::PixelType;
+
+struct DetectionFrameSourceStamp::LazyLayers {
+  LazyLayers(const DetectionFrameImages& images, PixelCoordinate top_left, int width, int height)
+    : m_images(images), m_top_left(top_left), m_width(width), m_height(height) {}
+
+  DetectionFrameImages m_images;
+  PixelCoordinate m_top_left;
+  int m_width, m_height;
+
+  /// The layers read so far, one after the other in the order they were requested. The size of all
+  /// the layers is reserved on the first read, so the arena grows by one layer at a time without
+  /// moving the layers already read, and only those are ever written to
+  std::shared_ptr<std::vector<StampPixelType>> m_arena;
+  std::mutex m_arena_mutex;
+  std::array<std::once_flag, s_nlayers> m_layer_flags;
+  /// Views over the arena
+  std::array<std::shared_ptr<DetectionImage>, s_nlayers> m_views;
+};
+
+namespace {
+
+// In the order of the layers of the stamp
+const FrameImageLayer s_frame_layers[] = {
+  LayerSubtractedImage, LayerFilteredImage, LayerThresholdedImage, LayerVarianceMap, LayerDetectionThresholdMap
+};
+
+/// A layer of the arena of a stamp. It keeps the arena alive, so chunks taken from it outlive the stamp
+class ArenaLayer : public ImageChunk<StampPixelType> {
+public:
+  ArenaLayer(std::shared_ptr<std::vector<StampPixelType>> arena, std::size_t offset, int width, int height)
+    : ImageChunk<StampPixelType>(arena->data() + offset, width, height, width), m_arena(arena) {}
+
+  std::string getRepr() const override {
+    return "ArenaLayer<" + std::to_string(m_width) + "," + std::to_string(m_height) + ">";
+  }
+
+private:
+  std::shared_ptr<std::vector<StampPixelType>> m_arena;
+};
+
+}
+
+DetectionFrameSourceStamp::DetectionFrameSourceStamp(const DetectionFrameImages& images, PixelCoordinate top_left,
+                                                     int width, int height)
+  : m_lazy(std::make_shared<LazyLayers>(images, top_left, width, height)), m_top_left(top_left) {}
+
+const DetectionImage& DetectionFrameSourceStamp::getLayer(int index) const {
+  if (m_lazy) {
+    auto& lazy = *m_lazy;
+    std::call_once(lazy.m_layer_flags[index], [&lazy, index]() {
+      std::size_t layer_size = static_cast<std::size_t>(lazy.m_width) * lazy.m_height;
+      std::size_t offset;
+      {
+        std::lock_guard<std::mutex> lock(lazy.m_arena_mutex);
+        if (!lazy.m_arena) {
+          lazy.m_arena = std::make_shared<std::vector<StampPixelType>>();
+          lazy.m_arena->reserve(s_nlayers * layer_size);
+        }
+        offset = lazy.m_arena->size();
+        lazy.m_arena->resize(offset + layer_size);
+      }
+
+      // getImageChunk serializes on the global mutex, and it has to: the frame creates the filtered,
+      // thresholded and variance images the first time they are requested, and images without their own
+      // getChunk (e.g. the thresholded image) are read through getValue, which on a BufferedImage caches
+      // the current tile without any synchronization. The lock is only held while reading the chunk.
+      auto chunk = lazy.m_images.getImageChunk(s_frame_layers[index], lazy.m_top_left.m_x, lazy.m_top_left.m_y,
+                                               lazy.m_width, lazy.m_height);
+
+      // Copy the pixels, so the stamp does not keep the tiles the chunk may point to alive
+      auto layer = lazy.m_arena->data() + offset;
+      for (int y = 0; y < lazy.m_height; ++y) {
+        for (int x = 0; x < lazy.m_width; ++x) {
+          layer[x + y * lazy.m_width] = chunk->getValue(x, y);
+        }
+      }
+      lazy.m_views[index] = std::make_shared<ArenaLayer>(lazy.m_arena, offset, lazy.m_width, lazy.m_height);
+    });
+    return *lazy.m_views[index];
+  }
+  return *m_layers[index];
+}
+
+} // SourceXtractor namespace
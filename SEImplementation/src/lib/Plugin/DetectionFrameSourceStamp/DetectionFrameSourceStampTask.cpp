@@ -23,7 +23,6 @@
 #include <mutex>
 
 #include "SEFramework/Image/Image.h"
-#include "SEFramework/Image/VectorImage.h"
 #include "SEImplementation/Plugin/PixelBoundaries/PixelBoundaries.h"
 #include "SEImplementation/Plugin/DetectionFrameImages/DetectionFrameImages.h"
 
@@ -36,7 +35,7 @@ namespace SourceXtractor {
 
 void DetectionFrameSourceStampTask::computeProperties(SourceInterface& source) const {
 
-  auto detection_frame_images = source.getProperty<DetectionFrameImages>();
+  const auto& detection_frame_images = source.getProperty<DetectionFrameImages>();
 
   const auto& boundaries = source.getProperty<PixelBoundaries>();
   auto min = boundaries.getMin();
@@ -57,18 +56,8 @@ void DetectionFrameSourceStampTask::computeProperties(SourceInterface& source) c
   auto width = max.m_x - min.m_x +1;
   auto height = max.m_y - min.m_y + 1;
 
-  std::shared_ptr<DetectionImage> stamp = VectorImage<DetectionImage::PixelType>::create(
-      *detection_frame_images.getImageChunk(LayerSubtractedImage, min.m_x, min.m_y, width, height));
-  std::shared_ptr<DetectionImage> filtered_stamp = VectorImage<DetectionImage::PixelType>::create(
-      *detection_frame_images.getImageChunk(LayerFilteredImage, min.m_x, min.m_y, width, height));
-  std::shared_ptr<DetectionImage> thresholded_stamp = VectorImage<DetectionImage::PixelType>::create(
-      *detection_frame_images.getImageChunk(LayerThresholdedImage, min.m_x, min.m_y, width, height));
-  std::shared_ptr<WeightImage> variance_stamp = VectorImage<WeightImage::PixelType>::create(
-      *detection_frame_images.getImageChunk(LayerVarianceMap, min.m_x, min.m_y, width, height));
-  std::shared_ptr<DetectionImage> threshold_map_stamp = VectorImage<DetectionImage::PixelType>::create(
-      *detection_frame_images.getImageChunk(LayerDetectionThresholdMap, min.m_x, min.m_y, width, height));
-
-  source.setProperty<DetectionFrameSourceStamp>(stamp, filtered_stamp, thresholded_stamp, min, variance_stamp, threshold_map_stamp);
+  // The layers are only read when requested
+  source.setProperty<DetectionFrameSourceStamp>(detection_frame_images, min, width, height);
 }
 
 } // SEImplementation namespace
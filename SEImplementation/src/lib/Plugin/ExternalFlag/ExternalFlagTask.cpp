@@ -20,8 +20,12 @@
  * @author nikoapos
  */
 
+#include <algorithm>
+#include <limits>
+#include <map>
 #include <mutex>
 
+#include "SEFramework/Image/ImageChunk.h"
 #include "SEImplementation/Property/PixelCoordinateList.h"
 #include "SEImplementation/Measurement/MultithreadedMeasurement.h"
 #include "SEImplementation/Plugin/DetectionFrameInfo/DetectionFrameInfo.h"
@@ -36,15 +40,61 @@ ExternalFlagTask<Combine>::~ExternalFlagTask() {
 
 template<typename Combine>
 ExternalFlagTask<Combine>::ExternalFlagTask(std::shared_ptr<FlagImage> flag_image, unsigned int flag_instance)
-  : m_flag_image(flag_image), m_flag_instance(flag_instance) {
+  : m_flag_image(flag_image), m_flag_instance(flag_instance),
+    m_blocks_x((flag_image->getWidth() + s_block_size - 1) / s_block_size),
+    m_blocks_y((flag_image->getHeight() + s_block_size - 1) / s_block_size),
+    m_block_state(new std::atomic<char>[m_blocks_x * m_blocks_y]) {
+  for (int i = 0; i < m_blocks_x * m_blocks_y; ++i) {
+    m_block_state[i].store(0, std::memory_order_relaxed);
+  }
 }
 
 
 template<typename Combine>
-void ExternalFlagTask<Combine>::computeProperties(SourceInterface &source) const {
-  // FIXME: for flag_image access, the external flags image not part of detection frame?!
-  std::lock_guard<std::recursive_mutex> lock(MultithreadedMeasurement::g_global_mutex);
+bool ExternalFlagTask<Combine>::isZero(int min_x, int min_y, int max_x, int max_y) const {
+  for (int by = min_y / s_block_size; by <= max_y / s_block_size; ++by) {
+    for (int bx = min_x / s_block_size; bx <= max_x / s_block_size; ++bx) {
+      auto& state = m_block_state[bx + by * m_blocks_x];
+      char value = state.load(std::memory_order_acquire);
+      if (value == 0) {
+        int x = bx * s_block_size, y = by * s_block_size;
+        int w = std::min(s_block_size, m_flag_image->getWidth() - x);
+        int h = std::min(s_block_size, m_flag_image->getHeight() - y);
+        std::shared_ptr<ImageChunk<FlagImage::PixelType>> chunk;
+        {
+          std::lock_guard<std::recursive_mutex> lock(MultithreadedMeasurement::g_global_mutex);
+          chunk = m_flag_image->getChunk(x, y, w, h);
+        }
+        value = 1;
+        for (int iy = 0; iy < h && value == 1; ++iy) {
+          for (int ix = 0; ix < w; ++ix) {
+            if (chunk->getValue(ix, iy) != 0) {
+              value = 2;
+              break;
+            }
+          }
+        }
+        // Concurrent checks of the same block reach the same result, so the last store wins harmlessly
+        state.store(value, std::memory_order_release);
+      }
+      if (value != 1) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
 
+
+template<typename Combine>
+std::vector<PropertyId> ExternalFlagTask<Combine>::getDependencies() const {
+  // The flag image is only read under the global lock, and no property is read meanwhile
+  return {PropertyId::create<DetectionFrameInfo>(), PropertyId::create<PixelCoordinateList>()};
+}
+
+
+template<typename Combine>
+void ExternalFlagTask<Combine>::computeProperties(SourceInterface &source) const {
   const auto& detection_frame_info = source.getProperty<DetectionFrameInfo>();
 
   if (m_flag_image->getWidth() != detection_frame_info.getWidth() ||
@@ -55,88 +105,129 @@ void ExternalFlagTask<Combine>::computeProperties(SourceInterface &source) const
       << detection_frame_info.getWidth() << "x" << detection_frame_info.getHeight();
   }
 
-  std::vector<FlagImage::PixelType> pixel_flags{};
-  for (auto& coords : source.getProperty<PixelCoordinateList>().getCoordinateList()) {
-    pixel_flags.push_back(m_flag_image->getValue(coords.m_x, coords.m_y));
+  const auto& pixel_coords = source.getProperty<PixelCoordinateList>().getCoordinateList();
+
+  Combine combine;
+  if (!pixel_coords.empty()) {
+    int min_x = pixel_coords.front().m_x, max_x = min_x;
+    int min_y = pixel_coords.front().m_y, max_y = min_y;
+    for (auto& coords : pixel_coords) {
+      min_x = std::min(min_x, coords.m_x);
+      max_x = std::max(max_x, coords.m_x);
+      min_y = std::min(min_y, coords.m_y);
+      max_y = std::max(max_y, coords.m_y);
+    }
+
+    if (isZero(min_x, min_y, max_x, max_y)) {
+      for (std::size_t i = 0; i < pixel_coords.size(); ++i) {
+        combine.add(0);
+      }
+    }
+    else {
+      // The flag image is shared by all the measurement threads, so only the copy of the rows
+      // covering the footprint is done under the lock. The chunk is private to this thread.
+      std::shared_ptr<ImageChunk<FlagImage::PixelType>> chunk;
+      {
+        std::lock_guard<std::recursive_mutex> lock(MultithreadedMeasurement::g_global_mutex);
+        chunk = m_flag_image->getChunk(min_x, min_y, max_x - min_x + 1, max_y - min_y + 1);
+      }
+      for (auto& coords : pixel_coords) {
+        combine.add(chunk->getValue(coords.m_x - min_x, coords.m_y - min_y));
+      }
+    }
   }
+
   std::int64_t flag = 0;
   int count = 0;
-  std::tie(flag, count) = Combine::combine(pixel_flags);
+  std::tie(flag, count) = combine.result();
   source.setIndexedProperty<ExternalFlag>(m_flag_instance, flag, count);
 }
 
 
 namespace ExternalFlagCombineTypes {
 
+// The combiners fold the pixel values as they are read, so no intermediate list is needed
+
 struct Or {
-  static std::pair<std::int64_t, int> combine(const std::vector<FlagImage::PixelType> &pixel_flags) {
-    std::int64_t flag = 0;
-    int count = 0;
-    for (auto pix_flag : pixel_flags) {
-      if (pix_flag != 0) {
-        flag |= pix_flag;
-        ++count;
-      }
+  std::int64_t flag = 0;
+  int count = 0;
+
+  void add(FlagImage::PixelType pix_flag) {
+    if (pix_flag != 0) {
+      flag |= pix_flag;
+      ++count;
     }
+  }
+
+  std::pair<std::int64_t, int> result() const {
     return {flag, count};
   }
 };
 
 struct And {
-  static std::pair<std::int64_t, int> combine(const std::vector<FlagImage::PixelType> &pixel_flags) {
-    std::int64_t flag = std::numeric_limits<std::int64_t>::max();
-    int count = pixel_flags.size();
-    for (auto pix_flag : pixel_flags) {
-      flag &= pix_flag;
-    }
+  std::int64_t flag = std::numeric_limits<std::int64_t>::max();
+  int count = 0;
+
+  void add(FlagImage::PixelType pix_flag) {
+    flag &= pix_flag;
+    ++count;
+  }
+
+  std::pair<std::int64_t, int> result() const {
     return {flag, count};
   }
 };
 
 struct Min {
-  static std::pair<std::int64_t, int> combine(const std::vector<FlagImage::PixelType> &pixel_flags) {
-    std::int64_t flag = std::numeric_limits<std::int64_t>::max();
-    int count = 0;
-    for (auto pix_flag : pixel_flags) {
-      if (pix_flag < flag) {
-        flag = pix_flag;
-        count = 1;
-      } else if (pix_flag == flag) {
-        ++count;
-      }
+  std::int64_t flag = std::numeric_limits<std::int64_t>::max();
+  int count = 0;
+
+  void add(FlagImage::PixelType pix_flag) {
+    if (pix_flag < flag) {
+      flag = pix_flag;
+      count = 1;
+    } else if (pix_flag == flag) {
+      ++count;
     }
+  }
+
+  std::pair<std::int64_t, int> result() const {
     if (count == 0) {
-      flag = 0;
+      return {0, 0};
     }
     return {flag, count};
   }
 };
 
 struct Max {
-  static std::pair<std::int64_t, int> combine(const std::vector<FlagImage::PixelType> &pixel_flags) {
-    std::int64_t flag = 0;
-    int count = 0;
-    for (auto pix_flag : pixel_flags) {
-      if (pix_flag > flag) {
-        flag = pix_flag;
-        count = 1;
-      } else if (pix_flag == flag) {
-        ++count;
-      }
+  std::int64_t flag = 0;
+  int count = 0;
+
+  void add(FlagImage::PixelType pix_flag) {
+    if (pix_flag > flag) {
+      flag = pix_flag;
+      count = 1;
+    } else if (pix_flag == flag) {
+      ++count;
     }
+  }
+
+  std::pair<std::int64_t, int> result() const {
     if (count == 0) {
-      flag = 0;
+      return {0, 0};
     }
     return {flag, count};
   }
 };
 
 struct Most {
-  static std::pair<std::int64_t, int> combine(const std::vector<FlagImage::PixelType> &pixel_flags) {
-    std::map<FlagImage::PixelType, int> counters;
-    for (auto pix_flag : pixel_flags) {
-      counters[pix_flag] += 1;
-    }
+  std::map<FlagImage::PixelType, int> counters;
+
+  void add(FlagImage::PixelType pix_flag) {
+    counters[pix_flag] += 1;
+  }
+
+  std::pair<std::int64_t, int> result() const {
     std::int64_t flag = 0;
     int count = 0;
     for (auto& pair : counters) {
@@ -0,0 +1,124 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * FlexibleModelFittingBinning.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <numeric>
+#include <vector>
+
+#include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingBinning.h"
+
+namespace SourceXtractor {
+
+BinnedStamp binStamp(const VectorImage<SeFloat>& image, const VectorImage<SeFloat>& weight, int binning) {
+  int width = image.getWidth() / binning;
+  int height = image.getHeight() / binning;
+  BinnedStamp binned{VectorImage<SeFloat>::create(width, height), VectorImage<SeFloat>::create(width, height)};
+
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      SeFloat value = 0, variance = 0;
+      bool masked = false;
+      for (int dy = 0; dy < binning; ++dy) {
+        for (int dx = 0; dx < binning; ++dx) {
+          int fx = x * binning + dx, fy = y * binning + dy;
+          SeFloat w = weight.getValue(fx, fy);
+          masked |= (w <= 0);
+          if (!masked) {
+            value += image.getValue(fx, fy);
+            variance += 1 / (w * w);
+          }
+        }
+      }
+      binned.m_image->at(x, y) = masked ? 0 : value;
+      binned.m_weight->at(x, y) = masked ? 0 : 1 / std::sqrt(variance);
+    }
+  }
+
+  return binned;
+}
+
+std::shared_ptr<VectorImage<SeFloat>> binPsf(const VectorImage<SeFloat>& psf, int binning) {
+  int half = psf.getWidth() / 2;
+  int binned_half = (half + binning - 1) / binning;
+  int binned_size = 2 * binned_half + 1;
+
+  // Weight of a fine pixel at the given distance from the center of the box. The box is
+  // binning pixels wide, so for an even binning the pixels on the border are only half inside
+  std::vector<SeFloat> box(binning / 2 + 1, 1);
+  if (binning % 2 == 0) {
+    box.back() = 0.5;
+  }
+
+  // The kernel is separable, so first collapse the rows and then the columns
+  auto rows = VectorImage<SeFloat>::create(binned_size, psf.getHeight());
+  for (int y = 0; y < psf.getHeight(); ++y) {
+    for (int bx = 0; bx < binned_size; ++bx) {
+      int center = half + (bx - binned_half) * binning;
+      SeFloat value = 0;
+      for (int d = -binning / 2; d <= binning / 2; ++d) {
+        int x = center + d;
+        if (x >= 0 && x < psf.getWidth()) {
+          value += box[std::abs(d)] * psf.getValue(x, y);
+        }
+      }
+      rows->at(bx, y) = value;
+    }
+  }
+
+  auto binned = VectorImage<SeFloat>::create(binned_size, binned_size);
+  for (int by = 0; by < binned_size; ++by) {
+    int center = half + (by - binned_half) * binning;
+    for (int bx = 0; bx < binned_size; ++bx) {
+      SeFloat value = 0;
+      for (int d = -binning / 2; d <= binning / 2; ++d) {
+        int y = center + d;
+        if (y >= 0 && y < psf.getHeight()) {
+          value += box[std::abs(d)] * rows->getValue(bx, y);
+        }
+      }
+      binned->at(bx, by) = value;
+    }
+  }
+
+  // The boxes on the border may fall partially outside the kernel
+  SeFloat original_sum = std::accumulate(psf.getData().begin(), psf.getData().end(), SeFloat(0));
+  SeFloat binned_sum = std::accumulate(binned->getData().begin(), binned->getData().end(), SeFloat(0));
+  if (binned_sum != 0) {
+    for (auto& v : binned->getData()) {
+      v *= original_sum / binned_sum;
+    }
+  }
+
+  return binned;
+}
+
+unsigned int coarseLevels(int width, int height, unsigned int max_levels) {
+  unsigned int levels = 0;
+  while (levels < max_levels && (std::min(width, height) >> (levels + 1)) >= MIN_BINNED_STAMP_SIZE) {
+    ++levels;
+  }
+  return levels;
+}
+
+}
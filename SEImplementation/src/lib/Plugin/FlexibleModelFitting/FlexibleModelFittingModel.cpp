@@ -63,6 +63,20 @@ using namespace Euclid::Configuration;
 static const double MODEL_MIN_SIZE = 4.0;
 static const double MODEL_SIZE_FACTOR = 1.2;
 
+// Light of extended sources is still noticeable at a few effective radii
+static const double MODEL_EXTENT_RADII = 3.0;
+
+// Size of the stamp extended models are rendered on
+static int getModelSize(const SourceInterface& source) {
+  auto& boundaries = source.getProperty<PixelBoundaries>();
+  return std::max(MODEL_MIN_SIZE, MODEL_SIZE_FACTOR * std::max(boundaries.getWidth(), boundaries.getHeight()));
+}
+
+// Extended models have no flux beyond their stamp, but a large profile still has flux beyond it on the image
+static double getExtendedModelExtent(const SourceInterface& source, double effective_radius) {
+  return std::max(getModelSize(source) / 2., MODEL_EXTENT_RADII * effective_radius);
+}
+
 // Reference for Sersic related quantities:
 // See https://ned.ipac.caltech.edu/level5/March05/Graham/Graham2.html
 
@@ -139,14 +153,18 @@ void FlexibleModelFittingExponentialModel::addForSource(FlexibleModelFittingPara
       [](double eff_radius) { return 1.678 / eff_radius; },
       manager.getParameter(source, m_effective_radius));
 
-  auto& boundaries = source.getProperty<PixelBoundaries>();
-  int size = std::max(MODEL_MIN_SIZE, MODEL_SIZE_FACTOR * std::max(boundaries.getWidth(), boundaries.getHeight()));
+  int size = getModelSize(source);
 
   extended_models.emplace_back(std::make_shared<CompactExponentialModel<ImageInterfaceTypePtr>>(
       2.0, i0, k, x_scale, manager.getParameter(source, m_aspect_ratio), manager.getParameter(source, m_angle),
       size, size, pixel_x, pixel_y, manager.getParameter(source, m_flux), jacobian));
 }
 
+double FlexibleModelFittingExponentialModel::getExtent(FlexibleModelFittingParameterManager& manager,
+                                                       const SourceInterface& source) const {
+  return getExtendedModelExtent(source, manager.getParameter(source, m_effective_radius)->getValue());
+}
+
 void FlexibleModelFittingDevaucouleursModel::addForSource(FlexibleModelFittingParameterManager& manager,
                           const SourceInterface& source,
                           std::vector<ModelFitting::ConstantModel>& /* constant_models */,
@@ -179,12 +197,16 @@ void FlexibleModelFittingDevaucouleursModel::addForSource(FlexibleModelFittingPa
       [](double eff_radius) { return 7.669 / pow(eff_radius, .25); },
       manager.getParameter(source, m_effective_radius));
 
-  auto& boundaries = source.getProperty<PixelBoundaries>();
-  int size = std::max(MODEL_MIN_SIZE, MODEL_SIZE_FACTOR * std::max(boundaries.getWidth(), boundaries.getHeight()));
+  int size = getModelSize(source);
 
   extended_models.emplace_back(std::make_shared<CompactSersicModel<ImageInterfaceTypePtr>>(
       3.0, i0, k, n, x_scale, manager.getParameter(source, m_aspect_ratio), manager.getParameter(source, m_angle),
-      size, size, pixel_x, pixel_y, manager.getParameter(source, m_flux), jacobian));
+      size, size, pixel_x, pixel_y, manager.getParameter(source, m_flux), jacobian, m_lut_tolerance));
+}
+
+double FlexibleModelFittingDevaucouleursModel::getExtent(FlexibleModelFittingParameterManager& manager,
+                                                         const SourceInterface& source) const {
+  return getExtendedModelExtent(source, manager.getParameter(source, m_effective_radius)->getValue());
 }
 
 static double computeBn(double n) {
@@ -223,12 +245,17 @@ void FlexibleModelFittingSersicModel::addForSource(FlexibleModelFittingParameter
       [](double eff_radius, double n) { return computeBn(n) / pow(eff_radius, 1.0 / n); },
       manager.getParameter(source, m_effective_radius), manager.getParameter(source, m_sersic_index));
 
-  auto& boundaries = source.getProperty<PixelBoundaries>();
-  int size = std::max(MODEL_MIN_SIZE, MODEL_SIZE_FACTOR * std::max(boundaries.getWidth(), boundaries.getHeight()));
+  int size = getModelSize(source);
 
   extended_models.emplace_back(std::make_shared<CompactSersicModel<ImageInterfaceTypePtr>>(
       3.0, i0, k, manager.getParameter(source, m_sersic_index), x_scale, manager.getParameter(source, m_aspect_ratio),
-      manager.getParameter(source, m_angle), size, size, pixel_x, pixel_y, manager.getParameter(source, m_flux), jacobian));
+      manager.getParameter(source, m_angle), size, size, pixel_x, pixel_y, manager.getParameter(source, m_flux), jacobian,
+      m_lut_tolerance));
+}
+
+double FlexibleModelFittingSersicModel::getExtent(FlexibleModelFittingParameterManager& manager,
+                                                  const SourceInterface& source) const {
+  return getExtendedModelExtent(source, manager.getParameter(source, m_effective_radius)->getValue());
 }
 
 void FlexibleModelFittingConstantModel::addForSource(FlexibleModelFittingParameterManager& manager,
@@ -0,0 +1,83 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * FlexibleModelFittingPartition.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <algorithm>
+#include <numeric>
+
+#include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingPartition.h"
+
+namespace SourceXtractor {
+
+namespace {
+
+std::size_t findRoot(std::vector<std::size_t>& parents, std::size_t i) {
+  while (parents[i] != i) {
+    parents[i] = parents[parents[i]];
+    i = parents[i];
+  }
+  return i;
+}
+
+}
+
+std::vector<std::vector<std::size_t>> partitionFootprints(const std::vector<FittingFootprint>& footprints) {
+  std::vector<std::size_t> parents(footprints.size());
+  std::iota(parents.begin(), parents.end(), 0);
+
+  // Sweep along x, so only footprints that overlap on that axis are compared
+  std::vector<std::size_t> order(footprints.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&footprints](std::size_t a, std::size_t b) {
+    return footprints[a].m_min.m_x < footprints[b].m_min.m_x;
+  });
+
+  std::vector<std::size_t> active;
+  for (auto i : order) {
+    auto& current = footprints[i];
+    active.erase(std::remove_if(active.begin(), active.end(), [&](std::size_t j) {
+      return footprints[j].m_max.m_x < current.m_min.m_x;
+    }), active.end());
+
+    for (auto j : active) {
+      if (current.overlaps(footprints[j])) {
+        auto root_i = findRoot(parents, i), root_j = findRoot(parents, j);
+        parents[std::max(root_i, root_j)] = std::min(root_i, root_j);
+      }
+    }
+    active.push_back(i);
+  }
+
+  // Roots are always the smallest index of their component, so components come ordered
+  std::vector<std::vector<std::size_t>> components;
+  std::vector<std::size_t> component_index(footprints.size());
+  for (std::size_t i = 0; i < footprints.size(); ++i) {
+    auto root = findRoot(parents, i);
+    if (root == i) {
+      component_index[i] = components.size();
+      components.emplace_back();
+    }
+    components[component_index[root]].push_back(i);
+  }
+  return components;
+}
+
+}
@@ -46,6 +46,15 @@ void FlexibleModelFittingPlugin::registerPlugin(PluginAPI& plugin_api) {
           "Reduced chi-square of the model fitting"
   );
 
+  plugin_api.getOutputRegistry().registerColumnConverter<FlexibleModelFitting, double>(
+          "fmf_source_reduced_chi_2",
+          [](const FlexibleModelFitting& prop) {
+            return prop.getSourceReducedChiSquared();
+          },
+          "",
+          "Reduced chi-square of the model fitting within the footprint of the source"
+  );
+
   plugin_api.getOutputRegistry().registerColumnConverter<FlexibleModelFitting, int>(
           "fmf_iterations",
           [](const FlexibleModelFitting& prop) {
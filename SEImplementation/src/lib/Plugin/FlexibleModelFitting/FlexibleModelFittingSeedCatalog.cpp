@@ -0,0 +1,85 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * FlexibleModelFittingSeedCatalog.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <cmath>
+#include <limits>
+
+#include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingSeedCatalog.h"
+
+namespace SourceXtractor {
+
+FlexibleModelFittingSeedCatalog::FlexibleModelFittingSeedCatalog(std::vector<Seed> seeds, MatchBy match_by,
+                                                                 double max_distance)
+  : m_seeds(std::move(seeds)), m_match_by(match_by), m_max_distance(max_distance > 0 ? max_distance : 1.) {
+  for (std::size_t i = 0; i < m_seeds.size(); ++i) {
+    auto& seed = m_seeds[i];
+    if (m_match_by == MatchBy::ID) {
+      m_by_id.emplace(seed.m_id, i);
+    }
+    else if (std::isfinite(seed.m_x) && std::isfinite(seed.m_y)) {
+      int cell_x = std::floor(seed.m_x / m_max_distance);
+      int cell_y = std::floor(seed.m_y / m_max_distance);
+      m_by_cell[cellKey(cell_x, cell_y)].push_back(i);
+    }
+  }
+}
+
+std::int64_t FlexibleModelFittingSeedCatalog::cellKey(int cell_x, int cell_y) const {
+  return (static_cast<std::int64_t>(cell_y) << 32) ^ static_cast<std::uint32_t>(cell_x);
+}
+
+const std::unordered_map<int, double>* FlexibleModelFittingSeedCatalog::find(unsigned int id, double x,
+                                                                             double y) const {
+  if (m_match_by == MatchBy::ID) {
+    auto i = m_by_id.find(id);
+    return (i != m_by_id.end()) ? &m_seeds[i->second].m_values : nullptr;
+  }
+
+  if (!std::isfinite(x) || !std::isfinite(y)) {
+    return nullptr;
+  }
+
+  int cell_x = std::floor(x / m_max_distance);
+  int cell_y = std::floor(y / m_max_distance);
+  double closest_distance = m_max_distance * m_max_distance;
+  const Seed* closest = nullptr;
+  for (int cy = cell_y - 1; cy <= cell_y + 1; ++cy) {
+    for (int cx = cell_x - 1; cx <= cell_x + 1; ++cx) {
+      auto cell = m_by_cell.find(cellKey(cx, cy));
+      if (cell == m_by_cell.end()) {
+        continue;
+      }
+      for (auto i : cell->second) {
+        auto& seed = m_seeds[i];
+        double dx = seed.m_x - x, dy = seed.m_y - y;
+        double distance = dx * dx + dy * dy;
+        if (distance <= closest_distance && (!closest || distance < closest_distance)) {
+          closest = &seed;
+          closest_distance = distance;
+        }
+      }
+    }
+  }
+  return closest ? &closest->m_values : nullptr;
+}
+
+} // end of namespace SourceXtractor
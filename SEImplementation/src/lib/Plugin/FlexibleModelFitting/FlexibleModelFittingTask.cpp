@@ -21,6 +21,9 @@
  *      Author: mschefer
  */
 
+#include <algorithm>
+#include <atomic>
+#include <future>
 #include <mutex>
 
 #include "ModelFitting/Parameters/ManualParameter.h"
@@ -35,6 +38,8 @@
 
 #include "ModelFitting/Engine/DataVsModelResiduals.h"
 
+#include "SEFramework/Pipeline/MemoryGovernor.h"
+
 #include "SEImplementation/Measurement/MultithreadedMeasurement.h"
 
 #include "SEImplementation/Image/VectorImageDataVsModelInputTraits.h"
@@ -50,9 +55,14 @@
 #include "SEImplementation/Plugin/MeasurementFrameGroupRectangle/MeasurementFrameGroupRectangle.h"
 #include "SEImplementation/Plugin/Jacobian/Jacobian.h"
 #include "SEImplementation/Plugin/DetectionFrameCoordinates/DetectionFrameCoordinates.h"
+#include "SEImplementation/Plugin/PixelBoundaries/PixelBoundaries.h"
+#include "SEImplementation/Plugin/PixelCentroid/PixelCentroid.h"
+#include "SEImplementation/Plugin/SourceIDs/SourceID.h"
 
 #include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFitting.h"
+#include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingBinning.h"
 #include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingParameterManager.h"
+#include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingPartition.h"
 #include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingTask.h"
 
 #include "SEImplementation/CheckImages/CheckImages.h"
@@ -104,25 +114,67 @@ void printLevmarInfo(std::array<double, 10> info) {
 
 }
 
+using FrameModelType = FrameModel<ImagePsf, std::shared_ptr<VectorImage<SeFloat>>>;
+
+/// Stamps of one frame, and the model compared with them by the residual estimator
+struct FittedFrame {
+  int m_frame_index;
+  std::shared_ptr<VectorImage<SeFloat>> m_image, m_weight;
+  const FrameModelType* m_model;
+  /// Position of the residuals of the stamp among those of the residual estimator
+  std::size_t m_residual_offset;
+};
+
+struct FlexibleModelFittingTask::ChiSquared {
+  double m_chi_squared = 0;
+  int m_data_points = 0;
+  /// Indexed as the sources of the problem
+  std::vector<double> m_source_chi_squared;
+  std::vector<int> m_source_data_points;
+};
+
+struct FlexibleModelFittingTask::FittingState {
+  FlexibleModelFittingParameterManager m_parameter_manager;
+  ModelFitting::EngineParameterManager m_engine_parameter_manager{};
+  ResidualEstimator m_res_estimator{};
+  int m_n_free_parameters = 0;
+  Flags m_flags = Flags::NONE;
+  LeastSquareSummary m_solution;
+  /// Independent copies of the parameters and models of the problem, sharing its stamps, used to compute
+  /// the Jacobian concurrently
+  std::vector<std::unique_ptr<FittingState>> m_replicas;
+  /// After the fit, the models hold the images rendered for the solution
+  std::vector<FittedFrame> m_fitted_frames;
+  /// Bytes charged to the MemoryGovernor for the stamps and the rendered images
+  std::size_t m_charged_bytes = 0;
+
+  ~FittingState() {
+    MemoryGovernor::getInstance()->release(m_charged_bytes);
+  }
+};
+
 FlexibleModelFittingTask::FlexibleModelFittingTask(const std::string &least_squares_engine,
     unsigned int max_iterations, double modified_chi_squared_scale,
     std::vector<std::shared_ptr<FlexibleModelFittingParameter>> parameters,
     std::vector<std::shared_ptr<FlexibleModelFittingFrame>> frames,
     std::vector<std::shared_ptr<FlexibleModelFittingPrior>> priors,
-    double scale_factor)
+    double scale_factor, unsigned int split_group_size, bool joint_refinement, unsigned int jacobian_threads,
+    unsigned int coarse_levels, std::shared_ptr<FlexibleModelFittingSeedCatalog> seed_catalog)
   : m_least_squares_engine(least_squares_engine),
     m_max_iterations(max_iterations), m_modified_chi_squared_scale(modified_chi_squared_scale),
-    m_parameters(parameters), m_frames(frames), m_priors(priors), m_scale_factor(scale_factor) {}
+    m_parameters(parameters), m_frames(frames), m_priors(priors), m_scale_factor(scale_factor),
+    m_split_group_size(split_group_size), m_joint_refinement(joint_refinement),
+    m_jacobian_threads(jacobian_threads), m_coarse_levels(coarse_levels), m_seed_catalog(seed_catalog) {}
 
-bool FlexibleModelFittingTask::isFrameValid(SourceGroupInterface& group, int frame_index) const {
-  auto stamp_rect = group.getProperty<MeasurementFrameGroupRectangle>(frame_index);
+bool FlexibleModelFittingTask::isFrameValid(const FittingProblem& problem, int frame_index) const {
+  auto& stamp_rect = problem.m_regions.at(frame_index);
   return stamp_rect.getWidth() > 0 && stamp_rect.getHeight() > 0;
 }
 
 std::shared_ptr<VectorImage<SeFloat>> FlexibleModelFittingTask::createImageCopy(
-  SourceGroupInterface& group, int frame_index) const {
+  SourceGroupInterface& group, const FittingProblem& problem, int frame_index) const {
   const auto& frame_images = group.begin()->getProperty<MeasurementFrameImages>(frame_index);
-  auto rect = group.getProperty<MeasurementFrameGroupRectangle>(frame_index);
+  auto& rect = problem.m_regions.at(frame_index);
   auto image = VectorImage<SeFloat>::create(frame_images.getImageChunk(
       LayerSubtractedImage, rect.getTopLeft().m_x, rect.getTopLeft().m_y, rect.getWidth(), rect.getHeight()));
 
@@ -130,7 +182,7 @@ std::shared_ptr<VectorImage<SeFloat>> FlexibleModelFittingTask::createImageCopy(
 }
 
 std::shared_ptr<VectorImage<SeFloat>> FlexibleModelFittingTask::createWeightImage(
-  SourceGroupInterface& group, int frame_index) const {
+  SourceGroupInterface& group, const FittingProblem& problem, int frame_index) const {
   const auto& frame_images = group.begin()->getProperty<MeasurementFrameImages>(frame_index);
 
   auto frame_image = frame_images.getLockedImage(LayerSubtractedImage);
@@ -141,10 +193,22 @@ std::shared_ptr<VectorImage<SeFloat>> FlexibleModelFittingTask::createWeightImag
   SeFloat gain = frame_info.getGain();
   SeFloat saturation = frame_info.getSaturation();
 
-  auto rect = group.getProperty<MeasurementFrameGroupRectangle>(frame_index);
+  auto& rect = problem.m_regions.at(frame_index);
   auto weight = VectorImage<SeFloat>::create(rect.getWidth(), rect.getHeight());
   std::fill(weight->getData().begin(), weight->getData().end(), 1);
 
+  // Pixels covered by sources fitted separately do not constrain this problem
+  auto excluded = problem.m_excluded.find(frame_index);
+  if (excluded != problem.m_excluded.end()) {
+    for (auto& footprint : excluded->second) {
+      for (int y = footprint.getTopLeft().m_y; y <= footprint.getBottomRight().m_y; ++y) {
+        for (int x = footprint.getTopLeft().m_x; x <= footprint.getBottomRight().m_x; ++x) {
+          weight->at(x - rect.getTopLeft().m_x, y - rect.getTopLeft().m_y) = 0;
+        }
+      }
+    }
+  }
+
   for (int y = 0; y < rect.getHeight(); y++) {
     for (int x = 0; x < rect.getWidth(); x++) {
       auto back_var = variance_map->getValue(rect.getTopLeft().m_x + x, rect.getTopLeft().m_y + y);
@@ -165,9 +229,9 @@ std::shared_ptr<VectorImage<SeFloat>> FlexibleModelFittingTask::createWeightImag
 }
 
 FrameModel<ImagePsf, std::shared_ptr<VectorImage<SourceXtractor::SeFloat>>> FlexibleModelFittingTask::createFrameModel(
-  SourceGroupInterface& group,
+  SourceGroupInterface& group, const FittingProblem& problem,
   double pixel_scale, FlexibleModelFittingParameterManager& manager,
-  std::shared_ptr<FlexibleModelFittingFrame> frame) const {
+  std::shared_ptr<FlexibleModelFittingFrame> frame, int binning) const {
 
   int frame_index = frame->getFrameNb();
 
@@ -176,7 +240,7 @@ FrameModel<ImagePsf, std::shared_ptr<VectorImage<SourceXtractor::SeFloat>>> Flex
   auto ref_coordinates =
     group.begin()->getProperty<DetectionFrameCoordinates>().getCoordinateSystem();
 
-  auto stamp_rect = group.getProperty<MeasurementFrameGroupRectangle>(frame_index);
+  auto& stamp_rect = problem.m_regions.at(frame_index);
   auto psf_property = group.getProperty<PsfProperty>(frame_index);
   auto jacobian = group.getProperty<JacobianGroup>(frame_index).asTuple();
 
@@ -184,13 +248,18 @@ FrameModel<ImagePsf, std::shared_ptr<VectorImage<SourceXtractor::SeFloat>>> Flex
   // It will be used to compute the rastering grid size, and after convolving with the PSF the result will be
   // downscaled before copied into the frame image.
   // We can multiply here then, as the unit is pixel/pixel, rather than "/pixel or similar
-  auto group_psf = ImagePsf(pixel_scale * psf_property.getPixelSampling(), psf_property.getPsf());
+  // A binned frame uses a PSF binned the same way, so the models are rasterized on a coarser grid too
+  auto psf_image = psf_property.getPsf();
+  if (binning > 1) {
+    psf_image = binPsf(*psf_image, binning);
+  }
+  auto group_psf = ImagePsf(binning * pixel_scale * psf_property.getPixelSampling(), psf_image);
 
   std::vector<ConstantModel> constant_models;
   std::vector<PointModel> point_models;
   std::vector<std::shared_ptr<ModelFitting::ExtendedModel<ImageInterfaceTypePtr>>> extended_models;
 
-  for (auto& source : group) {
+  for (auto& source : problem.m_sources) {
     for (auto model : frame->getModels()) {
       model->addForSource(manager, source, constant_models, point_models, extended_models, jacobian, ref_coordinates, frame_coordinates,
                           stamp_rect.getTopLeft());
@@ -199,53 +268,421 @@ FrameModel<ImagePsf, std::shared_ptr<VectorImage<SourceXtractor::SeFloat>>> Flex
 
   // Full frame model with all sources
   FrameModel<ImagePsf, std::shared_ptr<VectorImage<SourceXtractor::SeFloat>>> frame_model(
-    pixel_scale, (size_t) stamp_rect.getWidth(), (size_t) stamp_rect.getHeight(),
-    std::move(constant_models), std::move(point_models), std::move(extended_models), group_psf);
+    binning * pixel_scale, (size_t) stamp_rect.getWidth() / binning, (size_t) stamp_rect.getHeight() / binning,
+    std::move(constant_models), std::move(point_models), std::move(extended_models), group_psf, binning);
 
   return frame_model;
 }
 
+FlexibleModelFittingTask::FittingProblem FlexibleModelFittingTask::createGroupProblem(SourceGroupInterface& group) const {
+  FittingProblem problem;
+  for (auto& source : group) {
+    problem.m_sources.emplace_back(source);
+  }
+  for (auto frame : m_frames) {
+    int frame_index = frame->getFrameNb();
+    problem.m_regions[frame_index] = group.getProperty<MeasurementFrameGroupRectangle>(frame_index);
+  }
+  return problem;
+}
+
+namespace {
+
+// Bounding box, on a measurement frame, of a footprint on the detection frame. Clipped to the given region.
+MeasurementFrameGroupRectangle footprintToFrame(const FittingFootprint& footprint,
+                                                const std::shared_ptr<CoordinateSystem>& detection_coordinates,
+                                                const std::shared_ptr<CoordinateSystem>& frame_coordinates,
+                                                const MeasurementFrameGroupRectangle& clip) {
+  if (clip.getWidth() <= 0 || clip.getHeight() <= 0) {
+    return {};
+  }
+
+  double min_x = std::numeric_limits<double>::max(), min_y = std::numeric_limits<double>::max();
+  double max_x = std::numeric_limits<double>::lowest(), max_y = std::numeric_limits<double>::lowest();
+  for (auto& corner : {footprint.m_min, PixelCoordinate(footprint.m_max.m_x + 1, footprint.m_min.m_y),
+                       PixelCoordinate(footprint.m_min.m_x, footprint.m_max.m_y + 1),
+                       PixelCoordinate(footprint.m_max.m_x + 1, footprint.m_max.m_y + 1)}) {
+    auto coord = frame_coordinates->worldToImage(
+      detection_coordinates->imageToWorld(ImageCoordinate(corner.m_x, corner.m_y)));
+    min_x = std::min(min_x, coord.m_x);
+    min_y = std::min(min_y, coord.m_y);
+    max_x = std::max(max_x, coord.m_x);
+    max_y = std::max(max_y, coord.m_y);
+  }
+
+  PixelCoordinate min_coord(std::max(clip.getTopLeft().m_x, int(min_x)),
+                            std::max(clip.getTopLeft().m_y, int(min_y)));
+  PixelCoordinate max_coord(std::min(clip.getBottomRight().m_x, int(max_x) + 1),
+                            std::min(clip.getBottomRight().m_y, int(max_y) + 1));
+  if (min_coord.m_x > max_coord.m_x || min_coord.m_y > max_coord.m_y) {
+    return {};
+  }
+  return {min_coord, max_coord};
+}
+
+}
+
+std::vector<FlexibleModelFittingTask::FittingProblem> FlexibleModelFittingTask::partitionGroup(
+  SourceGroupInterface& group, const FittingProblem& group_problem, const FittedValues* initial_values) const {
+
+  // The PSF spreads the models further. Its size is in measurement frame pixels, which is close enough
+  // to the detection frame
+  int psf_margin = 0;
+  for (auto frame : m_frames) {
+    int frame_index = frame->getFrameNb();
+    if (isFrameValid(group_problem, frame_index)) {
+      auto& psf_property = group.getProperty<PsfProperty>(frame_index);
+      auto psf_size = std::max(psf_property.getPsf()->getWidth(), psf_property.getPsf()->getHeight());
+      psf_margin = std::max(psf_margin, int(std::ceil(psf_size * psf_property.getPixelSampling() / 2)));
+    }
+  }
+
+  // How far each model spreads depends on the initial value of its parameters, i.e. its radius.
+  // If a source had no flux beyond its footprint, the pixels it shares with a different problem
+  // would be left out of the fit of its wings
+  FittingState initial_state;
+  createParameters(group_problem, initial_state);
+  std::vector<double> extents(group_problem.m_sources.size(), 0.);
+  try {
+    if (initial_values) {
+      setInitialValues(group_problem, initial_state, *initial_values);
+    }
+    for (std::size_t i = 0; i < group_problem.m_sources.size(); ++i) {
+      for (auto frame : m_frames) {
+        for (auto model : frame->getModels()) {
+          extents[i] = std::max(extents[i],
+                                model->getExtent(initial_state.m_parameter_manager, group_problem.m_sources[i]));
+        }
+      }
+    }
+  }
+  catch (const Elements::Exception& e) {
+    logger.warn() << "Can not evaluate the extent of the models, the group is fitted as a whole: " << e.what();
+    return {group_problem};
+  }
+
+  std::vector<FittingFootprint> footprints;
+  for (std::size_t i = 0; i < group_problem.m_sources.size(); ++i) {
+    auto& source = group_problem.m_sources[i].get();
+    auto& boundaries = source.getProperty<PixelBoundaries>();
+    auto& centroid = source.getProperty<PixelCentroid>();
+    int margin = psf_margin + int(std::ceil(extents[i]));
+    footprints.emplace_back(FittingFootprint{
+      PixelCoordinate(std::min(boundaries.getMin().m_x, int(centroid.getCentroidX()) - margin),
+                      std::min(boundaries.getMin().m_y, int(centroid.getCentroidY()) - margin)),
+      PixelCoordinate(std::max(boundaries.getMax().m_x, int(centroid.getCentroidX()) + 1 + margin),
+                      std::max(boundaries.getMax().m_y, int(centroid.getCentroidY()) + 1 + margin))
+    });
+  }
+
+  auto components = partitionFootprints(footprints);
+  if (components.size() <= 1) {
+    return {group_problem};
+  }
+
+  auto detection_coordinates = group.begin()->getProperty<DetectionFrameCoordinates>().getCoordinateSystem();
+
+  std::vector<FittingProblem> problems(components.size());
+  std::vector<std::size_t> component_of(footprints.size());
+  for (std::size_t c = 0; c < components.size(); ++c) {
+    for (auto i : components[c]) {
+      problems[c].m_sources.emplace_back(group_problem.m_sources[i]);
+      component_of[i] = c;
+    }
+  }
+
+  for (auto frame : m_frames) {
+    int frame_index = frame->getFrameNb();
+    auto& group_region = group_problem.m_regions.at(frame_index);
+    auto frame_coordinates = group.begin()->getProperty<MeasurementFrameCoordinates>(frame_index).getCoordinateSystem();
+
+    std::vector<MeasurementFrameGroupRectangle> frame_footprints;
+    for (auto& footprint : footprints) {
+      frame_footprints.emplace_back(footprintToFrame(footprint, detection_coordinates, frame_coordinates, group_region));
+    }
+
+    for (std::size_t c = 0; c < components.size(); ++c) {
+      auto& problem = problems[c];
+
+      // Union of the footprints of the component
+      int min_x = std::numeric_limits<int>::max(), min_y = std::numeric_limits<int>::max();
+      int max_x = -1, max_y = -1;
+      for (auto i : components[c]) {
+        if (frame_footprints[i].getWidth() > 0) {
+          min_x = std::min(min_x, frame_footprints[i].getTopLeft().m_x);
+          min_y = std::min(min_y, frame_footprints[i].getTopLeft().m_y);
+          max_x = std::max(max_x, frame_footprints[i].getBottomRight().m_x);
+          max_y = std::max(max_y, frame_footprints[i].getBottomRight().m_y);
+        }
+      }
+      if (max_x < 0) {
+        problem.m_regions[frame_index] = MeasurementFrameGroupRectangle();
+        continue;
+      }
+      MeasurementFrameGroupRectangle region(PixelCoordinate(min_x, min_y), PixelCoordinate(max_x, max_y));
+      problem.m_regions[frame_index] = region;
+
+      for (std::size_t i = 0; i < footprints.size(); ++i) {
+        if (component_of[i] != c && frame_footprints[i].getWidth() > 0) {
+          auto excluded = footprintToFrame(footprints[i], detection_coordinates, frame_coordinates, region);
+          if (excluded.getWidth() > 0) {
+            problem.m_excluded[frame_index].emplace_back(excluded);
+          }
+        }
+      }
+    }
+  }
+
+  return problems;
+}
+
+FlexibleModelFittingTask::FittedValues FlexibleModelFittingTask::findSeeds(SourceGroupInterface& group) const {
+  FittedValues seeds;
+  for (auto& source : group) {
+    // The catalog uses FITS coordinates
+    auto& centroid = source.getProperty<PixelCentroid>();
+    auto values = m_seed_catalog->find(source.getProperty<SourceID>().getId(),
+                                       centroid.getCentroidX() + 1, centroid.getCentroidY() + 1);
+    if (values) {
+      seeds[&source] = *values;
+    }
+  }
+  return seeds;
+}
 
 void FlexibleModelFittingTask::computeProperties(SourceGroupInterface& group) const {
-  double pixel_scale = 1 / m_scale_factor;
-  FlexibleModelFittingParameterManager parameter_manager;
-  ModelFitting::EngineParameterManager engine_parameter_manager{};
-  int n_free_parameters = 0;
+  auto group_problem = createGroupProblem(group);
+
+  FittedValues seeds;
+  if (m_seed_catalog) {
+    seeds = findSeeds(group);
+  }
+  const FittedValues* initial_values = seeds.empty() ? nullptr : &seeds;
 
-  {
-    std::lock_guard<std::recursive_mutex> lock(MultithreadedMeasurement::g_global_mutex);
+  if (m_split_group_size == 0 || group.size() < m_split_group_size) {
+    fitProblems(group, {group_problem}, initial_values, true, nullptr);
+    return;
+  }
 
-    // Prepare parameters
-    for (auto& source : group) {
-      for (auto parameter : m_parameters) {
-        if (std::dynamic_pointer_cast<FlexibleModelFittingFreeParameter>(parameter)) {
-          ++n_free_parameters;
+  auto problems = partitionGroup(group, group_problem, initial_values);
+  logger.debug() << "Group of " << group.size() << " sources split into " << problems.size() << " fitting problems";
+
+  if (problems.size() == 1 || !m_joint_refinement) {
+    fitProblems(group, problems, initial_values, true, nullptr);
+    return;
+  }
+
+  FittedValues fitted_values;
+  fitProblems(group, problems, initial_values, false, &fitted_values);
+  fitProblems(group, {group_problem}, &fitted_values, true, nullptr);
+}
+
+void FlexibleModelFittingTask::fitProblems(SourceGroupInterface& group, const std::vector<FittingProblem>& problems,
+                                           const FittedValues* initial_values, bool check_images,
+                                           FittedValues* fitted_values) const {
+  // Binned stamps are cheaper to fit, and their solution is a good starting point for the full resolution
+  FittedValues coarse_values;
+  if (m_coarse_levels > 0) {
+    if (initial_values) {
+      coarse_values = *initial_values;
+    }
+    fitCoarseLevels(group, problems, coarse_values);
+    initial_values = &coarse_values;
+  }
+
+  // Setting up the problems access the source properties, which may be computed on demand, so do it sequentially
+  std::vector<std::unique_ptr<FittingState>> states;
+  for (auto& problem : problems) {
+    states.emplace_back(Euclid::make_unique<FittingState>());
+    prepareProblem(group, problem, *states.back(), initial_values);
+  }
+
+  // The minimization only evaluates the models, so independent problems can be solved concurrently.
+  // A single problem can instead spread the columns of its Jacobian over copies of its parameters and models
+  if (states.size() == 1) {
+    auto& state = *states.front();
+    std::size_t nworkers = std::min<std::size_t>(m_jacobian_threads,
+                                                 state.m_engine_parameter_manager.numberOfParameters());
+    if (nworkers > 1 && state.m_flags == Flags::NONE) {
+      for (std::size_t i = 1; i < nworkers; ++i) {
+        state.m_replicas.emplace_back(Euclid::make_unique<FittingState>());
+        prepareProblem(group, problems.front(), *state.m_replicas.back(), initial_values, 1, &state);
+      }
+    }
+    solveProblem(state);
+    state.m_replicas.clear();
+  }
+  else {
+    solveProblems(states);
+  }
+
+  for (std::size_t i = 0; i < problems.size(); ++i) {
+    finishProblem(group, problems[i], *states[i], check_images, fitted_values);
+  }
+}
+
+void FlexibleModelFittingTask::solveProblems(std::vector<std::unique_ptr<FittingState>>& states) const {
+  std::atomic<std::size_t> next_state{0};
+  auto worker = [this, &states, &next_state]() {
+    for (std::size_t i = next_state++; i < states.size(); i = next_state++) {
+      solveProblem(*states[i]);
+    }
+  };
+
+  // Other groups are being measured at the same time, so only use the threads given to this group.
+  // The measurement thread is one of them
+  std::size_t nworkers = std::min<std::size_t>(states.size(), std::max(1u, m_jacobian_threads));
+  std::vector<std::future<void>> workers;
+  for (std::size_t i = 1; i < nworkers; ++i) {
+    workers.emplace_back(std::async(std::launch::async, worker));
+  }
+  worker();
+  for (auto& w : workers) {
+    w.get();
+  }
+}
+
+unsigned int FlexibleModelFittingTask::coarseLevels(const FittingProblem& problem) const {
+  unsigned int levels = m_coarse_levels;
+  bool any_valid = false;
+  for (auto frame : m_frames) {
+    int frame_index = frame->getFrameNb();
+    if (isFrameValid(problem, frame_index)) {
+      auto& stamp_rect = problem.m_regions.at(frame_index);
+      levels = SourceXtractor::coarseLevels(stamp_rect.getWidth(), stamp_rect.getHeight(), levels);
+      any_valid = true;
+    }
+  }
+  return any_valid ? levels : 0;
+}
+
+void FlexibleModelFittingTask::fitCoarseLevels(SourceGroupInterface& group, const std::vector<FittingProblem>& problems,
+                                               FittedValues& values) const {
+  std::vector<unsigned int> problem_levels;
+  for (auto& problem : problems) {
+    problem_levels.emplace_back(coarseLevels(problem));
+  }
+
+  for (unsigned int level = m_coarse_levels; level > 0; --level) {
+    int binning = 1 << level;
+
+    std::vector<const FittingProblem*> level_problems;
+    std::vector<std::unique_ptr<FittingState>> states;
+    for (std::size_t i = 0; i < problems.size(); ++i) {
+      if (problem_levels[i] >= level) {
+        level_problems.emplace_back(&problems[i]);
+        states.emplace_back(Euclid::make_unique<FittingState>());
+        prepareProblem(group, problems[i], *states.back(), &values, binning);
+      }
+    }
+    if (states.empty()) {
+      continue;
+    }
+
+    solveProblems(states);
+
+    // Keep the solution of the free parameters, so it becomes the starting point of the next level.
+    // A failed fit leaves the previous values untouched
+    for (std::size_t i = 0; i < states.size(); ++i) {
+      auto& state = *states[i];
+      if (state.m_flags != Flags::NONE) {
+        continue;
+      }
+      for (auto& source : level_problems[i]->m_sources) {
+        auto& source_values = values[&source.get()];
+        for (auto parameter : m_parameters) {
+          if (std::dynamic_pointer_cast<FlexibleModelFittingFreeParameter>(parameter) &&
+              state.m_parameter_manager.isParamAccessed(source, parameter)) {
+            source_values[parameter->getId()] = state.m_parameter_manager.getParameter(source, parameter)->getValue();
+          }
         }
-        parameter_manager.addParameter(source, parameter,
-                                       parameter->create(parameter_manager, engine_parameter_manager, source));
       }
     }
+    logger.debug() << "Fitted " << states.size() << " problems binned by " << binning;
+  }
+}
+
+void FlexibleModelFittingTask::createParameters(const FittingProblem& problem, FittingState& state) const {
+  std::lock_guard<std::recursive_mutex> lock(MultithreadedMeasurement::g_global_mutex);
+
+  for (auto& source : problem.m_sources) {
+    for (auto parameter : m_parameters) {
+      if (std::dynamic_pointer_cast<FlexibleModelFittingFreeParameter>(parameter)) {
+        ++state.m_n_free_parameters;
+      }
+      state.m_parameter_manager.addParameter(source, parameter,
+                                             parameter->create(state.m_parameter_manager,
+                                                               state.m_engine_parameter_manager, source));
+    }
   }
+}
+
+void FlexibleModelFittingTask::setInitialValues(const FittingProblem& problem, FittingState& state,
+                                                const FittedValues& initial_values) const {
+  for (auto& source : problem.m_sources) {
+    auto values = initial_values.find(&source.get());
+    if (values == initial_values.end()) {
+      continue;
+    }
+    for (auto parameter : m_parameters) {
+      auto value = values->second.find(parameter->getId());
+      if (!std::dynamic_pointer_cast<FlexibleModelFittingFreeParameter>(parameter) ||
+          value == values->second.end() || !std::isfinite(value->second)) {
+        continue;
+      }
+      auto engine_parameter = std::dynamic_pointer_cast<EngineParameter>(
+        state.m_parameter_manager.getParameter(source, parameter));
+      if (engine_parameter) {
+        engine_parameter->setValue(value->second);
+      }
+    }
+  }
+}
+
+void FlexibleModelFittingTask::prepareProblem(SourceGroupInterface& group, const FittingProblem& problem,
+                                              FittingState& state, const FittedValues* initial_values,
+                                              int binning, const FittingState* shared_stamps) const {
+  double pixel_scale = 1 / m_scale_factor;
+  auto& parameter_manager = state.m_parameter_manager;
+
+  createParameters(problem, state);
 
   try {
+    if (initial_values) {
+      setInitialValues(problem, state, *initial_values);
+    }
+
     // Reset access checks, as a dependent parameter could have triggered it
     parameter_manager.clearAccessCheck();
 
     // Add models for all frames
-    ResidualEstimator res_estimator{};
-
     int valid_frames = 0;
     int n_good_pixels = 0;
+    std::size_t n_residuals = 0;
     for (auto frame : m_frames) {
       int frame_index = frame->getFrameNb();
       // Validate that each frame covers the model fitting region
-      if (isFrameValid(group, frame_index)) {
+      if (isFrameValid(problem, frame_index)) {
         valid_frames++;
 
-        auto frame_model = createFrameModel(group, pixel_scale, parameter_manager, frame);
+        auto frame_model = createFrameModel(group, problem, pixel_scale, parameter_manager, frame, binning);
 
-        auto image = createImageCopy(group, frame_index);
-        auto weight = createWeightImage(group, frame_index);
+        std::shared_ptr<VectorImage<SeFloat>> image, weight;
+        if (shared_stamps) {
+          auto shared = std::find_if(shared_stamps->m_fitted_frames.begin(), shared_stamps->m_fitted_frames.end(),
+                                     [frame_index](const FittedFrame& f) { return f.m_frame_index == frame_index; });
+          image = shared->m_image;
+          weight = shared->m_weight;
+        }
+        else {
+          image = createImageCopy(group, problem, frame_index);
+          weight = createWeightImage(group, problem, frame_index);
+          if (binning > 1) {
+            auto binned = binStamp(*image, *weight, binning);
+            image = binned.m_image;
+            weight = binned.m_weight;
+          }
+        }
 
         for (int y = 0; y < weight->getHeight(); ++y) {
           for (int x = 0; x < weight->getWidth(); ++x) {
@@ -253,61 +690,111 @@ void FlexibleModelFittingTask::computeProperties(SourceGroupInterface& group) co
           }
         }
 
+        // The model renders an image of the same size. The stamps are only charged by who copied them
+        std::size_t stamp_bytes = static_cast<std::size_t>(image->getWidth()) * image->getHeight() * sizeof(SeFloat);
+        std::size_t state_bytes = shared_stamps ? stamp_bytes : 3 * stamp_bytes;
+        MemoryGovernor::getInstance()->charge(state_bytes);
+        state.m_charged_bytes += state_bytes;
+
         // Setup residuals
         auto data_vs_model =
           createDataVsModelResiduals(image, std::move(frame_model), weight,
                                      //LogChiSquareComparator(m_modified_chi_squared_scale));
                                      AsinhChiSquareComparator(m_modified_chi_squared_scale));
-        res_estimator.registerBlockProvider(std::move(data_vs_model));
+        state.m_fitted_frames.push_back(FittedFrame{frame_index, image, weight, &data_vs_model->getModel(), n_residuals});
+        n_residuals += data_vs_model->numberOfResiduals();
+        state.m_res_estimator.registerBlockProvider(std::move(data_vs_model));
       }
     }
 
     // Check that we had enough data for the fit
-    Flags group_flags = Flags::NONE;
     if (valid_frames == 0) {
-      group_flags = Flags::OUTSIDE;
+      state.m_flags = Flags::OUTSIDE;
     }
-    else if (n_good_pixels < n_free_parameters) {
-      group_flags = Flags::INSUFFICIENT_DATA;
+    else if (n_good_pixels < state.m_n_free_parameters) {
+      state.m_flags = Flags::INSUFFICIENT_DATA;
     }
 
-    if (group_flags != Flags::NONE) {
-      setDummyProperty(group, parameter_manager, group_flags);
+    if (state.m_flags != Flags::NONE) {
       return;
     }
 
     // Add priors
-    for (auto& source : group) {
+    for (auto& source : problem.m_sources) {
       for (auto prior : m_priors) {
-        prior->setupPrior(parameter_manager, source, res_estimator);
+        prior->setupPrior(parameter_manager, source, state.m_res_estimator);
       }
     }
+  }
+  catch (const Elements::Exception& e) {
+    logger.error() << "An exception occured during model fitting:  " << e.what();
+    state.m_flags = Flags::ERROR;
+  }
+}
 
-    // Model fitting
+void FlexibleModelFittingTask::solveProblem(FittingState& state) const {
+  if (state.m_flags != Flags::NONE) {
+    return;
+  }
 
+  try {
     // FIXME we can no longer specify different settings with LeastSquareEngineManager!!
     //  LevmarEngine engine{m_max_iterations, 1E-3, 1E-6, 1E-6, 1E-6, 1E-4};
     auto engine = LeastSquareEngineManager::create(m_least_squares_engine, m_max_iterations);
-    auto solution = engine->solveProblem(engine_parameter_manager, res_estimator);
+    std::vector<ProblemReplica> replicas;
+    for (auto& replica : state.m_replicas) {
+      if (replica->m_flags == Flags::NONE) {
+        replicas.push_back(ProblemReplica{replica->m_engine_parameter_manager, replica->m_res_estimator});
+      }
+    }
+    state.m_solution = engine->solveProblem(state.m_engine_parameter_manager, state.m_res_estimator, replicas);
+  }
+  catch (const Elements::Exception& e) {
+    logger.error() << "An exception occured during model fitting:  " << e.what();
+    state.m_flags = Flags::ERROR;
+  }
+}
+
+void FlexibleModelFittingTask::finishProblem(SourceGroupInterface& group, const FittingProblem& problem,
+                                             FittingState& state, bool check_images,
+                                             FittedValues* fitted_values) const {
+  auto& parameter_manager = state.m_parameter_manager;
+
+  if (state.m_flags != Flags::NONE) {
+    setDummyProperty(problem, parameter_manager, state.m_flags);
+    return;
+  }
+
+  try {
+    auto& solution = state.m_solution;
     size_t iterations = (size_t) boost::any_cast<std::array<double, 10>>(solution.underlying_framework_info)[5];
 
-    int total_data_points = 0;
-    SeFloat avg_reduced_chi_squared = computeChiSquared(group, pixel_scale, parameter_manager, total_data_points);
+    auto chi_squared = computeChiSquared(group, problem, state, check_images);
 
     int nb_of_free_parameters = 0;
-    for (auto& source : group) {
+    std::vector<int> source_free_parameters;
+    for (auto& source : problem.m_sources) {
+      int source_parameters = 0;
       for (auto parameter : m_parameters) {
         bool is_free_parameter = std::dynamic_pointer_cast<FlexibleModelFittingFreeParameter>(parameter).get();
         bool accessed_by_modelfitting = parameter_manager.isParamAccessed(source, parameter);
         if (is_free_parameter && accessed_by_modelfitting) {
-          nb_of_free_parameters++;
+          source_parameters++;
         }
       }
+      source_free_parameters.push_back(source_parameters);
+      nb_of_free_parameters += source_parameters;
     }
-    avg_reduced_chi_squared /= (total_data_points - nb_of_free_parameters);
+    SeFloat avg_reduced_chi_squared = chi_squared.m_chi_squared / (chi_squared.m_data_points - nb_of_free_parameters);
 
     // Collect parameters for output
-    for (auto& source : group) {
+    for (std::size_t i = 0; i < problem.m_sources.size(); ++i) {
+      auto& source = problem.m_sources[i].get();
+      int source_degrees_of_freedom = chi_squared.m_source_data_points[i] - source_free_parameters[i];
+      SeFloat source_reduced_chi_squared = std::numeric_limits<SeFloat>::quiet_NaN();
+      if (source_degrees_of_freedom > 0) {
+        source_reduced_chi_squared = chi_squared.m_source_chi_squared[i] / source_degrees_of_freedom;
+      }
       std::unordered_map<int, double> parameter_values, parameter_sigmas;
       auto source_flags = Flags::NONE;
 
@@ -331,21 +818,23 @@ void FlexibleModelFittingTask::computeProperties(SourceGroupInterface& group) co
           source_flags |= Flags::PARTIAL_FIT;
         }
       }
-      source.setProperty<FlexibleModelFitting>(iterations, avg_reduced_chi_squared, source_flags, parameter_values,
-                                               parameter_sigmas);
+      if (fitted_values) {
+        (*fitted_values)[&source] = parameter_values;
+      }
+      source.setProperty<FlexibleModelFitting>(iterations, avg_reduced_chi_squared, source_reduced_chi_squared,
+                                               source_flags, parameter_values, parameter_sigmas);
     }
-    updateCheckImages(group, pixel_scale, parameter_manager);
-
   }
   catch (const Elements::Exception& e) {
     logger.error() << "An exception occured during model fitting:  " << e.what();
-    setDummyProperty(group, parameter_manager, Flags::ERROR);
+    setDummyProperty(problem, parameter_manager, Flags::ERROR);
   }
 }
 
 // Used to set a dummy property in case of error that contains no result but just an error flag
-void FlexibleModelFittingTask::setDummyProperty(SourceGroupInterface& group, FlexibleModelFittingParameterManager& parameter_manager, Flags flags) const {
-  for (auto& source : group) {
+void FlexibleModelFittingTask::setDummyProperty(const FittingProblem& problem, FlexibleModelFittingParameterManager& parameter_manager, Flags flags) const {
+  for (auto& source_ref : problem.m_sources) {
+    auto& source = source_ref.get();
     std::unordered_map<int, double> dummy_values;
     for (auto parameter : m_parameters) {
       auto modelfitting_parameter = parameter_manager.getParameter(source, parameter);
@@ -355,84 +844,83 @@ void FlexibleModelFittingTask::setDummyProperty(SourceGroupInterface& group, Fle
       }
       dummy_values[parameter->getId()] = std::numeric_limits<double>::quiet_NaN();
     }
-    source.setProperty<FlexibleModelFitting>(0, std::numeric_limits<double>::quiet_NaN(), flags,
+    source.setProperty<FlexibleModelFitting>(0, std::numeric_limits<double>::quiet_NaN(),
+                                             std::numeric_limits<double>::quiet_NaN(), flags,
                                              dummy_values, dummy_values);
   }
 }
 
-void FlexibleModelFittingTask::updateCheckImages(SourceGroupInterface& group,
-    double pixel_scale, FlexibleModelFittingParameterManager& manager) const {
-
-  int frame_id = 0;
-  for (auto frame : m_frames) {
-    int frame_index = frame->getFrameNb();
-    // Validate that each frame covers the model fitting region
-    if (isFrameValid(group, frame_index)) {
-      auto frame_model = createFrameModel(group, pixel_scale, manager, frame);
-      auto final_stamp = frame_model.getImage();
-
-      auto stamp_rect = group.getProperty<MeasurementFrameGroupRectangle>(frame_index);
-
-      auto debug_image = CheckImages::getInstance().getModelFittingImage(frame_index);
-      if (debug_image) {
-        for (int x = 0; x < final_stamp->getWidth(); x++) {
-          for (int y = 0; y < final_stamp->getHeight(); y++) {
-            auto x_coord = stamp_rect.getTopLeft().m_x + x;
-            auto y_coord = stamp_rect.getTopLeft().m_y + y;
-            debug_image->setValue(x_coord, y_coord,
-                                  debug_image->getValue(x_coord, y_coord) + final_stamp->getValue(x, y));
-          }
-        }
-      }
+FlexibleModelFittingTask::ChiSquared FlexibleModelFittingTask::computeChiSquared(
+  SourceGroupInterface& group, const FittingProblem& problem, const FittingState& state, bool check_images) const {
+  ChiSquared result;
+  result.m_source_chi_squared.resize(problem.m_sources.size());
+  result.m_source_data_points.resize(problem.m_sources.size());
+
+  // The residuals are weighted by the same comparator used for the fit, which is undone to get the chi squared
+  AsinhChiSquareComparator comparator(m_modified_chi_squared_scale);
+  auto& residuals = state.m_solution.residuals;
+  auto detection_coordinates = group.begin()->getProperty<DetectionFrameCoordinates>().getCoordinateSystem();
+
+  for (auto& fitted_frame : state.m_fitted_frames) {
+    int frame_index = fitted_frame.m_frame_index;
+    auto& weight_data = fitted_frame.m_weight->getData();
+    int width = fitted_frame.m_weight->getWidth(), height = fitted_frame.m_weight->getHeight();
+    if (residuals.size() < fitted_frame.m_residual_offset + weight_data.size()) {
+      throw Elements::Exception() << "The residuals of frame " << frame_index << " were not returned with the solution";
     }
-    frame_id++;
-  }
-}
-
-SeFloat FlexibleModelFittingTask::computeChiSquaredForFrame(std::shared_ptr<const Image<SeFloat>> image,
-    std::shared_ptr<const Image<SeFloat>> model, std::shared_ptr<const Image<SeFloat>> weights, int& data_points) const {
-  double reduced_chi_squared = 0.0;
-  data_points = 0;
-  for (int y=0; y < image->getHeight(); y++) {
-    for (int x=0; x < image->getWidth(); x++) {
-      double tmp = image->getValue(x, y) - model->getValue(x, y);
-      reduced_chi_squared += tmp * tmp * weights->getValue(x, y) * weights->getValue(x, y);
-      if (weights->getValue(x, y) > 0) {
-        data_points++;
+    const double* frame_residuals = residuals.data() + fitted_frame.m_residual_offset;
+
+    std::shared_ptr<CheckImageAccumulator> accumulator;
+    const VectorImage<SeFloat>* final_stamp = nullptr;
+    if (check_images) {
+      accumulator = CheckImages::getInstance().getModelFittingAccumulator(frame_index);
+      auto rendered = fitted_frame.m_model->getRenderedImage();
+      if (rendered) {
+        final_stamp = rendered->get();
       }
     }
-  }
-  return reduced_chi_squared;
-}
-
-SeFloat FlexibleModelFittingTask::computeChiSquared(SourceGroupInterface& group,
-    double pixel_scale, FlexibleModelFittingParameterManager& manager, int& total_data_points) const {
 
-  SeFloat total_chi_squared = 0;
-  total_data_points = 0;
-  int valid_frames = 0;
-  for (auto frame : m_frames) {
-    int frame_index = frame->getFrameNb();
-    // Validate that each frame covers the model fitting region
-    if (isFrameValid(group, frame_index)) {
-      valid_frames++;
-      auto frame_model = createFrameModel(group, pixel_scale, manager, frame);
-      auto final_stamp = frame_model.getImage();
+    // Footprints of the sources on the stamp
+    auto& stamp_rect = problem.m_regions.at(frame_index);
+    auto frame_coordinates = group.begin()->getProperty<MeasurementFrameCoordinates>(frame_index).getCoordinateSystem();
+    std::vector<MeasurementFrameGroupRectangle> footprints;
+    for (auto& source : problem.m_sources) {
+      auto& boundaries = source.get().getProperty<PixelBoundaries>();
+      footprints.emplace_back(footprintToFrame(FittingFootprint{boundaries.getMin(), boundaries.getMax()},
+                                               detection_coordinates, frame_coordinates, stamp_rect));
+    }
 
-      auto stamp_rect = group.getProperty<MeasurementFrameGroupRectangle>(frame_index);
-      auto image = createImageCopy(group, frame_index);
-      auto weight = createWeightImage(group, frame_index);
+    std::vector<double> row_chi_squared(width);
+    for (int y = 0; y < height; ++y) {
+      const double* row_residuals = frame_residuals + y * width;
+      const SeFloat* row_weights = weight_data.data() + y * width;
+      for (int x = 0; x < width; ++x) {
+        double chi = comparator.inverse(row_residuals[x]);
+        row_chi_squared[x] = chi * chi;
+        result.m_chi_squared += row_chi_squared[x];
+        result.m_data_points += (row_weights[x] > 0);
+      }
 
-      int data_points = 0;
-      SeFloat chi_squared = computeChiSquaredForFrame(
-          image, final_stamp, weight, data_points);
+      int frame_y = stamp_rect.getTopLeft().m_y + y;
+      for (std::size_t i = 0; i < footprints.size(); ++i) {
+        auto& footprint = footprints[i];
+        if (footprint.getWidth() <= 0 || frame_y < footprint.getTopLeft().m_y || frame_y > footprint.getBottomRight().m_y) {
+          continue;
+        }
+        for (int x = footprint.getTopLeft().m_x - stamp_rect.getTopLeft().m_x;
+             x <= footprint.getBottomRight().m_x - stamp_rect.getTopLeft().m_x; ++x) {
+          result.m_source_chi_squared[i] += row_chi_squared[x];
+          result.m_source_data_points[i] += (row_weights[x] > 0);
+        }
+      }
 
-      total_data_points += data_points;
-      total_chi_squared += chi_squared;
+      if (accumulator && final_stamp) {
+        accumulator->addRow(final_stamp->getData().data() + y * width, width, stamp_rect.getTopLeft().m_x, frame_y);
+      }
     }
   }
 
-  return total_chi_squared;
+  return result;
 }
 
 FlexibleModelFittingTask::~FlexibleModelFittingTask() {
@@ -36,7 +36,9 @@ static auto logger = Elements::Logging::getLogger("FlexibleModelFitting");
 std::shared_ptr<Task> FlexibleModelFittingTaskFactory::createTask(const PropertyId& property_id) const {
   if (property_id == PropertyId::create<FlexibleModelFitting>()) {
     return std::make_shared<FlexibleModelFittingTask>(m_least_squares_engine, m_max_iterations,
-                                                      m_modified_chi_squared_scale, m_parameters, m_frames, m_priors, m_scale_factor);
+                                                      m_modified_chi_squared_scale, m_parameters, m_frames, m_priors, m_scale_factor,
+                                                      m_split_group_size, m_joint_refinement, m_jacobian_threads,
+                                                      m_coarse_levels, m_seed_catalog);
   } else {
     return nullptr;
   }
@@ -63,9 +65,27 @@ void FlexibleModelFittingTaskFactory::configure(Euclid::Configuration::ConfigMan
   m_least_squares_engine = model_fitting_config.getLeastSquaresEngine();
   m_max_iterations = model_fitting_config.getMaxIterations();
   m_modified_chi_squared_scale = model_fitting_config.getModifiedChiSquaredScale();
+  m_split_group_size = model_fitting_config.getSplitGroupSize();
+  m_joint_refinement = model_fitting_config.getJointRefinement();
+  m_jacobian_threads = model_fitting_config.getJacobianThreads();
+  m_coarse_levels = model_fitting_config.getCoarseLevels();
+  m_seed_catalog = model_fitting_config.getSeedCatalog();
 
   logger.info() << "Using engine " << m_least_squares_engine << " with "
                 << m_max_iterations << " maximum number of iterations";
+  if (m_split_group_size > 0) {
+    logger.info() << "Groups with " << m_split_group_size << " or more sources will be split into independent fits"
+                  << (m_joint_refinement ? ", followed by a joint refinement" : "");
+  }
+  if (m_jacobian_threads > 1) {
+    logger.info() << "The Jacobian of single problem fits will be computed on " << m_jacobian_threads << " threads";
+  }
+  if (m_coarse_levels > 0) {
+    logger.info() << "Fits will start on stamps binned up to " << (1 << m_coarse_levels) << " times";
+  }
+  if (m_seed_catalog) {
+    logger.info() << "Fits will start from the values of " << m_seed_catalog->size() << " seeds";
+  }
 
   m_outputs = model_fitting_config.getOutputs();
 
@@ -15,13 +15,10 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
-#include <MathUtils/interpolation/interpolation.h>
-
 #include "SEImplementation/Plugin/GrowthCurve/GrowthCurve.h"
 #include "SEImplementation/Plugin/GrowthCurve/GrowthCurveResampled.h"
 #include "SEImplementation/Plugin/GrowthCurve/GrowthCurveResampledTask.h"
 
-using namespace Euclid::MathUtils;
 using namespace Euclid::NdArray;
 
 namespace SourceXtractor {
@@ -35,19 +32,11 @@ void GrowthCurveResampledTask::computeProperties(SourceInterface& source) const
 
   for (size_t i = 0; i < m_instances.size(); ++i) {
     auto& growth_curve_prop = source.getProperty<GrowthCurve>(m_instances[i]);
-    auto& growth_curve = growth_curve_prop.getCurve();
-    auto step_size = growth_curve_prop.getStepSize();
     auto new_step_size = growth_curve_prop.getMax() / m_nsamples;
     step_sizes[i] = new_step_size;
 
-    std::vector<double> steps(growth_curve.size());
-    for (size_t s = 0; s < steps.size(); ++s) {
-      steps[s] = (s + 1) * step_size;
-    }
-
-    auto interpolated = interpolate(steps, growth_curve, InterpolationType::LINEAR, true);
     for (size_t s = 0; s < m_nsamples; ++s) {
-      data.at(i, s) = (*interpolated)((s + 1) * new_step_size);
+      data.at(i, s) = growth_curve_prop.getFlux((s + 1) * new_step_size);
     }
   }
   source.setProperty<GrowthCurveResampled>(std::move(data), std::move(step_sizes));
@@ -15,7 +15,10 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#include <algorithm>
 #include "SEFramework/Aperture/CircularAperture.h"
+#include "SEFramework/Aperture/RadialAccumulator.h"
+#include "SEFramework/Image/ImageChunk.h"
 #include "SEImplementation/Plugin/GrowthCurve/GrowthCurve.h"
 #include "SEImplementation/Plugin/GrowthCurve/GrowthCurveTask.h"
 #include "SEImplementation/Plugin/Jacobian/Jacobian.h"
@@ -34,30 +37,68 @@ using SExtractor::Mat22;
 static const SeFloat GROWTH_NSIG = 6.;
 static const size_t GROWTH_NSAMPLES = 64;
 
-static SeFloat getPixelValue(int x, int y, SeFloat centroid_x, SeFloat centroid_y,
-                             const std::shared_ptr<Image<SeFloat>>& image,
-                             const std::shared_ptr<Image<SeFloat>>& variance_map, SeFloat variance_threshold,
-                             bool use_symmetry) {
-  // Get the pixel value
-  DetectionImage::PixelType pixel_value = 0;
-  // Masked out
-  if (variance_map->getValue(x, y) > variance_threshold) {
-    if (use_symmetry) {
-      auto mirror_x = 2 * centroid_x - x + 0.49999;
-      auto mirror_y = 2 * centroid_y - y + 0.49999;
-      if (mirror_x >= 0 && mirror_y >= 0 && mirror_x < image->getWidth() && mirror_y < image->getHeight()) {
-        if (variance_map->getValue(mirror_x, mirror_y) < variance_threshold) {
-          // mirror pixel is OK: take the value
-          pixel_value = image->getValue(mirror_x, mirror_y);
+/**
+ * Copy the pixels of the box [min, max] that are inside the image into a contiguous buffer.
+ * Masked pixels are replaced by their mirror with respect to the centroid if use_symmetry is set,
+ * or by 0 otherwise. The box is updated with the part inside the image.
+ */
+static std::vector<SeFloat> getStamp(PixelCoordinate& min, PixelCoordinate& max,
+                                     SeFloat centroid_x, SeFloat centroid_y,
+                                     const std::shared_ptr<Image<SeFloat>>& image,
+                                     const std::shared_ptr<Image<SeFloat>>& variance_map, SeFloat variance_threshold,
+                                     bool use_symmetry) {
+  min.m_x = std::max(min.m_x, 0);
+  min.m_y = std::max(min.m_y, 0);
+  max.m_x = std::min(max.m_x, image->getWidth() - 1);
+  max.m_y = std::min(max.m_y, image->getHeight() - 1);
+  if (max.m_x < min.m_x || max.m_y < min.m_y) {
+    return {};
+  }
+
+  // The mirrored pixels may fall a bit outside of the box, so read a margin around it
+  int read_min_x = std::max(min.m_x - 2, 0), read_min_y = std::max(min.m_y - 2, 0);
+  int read_max_x = std::min(max.m_x + 2, image->getWidth() - 1);
+  int read_max_y = std::min(max.m_y + 2, image->getHeight() - 1);
+  int read_width = read_max_x - read_min_x + 1, read_height = read_max_y - read_min_y + 1;
+  auto image_chunk = image->getChunk(read_min_x, read_min_y, read_width, read_height);
+  auto variance_chunk = variance_map->getChunk(read_min_x, read_min_y, read_width, read_height);
+
+  auto getValue = [&](int x, int y) -> SeFloat {
+    if (x >= read_min_x && y >= read_min_y && x <= read_max_x && y <= read_max_y) {
+      return image_chunk->getValue(x - read_min_x, y - read_min_y);
+    }
+    return image->getValue(x, y);
+  };
+  auto getVariance = [&](int x, int y) -> SeFloat {
+    if (x >= read_min_x && y >= read_min_y && x <= read_max_x && y <= read_max_y) {
+      return variance_chunk->getValue(x - read_min_x, y - read_min_y);
+    }
+    return variance_map->getValue(x, y);
+  };
+
+  int width = max.m_x - min.m_x + 1, height = max.m_y - min.m_y + 1;
+  std::vector<SeFloat> stamp(width * height, 0.);
+  auto stamp_pixel = stamp.begin();
+  for (int y = min.m_y; y <= max.m_y; ++y) {
+    for (int x = min.m_x; x <= max.m_x; ++x, ++stamp_pixel) {
+      // Not masked
+      if (getVariance(x, y) <= variance_threshold) {
+        *stamp_pixel = getValue(x, y);
+      }
+      // Masked out
+      else if (use_symmetry) {
+        auto mirror_x = 2 * centroid_x - x + 0.49999;
+        auto mirror_y = 2 * centroid_y - y + 0.49999;
+        if (mirror_x >= 0 && mirror_y >= 0 && mirror_x < image->getWidth() && mirror_y < image->getHeight()) {
+          if (getVariance(mirror_x, mirror_y) < variance_threshold) {
+            // mirror pixel is OK: take the value
+            *stamp_pixel = getValue(mirror_x, mirror_y);
+          }
         }
       }
     }
   }
-  // Not masked
-  else {
-    pixel_value = image->getValue(x, y);
-  }
-  return pixel_value;
+  return stamp;
 }
 
 GrowthCurveTask::GrowthCurveTask(unsigned instance, bool use_symmetry)
@@ -94,59 +135,20 @@ void GrowthCurveTask::computeProperties(SourceInterface& source) const {
 
   double step_size = rlim / GROWTH_NSAMPLES;
 
-  // List of apertures
-  std::vector<CircularAperture> apertures;
-  std::vector<double> fluxes(GROWTH_NSAMPLES);
-  apertures.reserve(GROWTH_NSAMPLES);
-  for (size_t step = 1; step <= GROWTH_NSAMPLES; ++step) {
-    apertures.emplace_back(step_size * step);
-  }
-
-  // Boundaries for the computation
-  // We know the last aperture is the widest, so we take the limits from it
-  auto min_coord = apertures.back().getMinPixel(centroid_x, centroid_y);
-  auto max_coord = apertures.back().getMaxPixel(centroid_x, centroid_y);
-
-  // Compute fluxes for each ring
-  for (auto y = min_coord.m_y; y <= max_coord.m_y; ++y) {
-    for (auto x = min_coord.m_x; x <= max_coord.m_x; ++x) {
-      if (!image->isInside(x, y)) {
-        continue;
-      }
-
-      auto pixel_value = getPixelValue(x, y, centroid_x, centroid_y, image,
-                                       variance_map, variance_threshold,
-                                       m_use_symmetry);
-
-      // Assign the pixel value according to the affected area
-      auto dx = x - centroid_x;
-      auto dy = y - centroid_y;
-      double r = std::sqrt(dx * dx + dy * dy);
-
-      // The pixel may be affected by multiple rings, so we look for those
-      // that overlap the start and the end of the pixels (which has size sqrt(2) on the diagonal)
-      size_t idx = 0;
-      if (r > 1.42 / 2.) {
-        idx = static_cast<size_t>((r - 1.42 / 2.) / step_size);
-      }
-      size_t outer_idx = static_cast<size_t>(std::ceil((r + 1.42 / 2.) / step_size));
-
-      double inner = 0;
-      outer_idx = std::min(outer_idx, apertures.size() - 1);
-      for (; idx <= outer_idx; ++idx) {
-        auto& aperture = apertures[idx];
-        auto area = aperture.getArea(centroid_x, centroid_y, x, y);
-
-        fluxes[idx] += area * pixel_value - inner;
-        inner = area * pixel_value;
-      }
-    }
-  }
-
-  // Accumulate
-  for (size_t i = 1; i < fluxes.size(); ++i) {
-    fluxes[i] += fluxes[i - 1];
+  // Boundaries for the computation, given by the widest aperture
+  CircularAperture widest(step_size * GROWTH_NSAMPLES);
+  auto min_coord = widest.getMinPixel(centroid_x, centroid_y);
+  auto max_coord = widest.getMaxPixel(centroid_x, centroid_y);
+
+  // Histogram of the flux per ring, accumulated into the flux within each radius
+  auto stamp = getStamp(min_coord, max_coord, centroid_x, centroid_y, image, variance_map, variance_threshold,
+                        m_use_symmetry);
+  RadialAccumulator accumulator(step_size, GROWTH_NSAMPLES);
+  if (!stamp.empty()) {
+    accumulator.add(stamp.data(), min_coord.m_x, min_coord.m_y,
+                    max_coord.m_x - min_coord.m_x + 1, max_coord.m_y - min_coord.m_y + 1, centroid_x, centroid_y);
   }
+  auto fluxes = accumulator.getCumulative();
 
   // Set property
   source.setIndexedProperty<GrowthCurve>(m_instance, std::move(fluxes), rlim);
@@ -30,6 +30,10 @@
 
 namespace SourceXtractor {
 
+std::vector<PropertyId> IsophotalFluxTask::getDependencies() const {
+  return {PropertyId::create<DetectionFrameInfo>(), PropertyId::create<DetectionFramePixelValues>()};
+}
+
 void IsophotalFluxTask::computeProperties(SourceInterface& source) const {
   const auto& detection_frame_info = source.getProperty<DetectionFrameInfo>();
   const auto& pixel_values = source.getProperty<DetectionFramePixelValues>().getValues();
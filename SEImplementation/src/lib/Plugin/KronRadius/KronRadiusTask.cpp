@@ -22,8 +22,10 @@
  */
 
 #include <math.h>
+#include <algorithm>
 
-#include "SEFramework/Aperture/EllipticalAperture.h"
+#include "SEFramework/Aperture/EllipticalScan.h"
+#include "SEFramework/Image/ImageChunk.h"
 #include "SEFramework/Aperture/NeighbourInfo.h"
 
 #include "SEImplementation/Property/PixelCoordinateList.h"
@@ -70,12 +72,12 @@ void KronRadiusTask::computeProperties(SourceInterface& source) const {
   const auto& cyy = source.getProperty<ShapeParameters>().getEllipseCyy();
   const auto& cxy = source.getProperty<ShapeParameters>().getEllipseCxy();
 
-  // create the elliptical aperture
-  auto ell_aper = std::make_shared<EllipticalAperture>(cxx, cyy, cxy, KRON_NRADIUS);
+  // the elliptical aperture
+  EllipticalScan ellipse(cxx, cyy, cxy, KRON_NRADIUS, centroid_x, centroid_y);
 
   // get the aperture borders on the image
-  const auto& min_pixel = ell_aper->getMinPixel(centroid_x, centroid_y);
-  const auto& max_pixel = ell_aper->getMaxPixel(centroid_x, centroid_y);
+  const auto& min_pixel = ellipse.getMinPixel();
+  const auto& max_pixel = ellipse.getMaxPixel();
 
   // get the pixel list
   const auto& pix_list = source.getProperty<PixelCoordinateList>().getCoordinateList();
@@ -83,6 +85,18 @@ void KronRadiusTask::computeProperties(SourceInterface& source) const {
   // get the neighbourhood information
   NeighbourInfo neighbour_info(min_pixel, max_pixel, pix_list, threshold_image);
 
+  // read the part of the aperture inside the image
+  int clip_min_x = std::max(min_pixel.m_x, 0);
+  int clip_min_y = std::max(min_pixel.m_y, 0);
+  int clip_max_x = std::min(max_pixel.m_x, detection_frame_images.getWidth() - 1);
+  int clip_max_y = std::min(max_pixel.m_y, detection_frame_images.getHeight() - 1);
+  std::shared_ptr<ImageChunk<SeFloat>> image_chunk, variance_chunk;
+  if (clip_max_x >= clip_min_x && clip_max_y >= clip_min_y) {
+    int clip_width = clip_max_x - clip_min_x + 1, clip_height = clip_max_y - clip_min_y + 1;
+    image_chunk = detection_image->getChunk(clip_min_x, clip_min_y, clip_width, clip_height);
+    variance_chunk = detection_variance->getChunk(clip_min_x, clip_min_y, clip_width, clip_height);
+  }
+
   SeFloat radius_flux_sum = 0.;
   SeFloat flux_sum = 0.;
   SeFloat area_sum = 0;
@@ -91,46 +105,37 @@ void KronRadiusTask::computeProperties(SourceInterface& source) const {
   long int flag = 0;
 
   // iterate over the aperture pixels
-  for (int pixel_y = min_pixel.m_y; pixel_y <= max_pixel.m_y; pixel_y++) {
-    for (int pixel_x = min_pixel.m_x; pixel_x <= max_pixel.m_x; pixel_x++) {
+  ellipse.scan([&](int pixel_x, int pixel_y, SeFloat radius_squared) {
+    // make sure the pixel is inside the image
+    if (pixel_x >= clip_min_x && pixel_y >= clip_min_y && pixel_x <= clip_max_x && pixel_y <= clip_max_y) {
+      SeFloat value = 0;
 
-      // check whether the current pixel is inside
-      SeFloat area = ell_aper->getArea(centroid_x, centroid_y, pixel_x, pixel_y);
-      if (area <= 0) {
-        continue;
-      }
+      // enhance the area
+      area_sum += 1;
+
+      // get the variance value
+      auto pixel_variance = variance_chunk->getValue(pixel_x - clip_min_x, pixel_y - clip_min_y);
 
-      // make sure the pixel is inside the image
-      if (detection_image->isInside(pixel_x, pixel_y)) {
-        SeFloat value = 0;
-
-        // enhance the area
-        area_sum += 1;
-
-        // get the variance value
-        auto pixel_variance = detection_variance->getValue(pixel_x, pixel_y);
-
-        // check whether the pixel is good
-        bool is_good = pixel_variance < variance_threshold;
-        value = detection_image->getValue(pixel_x, pixel_y) * is_good;
-        area_bad += !is_good;
-
-        // check whether the pixel is part of another object
-        if (neighbour_info.isNeighbourObjectPixel(pixel_x, pixel_y)) {
-          area_full += 1;
-        }
-        else {
-          // add the pixel quantity
-          radius_flux_sum += value * sqrt(ell_aper->getRadiusSquared(centroid_x, centroid_y, pixel_x, pixel_y));
-          flux_sum += value;
-        }
+      // check whether the pixel is good
+      bool is_good = pixel_variance < variance_threshold;
+      value = image_chunk->getValue(pixel_x - clip_min_x, pixel_y - clip_min_y) * is_good;
+      area_bad += !is_good;
+
+      // check whether the pixel is part of another object
+      if (neighbour_info.isNeighbourObjectPixel(pixel_x, pixel_y)) {
+        area_full += 1;
       }
       else {
-        // set the border flag
-        flag |= 0x0008;
+        // add the pixel quantity
+        radius_flux_sum += value * sqrt(radius_squared);
+        flux_sum += value;
       }
     }
-  }
+    else {
+      // set the border flag
+      flag |= 0x0008;
+    }
+  });
 
   // check/set the bad area flag
   bool bad_threshold = area_sum > 0 && area_bad / area_sum > BADAREA_THRESHOLD_KRON;
@@ -64,6 +64,7 @@
 #include "ModelFitting/Engine/DataVsModelResiduals.h"
 
 #include "SEImplementation/Plugin/DetectionFrameSourceStamp/DetectionFrameSourceStamp.h"
+#include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingBinning.h"
 
 #include "SEImplementation/Plugin/PixelCentroid/PixelCentroid.h"
 #include "SEImplementation/Property/PixelCoordinateList.h"
@@ -151,6 +152,15 @@ struct SourceModel {
 }
 
 
+std::vector<PropertyId> MoffatModelFittingTask::getDependencies() const {
+  return {
+    PropertyId::create<DetectionFrameSourceStamp>(), PropertyId::create<PixelCoordinateList>(),
+    PropertyId::create<PixelCentroid>(), PropertyId::create<ShapeParameters>(),
+    PropertyId::create<IsophotalFlux>(), PropertyId::create<DetectionFrameInfo>(),
+    PropertyId::create<DetectionFrameCoordinates>()
+  };
+}
+
 void MoffatModelFittingTask::computeProperties(SourceInterface& source) const {
   auto& source_stamp = source.getProperty<DetectionFrameSourceStamp>().getStamp();
   auto& variance_stamp = source.getProperty<DetectionFrameSourceStamp>().getVarianceStamp();
@@ -244,6 +254,36 @@ void MoffatModelFittingTask::computeProperties(SourceInterface& source) const {
   // FIXME we should be able to use the source_stamp Image interface directly
   auto image = VectorImage<SeFloat>::create(source_stamp);
 
+  auto engine = LeastSquareEngineManager::create(m_least_squares_engine, m_max_iterations);
+
+  // Fit first on binned stamps, from the coarsest. Each level leaves its solution on the parameters,
+  // so it is the starting point of the next one
+  auto levels = coarseLevels(source_stamp.getWidth(), source_stamp.getHeight(), m_coarse_levels);
+  for (unsigned int level = levels; level > 0; --level) {
+    int binning = 1 << level;
+    std::vector<std::shared_ptr<ModelFitting::ExtendedModel<ImageInterfaceTypePtr>>> coarse_extended_models;
+    std::vector<PointModel> coarse_point_models;
+    source_model->createModels(coarse_extended_models, coarse_point_models);
+    FrameModel<NullPsf<VectorImageType>, VectorImageType> coarse_frame_model {
+      binning * pixel_scale,
+      (size_t) source_stamp.getWidth() / binning, (size_t) source_stamp.getHeight() / binning,
+      {}, std::move(coarse_point_models), std::move(coarse_extended_models),
+      NullPsf<VectorImageType>(binning * pixel_scale), (size_t) binning
+    };
+
+    auto binned = binStamp(*image, *weight, binning);
+    ResidualEstimator coarse_estimator {};
+    coarse_estimator.registerBlockProvider(createDataVsModelResiduals(
+        binned.m_image, std::move(coarse_frame_model), binned.m_weight, AsinhChiSquareComparator{}));
+
+    // A failed fit leaves the previous values untouched
+    std::vector<double> previous_values(manager.numberOfParameters());
+    manager.getEngineValues(previous_values.begin());
+    if (!engine->solveProblem(manager, coarse_estimator).success_flag) {
+      manager.updateEngineValues(previous_values.begin());
+    }
+  }
+
   auto data_vs_model =
       createDataVsModelResiduals(image, std::move(frame_model), weight, AsinhChiSquareComparator{});
 
@@ -251,7 +291,6 @@ void MoffatModelFittingTask::computeProperties(SourceInterface& source) const {
   res_estimator.registerBlockProvider(move(data_vs_model));
 
   // Perform the minimization
-  auto engine = LeastSquareEngineManager::create(m_least_squares_engine, m_max_iterations);
   auto solution = engine->solveProblem(manager, res_estimator);
   size_t iterations = (size_t) boost::any_cast<std::array<double,10>>(solution.underlying_framework_info)[5];
 
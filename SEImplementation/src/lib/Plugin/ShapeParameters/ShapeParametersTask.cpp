@@ -33,6 +33,13 @@
 
 namespace SourceXtractor {
 
+std::vector<PropertyId> ShapeParametersTask::getDependencies() const {
+  return {
+    PropertyId::create<DetectionFramePixelValues>(), PropertyId::create<PixelCentroid>(),
+    PropertyId::create<PeakValue>(), PropertyId::create<PixelCoordinateList>()
+  };
+}
+
 void ShapeParametersTask::computeProperties(SourceInterface& source) const {
   const auto& pixel_values = source.getProperty<DetectionFramePixelValues>().getFilteredValues();
   const auto& centroid_x = source.getProperty<PixelCentroid>().getCentroidX();
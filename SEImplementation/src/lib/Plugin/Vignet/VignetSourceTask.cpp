@@ -22,7 +22,12 @@
  * @author mkuemmel@usm.lmu.de
  */
 
+#include <algorithm>
+#include <limits>
+
+#include "SEFramework/CoordinateSystem/LocalAffineMapping.h"
 #include "SEImplementation/Property/PixelCoordinateList.h"
+#include "SEImplementation/Property/PixelCoordinateMask.h"
 #include <SEImplementation/Plugin/MeasurementFrameInfo/MeasurementFrameInfo.h>
 #include <SEImplementation/Plugin/MeasurementFrameCoordinates/MeasurementFrameCoordinates.h>
 #include <SEImplementation/Plugin/MeasurementFrameImages/MeasurementFrameImages.h>
@@ -35,18 +40,19 @@
 #include "SEImplementation/Plugin/Vignet/VignetSourceTask.h"
 
 namespace SourceXtractor {
+
+// Above this error, in detection frame pixels, the local affine mapping is not trusted
+// and every vignet pixel is mapped through the world coordinates
+static const double s_max_affine_error = 0.01;
+
 void VignetSourceTask::computeProperties(SourceInterface& source) const {
   const auto& measurement_frame_info = source.getProperty<MeasurementFrameInfo>(m_instance);
   const auto& measurement_frame_images = source.getProperty<MeasurementFrameImages>(m_instance);
 
   auto measurement_var_threshold = measurement_frame_info.getVarianceThreshold();
 
-  const auto measurement_sub_image = measurement_frame_images.getLockedImage(LayerSubtractedImage);
-  const auto measurement_var_image = measurement_frame_images.getLockedImage(LayerVarianceMap);
-
   // neighbor masking from the detection image
   const auto& detection_frame_images = source.getProperty<DetectionFrameImages>();
-  const auto& detection_thresh_image = detection_frame_images.getLockedImage(LayerThresholdedImage);
 
   // get the object pixel coordinates from the detection image
   const auto& pixel_coords = source.getProperty<PixelCoordinateList>();
@@ -66,30 +72,83 @@ void VignetSourceTask::computeProperties(SourceInterface& source) const {
   int x_end = x_start + m_vignet_size[0];
   int y_end = y_start + m_vignet_size[1];
 
-  // create and fill the vignet vector using the measurement frame
-  std::vector<SeFloat> vignet_vector(m_vignet_size[0] * m_vignet_size[1], m_vignet_default_pixval);
-  int index = 0;
-  for (int iy = y_start; iy < y_end; iy++) {
-    for (int ix = x_start; ix < x_end; ix++, index++) {
-
-      // skip pixels outside of the image
-      if (ix < 0 || iy < 0 || ix >= measurement_sub_image->getWidth() || iy >= measurement_sub_image->getHeight())
-        continue;
+  // pixels outside of the image are left with the default value
+  int clip_x_start = std::max(x_start, 0);
+  int clip_y_start = std::max(y_start, 0);
+  int clip_x_end = std::min(x_end, measurement_frame_images.getWidth());
+  int clip_y_end = std::min(y_end, measurement_frame_images.getHeight());
+  int clip_width = clip_x_end - clip_x_start;
+  int clip_height = clip_y_end - clip_y_start;
 
-      // translate pixel coordinates to the detection frame
-      auto world_coord = measurement_coordinate_system->imageToWorld({static_cast<double>(ix), static_cast<double>(iy)});
-      auto detection_coord = detection_coordinate_system->worldToImage(world_coord);
+  std::vector<SeFloat> vignet_vector(m_vignet_size[0] * m_vignet_size[1], m_vignet_default_pixval);
 
-      // copy the pixel value if it is not masked, and if it does not correspond to a detection pixel
-      // if it corresponds to a detection pixel, use it if it belongs to the source
-      int detection_x = static_cast<int>(detection_coord.m_x + 0.5);
-      int detection_y = static_cast<int>(detection_coord.m_y + 0.5);
+  if (clip_width > 0 && clip_height > 0) {
+    // translate the pixel coordinates to the detection frame, using a linear approximation if it is good enough
+    LocalAffineMapping affine(*measurement_coordinate_system, *detection_coordinate_system,
+                              ImageCoordinate((clip_x_start + clip_x_end - 1) / 2., (clip_y_start + clip_y_end - 1) / 2.),
+                              (clip_width - 1) / 2., (clip_height - 1) / 2.);
+    bool use_affine = affine.getMaxError() <= s_max_affine_error;
+
+    std::vector<PixelCoordinate> detection_pixels(clip_width * clip_height);
+    int det_min_x = std::numeric_limits<int>::max(), det_min_y = std::numeric_limits<int>::max();
+    int det_max_x = std::numeric_limits<int>::min(), det_max_y = std::numeric_limits<int>::min();
+    auto detection_pixel = detection_pixels.begin();
+    for (int iy = clip_y_start; iy < clip_y_end; iy++) {
+      for (int ix = clip_x_start; ix < clip_x_end; ix++, ++detection_pixel) {
+        ImageCoordinate detection_coord;
+        if (use_affine) {
+          detection_coord = affine(ix, iy);
+        }
+        else {
+          auto world_coord = measurement_coordinate_system->imageToWorld({static_cast<double>(ix), static_cast<double>(iy)});
+          detection_coord = detection_coordinate_system->worldToImage(world_coord);
+        }
+        detection_pixel->m_x = static_cast<int>(detection_coord.m_x + 0.5);
+        detection_pixel->m_y = static_cast<int>(detection_coord.m_y + 0.5);
+        det_min_x = std::min(det_min_x, detection_pixel->m_x);
+        det_min_y = std::min(det_min_y, detection_pixel->m_y);
+        det_max_x = std::max(det_max_x, detection_pixel->m_x);
+        det_max_y = std::max(det_max_y, detection_pixel->m_y);
+      }
+    }
 
-      bool is_masked = measurement_var_image->getValue(ix, iy) > measurement_var_threshold;
-      bool is_detection_pixel = detection_thresh_image->getValue(detection_x, detection_y) > 0;
+    // read the three layers in one go
+    auto measurement_sub_chunk = measurement_frame_images.getImageChunk(
+      LayerSubtractedImage, clip_x_start, clip_y_start, clip_width, clip_height);
+    auto measurement_var_chunk = measurement_frame_images.getImageChunk(
+      LayerVarianceMap, clip_x_start, clip_y_start, clip_width, clip_height);
+
+    det_min_x = std::max(det_min_x, 0);
+    det_min_y = std::max(det_min_y, 0);
+    det_max_x = std::min(det_max_x, detection_frame_images.getWidth() - 1);
+    det_max_y = std::min(det_max_y, detection_frame_images.getHeight() - 1);
+    std::shared_ptr<ImageChunk<DetectionImage::PixelType>> detection_thresh_chunk;
+    if (det_max_x >= det_min_x && det_max_y >= det_min_y) {
+      detection_thresh_chunk = detection_frame_images.getImageChunk(
+        LayerThresholdedImage, det_min_x, det_min_y, det_max_x - det_min_x + 1, det_max_y - det_min_y + 1);
+    }
 
-      if (!is_masked && (!is_detection_pixel || pixel_coords.contains({detection_x, detection_y}))) {
-        vignet_vector[index] = measurement_sub_image->getValue(ix, iy);
+    PixelCoordinateMask footprint(pixel_coords.getCoordinateList());
+
+    // fill the vignet using the measurement frame
+    detection_pixel = detection_pixels.begin();
+    for (int cy = 0; cy < clip_height; cy++) {
+      int index = (clip_x_start - x_start) + (clip_y_start - y_start + cy) * m_vignet_size[0];
+      for (int cx = 0; cx < clip_width; cx++, index++, ++detection_pixel) {
+        int detection_x = detection_pixel->m_x;
+        int detection_y = detection_pixel->m_y;
+
+        // copy the pixel value if it is not masked, and if it does not correspond to a detection pixel
+        // if it corresponds to a detection pixel, use it if it belongs to the source
+        bool is_masked = measurement_var_chunk->getValue(cx, cy) > measurement_var_threshold;
+        bool is_detection_pixel = detection_thresh_chunk &&
+          detection_x >= det_min_x && detection_x <= det_max_x &&
+          detection_y >= det_min_y && detection_y <= det_max_y &&
+          detection_thresh_chunk->getValue(detection_x - det_min_x, detection_y - det_min_y) > 0;
+
+        if (!is_masked && (!is_detection_pixel || footprint.contains(detection_x, detection_y))) {
+          vignet_vector[index] = measurement_sub_chunk->getValue(cx, cy);
+        }
       }
     }
   }
@@ -21,7 +21,10 @@
  *      Author: mschefer
  */
 
+#include "SEFramework/Convolution/ConvolutionStrategy.h"
+#include "SEFramework/Convolution/SeparableConvolution.h"
 #include "SEFramework/Image/BufferedImage.h"
+#include "SEFramework/Image/ConstantImage.h"
 #include "SEImplementation/Segmentation/BgConvolutionImageSource.h"
 #include "SEImplementation/Segmentation/BgDFTConvolutionImageSource.h"
 #include "SEImplementation/Segmentation/BackgroundConvolution.h"
@@ -31,20 +34,49 @@ namespace SourceXtractor {
 
 Elements::Logging logger = Elements::Logging::getLogger("Segmentation");
 
+// Number of tiles filtered at once by the DFT implementation
+static const int dft_tiles_per_block = 4;
+
 std::shared_ptr<DetectionImage>
 BackgroundConvolution::processImage(std::shared_ptr<DetectionImage> image, std::shared_ptr<DetectionImage> variance,
                                     SeFloat threshold) const {
 
-  if (m_convolution_filter->getWidth() > 5) {
-    logger.debug() << "Using DFT algorithm for the image convolution";
-    return BufferedImage<DetectionImage::PixelType>::create(
-      std::make_shared<BgDFTConvolutionImageSource>(image, variance, threshold, m_convolution_filter)
-    );
+  // Pick the cheapest strategy given the kernel, its rank, and the size of the tiles to generate
+  auto tile_manager = TileManager::getInstance();
+  int tile_width = std::min(tile_manager->getTileWidth(), image->getWidth());
+  int tile_height = std::min(tile_manager->getTileHeight(), image->getHeight());
+  int kernel_width = m_convolution_filter->getWidth();
+  int kernel_height = m_convolution_filter->getHeight();
+  int rank = decomposeKernel(*m_convolution_filter).getRank();
+
+  // An all-zero kernel filters everything out, and the normalization by the convolved mask would be 0/0
+  if (rank == 0) {
+    logger.debug() << "The convolution kernel is zero, the filtered image is zero too";
+    return ConstantImage<DetectionImage::PixelType>::create(image->getWidth(), image->getHeight(), 0);
+  }
+
+  int dft_tiles = std::max(1, std::min(dft_tiles_per_block, image->getWidth() / tile_width));
+
+  auto strategy = chooseConvolutionStrategy(kernel_width, kernel_height, rank, tile_width, tile_height, dft_tiles);
+
+  switch (strategy) {
+    case ConvolutionStrategy::DFT:
+      logger.debug() << "Using DFT algorithm for the image convolution";
+      return BufferedImage<DetectionImage::PixelType>::create(
+        std::make_shared<BgDFTConvolutionImageSource>(image, variance, threshold, m_convolution_filter,
+                                                      dft_tiles_per_block)
+      );
+    case ConvolutionStrategy::SEPARABLE:
+      logger.debug() << "Using separable algorithm (rank " << rank << ") for the image convolution";
+      return BufferedImage<DetectionImage::PixelType>::create(
+        std::make_shared<BgConvolutionImageSource>(image, variance, threshold, m_convolution_filter, true)
+      );
+    default:
+      logger.debug() << "Using direct algorithm for the image convolution";
+      return BufferedImage<DetectionImage::PixelType>::create(
+        std::make_shared<BgConvolutionImageSource>(image, variance, threshold, m_convolution_filter)
+      );
   }
-  logger.debug() << "Using direct algorithm for the image convolution";
-  return BufferedImage<DetectionImage::PixelType>::create(
-    std::make_shared<BgConvolutionImageSource>(image, variance, threshold, m_convolution_filter)
-  );
 }
 
 void BackgroundConvolution::normalize() {
@@ -23,44 +23,46 @@
  */
 
 #include "SEImplementation/Segmentation/BgConvolutionImageSource.h"
-#include "SEFramework/Image/FunctionalImage.h"
+#include "SEFramework/Image/ImageChunk.h"
 
 namespace SourceXtractor {
 
 
 BgConvolutionImageSource::BgConvolutionImageSource(std::shared_ptr<Image<DetectionImage::PixelType>> image,
                                                    std::shared_ptr<DetectionImage> variance, SeFloat threshold,
-                                                   std::shared_ptr<VectorImage<SeFloat>> kernel)
+                                                   std::shared_ptr<VectorImage<SeFloat>> kernel, bool separable)
   : ProcessingImageSource<DetectionImage::PixelType>(image),
-    m_variance(variance), m_threshold(threshold) {
+    m_variance(variance), m_threshold(threshold), m_use_separable(separable) {
   m_kernel = VectorImage<SeFloat>::create(MirrorImage<SeFloat>::create(kernel));
+  if (m_use_separable) {
+    m_separable = decomposeKernel(*m_kernel);
+  }
 }
 
 std::string BgConvolutionImageSource::getRepr() const {
   return "BgConvolutionImageSource(" + getImageRepr() + ")";
 }
 
-static std::tuple<float, float>
-applyKernel(const VectorImage<SeFloat>& kernel, ImageChunk<SeFloat>& image_chunk, ImageChunk<SeFloat>& variance_chunk,
-            int start_x, int start_y, int clip_w, int clip_h, SeFloat threshold) {
-  DetectionImage::PixelType total = 0.;
-  DetectionImage::PixelType conv_weight = 0.;
-
-  for (int cy = 0; cy < kernel.getHeight(); ++cy) {
-    for (int cx = 0; cx < kernel.getWidth(); ++cx) {
-      int clip_x2 = start_x + cx;
-      int clip_y2 = start_y + cy;
-
-      if (clip_x2 >= 0 && clip_x2 < clip_w && clip_y2 >= 0 && clip_y2 < clip_h) {
-        if (variance_chunk.getValue(clip_x2, clip_y2) < threshold) {
-          total += image_chunk.getValue(clip_x2, clip_y2) * kernel.getValue(cx, cy);
-          conv_weight += kernel.getValue(cx, cy);
+/**
+ * Correlate the input with the 2D kernel, one kernel row at a time, so the inner loop
+ * runs over contiguous memory and can be vectorized
+ */
+static void directCorrelate(const VectorImage<SeFloat>& kernel, const SeFloat *in, int in_stride,
+                            SeFloat *out, int out_width, int out_height) {
+  const auto& kernel_data = kernel.getData();
+  for (int y = 0; y < out_height; ++y) {
+    SeFloat *out_row = out + y * out_width;
+    for (int ky = 0; ky < kernel.getHeight(); ++ky) {
+      const SeFloat *in_row = in + (y + ky) * in_stride;
+      for (int kx = 0; kx < kernel.getWidth(); ++kx) {
+        const SeFloat kv = kernel_data[kx + ky * kernel.getWidth()];
+        const SeFloat *in_k = in_row + kx;
+        for (int x = 0; x < out_width; ++x) {
+          out_row[x] += kv * in_k[x];
         }
       }
     }
   }
-
-  return std::make_pair(total, conv_weight);
 }
 
 void BgConvolutionImageSource::generateTile(const std::shared_ptr<Image<DetectionImage::PixelType>>& image,
@@ -70,33 +72,53 @@ void BgConvolutionImageSource::generateTile(const std::shared_ptr<Image<Detectio
   const int hy = m_kernel->getHeight() / 2;
   const int clip_x = std::max(start_x - hx, 0);
   const int clip_y = std::max(start_y - hy, 0);
-  const int clip_w = std::min(width + hx * 2, image->getWidth() - clip_x);
-  const int clip_h = std::min(height + hy * 2, image->getHeight() - clip_y);
+  const int clip_w = std::min(start_x + width + hx, image->getWidth()) - clip_x;
+  const int clip_h = std::min(start_y + height + hy, image->getHeight()) - clip_y;
 
   // "Materialize" the image and variance
   auto image_chunk = image->getChunk(clip_x, clip_y, clip_w, clip_h);
   auto variance_chunk = m_variance->getChunk(clip_x, clip_y, clip_w, clip_h);
 
-  // Convolve both and copy out to the tile
-  const int off_x = start_x - clip_x;
-  const int off_y = start_y - clip_y;
+  // Masked image and mask, padded with 0 where the margins fall outside the image
+  const int padded_w = width + hx * 2;
+  const int padded_h = height + hy * 2;
+  const int off_x = clip_x - (start_x - hx);
+  const int off_y = clip_y - (start_y - hy);
+  std::vector<SeFloat> masked(padded_w * padded_h, 0.), mask(padded_w * padded_h, 0.);
+  for (int y = 0; y < clip_h; ++y) {
+    for (int x = 0; x < clip_w; ++x) {
+      if (variance_chunk->getValue(x, y) < m_threshold) {
+        auto i = (x + off_x) + (y + off_y) * padded_w;
+        masked[i] = image_chunk->getValue(x, y);
+        mask[i] = 1.;
+      }
+    }
+  }
+
+  // Convolve both
+  std::vector<SeFloat> total(width * height, 0.), conv_weight(width * height, 0.);
+  if (m_use_separable) {
+    std::vector<SeFloat> scratch;
+    separableCorrelate(m_separable, masked.data(), padded_w, total.data(), width, width, height, scratch);
+    separableCorrelate(m_separable, mask.data(), padded_w, conv_weight.data(), width, width, height, scratch);
+  }
+  else {
+    directCorrelate(*m_kernel, masked.data(), padded_w, total.data(), width, height);
+    directCorrelate(*m_kernel, mask.data(), padded_w, conv_weight.data(), width, height);
+  }
 
+  // Copy out to the tile, masking again
+  auto& tile_data = tile.getImage()->getData();
   for (int iy = 0; iy < height; ++iy) {
     for (int ix = 0; ix < width; ++ix) {
-      if (variance_chunk->getValue(ix + off_x, iy + off_y) < m_threshold) {
-        DetectionImage::PixelType total = 0.;
-        DetectionImage::PixelType conv_weight = 0.;
-
-        std::tie(total, conv_weight) = applyKernel(*m_kernel, *image_chunk, *variance_chunk,
-                                                   ix - hx + off_x, iy - hy + off_y, clip_w, clip_h,
-                                                   m_threshold);
-
-        // Note that because of the conditional, at least the center pixel is below the threshold,
-        // so checking for conv_weight > 0 is redundant
-        tile.getImage()->setValue(ix, iy, total / conv_weight);
+      auto i = ix + iy * width;
+      // The center pixel is below the threshold, but the convolved mask can still be 0
+      // if the kernel is zero on all the valid pixels around it
+      if (mask[(ix + hx) + (iy + hy) * padded_w] && conv_weight[i] != 0) {
+        tile_data[i] = total[i] / conv_weight[i];
       }
       else {
-        tile.getImage()->setValue(ix, iy, 0.);
+        tile_data[i] = 0.;
       }
     }
   }
@@ -104,4 +126,3 @@ void BgConvolutionImageSource::generateTile(const std::shared_ptr<Image<Detectio
 
 
 } // end namespace SourceXtractor
-
@@ -23,88 +23,209 @@
  */
 
 #include "SEImplementation/Segmentation/BgDFTConvolutionImageSource.h"
-#include "SEFramework/Image/ProcessedImage.h"
-#include "SEFramework/Image/FunctionalImage.h"
+#include "SEFramework/Image/ImageChunk.h"
 
 namespace SourceXtractor {
 
+namespace {
+
+/**
+ * Working buffers are kept per thread, so they can be reused between blocks
+ */
+std::vector<DetectionImage::PixelType>& getThreadRealBuffer(std::size_t size) {
+  static thread_local std::vector<DetectionImage::PixelType> buffer;
+  if (buffer.size() < size) {
+    buffer.resize(size);
+  }
+  return buffer;
+}
+
+std::vector<FFT<DetectionImage::PixelType>::complex_t>& getThreadComplexBuffer(std::size_t size) {
+  static thread_local std::vector<FFT<DetectionImage::PixelType>::complex_t> buffer;
+  if (buffer.size() < size) {
+    buffer.resize(size);
+  }
+  return buffer;
+}
+
+}
 
 BgDFTConvolutionImageSource::BgDFTConvolutionImageSource(std::shared_ptr<Image<DetectionImage::PixelType>> image,
                                                          std::shared_ptr<DetectionImage> variance, SeFloat threshold,
-                                                         std::shared_ptr<VectorImage<SeFloat>> kernel)
+                                                         std::shared_ptr<VectorImage<SeFloat>> kernel,
+                                                         int tiles_per_block)
   : ProcessingImageSource<DetectionImage::PixelType>(image),
-    m_variance(variance), m_threshold(threshold), m_convolution(kernel) {
+    m_variance(variance), m_threshold(threshold), m_kernel(kernel), m_kernel_sum(0),
+    m_tiles_per_block(std::max(tiles_per_block, 1)) {
+  for (auto v : m_kernel->getData()) {
+    m_kernel_sum += v;
+  }
 }
 
 std::string BgDFTConvolutionImageSource::getRepr() const {
   return "BgDFTConvolutionImageSource(" + getImageRepr() + ")";
 }
 
+auto BgDFTConvolutionImageSource::getKernelTransform(int fft_width, int fft_height) const
+-> const std::vector<complex_t>& {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  auto key = std::make_tuple(fft_width, fft_height);
+  auto i = m_kernel_transforms.find(key);
+  if (i != m_kernel_transforms.end()) {
+    return i->second;
+  }
+
+  // Wrap the kernel around, so its center falls on (0, 0)
+  int total_size = fft_width * fft_height;
+  int hx = m_kernel->getWidth() / 2;
+  int hy = m_kernel->getHeight() / 2;
+  std::vector<PixelType> real_buffer(total_size);
+  std::vector<complex_t> complex_buffer(total_size);
+  for (int ky = 0; ky < m_kernel->getHeight(); ++ky) {
+    for (int kx = 0; kx < m_kernel->getWidth(); ++kx) {
+      int x = (kx - hx + fft_width) % fft_width;
+      int y = (ky - hy + fft_height) % fft_height;
+      real_buffer[x + y * fft_width] = m_kernel->getValue(kx, ky);
+    }
+  }
+
+  auto plan = FFT<PixelType>::createForwardPlan(1, fft_width, fft_height, real_buffer, complex_buffer);
+  FFT<PixelType>::executeForward(plan, real_buffer, complex_buffer);
+
+  // Only height * (width / 2 + 1) positions are meaningful for a real to complex transform
+  complex_buffer.resize(fft_height * (fft_width / 2 + 1));
+  return m_kernel_transforms.emplace(key, std::move(complex_buffer)).first->second;
+}
+
 void BgDFTConvolutionImageSource::generateTile(const std::shared_ptr<Image<DetectionImage::PixelType>>& image,
                                                ImageTile<DetectionImage::PixelType>& tile,
                                                int start_x, int start_y, int width, int height) const {
-  int hx = m_convolution.getWidth() / 2;
-  int hy = m_convolution.getHeight() / 2;
-  int clip_x = std::max(start_x - hx, 0);
-  int clip_y = std::max(start_y - hy, 0);
-  int clip_w = std::min(width + hx * 2, image->getWidth() - clip_x);
-  int clip_h = std::min(height + hy * 2, image->getHeight() - clip_y);
-
-  // Clip the image and variance map to the given size, accounting for the margins for the convolution
-  auto clipped_img = FunctionalImage<DetectionImage::PixelType>::create(
-    clip_w, clip_h, [image, clip_x, clip_y](int x, int y) {
-      return image->getValue(clip_x + x, clip_y + y);
+  // The tile may have been computed already as part of a previous block
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    TileKey key{start_x, start_y, width, height};
+    auto ready = m_ready_tiles.find(key);
+    if (ready != m_ready_tiles.end()) {
+      tile.getImage() = ready->second;
+      m_ready_tiles.erase(ready);
+      m_ready_order.remove(key);
+      return;
+    }
+  }
+
+  filterBlock(image, *tile.getImage(), start_x, start_y, width, height);
+}
+
+void BgDFTConvolutionImageSource::filterBlock(const std::shared_ptr<Image<DetectionImage::PixelType>>& image,
+                                              VectorImage<DetectionImage::PixelType>& first_tile,
+                                              int start_x, int start_y, int width, int height) const {
+  const int hx = m_kernel->getWidth() / 2;
+  const int hy = m_kernel->getHeight() / 2;
+
+  // The block spans the requested tile, and as many of the following ones as requested and available
+  const int block_w = std::min(width * m_tiles_per_block, image->getWidth() - start_x);
+
+  // Region to transform: the block plus the margin required by the kernel, which may fall outside the image
+  const int region_x = start_x - hx;
+  const int region_y = start_y - hy;
+  const int region_w = block_w + hx * 2;
+  const int region_h = height + hy * 2;
+
+  const int clip_x = std::max(region_x, 0);
+  const int clip_y = std::max(region_y, 0);
+  const int clip_w = std::min(region_x + region_w, image->getWidth()) - clip_x;
+  const int clip_h = std::min(region_y + region_h, image->getHeight()) - clip_y;
+  const int off_x = clip_x - region_x;
+  const int off_y = clip_y - region_y;
+
+  auto image_chunk = image->getChunk(clip_x, clip_y, clip_w, clip_h);
+  auto variance_chunk = m_variance->getChunk(clip_x, clip_y, clip_w, clip_h);
+
+  // If the region is fully inside the image, and nothing is masked, the convolution of the mask
+  // is just the sum of the kernel, so there is no need to transform it
+  bool need_mask = (clip_w != region_w || clip_h != region_h);
+  for (int y = 0; y < clip_h && !need_mask; ++y) {
+    for (int x = 0; x < clip_w && !need_mask; ++x) {
+      need_mask = !(variance_chunk->getValue(x, y) < m_threshold);
+    }
+  }
+  const int howmany = need_mask ? 2 : 1;
+
+  // Overlap-save: the circular convolution is exact for the block, as long as the transform covers the margins
+  const int fft_w = fftSmoothDimension(region_w);
+  const int fft_h = fftSmoothDimension(region_h);
+  const int total_size = fft_w * fft_h;
+  const auto& kernel_transform = getKernelTransform(fft_w, fft_h);
+
+  auto& real_buffer = getThreadRealBuffer(total_size * howmany);
+  auto& complex_buffer = getThreadComplexBuffer(total_size * howmany);
+  std::fill(real_buffer.begin(), real_buffer.begin() + total_size * howmany, 0);
+
+  // First transform is the masked image, second (if needed) the mask
+  for (int y = 0; y < clip_h; ++y) {
+    auto row_offset = (y + off_y) * fft_w + off_x;
+    for (int x = 0; x < clip_w; ++x) {
+      bool valid = variance_chunk->getValue(x, y) < m_threshold;
+      real_buffer[row_offset + x] = valid ? image_chunk->getValue(x, y) : 0;
+      if (need_mask) {
+        real_buffer[total_size + row_offset + x] = valid;
+      }
     }
-  );
-  auto clipped_variance = FunctionalImage<DetectionImage::PixelType>::create(
-    clip_w, clip_h, [this, clip_x, clip_y](int x, int y) {
-      return m_variance->getValue(clip_x + x, clip_y + y);
+  }
+
+  auto fwd_plan = FFT<PixelType>::createForwardPlan(howmany, fft_w, fft_h, real_buffer, complex_buffer);
+  auto inv_plan = FFT<PixelType>::createInversePlan(howmany, fft_w, fft_h, complex_buffer, real_buffer);
+
+  FFT<PixelType>::executeForward(fwd_plan, real_buffer, complex_buffer);
+  for (int i = 0; i < howmany; ++i) {
+    complex_t *spectrum = complex_buffer.data() + i * total_size;
+    for (std::size_t j = 0; j < kernel_transform.size(); ++j) {
+      const auto& a = spectrum[j];
+      const auto& b = kernel_transform[j];
+      PixelType re = a.real() * b.real() - a.imag() * b.imag();
+      PixelType im = a.real() * b.imag() + a.imag() * b.real();
+      spectrum[j] = complex_t(re, im);
     }
-  );
-
-  // Get the mask
-  // For instance, with a threshold of 0.5
-  // Variance     Mask       Negative
-  // 1  1  1     0  0  0     1  1  1
-  // 1  0  1     0  1  0     1  0  1
-  // 1  1  1     0  0  0     1  1  1
-  auto mask = FunctionalImage<DetectionImage::PixelType>::create(
-    clipped_variance->getWidth(), clipped_variance->getHeight(),
-    [this, clipped_variance](int x, int y) -> DetectionImage::PixelType {
-      return clipped_variance->getValue(x, y) < m_threshold;
+  }
+  FFT<PixelType>::executeInverse(inv_plan, complex_buffer, real_buffer);
+
+  // Copy out the value of the convolved image, divided by the convolved mask, applying
+  // again the mask to the convolved result. Both transforms share the same normalization, so it cancels out
+  // when the mask is transformed.
+  const PixelType constant_weight = m_kernel_sum * total_size;
+  for (int tile_x = start_x; tile_x < start_x + block_w; tile_x += width) {
+    int tile_w = std::min(width, start_x + block_w - tile_x);
+    auto tile_image = (tile_x == start_x) ? nullptr : VectorImage<PixelType>::create(tile_w, height);
+    auto& target = tile_image ? *tile_image : first_tile;
+
+    for (int y = 0; y < height; ++y) {
+      for (int x = 0; x < tile_w; ++x) {
+        int region_ix = x + tile_x - start_x + hx;
+        int region_iy = y + hy;
+        int buffer_i = region_ix + region_iy * fft_w;
+        if (variance_chunk->getValue(region_ix - off_x, region_iy - off_y) < m_threshold) {
+          PixelType weight = need_mask ? real_buffer[total_size + buffer_i] : constant_weight;
+          target.setValue(x, y, real_buffer[buffer_i] / weight);
+        }
+        else {
+          target.setValue(x, y, 0);
+        }
+      }
     }
-  );
-
-  // Get the image masking out values where the variance is greater than the threshold
-  auto masked_img = MultiplyImage<DetectionImage::PixelType>::create(clipped_img, mask);
-
-  // Convolve the masked image, padding with 0
-  auto conv_masked = VectorImage<DetectionImage::PixelType>::create(masked_img);
-  m_convolution.convolve(conv_masked);
-
-  // Convolve the mask
-  // This gives us in each cell the sum of the kernel values that have been used,
-  // so we can divide the previous convolution.
-  auto conv_mask = VectorImage<DetectionImage::PixelType>::create(mask);
-  m_convolution.convolve(conv_mask);
-
-  // Copy out the value of the convolved image, divided by the negative mask, applying
-  // again the mask to the convolved result
-  int off_x = start_x - clip_x;
-  int off_y = start_y - clip_y;
-  for (int y = 0; y < height; ++y) {
-    for (int x = 0; x < width; ++x) {
-      if (mask->getValue(x + off_x, y + off_y)) {
-        tile.setValue(
-          x + start_x, y + start_y,
-          conv_masked->getValue(x + off_x, y + off_y) / conv_mask->getValue(x + off_x, y + off_y)
-        );
-      } else {
-        tile.setValue(x + start_x, y + start_y, 0);
+
+    if (tile_image) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      TileKey key{tile_x, start_y, tile_w, height};
+      m_ready_tiles[key] = tile_image;
+      m_ready_order.push_back(key);
+      // Tiles that are never requested (i.e. only part of the image is read) must not pile up
+      while (m_ready_order.size() > static_cast<std::size_t>(4 * m_tiles_per_block)) {
+        m_ready_tiles.erase(m_ready_order.front());
+        m_ready_order.pop_front();
       }
     }
   }
 }
 
 } // end namespace SourceXtractor
-
@@ -0,0 +1,322 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * DetectionSnapshot.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "ElementsKernel/Exception.h"
+
+#include "SEFramework/Image/BufferedImage.h"
+#include "SEFramework/Image/ConstantImage.h"
+#include "SEFramework/Image/ScaledImageSource.h"
+#include "SEFramework/Image/VectorImage.h"
+#include "SEFramework/Property/DetectionFrame.h"
+#include "SEImplementation/Background/SE2/TypedSplineModelWrapper.h"
+#include "SEImplementation/Property/PixelCoordinateList.h"
+#include "SEImplementation/Property/SourceId.h"
+
+#include "SEImplementation/Snapshot/DetectionSnapshot.h"
+
+namespace SourceXtractor {
+
+static const char SNAPSHOT_MAGIC[8] = {'S', 'E', 'S', 'N', 'A', 'P', 'S', 'H'};
+// Written in the native byte order, so a reader with a different one sees it swapped
+static const std::uint32_t SNAPSHOT_BYTE_ORDER_MARK = 0x01020304;
+static const std::uint32_t SNAPSHOT_VERSION = 2;
+
+// How a background map is stored: its full resolution pixels, or the mesh it is interpolated from
+enum class SnapshotMap : std::uint32_t {
+  FULL = 0, CONSTANT = 1, BICUBIC = 2, SPLINE = 3
+};
+
+// Number of rows read at once when saving the background maps
+static const int SNAPSHOT_BLOCK_HEIGHT = 64;
+
+template <typename T>
+static void writeValue(std::ostream& stream, T value) {
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+static T readValue(std::istream& stream, const std::string& path) {
+  T value;
+  if (!stream.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+    throw Elements::Exception() << "Truncated detection snapshot " << path;
+  }
+  return value;
+}
+
+static void writeImage(std::ostream& stream, const Image<SeFloat>& image) {
+  int width = image.getWidth(), height = image.getHeight();
+  for (int y = 0; y < height; y += SNAPSHOT_BLOCK_HEIGHT) {
+    int block_height = std::min(SNAPSHOT_BLOCK_HEIGHT, height - y);
+    auto chunk = image.getChunk(0, y, width, block_height);
+    for (int dy = 0; dy < block_height; ++dy) {
+      for (int x = 0; x < width; ++x) {
+        writeValue<SeFloat>(stream, chunk->getValue(x, dy));
+      }
+    }
+  }
+}
+
+static std::shared_ptr<VectorImage<SeFloat>> readImage(std::istream& stream, const std::string& path,
+                                                       int width, int height) {
+  auto image = VectorImage<SeFloat>::create(width, height);
+  auto& data = image->getData();
+  if (!stream.read(reinterpret_cast<char*>(data.data()), data.size() * sizeof(SeFloat))) {
+    throw Elements::Exception() << "Truncated detection snapshot " << path;
+  }
+  return image;
+}
+
+static void writeMap(std::ostream& stream, const Image<SeFloat>& image, const BackgroundMesh* mesh) {
+  if (!mesh) {
+    writeValue<std::uint32_t>(stream, static_cast<std::uint32_t>(SnapshotMap::FULL));
+    writeImage(stream, image);
+    return;
+  }
+
+  SnapshotMap type = SnapshotMap::CONSTANT;
+  switch (mesh->m_interpolation) {
+    case BackgroundMesh::Interpolation::CONSTANT:
+      type = SnapshotMap::CONSTANT;
+      break;
+    case BackgroundMesh::Interpolation::BICUBIC:
+      type = SnapshotMap::BICUBIC;
+      break;
+    case BackgroundMesh::Interpolation::SPLINE:
+      type = SnapshotMap::SPLINE;
+      break;
+  }
+  writeValue<std::uint32_t>(stream, static_cast<std::uint32_t>(type));
+  writeValue<std::int32_t>(stream, mesh->m_cell_width);
+  writeValue<std::int32_t>(stream, mesh->m_cell_height);
+  writeValue<std::int32_t>(stream, mesh->m_values->getWidth());
+  writeValue<std::int32_t>(stream, mesh->m_values->getHeight());
+  writeImage(stream, *mesh->m_values);
+}
+
+/// Builds the map the same way the background analyzers do from the mesh
+static std::shared_ptr<Image<SeFloat>> rebuildMap(const BackgroundMesh& mesh, int width, int height) {
+  switch (mesh.m_interpolation) {
+    case BackgroundMesh::Interpolation::CONSTANT:
+      return ConstantImage<SeFloat>::create(width, height, mesh.m_values->getValue(0, 0));
+    case BackgroundMesh::Interpolation::BICUBIC:
+      return BufferedImage<SeFloat>::create(std::make_shared<ScaledImageSource<SeFloat>>(
+        mesh.m_values, width, height, ScaledImageSource<SeFloat>::InterpolationType::BICUBIC));
+    case BackgroundMesh::Interpolation::SPLINE: {
+      size_t naxes[2] = {size_t(width), size_t(height)};
+      size_t cell_size[2] = {size_t(mesh.m_cell_width), size_t(mesh.m_cell_height)};
+      size_t n_grid[2] = {size_t(mesh.m_values->getWidth()), size_t(mesh.m_values->getHeight())};
+      // The spline model takes ownership of the grid
+      auto& values = mesh.m_values->getData();
+      PIXTYPE* grid = new PIXTYPE[values.size()];
+      std::copy(values.begin(), values.end(), grid);
+      return BufferedImage<SeFloat>::create(TypedSplineModelWrapper<SeFloat>::create(naxes, cell_size, n_grid, grid));
+    }
+  }
+  return nullptr;
+}
+
+/// Returns the mesh, or nullptr and the full resolution map in image
+static std::shared_ptr<BackgroundMesh> readMap(std::istream& stream, const std::string& path, int width, int height,
+                                               std::shared_ptr<Image<SeFloat>>& image) {
+  auto type = static_cast<SnapshotMap>(readValue<std::uint32_t>(stream, path));
+  BackgroundMesh::Interpolation interpolation;
+  switch (type) {
+    case SnapshotMap::FULL:
+      image = readImage(stream, path, width, height);
+      return nullptr;
+    case SnapshotMap::CONSTANT:
+      interpolation = BackgroundMesh::Interpolation::CONSTANT;
+      break;
+    case SnapshotMap::BICUBIC:
+      interpolation = BackgroundMesh::Interpolation::BICUBIC;
+      break;
+    case SnapshotMap::SPLINE:
+      interpolation = BackgroundMesh::Interpolation::SPLINE;
+      break;
+    default:
+      throw Elements::Exception() << "Unknown background map type " << static_cast<std::uint32_t>(type)
+                                  << " in the detection snapshot " << path;
+  }
+
+  auto cell_width = readValue<std::int32_t>(stream, path);
+  auto cell_height = readValue<std::int32_t>(stream, path);
+  auto grid_width = readValue<std::int32_t>(stream, path);
+  auto grid_height = readValue<std::int32_t>(stream, path);
+  if (cell_width <= 0 || cell_height <= 0 || grid_width <= 0 || grid_height <= 0) {
+    throw Elements::Exception() << "Invalid background mesh in the detection snapshot " << path;
+  }
+  auto mesh = BackgroundMesh::create(interpolation, cell_width, cell_height,
+                                     readImage(stream, path, grid_width, grid_height));
+  image = rebuildMap(*mesh, width, height);
+  return mesh;
+}
+
+//
+// class DetectionSnapshotWriter
+//
+
+DetectionSnapshotWriter::DetectionSnapshotWriter(const std::string& path)
+    : m_path(path), m_stream(path, std::ios::binary | std::ios::trunc) {
+  if (!m_stream) {
+    throw Elements::Exception() << "Can not create the detection snapshot " << path;
+  }
+  m_stream.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+  writeValue<std::uint32_t>(m_stream, SNAPSHOT_BYTE_ORDER_MARK);
+  writeValue<std::uint32_t>(m_stream, SNAPSHOT_VERSION);
+}
+
+void DetectionSnapshotWriter::writeBackground(const BackgroundModel& background_model) {
+  auto level = background_model.getLevelMap();
+  writeValue<std::int32_t>(m_stream, level->getWidth());
+  writeValue<std::int32_t>(m_stream, level->getHeight());
+  writeValue<SeFloat>(m_stream, background_model.getScalingFactor());
+  writeValue<SeFloat>(m_stream, background_model.getMedianRms());
+  // The meshes are much smaller than the maps, and cheap to interpolate again
+  writeMap(m_stream, *level, background_model.getLevelMesh().get());
+  writeMap(m_stream, *background_model.getVarianceMap(), background_model.getVarianceMesh().get());
+}
+
+void DetectionSnapshotWriter::handleMessage(const std::shared_ptr<SourceGroupInterface>& group) {
+  writeValue<std::uint32_t>(m_stream, group->size());
+
+  for (auto& source : *group) {
+    auto& source_id = source.getProperty<SourceId>();
+    auto& pixels = source.getProperty<PixelCoordinateList>().getCoordinateList();
+
+    writeValue<std::uint32_t>(m_stream, source_id.getSourceId());
+    writeValue<std::uint32_t>(m_stream, source_id.getDetectionId());
+
+    // Split the footprint into runs along the x axis, keeping the original order
+    std::vector<std::pair<PixelCoordinate, std::uint32_t>> runs;
+    for (auto& pixel : pixels) {
+      if (!runs.empty()) {
+        auto& last = runs.back();
+        if (pixel.m_y == last.first.m_y && pixel.m_x == last.first.m_x + static_cast<int>(last.second)) {
+          ++last.second;
+          continue;
+        }
+      }
+      runs.emplace_back(pixel, 1);
+    }
+
+    writeValue<std::uint32_t>(m_stream, runs.size());
+    for (auto& run : runs) {
+      writeValue<std::int32_t>(m_stream, run.first.m_x);
+      writeValue<std::int32_t>(m_stream, run.first.m_y);
+      writeValue<std::uint32_t>(m_stream, run.second);
+    }
+  }
+
+  if (!m_stream) {
+    throw Elements::Exception() << "Failed to write the detection snapshot " << m_path;
+  }
+}
+
+void DetectionSnapshotWriter::close() {
+  // Groups are never empty, so a zero size marks the end
+  writeValue<std::uint32_t>(m_stream, 0);
+  m_stream.close();
+  if (!m_stream) {
+    throw Elements::Exception() << "Failed to write the detection snapshot " << m_path;
+  }
+}
+
+//
+// class DetectionSnapshotReader
+//
+
+DetectionSnapshotReader::DetectionSnapshotReader(const std::string& path,
+                                                 std::shared_ptr<SourceFactory> source_factory,
+                                                 std::shared_ptr<SourceGroupFactory> group_factory)
+    : m_path(path), m_stream(path, std::ios::binary),
+      m_source_factory(source_factory), m_group_factory(group_factory) {
+  if (!m_stream) {
+    throw Elements::Exception() << "Can not open the detection snapshot " << path;
+  }
+  char magic[sizeof(SNAPSHOT_MAGIC)];
+  if (!m_stream.read(magic, sizeof(magic)) || std::memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) != 0) {
+    throw Elements::Exception() << path << " is not a detection snapshot";
+  }
+  auto byte_order_mark = readValue<std::uint32_t>(m_stream, m_path);
+  if (byte_order_mark != SNAPSHOT_BYTE_ORDER_MARK) {
+    throw Elements::Exception() << "The detection snapshot " << path
+                                << " was written on a machine with a different byte order";
+  }
+  auto version = readValue<std::uint32_t>(m_stream, m_path);
+  if (version != SNAPSHOT_VERSION) {
+    throw Elements::Exception() << "Unsupported version " << version << " of the detection snapshot " << path;
+  }
+}
+
+BackgroundModel DetectionSnapshotReader::readBackground(int width, int height) {
+  auto saved_width = readValue<std::int32_t>(m_stream, m_path);
+  auto saved_height = readValue<std::int32_t>(m_stream, m_path);
+  if (saved_width != width || saved_height != height) {
+    throw Elements::Exception() << "The detection snapshot " << m_path << " was made from a "
+                                << saved_width << "x" << saved_height << " image, but the detection image is "
+                                << width << "x" << height;
+  }
+  auto scaling_factor = readValue<SeFloat>(m_stream, m_path);
+  auto median_rms = readValue<SeFloat>(m_stream, m_path);
+  std::shared_ptr<Image<SeFloat>> level, variance;
+  auto level_mesh = readMap(m_stream, m_path, width, height, level);
+  auto variance_mesh = readMap(m_stream, m_path, width, height, variance);
+  BackgroundModel background_model(level, variance, scaling_factor, median_rms);
+  background_model.setMeshes(level_mesh, variance_mesh);
+  return background_model;
+}
+
+void DetectionSnapshotReader::processFrame(std::shared_ptr<DetectionImageFrame> frame) {
+  while (auto group_size = readValue<std::uint32_t>(m_stream, m_path)) {
+    auto group = m_group_factory->createSourceGroup();
+
+    for (std::uint32_t i = 0; i < group_size; ++i) {
+      auto source_id = readValue<std::uint32_t>(m_stream, m_path);
+      auto detection_id = readValue<std::uint32_t>(m_stream, m_path);
+
+      std::vector<PixelCoordinate> pixels;
+      auto nruns = readValue<std::uint32_t>(m_stream, m_path);
+      for (std::uint32_t r = 0; r < nruns; ++r) {
+        auto x = readValue<std::int32_t>(m_stream, m_path);
+        auto y = readValue<std::int32_t>(m_stream, m_path);
+        auto length = readValue<std::uint32_t>(m_stream, m_path);
+        for (std::uint32_t dx = 0; dx < length; ++dx) {
+          pixels.emplace_back(x + static_cast<std::int32_t>(dx), y);
+        }
+      }
+
+      auto source = m_source_factory->createSource();
+      source->setProperty<PixelCoordinateList>(std::move(pixels));
+      source->setProperty<SourceId>(source_id, detection_id);
+      source->setProperty<DetectionFrame>(frame);
+      group->addSource(source);
+    }
+
+    notifyObservers(group);
+  }
+}
+
+} /* namespace SourceXtractor */
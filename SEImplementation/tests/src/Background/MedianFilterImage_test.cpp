@@ -16,6 +16,7 @@
  */
 
 #include <boost/test/unit_test.hpp>
+#include <random>
 #include "SEImplementation/Background/SE/MedianFilter.h"
 #include "SEFramework/Image/VectorImage.h"
 #include "SEUtils/TestUtils.h"
@@ -134,6 +135,52 @@ BOOST_FIXTURE_TEST_CASE(median1x3, MedianFilterImageFixture) {
   BOOST_CHECK(compareImages(expected_var, filtered.second));
 }
 
+//-----------------------------------------------------------------------------
+// The sliding window must match sorting the clipped box of every pixel
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(medianSliding) {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> dist(0, 20);
+  auto image = VectorImage<SeFloat>::create(40, 30);
+  auto variance = VectorImage<SeFloat>::create(40, 30);
+  for (int y = 0; y < 30; ++y) {
+    for (int x = 0; x < 40; ++x) {
+      image->at(x, y) = dist(gen);
+      variance->at(x, y) = dist(gen) / 10.;
+    }
+  }
+
+  auto boxMedian = [](const VectorImage<SeFloat>& img, int x, int y, int hw, int hh) {
+    std::vector<SeFloat> box;
+    for (int iy = y - hh; iy <= y + hh; ++iy) {
+      for (int ix = x - hw; ix <= x + hw; ++ix) {
+        box.push_back(img.getValue(ix, iy));
+      }
+    }
+    std::sort(box.begin(), box.end());
+    return box[box.size() / 2];
+  };
+
+  SeFloat threshold = 2;
+  auto filtered = MedianFilter<SeFloat>(7, 5)(*image, *variance, threshold);
+  for (int y = 0; y < 30; ++y) {
+    int hh = std::min(2, std::min(y, 29 - y));
+    for (int x = 0; x < 40; ++x) {
+      int hw = std::min(3, std::min(x, 39 - x));
+      auto median = boxMedian(*image, x, y, hw, hh);
+      if (std::abs(median - image->getValue(x, y)) >= threshold) {
+        BOOST_CHECK_EQUAL(filtered.first->getValue(x, y), median);
+        BOOST_CHECK_EQUAL(filtered.second->getValue(x, y), boxMedian(*variance, x, y, hw, hh));
+      }
+      else {
+        BOOST_CHECK_EQUAL(filtered.first->getValue(x, y), image->getValue(x, y));
+        BOOST_CHECK_EQUAL(filtered.second->getValue(x, y), variance->getValue(x, y));
+      }
+    }
+  }
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -16,6 +16,7 @@
  */
 
 #include <boost/test/unit_test.hpp>
+#include <random>
 
 #include "SEImplementation/Background/SE/ReplaceUndefImage.h"
 #include "SEFramework/Image/VectorImage.h"
@@ -88,6 +89,60 @@ BOOST_AUTO_TEST_CASE(replaceInvTwo) {
   BOOST_CHECK(compareImages(expected, replaced, 1e-3));
 }
 
+//-----------------------------------------------------------------------------
+// Sparse defined pixels, with plenty of ties. Compare with a full scan
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(replaceInvSparse) {
+  std::mt19937 gen(7);
+  std::uniform_real_distribution<SeFloat> value(0, 10);
+  std::bernoulli_distribution defined(0.05);
+
+  auto sparse = VectorImage<SeFloat>::create(37, 23);
+  for (int y = 0; y < 23; ++y) {
+    for (int x = 0; x < 37; ++x) {
+      sparse->at(x, y) = defined(gen) ? value(gen) : INV;
+    }
+  }
+
+  auto replaced = ReplaceUndefImage<SeFloat>::create(sparse, INV);
+  for (int y = 0; y < 23; ++y) {
+    for (int x = 0; x < 37; ++x) {
+      int min_distance = std::numeric_limits<int>::max();
+      SeFloat acc = 0;
+      size_t count = 0;
+      for (int iy = 0; iy < 23; ++iy) {
+        for (int ix = 0; ix < 37; ++ix) {
+          auto v = sparse->getValue(ix, iy);
+          int distance = (x - ix) * (x - ix) + (y - iy) * (y - iy);
+          if (v == INV || distance > min_distance)
+            continue;
+          if (distance < min_distance) {
+            acc = v;
+            count = 1;
+            min_distance = distance;
+          }
+          else {
+            acc += v;
+            ++count;
+          }
+        }
+      }
+      BOOST_CHECK_EQUAL(replaced->getValue(x, y), acc / count);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+// Nothing to interpolate from
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(replaceInvAll) {
+  auto all_missing = VectorImage<SeFloat>::create(3, 2, std::vector<SeFloat>(6, INV));
+  auto replaced = ReplaceUndefImage<SeFloat>::create(all_missing, INV);
+  BOOST_CHECK_EQUAL(replaced->getValue(1, 1), 0);
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,94 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <vector>
+
+#include "SEImplementation/Background/SE2/SplineModel.h"
+
+using namespace SourceXtractor;
+
+struct SplineModelFixture {
+  size_t naxes[2] = {301, 203};
+  size_t cellSize[2] = {32, 25};
+  size_t nGrid[2] = {10, 9};
+
+  std::unique_ptr<SplineModel> model;
+
+  SplineModelFixture() {
+    // The model takes ownership of the grid
+    PIXTYPE *grid = new PIXTYPE[nGrid[0] * nGrid[1]];
+    for (size_t y = 0; y < nGrid[1]; ++y) {
+      for (size_t x = 0; x < nGrid[0]; ++x) {
+        grid[x + y * nGrid[0]] = 100 + 10 * std::sin(0.7 * x) + 5 * std::cos(1.3 * y) + 0.5 * x * y;
+      }
+    }
+    model.reset(new SplineModel(naxes, cellSize, nGrid, grid));
+  }
+
+  void checkWindow(size_t x0, size_t y0, size_t width, size_t height) {
+    std::vector<PIXTYPE> tile(width * height);
+    model->splineTile(tile.data(), x0, y0, width, height);
+    for (size_t y = 0; y < height; ++y) {
+      for (size_t x = 0; x < width; ++x) {
+        BOOST_CHECK_EQUAL(tile[x + y * width], model->getValue(x0 + x, y0 + y));
+      }
+    }
+  }
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(SplineModel_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(full_image, SplineModelFixture) {
+  checkWindow(0, 0, naxes[0], naxes[1]);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(windows, SplineModelFixture) {
+  checkWindow(0, 0, 64, 64);
+  checkWindow(17, 40, 100, 33);
+  checkWindow(250, 180, 51, 23);
+  checkWindow(150, 0, 1, naxes[1]);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(single_row_and_column) {
+  size_t naxes[2] = {100, 40};
+  size_t cellSize[2] = {64, 64};
+  size_t nGrid[2] = {2, 1};
+  PIXTYPE *grid = new PIXTYPE[2]{3., 7.};
+  SplineModel model(naxes, cellSize, nGrid, grid);
+
+  std::vector<PIXTYPE> tile(30 * 5);
+  model.splineTile(tile.data(), 60, 10, 30, 5);
+  for (size_t y = 0; y < 5; ++y) {
+    for (size_t x = 0; x < 30; ++x) {
+      BOOST_CHECK_EQUAL(tile[x + y * 30], model.getValue(60 + x, 10 + y));
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
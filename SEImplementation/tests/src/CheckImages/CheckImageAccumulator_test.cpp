@@ -0,0 +1,122 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * CheckImageAccumulator_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <future>
+
+#include "SEFramework/Pipeline/MemoryGovernor.h"
+#include "SEImplementation/CheckImages/CheckImageAccumulator.h"
+
+using namespace SourceXtractor;
+
+BOOST_AUTO_TEST_SUITE (CheckImageAccumulator_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (add_test) {
+  auto image = VectorImage<SeFloat>::create(600, 300);
+  image->at(0, 0) = 5;
+  CheckImageAccumulator accumulator(image, 2 * CheckImageAccumulator::BLOCK_BYTES);
+
+  // Crosses blocks and the image border
+  auto stamp = VectorImage<SeFloat>::create(300, 100);
+  stamp->fillValue(1);
+  accumulator.addStamp(*stamp, 400, 250);
+  accumulator.addStamp(*stamp, -10, -10);
+
+  // Concurrently add on the same area
+  std::vector<std::future<void>> adders;
+  for (int i = 0; i < 4; ++i) {
+    adders.emplace_back(std::async(std::launch::async, [&accumulator, &stamp]() {
+      for (int j = 0; j < 10; ++j) {
+        accumulator.addStamp(*stamp, 200, 100);
+      }
+    }));
+  }
+  for (auto& a : adders) {
+    a.get();
+  }
+  accumulator.flush();
+
+  BOOST_CHECK_EQUAL(image->getValue(0, 0), 6);
+  BOOST_CHECK_EQUAL(image->getValue(289, 89), 1);
+  BOOST_CHECK_EQUAL(image->getValue(290, 89), 0);
+  BOOST_CHECK_EQUAL(image->getValue(599, 299), 1);
+  BOOST_CHECK_EQUAL(image->getValue(399, 299), 0);
+  BOOST_CHECK_EQUAL(image->getValue(200, 100), 40);
+  BOOST_CHECK_EQUAL(image->getValue(499, 199), 40);
+  BOOST_CHECK_EQUAL(image->getValue(500, 199), 0);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (add_row_test) {
+  auto image = VectorImage<SeFloat>::create(600, 300);
+  CheckImageAccumulator accumulator(image, 2 * CheckImageAccumulator::BLOCK_BYTES);
+
+  std::vector<SeFloat> row{1, 2, 3, 4, 5};
+  accumulator.addRow(row.data(), row.size(), 254, 10);
+  accumulator.addRow(row.data(), row.size(), 597, 299);
+  accumulator.addRow(row.data(), row.size(), -2, 300);
+  accumulator.flush();
+
+  BOOST_CHECK_EQUAL(image->getValue(253, 10), 0);
+  BOOST_CHECK_EQUAL(image->getValue(255, 10), 2);
+  BOOST_CHECK_EQUAL(image->getValue(256, 10), 3);
+  BOOST_CHECK_EQUAL(image->getValue(258, 10), 5);
+  BOOST_CHECK_EQUAL(image->getValue(597, 299), 1);
+  BOOST_CHECK_EQUAL(image->getValue(599, 299), 3);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (memory_test) {
+  auto memory_governor = MemoryGovernor::getInstance();
+  auto used = memory_governor->getUsed();
+
+  auto image = VectorImage<SeFloat>::create(600, 300);
+  auto stamp = VectorImage<SeFloat>::create(10, 10);
+  stamp->fillValue(1);
+  {
+    CheckImageAccumulator accumulator(image, 4 * CheckImageAccumulator::BLOCK_BYTES);
+
+    // Each block is charged while it is held
+    accumulator.addStamp(*stamp, 250, 250);
+    BOOST_CHECK_EQUAL(memory_governor->getUsed(), used + 4 * CheckImageAccumulator::BLOCK_BYTES);
+
+    // More blocks than allowed, so they are added into the image
+    accumulator.addStamp(*stamp, 520, 10);
+    BOOST_CHECK_EQUAL(memory_governor->getUsed(), used);
+    BOOST_CHECK_EQUAL(image->getValue(255, 255), 1);
+    BOOST_CHECK_EQUAL(image->getValue(520, 10), 1);
+
+    // Released when the accumulator goes away without a flush
+    accumulator.addStamp(*stamp, 0, 0);
+    BOOST_CHECK_EQUAL(memory_governor->getUsed(), used + CheckImageAccumulator::BLOCK_BYTES);
+  }
+  BOOST_CHECK_EQUAL(memory_governor->getUsed(), used);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,187 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * LabelCheckImageWriter_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <future>
+#include <stdexcept>
+
+#include "SEFramework/Image/VectorImage.h"
+#include "SEImplementation/CheckImages/LabelCheckImageWriter.h"
+
+using namespace SourceXtractor;
+
+// Fails to write into a given row
+class FailingImage : public WriteableImage<unsigned int> {
+public:
+  FailingImage(int width, int height, int failing_row)
+    : m_image(VectorImage<unsigned int>::create(width, height)), m_failing_row(failing_row) {}
+
+  std::string getRepr() const override {
+    return "FailingImage";
+  }
+
+  unsigned int getValue(int x, int y) const override {
+    return m_image->getValue(x, y);
+  }
+
+  int getWidth() const override {
+    return m_image->getWidth();
+  }
+
+  int getHeight() const override {
+    return m_image->getHeight();
+  }
+
+  std::shared_ptr<ImageChunk<unsigned int>> getChunk(int x, int y, int width, int height) const override {
+    return m_image->getChunk(x, y, width, height);
+  }
+
+  void setValue(int x, int y, unsigned int value) override {
+    if (y == m_failing_row) {
+      throw std::runtime_error("Failed to write");
+    }
+    m_image->setValue(x, y, value);
+  }
+
+  std::shared_ptr<VectorImage<unsigned int>> m_image;
+  int m_failing_row;
+};
+
+BOOST_AUTO_TEST_SUITE (LabelCheckImageWriter_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (spans_test) {
+  std::vector<PixelCoordinate> pixels{{3, 1}, {1, 1}, {2, 1}, {5, 1}, {0, 0}, {2, 2}};
+  auto spans = LabelCheckImageWriter::toSpans(pixels, 7);
+
+  BOOST_REQUIRE_EQUAL(spans.size(), 4);
+  BOOST_CHECK_EQUAL(spans[0].m_x, 0);
+  BOOST_CHECK_EQUAL(spans[0].m_y, 0);
+  BOOST_CHECK_EQUAL(spans[0].m_length, 1);
+  BOOST_CHECK_EQUAL(spans[1].m_x, 1);
+  BOOST_CHECK_EQUAL(spans[1].m_y, 1);
+  BOOST_CHECK_EQUAL(spans[1].m_length, 3);
+  BOOST_CHECK_EQUAL(spans[2].m_x, 5);
+  BOOST_CHECK_EQUAL(spans[2].m_length, 1);
+  BOOST_CHECK_EQUAL(spans[3].m_y, 2);
+  BOOST_CHECK_EQUAL(spans[3].m_value, 7);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (write_test) {
+  auto image = VectorImage<unsigned int>::create(64, 64);
+  LabelCheckImageWriter writer(image);
+
+  // Each thread writes its own rows
+  std::vector<std::future<void>> producers;
+  for (unsigned int t = 0; t < 4; ++t) {
+    producers.emplace_back(std::async(std::launch::async, [&writer, t]() {
+      for (int y = t * 16; y < int(t + 1) * 16; ++y) {
+        std::vector<PixelCoordinate> row;
+        for (int x = 0; x < 64; ++x) {
+          row.emplace_back(x, y);
+        }
+        writer.write(row, t + 1);
+      }
+    }));
+  }
+  for (auto& p : producers) {
+    p.get();
+  }
+
+  // Overlapping footprints: the last one wins
+  writer.write({{0, 0}, {1, 0}, {2, 0}}, 10);
+  writer.write({{1, 0}}, 20);
+  writer.flush();
+
+  for (int y = 1; y < 64; ++y) {
+    for (int x = 0; x < 64; ++x) {
+      BOOST_CHECK_EQUAL(image->getValue(x, y), y / 16 + 1);
+    }
+  }
+  BOOST_CHECK_EQUAL(image->getValue(0, 0), 10);
+  BOOST_CHECK_EQUAL(image->getValue(1, 0), 20);
+  BOOST_CHECK_EQUAL(image->getValue(2, 0), 10);
+  BOOST_CHECK_EQUAL(image->getValue(3, 0), 1);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (bounded_queue_test) {
+  auto image = VectorImage<unsigned int>::create(64, 64);
+  // Room for less than a single footprint
+  LabelCheckImageWriter writer(image, 2);
+
+  std::vector<std::future<void>> producers;
+  for (unsigned int t = 0; t < 4; ++t) {
+    producers.emplace_back(std::async(std::launch::async, [&writer, t]() {
+      for (int y = t * 16; y < int(t + 1) * 16; ++y) {
+        // Two separate spans per row
+        std::vector<PixelCoordinate> row;
+        for (int x = 0; x < 64; x += 2) {
+          row.emplace_back(x, y);
+        }
+        writer.write(row, t + 1);
+        writer.write({{1, y}, {3, y}, {5, y}}, t + 10);
+      }
+    }));
+  }
+  for (auto& p : producers) {
+    p.get();
+  }
+  writer.flush();
+
+  for (int y = 0; y < 64; ++y) {
+    for (int x = 0; x < 64; ++x) {
+      unsigned int expected = 0;
+      if (x % 2 == 0) {
+        expected = y / 16 + 1;
+      }
+      else if (x < 6) {
+        expected = y / 16 + 10;
+      }
+      BOOST_CHECK_EQUAL(image->getValue(x, y), expected);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (error_test) {
+  auto image = std::make_shared<FailingImage>(64, 64, 3);
+  LabelCheckImageWriter writer(image);
+
+  for (int y = 0; y < 8; ++y) {
+    writer.write({{0, y}, {1, y}}, 1);
+  }
+  // The error of the writer thread reaches the caller, instead of terminating the program
+  BOOST_CHECK_THROW(writer.flush(), std::runtime_error);
+  BOOST_CHECK_THROW(writer.write({{0, 10}}, 1), std::runtime_error);
+  BOOST_CHECK_EQUAL(image->getValue(0, 10), 0);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,112 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * MoffatInfluence_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+
+#include "SEImplementation/Deblending/MoffatInfluence.h"
+
+using namespace SourceXtractor;
+
+struct MoffatInfluenceFixture {
+  std::vector<MoffatInfluence::Profile> profiles;
+  std::vector<MoffatInfluence::PixelList> pixel_lists;
+
+  MoffatInfluenceFixture() {
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<double> position(0, 100), scale(0.5, 2), angle(0, 3.14);
+    std::uniform_int_distribution<int> offset(-4, 4);
+
+    for (int i = 0; i < 20; ++i) {
+      double x = position(gen), y = position(gen);
+      profiles.emplace_back(x, y, 100, 2.5, 2, 0.5, scale(gen), scale(gen), angle(gen));
+      MoffatInfluence::PixelList pixels;
+      for (int j = 0; j < 30; ++j) {
+        pixels.emplace_back(static_cast<int>(x) + offset(gen), static_cast<int>(y) + offset(gen));
+      }
+      pixel_lists.emplace_back(std::move(pixels));
+    }
+  }
+
+  std::vector<std::reference_wrapper<const MoffatInfluence::PixelList>> getPixels() const {
+    return {pixel_lists.begin(), pixel_lists.end()};
+  }
+
+  double bruteForce(std::size_t source, std::size_t pixel) const {
+    double influence = 0;
+    auto& coord = pixel_lists[source][pixel];
+    for (std::size_t other = 0; other < profiles.size(); ++other) {
+      if (other != source) {
+        influence += profiles[other].getValue(coord.m_x, coord.m_y);
+      }
+    }
+    return influence;
+  }
+};
+
+BOOST_AUTO_TEST_SUITE (MoffatInfluence_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE (exact_test, MoffatInfluenceFixture) {
+  MoffatInfluence influence(profiles, getPixels(), 0);
+  for (std::size_t s = 0; s < pixel_lists.size(); ++s) {
+    BOOST_REQUIRE_EQUAL(influence.getInfluence(s).size(), pixel_lists[s].size());
+    for (std::size_t p = 0; p < pixel_lists[s].size(); ++p) {
+      BOOST_CHECK_EQUAL(influence.getInfluence(s)[p], bruteForce(s, p));
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE (truncated_test, MoffatInfluenceFixture) {
+  double threshold = 1e-2;
+  MoffatInfluence influence(profiles, getPixels(), threshold);
+  for (std::size_t s = 0; s < pixel_lists.size(); ++s) {
+    for (std::size_t p = 0; p < pixel_lists[s].size(); ++p) {
+      auto expected = bruteForce(s, p);
+      BOOST_CHECK_LE(influence.getInfluence(s)[p], expected);
+      BOOST_CHECK_GE(influence.getInfluence(s)[p], expected - threshold * profiles.size());
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (radius_test) {
+  MoffatInfluence::Profile profile(0, 0, 100, 2, 1.5, 1, 2, 0.5, 0.3);
+  double threshold = 0.1;
+  double radius = profile.getTruncationRadius(threshold);
+  BOOST_CHECK(std::isfinite(radius));
+  for (int i = 0; i < 360; ++i) {
+    double a = i * M_PI / 180;
+    BOOST_CHECK_LT(profile.getValue(radius * std::cos(a), radius * std::sin(a)), threshold);
+  }
+  BOOST_CHECK_EQUAL(profile.getTruncationRadius(100), 0);
+  BOOST_CHECK(std::isinf(profile.getTruncationRadius(0)));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -101,4 +101,41 @@ BOOST_FIXTURE_TEST_CASE( attractors_test, AttractorsPartitionFixture ) {
 
 //-----------------------------------------------------------------------------
 
+BOOST_FIXTURE_TEST_CASE( attractors_adjacent_peaks_test, AttractorsPartitionFixture ) {
+  auto detection_image = VectorImage<SeFloat>::create(1,1);
+  source->setProperty<DetectionFrame>(std::make_shared<DetectionImageFrame>(detection_image, std::make_shared<DummyCoordinateSystem>()));
+
+  // Two diagonal peaks that touch, plus a long ramp to a separate peak on the bottom right
+  int width = 1000, height = 2;
+  std::vector<PixelCoordinate> pixels;
+  std::vector<DetectionImage::PixelType> values(width * height);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      pixels.emplace_back(x, y);
+      values[x + y * width] = (x < 10) ? 1.f : x;
+    }
+  }
+  values[0] = 5.f;
+  values[1 + width] = 5.f;
+  source->setProperty<PixelCoordinateList>(pixels);
+  source->setProperty<PixelBoundaries>(0, 0, width - 1, height - 1);
+  source->setProperty<DetectionFrameSourceStamp>(
+    VectorImage<DetectionImage::PixelType>::create(width, height, values), nullptr, nullptr,
+    PixelCoordinate(0,0), nullptr, nullptr);
+
+  Partition partition( { attractors_step } );
+  auto source_observer = std::make_shared<SourceObserver>();
+  partition.addObserver(source_observer);
+  partition.handleMessage(source);
+
+  BOOST_REQUIRE_EQUAL(source_observer->m_list.size(), 2);
+  size_t total = 0;
+  for (auto& partitioned : source_observer->m_list) {
+    total += partitioned->getProperty<PixelCoordinateList>().getCoordinateList().size();
+  }
+  BOOST_CHECK_EQUAL(total, pixels.size());
+}
+
+//-----------------------------------------------------------------------------
+
 BOOST_AUTO_TEST_SUITE_END ()
@@ -72,6 +72,54 @@ BOOST_FIXTURE_TEST_CASE(example_test, DetectionFrameSourceStampFixture) {
   BOOST_CHECK_CLOSE(source_stamp.getValue(PixelCoordinate(2, 1) - top_left), 5.0, 0.000001);
 }
 
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(lazy_layers_test, DetectionFrameSourceStampFixture) {
+  auto image = VectorImage<DetectionImage::PixelType>::create(3, 2,
+      std::vector<DetectionImage::PixelType>{0.0, 1.0, 2.0, 3.0, 4.0, 5.0});
+  auto variance = VectorImage<WeightImage::PixelType>::create(3, 2,
+      std::vector<WeightImage::PixelType>{0.5, 1.5, 2.5, 3.5, 4.5, 5.5});
+  auto frame = std::make_shared<DetectionImageFrame>(image);
+  frame->setVarianceMap(variance);
+
+  DetectionFrameImages images(frame, 3, 2);
+  DetectionFrameSourceStamp stamp(images, PixelCoordinate(1, 0), 2, 2);
+
+  // Each layer is read once, on first use, into the arena of the stamp
+  auto& variance_stamp = stamp.getVarianceStamp();
+  BOOST_CHECK_EQUAL(&variance_stamp, &stamp.getVarianceStamp());
+  BOOST_CHECK_EQUAL(variance_stamp.getWidth(), 2);
+  BOOST_CHECK_EQUAL(variance_stamp.getHeight(), 2);
+  BOOST_CHECK_CLOSE(variance_stamp.getValue(0, 0), 1.5, 0.000001);
+  BOOST_CHECK_CLOSE(variance_stamp.getValue(1, 1), 5.5, 0.000001);
+
+  // A copy shares the layers already read
+  DetectionFrameSourceStamp copy(stamp);
+  BOOST_CHECK_EQUAL(&variance_stamp, &copy.getVarianceStamp());
+  BOOST_CHECK_CLOSE(copy.getStamp().getValue(1, 1), 5.0, 0.000001);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(arena_chunk_test, DetectionFrameSourceStampFixture) {
+  auto image = VectorImage<DetectionImage::PixelType>::create(3, 2,
+      std::vector<DetectionImage::PixelType>{0.0, 1.0, 2.0, 3.0, 4.0, 5.0});
+  auto frame = std::make_shared<DetectionImageFrame>(image);
+
+  std::shared_ptr<ImageChunk<DetectionImage::PixelType>> chunk;
+  {
+    DetectionFrameImages images(frame, 3, 2);
+    DetectionFrameSourceStamp stamp(images, PixelCoordinate(0, 0), 3, 2);
+    chunk = stamp.getThresholdedStamp().getChunk(0, 0, 3, 2);
+    chunk = stamp.getStamp().getChunk(1, 1, 2, 1);
+  }
+
+  // The chunk keeps the arena alive after the stamp is gone
+  BOOST_CHECK_EQUAL(chunk->getWidth(), 2);
+  BOOST_CHECK_CLOSE(chunk->getValue(0, 0), 4.0, 0.000001);
+  BOOST_CHECK_CLOSE(chunk->getValue(1, 0), 5.0, 0.000001);
+}
+
 //----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END ()
@@ -128,4 +128,29 @@ BOOST_FIXTURE_TEST_CASE( external_flag_most_test, ExternalFlagFixture ) {
 
 //-----------------------------------------------------------------------------
 
+BOOST_AUTO_TEST_CASE( external_flag_clean_block_test ) {
+  // Two blocks wide, with a single flagged pixel on the second one
+  std::vector<std::int64_t> flags(600 * 2, 0);
+  flags[600 + 290] = 4;
+  auto flag_image = VectorImage<std::int64_t>::create(600, 2, flags);
+
+  ExternalFlagTaskMax task(flag_image, 0);
+
+  SimpleSource clean;
+  clean.setProperty<DetectionFrameInfo>(600, 2, 1, 60000, 1e6, 1);
+  clean.setProperty<PixelCoordinateList>(std::vector<PixelCoordinate>{{10, 0}, {11, 0}, {10, 1}});
+  task.computeProperties(clean);
+  BOOST_CHECK_EQUAL(clean.getProperty<ExternalFlag>().getFlag(), 0);
+  BOOST_CHECK_EQUAL(clean.getProperty<ExternalFlag>().getCount(), 3);
+
+  SimpleSource flagged;
+  flagged.setProperty<DetectionFrameInfo>(600, 2, 1, 60000, 1e6, 1);
+  flagged.setProperty<PixelCoordinateList>(std::vector<PixelCoordinate>{{250, 0}, {290, 1}, {291, 1}});
+  task.computeProperties(flagged);
+  BOOST_CHECK_EQUAL(flagged.getProperty<ExternalFlag>().getFlag(), 4);
+  BOOST_CHECK_EQUAL(flagged.getProperty<ExternalFlag>().getCount(), 1);
+}
+
+//-----------------------------------------------------------------------------
+
 BOOST_AUTO_TEST_SUITE_END ()
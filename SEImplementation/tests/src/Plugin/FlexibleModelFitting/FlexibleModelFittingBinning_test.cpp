@@ -0,0 +1,177 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * FlexibleModelFittingBinning_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <cmath>
+
+#include "ModelFitting/Models/FrameModel.h"
+#include "ModelFitting/Models/PointModel.h"
+#include "ModelFitting/Parameters/ManualParameter.h"
+#include "SEImplementation/Image/ImageInterfaceTraits.h"
+#include "SEImplementation/Image/ImagePsf.h"
+#include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingBinning.h"
+
+using namespace SourceXtractor;
+using ModelFitting::FrameModel;
+using ModelFitting::ManualParameter;
+using ModelFitting::PointModel;
+
+namespace {
+
+// Render a point source on a frame binned by the given factor, as the coarse fitting passes do
+std::shared_ptr<VectorImage<SeFloat>> renderPoint(double x, double y, int size, int binning) {
+  // The interpolation of the kernel into the frame needs a margin around the profile
+  auto psf = VectorImage<SeFloat>::create(25, 25);
+  for (int py = 0; py < 25; ++py) {
+    for (int px = 0; px < 25; ++px) {
+      psf->at(px, py) = std::exp(-((px - 12) * (px - 12) + (py - 12) * (py - 12)) / 4.5);
+    }
+  }
+  std::shared_ptr<const VectorImage<SeFloat>> psf_image = psf;
+  if (binning > 1) {
+    psf_image = binPsf(*psf, binning);
+  }
+
+  std::vector<PointModel> point_models;
+  point_models.emplace_back(std::make_shared<ManualParameter>(x), std::make_shared<ManualParameter>(y),
+                            std::make_shared<ManualParameter>(100.));
+  FrameModel<ImagePsf, ImageInterfaceTypePtr> frame_model(
+    binning, size / binning, size / binning, {}, std::move(point_models), {},
+    ImagePsf(binning, psf_image), binning);
+  return frame_model.getImage();
+}
+
+// Flux weighted mean position, in pixel indices
+std::pair<double, double> centroid(const VectorImage<SeFloat>& image) {
+  double sum = 0, sum_x = 0, sum_y = 0;
+  for (int y = 0; y < image.getHeight(); ++y) {
+    for (int x = 0; x < image.getWidth(); ++x) {
+      sum += image.getValue(x, y);
+      sum_x += x * image.getValue(x, y);
+      sum_y += y * image.getValue(x, y);
+    }
+  }
+  return {sum_x / sum, sum_y / sum};
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE (FlexibleModelFittingBinning_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (bin_test) {
+  auto image = VectorImage<SeFloat>::create(5, 4);
+  auto weight = VectorImage<SeFloat>::create(5, 4);
+  for (int y = 0; y < 4; ++y) {
+    for (int x = 0; x < 5; ++x) {
+      image->at(x, y) = x + 10 * y;
+      weight->at(x, y) = 0.5;
+    }
+  }
+  weight->at(3, 3) = 0;
+
+  auto binned = binStamp(*image, *weight, 2);
+  BOOST_REQUIRE_EQUAL(binned.m_image->getWidth(), 2);
+  BOOST_REQUIRE_EQUAL(binned.m_image->getHeight(), 2);
+
+  // Fluxes add up
+  BOOST_CHECK_CLOSE(binned.m_image->at(0, 0), 0 + 1 + 10 + 11, 1e-6);
+  BOOST_CHECK_CLOSE(binned.m_image->at(1, 0), 2 + 3 + 12 + 13, 1e-6);
+  BOOST_CHECK_CLOSE(binned.m_image->at(0, 1), 20 + 21 + 30 + 31, 1e-6);
+
+  // So do the variances: 4 pixels with sigma 2
+  BOOST_CHECK_CLOSE(binned.m_weight->at(0, 0), 0.25, 1e-6);
+  BOOST_CHECK_CLOSE(binned.m_weight->at(0, 1), 0.25, 1e-6);
+
+  // A masked pixel masks the whole block
+  BOOST_CHECK_EQUAL(binned.m_weight->at(1, 1), 0);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (psf_test) {
+  // Symmetric kernel
+  auto psf = VectorImage<SeFloat>::create(7, 7);
+  SeFloat sum = 0;
+  for (int y = 0; y < 7; ++y) {
+    for (int x = 0; x < 7; ++x) {
+      psf->at(x, y) = std::exp(-((x - 3) * (x - 3) + (y - 3) * (y - 3)) / 4.);
+      sum += psf->at(x, y);
+    }
+  }
+
+  auto binned = binPsf(*psf, 2);
+  BOOST_REQUIRE_EQUAL(binned->getWidth(), 5);
+  BOOST_REQUIRE_EQUAL(binned->getHeight(), 5);
+
+  SeFloat binned_sum = 0;
+  for (int y = 0; y < 5; ++y) {
+    for (int x = 0; x < 5; ++x) {
+      binned_sum += binned->at(x, y);
+      // Still centered
+      BOOST_CHECK_CLOSE(binned->at(x, y), binned->at(4 - x, y), 1e-4);
+      BOOST_CHECK_CLOSE(binned->at(x, y), binned->at(x, 4 - y), 1e-4);
+    }
+  }
+  BOOST_CHECK_CLOSE(binned_sum, sum, 1e-4);
+  BOOST_CHECK_GT(binned->at(2, 2), binned->at(1, 2));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (binned_position_test) {
+  // Off the centre of the stamp and of its pixels
+  const double x = 13.3, y = 18.8;
+  auto fine = renderPoint(x, y, 32, 1);
+  auto coarse = renderPoint(x, y, 32, 2);
+
+  auto weight = VectorImage<SeFloat>::create(32, 32);
+  std::fill(weight->getData().begin(), weight->getData().end(), 1);
+  auto binned = binStamp(*fine, *weight, 2);
+
+  // The source lands where binning the full resolution render puts it. Pixel i is centered at i + 0.5
+  // for the model, so the centroids in pixel indices are half a pixel off
+  auto fine_centroid = centroid(*fine);
+  BOOST_CHECK_SMALL(fine_centroid.first - (x - 0.5), 0.05);
+  BOOST_CHECK_SMALL(fine_centroid.second - (y - 0.5), 0.05);
+
+  auto binned_centroid = centroid(*binned.m_image);
+  auto coarse_centroid = centroid(*coarse);
+  BOOST_CHECK_SMALL(coarse_centroid.first - binned_centroid.first, 0.05);
+  BOOST_CHECK_SMALL(coarse_centroid.second - binned_centroid.second, 0.05);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (levels_test) {
+  BOOST_CHECK_EQUAL(coarseLevels(20, 200, 2), 0);
+  BOOST_CHECK_EQUAL(coarseLevels(32, 200, 2), 1);
+  BOOST_CHECK_EQUAL(coarseLevels(64, 100, 2), 2);
+  BOOST_CHECK_EQUAL(coarseLevels(640, 640, 2), 2);
+  BOOST_CHECK_EQUAL(coarseLevels(640, 640, 0), 0);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,71 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * FlexibleModelFittingPartition_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingPartition.h"
+
+using namespace SourceXtractor;
+
+static FittingFootprint footprint(int min_x, int min_y, int max_x, int max_y) {
+  return FittingFootprint{PixelCoordinate(min_x, min_y), PixelCoordinate(max_x, max_y)};
+}
+
+BOOST_AUTO_TEST_SUITE (FlexibleModelFittingPartition_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (disjoint_test) {
+  auto components = partitionFootprints({
+    footprint(0, 0, 10, 10), footprint(20, 0, 30, 10), footprint(0, 20, 10, 30)
+  });
+  BOOST_CHECK_EQUAL(components.size(), 3);
+  for (std::size_t i = 0; i < components.size(); ++i) {
+    BOOST_CHECK_EQUAL(components[i].size(), 1);
+    BOOST_CHECK_EQUAL(components[i][0], i);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (chain_test) {
+  // 3 overlaps 0, and 1 overlaps 3, so they are all connected. 2 is isolated
+  // even if it overlaps the others on the x axis
+  auto components = partitionFootprints({
+    footprint(0, 0, 10, 10), footprint(18, 0, 30, 10), footprint(5, 50, 25, 60), footprint(10, 5, 20, 15)
+  });
+  BOOST_REQUIRE_EQUAL(components.size(), 2);
+  std::vector<std::size_t> expected{0, 1, 3};
+  BOOST_CHECK_EQUAL_COLLECTIONS(components[0].begin(), components[0].end(), expected.begin(), expected.end());
+  BOOST_REQUIRE_EQUAL(components[1].size(), 1);
+  BOOST_CHECK_EQUAL(components[1][0], 2);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (empty_test) {
+  BOOST_CHECK(partitionFootprints({}).empty());
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
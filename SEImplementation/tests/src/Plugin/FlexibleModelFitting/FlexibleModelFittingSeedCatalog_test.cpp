@@ -0,0 +1,79 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * FlexibleModelFittingSeedCatalog_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingSeedCatalog.h"
+
+using namespace SourceXtractor;
+
+using Seed = FlexibleModelFittingSeedCatalog::Seed;
+using MatchBy = FlexibleModelFittingSeedCatalog::MatchBy;
+
+struct SeedCatalogFixture {
+  std::vector<Seed> seeds {
+    {1, 10.0, 10.0, {{0, 1.}}},
+    {2, 10.8, 10.0, {{0, 2.}}},
+    {5, -3.2, 50.5, {{0, 5.}, {1, 0.5}}},
+  };
+};
+
+BOOST_AUTO_TEST_SUITE (FlexibleModelFittingSeedCatalog_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE (match_id_test, SeedCatalogFixture) {
+  FlexibleModelFittingSeedCatalog catalog(seeds, MatchBy::ID, 1.);
+  BOOST_CHECK_EQUAL(catalog.size(), 3);
+
+  auto values = catalog.find(5, 0., 0.);
+  BOOST_REQUIRE(values);
+  BOOST_CHECK_EQUAL(values->at(0), 5.);
+  BOOST_CHECK_EQUAL(values->at(1), 0.5);
+  BOOST_CHECK(!catalog.find(3, 10., 10.));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE (match_position_test, SeedCatalogFixture) {
+  FlexibleModelFittingSeedCatalog catalog(seeds, MatchBy::POSITION, 1.);
+
+  // Closest of two candidates, across a cell boundary
+  auto values = catalog.find(0, 10.5, 10.1);
+  BOOST_REQUIRE(values);
+  BOOST_CHECK_EQUAL(values->at(0), 2.);
+  values = catalog.find(0, 9.7, 9.5);
+  BOOST_REQUIRE(values);
+  BOOST_CHECK_EQUAL(values->at(0), 1.);
+
+  // Negative coordinates
+  values = catalog.find(0, -2.5, 50.);
+  BOOST_REQUIRE(values);
+  BOOST_CHECK_EQUAL(values->at(0), 5.);
+
+  // Too far
+  BOOST_CHECK(!catalog.find(1, 12., 10.));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,222 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * FlexibleModelFittingTask_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <random>
+
+#include "SEFramework/Image/VectorImage.h"
+#include "SEFramework/Source/SimpleSource.h"
+#include "SEFramework/Source/SimpleSourceGroup.h"
+
+#include "SEImplementation/Plugin/DetectionFrameCoordinates/DetectionFrameCoordinates.h"
+#include "SEImplementation/Plugin/Jacobian/Jacobian.h"
+#include "SEImplementation/Plugin/MeasurementFrameCoordinates/MeasurementFrameCoordinates.h"
+#include "SEImplementation/Plugin/MeasurementFrameGroupRectangle/MeasurementFrameGroupRectangle.h"
+#include "SEImplementation/Plugin/MeasurementFrameImages/MeasurementFrameImages.h"
+#include "SEImplementation/Plugin/MeasurementFrameInfo/MeasurementFrameInfo.h"
+#include "SEImplementation/Plugin/PixelBoundaries/PixelBoundaries.h"
+#include "SEImplementation/Plugin/PixelCentroid/PixelCentroid.h"
+#include "SEImplementation/Plugin/Psf/PsfProperty.h"
+
+#include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFitting.h"
+#include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingParameter.h"
+#include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingConverterFactory.h"
+#include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingFrame.h"
+#include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingModel.h"
+#include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingTask.h"
+
+#include "ModelFitting/Engine/LeastSquareEngineManager.h"
+
+using namespace SourceXtractor;
+
+namespace {
+
+class IdentityCoordinateSystem : public CoordinateSystem {
+public:
+  WorldCoordinate imageToWorld(ImageCoordinate image_coordinate) const override {
+    return WorldCoordinate(image_coordinate.m_x, image_coordinate.m_y);
+  }
+
+  ImageCoordinate worldToImage(WorldCoordinate world_coordinate) const override {
+    return ImageCoordinate(world_coordinate.m_alpha, world_coordinate.m_delta);
+  }
+};
+
+struct TrueSource {
+  double x, y, flux, radius, aspect;
+};
+
+}
+
+struct FlexibleModelFittingTaskFixture {
+  const int width = 96, height = 64;
+  std::vector<TrueSource> true_sources {{30.2, 32.7, 2000., 3.5, 0.8}, {62.6, 30.1, 1000., 2.5, 0.9}};
+
+  std::shared_ptr<VectorImage<SeFloat>> image = VectorImage<SeFloat>::create(width, height);
+  std::shared_ptr<VectorImage<SeFloat>> variance = VectorImage<SeFloat>::create(width, height);
+  std::shared_ptr<VectorImage<SeFloat>> psf = VectorImage<SeFloat>::create(5, 5);
+  std::shared_ptr<CoordinateSystem> coordinates = std::make_shared<IdentityCoordinateSystem>();
+
+  std::vector<std::shared_ptr<FlexibleModelFittingParameter>> parameters;
+  std::vector<std::shared_ptr<FlexibleModelFittingFrame>> frames;
+
+  FlexibleModelFittingTaskFixture() {
+    SeFloat psf_sum = 0;
+    for (int y = 0; y < 5; ++y) {
+      for (int x = 0; x < 5; ++x) {
+        psf->at(x, y) = std::exp(-((x - 2) * (x - 2) + (y - 2) * (y - 2)) / (2 * 0.8 * 0.8));
+        psf_sum += psf->at(x, y);
+      }
+    }
+    for (auto& v : psf->getData()) {
+      v /= psf_sum;
+    }
+
+    // Exponential profiles, with some noise
+    variance->fillValue(1.);
+    std::mt19937 generator(42);
+    std::normal_distribution<double> noise(0., 1.);
+    for (int y = 0; y < height; ++y) {
+      for (int x = 0; x < width; ++x) {
+        double value = noise(generator);
+        for (auto& s : true_sources) {
+          double dx = x - s.x, dy = (y - s.y) / s.aspect;
+          double i0 = s.flux / (2 * M_PI * 0.35513 * s.radius * s.radius * s.aspect);
+          value += i0 * std::exp(-1.678 * std::sqrt(dx * dx + dy * dy) / s.radius);
+        }
+        image->at(x, y) = value;
+      }
+    }
+
+    // Free position, flux, radius and aspect ratio, starting a bit off the true values
+    auto position_range = std::make_shared<FlexibleModelFittingLinearRangeConverterFactory>(
+      [](double init, const SourceInterface&) { return std::make_pair(init - 3., init + 3.); });
+    auto x = std::make_shared<FlexibleModelFittingFreeParameter>(0, [](const SourceInterface& source) {
+      return source.getProperty<PixelCentroid>().getCentroidX() + 1;
+    }, position_range);
+    auto y = std::make_shared<FlexibleModelFittingFreeParameter>(1, [](const SourceInterface& source) {
+      return source.getProperty<PixelCentroid>().getCentroidY() + 1;
+    }, position_range);
+    auto flux = std::make_shared<FlexibleModelFittingFreeParameter>(2, [](const SourceInterface&) {
+      return 700.;
+    }, std::make_shared<FlexibleModelFittingExponentialRangeConverterFactory>(
+      [](double init, const SourceInterface&) { return std::make_pair(init / 100., init * 100.); }));
+    auto radius = std::make_shared<FlexibleModelFittingFreeParameter>(3, [](const SourceInterface&) {
+      return 2.;
+    }, std::make_shared<FlexibleModelFittingExponentialRangeConverterFactory>(
+      [](double init, const SourceInterface&) { return std::make_pair(init / 10., init * 10.); }));
+    auto aspect = std::make_shared<FlexibleModelFittingFreeParameter>(4, [](const SourceInterface&) {
+      return 0.7;
+    }, std::make_shared<FlexibleModelFittingLinearRangeConverterFactory>(
+      [](double, const SourceInterface&) { return std::make_pair(0.1, 1.01); }));
+    auto angle = std::make_shared<FlexibleModelFittingConstantParameter>(5, [](const SourceInterface&) {
+      return 0.;
+    });
+    parameters = {x, y, flux, radius, aspect, angle};
+
+    frames.emplace_back(std::make_shared<FlexibleModelFittingFrame>(0,
+      std::vector<std::shared_ptr<FlexibleModelFittingModel>>{
+        std::make_shared<FlexibleModelFittingExponentialModel>(x, y, flux, radius, aspect, angle)
+      }));
+  }
+
+  std::shared_ptr<SimpleSourceGroup> createGroup() const {
+    auto frame = std::make_shared<MeasurementImageFrame>(image, coordinates, variance);
+    auto group = std::make_shared<SimpleSourceGroup>();
+    for (auto& s : true_sources) {
+      auto source = std::make_shared<SimpleSource>();
+      int cx = std::round(s.x), cy = std::round(s.y);
+      source->setProperty<PixelCentroid>(cx, cy);
+      source->setProperty<PixelBoundaries>(cx - 8, cy - 8, cx + 8, cy + 8);
+      source->setProperty<DetectionFrameCoordinates>(coordinates);
+      source->setIndexedProperty<MeasurementFrameCoordinates>(0, coordinates);
+      source->setIndexedProperty<MeasurementFrameImages>(0, frame, width, height);
+      source->setIndexedProperty<MeasurementFrameInfo>(0, width, height, 0., 0., 1e6, 1.);
+      group->addSource(source);
+    }
+    group->setIndexedProperty<MeasurementFrameGroupRectangle>(0, PixelCoordinate(0, 0),
+                                                              PixelCoordinate(width - 1, height - 1));
+    group->setIndexedProperty<PsfProperty>(0, 1., psf);
+    group->setIndexedProperty<JacobianGroup>(0);
+    return group;
+  }
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (FlexibleModelFittingTask_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE (coarse_to_fine_test, FlexibleModelFittingTaskFixture) {
+  auto engine = ModelFitting::LeastSquareEngineManager::getImplementations().front();
+  FlexibleModelFittingTask task(engine, 200, 10., parameters, frames, {});
+  FlexibleModelFittingTask coarse_task(engine, 200, 10., parameters, frames, {}, 1., 0, false, 0, 2);
+
+  auto group = createGroup();
+  auto coarse_group = createGroup();
+  task.computeProperties(*group);
+  coarse_task.computeProperties(*coarse_group);
+
+  // Starting from the binned stamps must not change the solution
+  auto source = group->begin();
+  auto coarse_source = coarse_group->begin();
+  for (auto& s : true_sources) {
+    auto& result = source->getProperty<FlexibleModelFitting>();
+    auto& coarse_result = coarse_source->getProperty<FlexibleModelFitting>();
+    BOOST_CHECK(result.getFlags() == Flags::NONE);
+    BOOST_CHECK(coarse_result.getFlags() == Flags::NONE);
+
+    BOOST_CHECK_SMALL(result.getParameterValue(0) - 1 - s.x, 0.1);
+    BOOST_CHECK_SMALL(result.getParameterValue(1) - 1 - s.y, 0.1);
+    BOOST_CHECK_SMALL(coarse_result.getParameterValue(0) - result.getParameterValue(0), 0.01f);
+    BOOST_CHECK_SMALL(coarse_result.getParameterValue(1) - result.getParameterValue(1), 0.01f);
+    for (int id = 2; id < 5; ++id) {
+      BOOST_CHECK_CLOSE(coarse_result.getParameterValue(id), result.getParameterValue(id), 0.5);
+    }
+    ++source;
+    ++coarse_source;
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE (chi_squared_test, FlexibleModelFittingTaskFixture) {
+  auto engine = ModelFitting::LeastSquareEngineManager::getImplementations().front();
+  FlexibleModelFittingTask task(engine, 200, 10., parameters, frames, {});
+
+  auto group = createGroup();
+  task.computeProperties(*group);
+
+  // The noise has unit variance, and is most of the residual away from the sources
+  for (auto& source : *group) {
+    auto& result = source.getProperty<FlexibleModelFitting>();
+    BOOST_CHECK_CLOSE(result.getReducedChiSquared(), 1., 15.);
+    BOOST_CHECK_GT(result.getSourceReducedChiSquared(), 0.5);
+    BOOST_CHECK_LT(result.getSourceReducedChiSquared(), 3.);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -156,6 +156,20 @@ BOOST_FIXTURE_TEST_CASE (NotCovered_test, GrowthCurveFixture) {
 
 //-----------------------------------------------------------------------------
 
+// Samples at arbitrary radii are interpolated between the closest steps of the curve
+BOOST_AUTO_TEST_CASE (GetFlux_test) {
+  GrowthCurve growth(std::vector<double>{1., 3., 4., 4.}, 8.);
+
+  BOOST_CHECK_CLOSE(growth.getFlux(2.), 1., 1e-8);
+  BOOST_CHECK_CLOSE(growth.getFlux(3.), 2., 1e-8);
+  BOOST_CHECK_CLOSE(growth.getFlux(5.), 3.5, 1e-8);
+  BOOST_CHECK_CLOSE(growth.getFlux(8.), 4., 1e-8);
+  // Extrapolated from the first two
+  BOOST_CHECK_CLOSE(growth.getFlux(1.), 0., 1e-8);
+}
+
+//-----------------------------------------------------------------------------
+
 BOOST_AUTO_TEST_SUITE_END ()
 
 //-----------------------------------------------------------------------------
@@ -23,6 +23,7 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <cmath>
 #include <memory>
 
 #include "SEImplementation/Plugin/MoffatModelFitting/MoffatModelFitting.h"
@@ -115,6 +116,60 @@ BOOST_FIXTURE_TEST_CASE(modelfitting_test, MoffatModelFittingFixture) {
 
 //-----------------------------------------------------------------------------
 
+BOOST_FIXTURE_TEST_CASE(coarse_to_fine_test, MoffatModelFittingFixture) {
+  auto image = VectorImage<SeFloat>::create(64, 64);
+  auto thresholded = VectorImage<SeFloat>::create(image->getWidth(), image->getHeight());
+  std::vector<PixelCoordinate> pixel_coordinates;
+
+  for (auto x = 0; x < 64; ++x) {
+    for (auto y = 0; y < 64; ++y) {
+      double r2 = (x - 30.3) * (x - 30.3) + (y - 33.6) * (y - 33.6);
+      image->setValue(x, y, 1000 * std::pow(1 + r2 / 16, -2.5));
+      thresholded->setValue(x, y, -1);
+      if (r2 < 100) {
+        pixel_coordinates.emplace_back(x, y);
+      }
+    }
+  }
+
+  auto variance_image = VectorImage<SeFloat>::create(image->getWidth(), image->getHeight());
+  variance_image->fillValue(0.1);
+
+  auto detection_frame = std::make_shared<DetectionImageFrame>(
+    image, nullptr, 10, std::make_shared<DummyCoordinateSystem>(), 1, 65000, 1);
+
+  auto setup = [&](SourceInterface& s) {
+    s.setProperty<DetectionFrameSourceStamp>(image, image, thresholded, PixelCoordinate(0,0), variance_image, variance_image);
+    s.setProperty<PixelCentroid>(31, 33);
+    s.setProperty<ShapeParameters>(6, 6, 0, 0, 0, 0, 0, 0);
+    s.setProperty<IsophotalFlux>(20000., 0., 1., 0.);
+    s.setProperty<PixelCoordinateList>(pixel_coordinates);
+    s.setProperty<DetectionFrame>(detection_frame);
+    s.setProperty<DetectionFrameCoordinates>(std::make_shared<DummyCoordinateSystem>());
+    s.setProperty<DetectionFrameInfo>(64, 64, 1, 65000, 1e6, 1);
+  };
+
+  auto known_engines = ModelFitting::LeastSquareEngineManager::getImplementations();
+  MoffatModelFittingTask coarse_task(known_engines.front(), 100, 2);
+  auto coarse_source = std::make_shared<SimpleSource>();
+  setup(*source);
+  setup(*coarse_source);
+
+  model_fitting_task->computeProperties(*source);
+  coarse_task.computeProperties(*coarse_source);
+
+  // Starting from the binned stamps must not change the solution
+  auto& moffat_model = source->getProperty<MoffatModelFitting>();
+  auto& coarse_model = coarse_source->getProperty<MoffatModelFitting>();
+  BOOST_CHECK_CLOSE(moffat_model.getX(), 30.3, 0.1);
+  BOOST_CHECK_CLOSE(moffat_model.getY(), 33.6, 0.1);
+  BOOST_CHECK_SMALL(coarse_model.getX() - moffat_model.getX(), 0.01f);
+  BOOST_CHECK_SMALL(coarse_model.getY() - moffat_model.getY(), 0.01f);
+  BOOST_CHECK_CLOSE(coarse_model.getMoffatI0(), moffat_model.getMoffatI0(), 1);
+}
+
+//-----------------------------------------------------------------------------
+
 BOOST_AUTO_TEST_SUITE_END ()
 
 
@@ -16,6 +16,7 @@
  */
 #include "SEImplementation/Segmentation/BgConvolutionImageSource.h"
 #include "SEImplementation/Segmentation/BgDFTConvolutionImageSource.h"
+#include "SEImplementation/Segmentation/BackgroundConvolution.h"
 #include <boost/test/unit_test.hpp>
 #include <boost/mpl/list.hpp>
 #include <random>
@@ -163,4 +164,58 @@ BOOST_AUTO_TEST_CASE_TEMPLATE (kerneln_background, T, kernel_sizes) {
 
 //-----------------------------------------------------------------------------
 
+BOOST_AUTO_TEST_CASE_TEMPLATE (kerneln_background_tiled, T, kernel_sizes) {
+  // The DFT convolution filters several tiles at once, so request them as Lutz would do
+  // (row by row), with and without masked pixels
+  auto image = generateImage(100);
+  auto kernel = generateImage(T().getSize());
+
+  for (SeFloat threshold : {0.5, 2.}) {
+    auto variance = generateImage(100);
+    auto direct_source = std::make_shared<BgConvolutionImageSource>(image, variance, threshold, kernel);
+    auto dft_source = std::make_shared<BgDFTConvolutionImageSource>(image, variance, threshold, kernel, 3);
+
+    for (int y = 0; y < 100; y += 32) {
+      for (int x = 0; x < 100; x += 32) {
+        int w = std::min(32, 100 - x), h = std::min(32, 100 - y);
+        auto direct_result = direct_source->getImageTile(x, y, w, h)->getImage();
+        auto dft_result = dft_source->getImageTile(x, y, w, h)->getImage();
+        BOOST_CHECK(compareImages(direct_result, dft_result, 1e-8, 1e-4));
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE (kerneln_background_separable, T, kernel_sizes) {
+  // A random kernel is full rank, so all its components are used
+  auto image = generateImage(100);
+  auto variance = generateImage(100);
+  auto kernel = generateImage(T().getSize());
+
+  auto direct_source = std::make_shared<BgConvolutionImageSource>(image, variance, 0.5, kernel);
+  auto separable_source = std::make_shared<BgConvolutionImageSource>(image, variance, 0.5, kernel, true);
+
+  auto direct_result = direct_source->getImageTile(0, 0, 100, 100)->getImage();
+  auto separable_result = separable_source->getImageTile(0, 0, 100, 100)->getImage();
+  BOOST_CHECK(compareImages(direct_result, separable_result, 1e-6, 1e-4));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (zero_kernel) {
+  auto image = generateImage(50);
+  auto variance = generateImage(50);
+  auto kernel = VectorImage<SeFloat>::create(5, 5);
+
+  BackgroundConvolution convolution(kernel, false);
+  auto result = convolution.processImage(image, variance, 0.5);
+  for (int y = 0; y < result->getHeight(); ++y) {
+    for (int x = 0; x < result->getWidth(); ++x) {
+      BOOST_CHECK_EQUAL(result->getValue(x, y), 0.);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+
 BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,253 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * DetectionSnapshot_test.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <fstream>
+
+#include <ElementsKernel/Exception.h>
+#include <ElementsKernel/Temporary.h>
+
+#include "SEFramework/Image/BufferedImage.h"
+#include "SEFramework/Image/ConstantImage.h"
+#include "SEFramework/Image/ScaledImageSource.h"
+#include "SEFramework/Image/VectorImage.h"
+#include "SEFramework/Source/SimpleSourceFactory.h"
+#include "SEFramework/Source/SimpleSourceGroupFactory.h"
+#include "SEImplementation/Property/PixelCoordinateList.h"
+#include "SEImplementation/Background/SE2/TypedSplineModelWrapper.h"
+#include "SEImplementation/Property/SourceId.h"
+#include "SEImplementation/Snapshot/DetectionSnapshot.h"
+
+using namespace SourceXtractor;
+
+class GroupCollector : public Observer<std::shared_ptr<SourceGroupInterface>> {
+public:
+  void handleMessage(const std::shared_ptr<SourceGroupInterface>& group) override {
+    m_groups.push_back(group);
+  }
+
+  std::vector<std::shared_ptr<SourceGroupInterface>> m_groups;
+};
+
+struct DetectionSnapshotFixture {
+  Elements::TempFile m_tmp_snapshot;
+  std::shared_ptr<SourceFactory> m_source_factory = std::make_shared<SimpleSourceFactory>();
+  std::shared_ptr<SourceGroupFactory> m_group_factory = std::make_shared<SimpleSourceGroupFactory>();
+
+  std::shared_ptr<VectorImage<SeFloat>> m_level = VectorImage<SeFloat>::create(
+      4, 3, std::vector<SeFloat>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12});
+  std::shared_ptr<VectorImage<SeFloat>> m_variance = VectorImage<SeFloat>::create(
+      4, 3, std::vector<SeFloat>{.1, .2, .3, .4, .5, .6, .7, .8, .9, 1., 1.1, 1.2});
+
+  std::shared_ptr<SourceInterface> createSource(std::vector<PixelCoordinate> pixels,
+                                                unsigned int source_id, unsigned int detection_id) {
+    auto source = m_source_factory->createSource();
+    source->setProperty<PixelCoordinateList>(std::move(pixels));
+    source->setProperty<SourceId>(source_id, detection_id);
+    return source;
+  }
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (DetectionSnapshot_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE (round_trip_test, DetectionSnapshotFixture) {
+  std::vector<PixelCoordinate> pixels_a {{1, 0}, {2, 0}, {3, 0}, {0, 1}, {1, 1}, {3, 1}};
+  std::vector<PixelCoordinate> pixels_b {{2, 2}, {1, 2}};
+  std::vector<PixelCoordinate> pixels_c {{0, 0}};
+
+  auto group_ab = m_group_factory->createSourceGroup();
+  group_ab->addSource(createSource(pixels_a, 5, 2));
+  group_ab->addSource(createSource(pixels_b, 6, 2));
+  auto group_c = m_group_factory->createSourceGroup();
+  group_c->addSource(createSource(pixels_c, 7, 7));
+
+  {
+    DetectionSnapshotWriter writer(m_tmp_snapshot.path().native());
+    writer.writeBackground(BackgroundModel(m_level, m_variance, 2.5, 0.75));
+    writer.handleMessage(group_ab);
+    writer.handleMessage(group_c);
+    writer.close();
+  }
+
+  DetectionSnapshotReader reader(m_tmp_snapshot.path().native(), m_source_factory, m_group_factory);
+  auto background = reader.readBackground(4, 3);
+  BOOST_CHECK_EQUAL(background.getScalingFactor(), 2.5);
+  BOOST_CHECK_EQUAL(background.getMedianRms(), 0.75);
+  for (int y = 0; y < 3; ++y) {
+    for (int x = 0; x < 4; ++x) {
+      BOOST_CHECK_EQUAL(background.getLevelMap()->getValue(x, y), m_level->getValue(x, y));
+      BOOST_CHECK_EQUAL(background.getVarianceMap()->getValue(x, y), m_variance->getValue(x, y));
+    }
+  }
+
+  auto collector = std::make_shared<GroupCollector>();
+  reader.addObserver(collector);
+  reader.processFrame(nullptr);
+  BOOST_REQUIRE_EQUAL(collector->m_groups.size(), 2);
+  BOOST_REQUIRE_EQUAL(collector->m_groups[0]->size(), 2);
+  BOOST_REQUIRE_EQUAL(collector->m_groups[1]->size(), 1);
+
+  // The order of the pixels is kept, even when they are not sorted
+  auto source = collector->m_groups[0]->begin();
+  BOOST_CHECK(source->getProperty<PixelCoordinateList>().getCoordinateList() == pixels_a);
+  BOOST_CHECK_EQUAL(source->getProperty<SourceId>().getSourceId(), 5);
+  BOOST_CHECK_EQUAL(source->getProperty<SourceId>().getDetectionId(), 2);
+  ++source;
+  BOOST_CHECK(source->getProperty<PixelCoordinateList>().getCoordinateList() == pixels_b);
+  BOOST_CHECK_EQUAL(source->getProperty<SourceId>().getSourceId(), 6);
+  source = collector->m_groups[1]->begin();
+  BOOST_CHECK(source->getProperty<PixelCoordinateList>().getCoordinateList() == pixels_c);
+  BOOST_CHECK_EQUAL(source->getProperty<SourceId>().getSourceId(), 7);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE (mesh_test, DetectionSnapshotFixture) {
+  int width = 40, height = 30;
+
+  // Level interpolated with a spline, as the SE2 analyzer does
+  auto level_grid = VectorImage<SeFloat>::create(
+      4, 3, std::vector<SeFloat>{1, 2, 3, 4, 2, 3, 4, 5, 3, 4, 5, 9});
+  size_t naxes[2] = {size_t(width), size_t(height)}, cell_size[2] = {10, 10}, n_grid[2] = {4, 3};
+  auto spline_data = new PIXTYPE[12];
+  std::copy(level_grid->getData().begin(), level_grid->getData().end(), spline_data);
+  auto level = BufferedImage<SeFloat>::create(
+      TypedSplineModelWrapper<SeFloat>::create(naxes, cell_size, n_grid, spline_data));
+
+  // Variance interpolated with bicubic splines, as the SE analyzer does
+  auto variance = BufferedImage<SeFloat>::create(std::make_shared<ScaledImageSource<SeFloat>>(
+      m_variance, width, height, ScaledImageSource<SeFloat>::InterpolationType::BICUBIC));
+
+  BackgroundModel model(level, variance, 1, 1);
+  model.setMeshes(BackgroundMesh::create(BackgroundMesh::Interpolation::SPLINE, 10, 10, level_grid),
+                  BackgroundMesh::create(BackgroundMesh::Interpolation::BICUBIC, 10, 10, m_variance));
+  {
+    DetectionSnapshotWriter writer(m_tmp_snapshot.path().native());
+    writer.writeBackground(model);
+    writer.close();
+  }
+
+  // Only the grids are saved
+  BOOST_CHECK_LT(boost::filesystem::file_size(m_tmp_snapshot.path()), width * height * sizeof(SeFloat));
+
+  DetectionSnapshotReader reader(m_tmp_snapshot.path().native(), m_source_factory, m_group_factory);
+  auto background = reader.readBackground(width, height);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      BOOST_CHECK_EQUAL(background.getLevelMap()->getValue(x, y), model.getLevelMap()->getValue(x, y));
+      BOOST_CHECK_EQUAL(background.getVarianceMap()->getValue(x, y), model.getVarianceMap()->getValue(x, y));
+    }
+  }
+  BOOST_REQUIRE(background.getLevelMesh());
+  BOOST_CHECK(background.getLevelMesh()->m_interpolation == BackgroundMesh::Interpolation::SPLINE);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE (constant_mesh_test, DetectionSnapshotFixture) {
+  BackgroundModel model(ConstantImage<SeFloat>::create(4, 3, 5.), ConstantImage<SeFloat>::create(4, 3, 2.), 1, 1);
+  model.setMeshes(BackgroundMesh::constant(4, 3, 5.), BackgroundMesh::constant(4, 3, 2.));
+  {
+    DetectionSnapshotWriter writer(m_tmp_snapshot.path().native());
+    writer.writeBackground(model);
+    writer.close();
+  }
+
+  DetectionSnapshotReader reader(m_tmp_snapshot.path().native(), m_source_factory, m_group_factory);
+  auto background = reader.readBackground(4, 3);
+  BOOST_CHECK_EQUAL(background.getLevelMap()->getValue(3, 2), 5.);
+  BOOST_CHECK_EQUAL(background.getVarianceMap()->getValue(0, 1), 2.);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE (byte_order_test, DetectionSnapshotFixture) {
+  {
+    DetectionSnapshotWriter writer(m_tmp_snapshot.path().native());
+    writer.writeBackground(BackgroundModel(m_level, m_variance, 1, 1));
+    writer.close();
+  }
+
+  // Swap the byte order mark, as if written on a machine with a different byte order
+  {
+    std::fstream file(m_tmp_snapshot.path().native(), std::ios::in | std::ios::out | std::ios::binary);
+    char mark[4];
+    file.seekg(8);
+    file.read(mark, sizeof(mark));
+    std::reverse(mark, mark + sizeof(mark));
+    file.seekp(8);
+    file.write(mark, sizeof(mark));
+  }
+  BOOST_CHECK_THROW(DetectionSnapshotReader(m_tmp_snapshot.path().native(), m_source_factory, m_group_factory),
+                    Elements::Exception);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE (size_mismatch_test, DetectionSnapshotFixture) {
+  {
+    DetectionSnapshotWriter writer(m_tmp_snapshot.path().native());
+    writer.writeBackground(BackgroundModel(m_level, m_variance, 1, 1));
+    writer.close();
+  }
+
+  DetectionSnapshotReader reader(m_tmp_snapshot.path().native(), m_source_factory, m_group_factory);
+  BOOST_CHECK_THROW(reader.readBackground(3, 4), Elements::Exception);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE (not_a_snapshot_test, DetectionSnapshotFixture) {
+  {
+    std::ofstream out(m_tmp_snapshot.path().native());
+    out << "SIMPLE  =                    T";
+  }
+  BOOST_CHECK_THROW(DetectionSnapshotReader(m_tmp_snapshot.path().native(), m_source_factory, m_group_factory),
+                    Elements::Exception);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE (truncated_test, DetectionSnapshotFixture) {
+  {
+    DetectionSnapshotWriter writer(m_tmp_snapshot.path().native());
+    writer.writeBackground(BackgroundModel(m_level, m_variance, 1, 1));
+    auto group = m_group_factory->createSourceGroup();
+    group->addSource(createSource({{0, 0}}, 1, 1));
+    writer.handleMessage(group);
+    // Not closed, so the end marker is missing
+  }
+
+  DetectionSnapshotReader reader(m_tmp_snapshot.path().native(), m_source_factory, m_group_factory);
+  reader.readBackground(4, 3);
+  BOOST_CHECK_THROW(reader.processFrame(nullptr), Elements::Exception);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -40,6 +40,8 @@ public:
 
 private:
   std::map<int, std::shared_ptr<SourceGroupInterface>> m_output_buffer;
+  // Bytes charged to the MemoryGovernor for each group in m_output_buffer
+  std::map<int, std::size_t> m_output_charges;
   int m_output_next;
 };
 
@@ -16,6 +16,7 @@
  */
 #include <SEImplementation/Plugin/SourceIDs/SourceID.h>
 #include <algorithm>
+#include "SEFramework/Pipeline/MemoryGovernor.h"
 #include "SEMain/Sorter.h"
 
 namespace SourceXtractor {
@@ -32,12 +33,18 @@ void Sorter::handleMessage(const std::shared_ptr<SourceGroupInterface> &message)
   std::transform(message->cbegin(), message->cend(), source_ids.begin(), extractSourceId);
   std::sort(source_ids.begin(), source_ids.end());
 
+  auto memory_governor = MemoryGovernor::getInstance();
   auto first_source_id = source_ids.front();
+  auto group_size = memory_governor->estimate(*message);
   m_output_buffer.emplace(first_source_id, message);
+  m_output_charges.emplace(first_source_id, group_size);
+  memory_governor->charge(group_size);
 
   while (!m_output_buffer.empty() && m_output_buffer.begin()->first == m_output_next) {
     auto &next_group = m_output_buffer.begin()->second;
     m_output_next += next_group->size();
+    memory_governor->release(m_output_charges.begin()->second);
+    m_output_charges.erase(m_output_charges.begin());
     notifyObservers(next_group);
     m_output_buffer.erase(m_output_buffer.begin());
   }
@@ -44,6 +44,7 @@
 #include "SEFramework/Pipeline/SourceGrouping.h"
 #include "SEFramework/Pipeline/Deblending.h"
 #include "SEFramework/Pipeline/Partition.h"
+#include "SEFramework/Pipeline/MemoryGovernor.h"
 #include "SEFramework/Output/OutputRegistry.h"
 
 #include "SEFramework/Task/TaskFactoryRegistry.h"
@@ -64,6 +65,8 @@
 #include "SEImplementation/Grouping/GroupingFactory.h"
 
 #include "SEImplementation/Plugin/PixelCentroid/PixelCentroid.h"
+#include "SEImplementation/Plugin/PixelBoundaries/PixelBoundaries.h"
+#include "SEImplementation/Property/PixelCoordinateList.h"
 
 #include "SEImplementation/Partition/PartitionFactory.h"
 #include "SEImplementation/Deblending/DeblendingFactory.h"
@@ -76,8 +79,10 @@
 #include "SEImplementation/Configuration/MemoryConfig.h"
 #include "SEImplementation/Configuration/OutputConfig.h"
 #include "SEImplementation/Configuration/SamplingConfig.h"
+#include "SEImplementation/Configuration/SnapshotConfig.h"
 
 #include "SEImplementation/CheckImages/CheckImages.h"
+#include "SEImplementation/Snapshot/DetectionSnapshot.h"
 
 #include "SEMain/ProgressReporterFactory.h"
 #include "SEMain/PluginConfig.h"
@@ -145,7 +150,7 @@ class SEMain : public Elements::Program {
   PartitionFactory partition_factory {source_factory};
   GroupingFactory grouping_factory {group_factory};
   DeblendingFactory deblending_factory {source_factory};
-  MeasurementFactory measurement_factory { output_registry };
+  MeasurementFactory measurement_factory { output_registry, task_provider };
   ProgressReporterFactory progress_printer_factory {};
 
   bool config_initialized = false;
@@ -169,6 +174,7 @@ public:
       config_manager.registerConfiguration<MemoryConfig>();
       config_manager.registerConfiguration<BackgroundAnalyzerFactory>();
       config_manager.registerConfiguration<SamplingConfig>();
+      config_manager.registerConfiguration<SnapshotConfig>();
 
       CheckImages::getInstance().reportConfigDependencies(config_manager);
 
@@ -308,6 +314,17 @@ public:
     TileManager::getInstance()->setOptions(memory_config.getTileSize(),
         memory_config.getTileSize(), memory_config.getTileMaxMemory());
 
+    // Configure the memory accounting of the pipeline. A source holds a few values per detected pixel,
+    // and the stamps of the detection frame over its bounding box
+    auto memory_governor = MemoryGovernor::getInstance();
+    memory_governor->setLimit(static_cast<size_t>(memory_config.getPipelineMaxMemory()) * 1024 * 1024);
+    memory_governor->setSourceSizeEstimator([](const SourceInterface& source) -> size_t {
+      auto& boundaries = source.getProperty<PixelBoundaries>();
+      size_t pixels = source.getProperty<PixelCoordinateList>().getCoordinateList().size();
+      size_t area = static_cast<size_t>(boundaries.getWidth()) * boundaries.getHeight();
+      return 4096 + pixels * 32 + area * 24;
+    });
+
     CheckImages::getInstance().configure(config_manager);
 
     task_factory_registry->configure(config_manager);
@@ -345,12 +362,32 @@ public:
 
     auto sorter = std::make_shared<Sorter>();
 
+    // A snapshot replaces the whole detection, or records its output
+    auto& snapshot_config = config_manager.getConfiguration<SnapshotConfig>();
+    std::shared_ptr<DetectionSnapshotReader> snapshot_reader;
+    std::shared_ptr<DetectionSnapshotWriter> snapshot_writer;
+    if (!snapshot_config.getLoadPath().empty()) {
+      snapshot_reader = std::make_shared<DetectionSnapshotReader>(snapshot_config.getLoadPath(),
+                                                                  source_factory, group_factory);
+    }
+    if (!snapshot_config.getSavePath().empty()) {
+      snapshot_writer = std::make_shared<DetectionSnapshotWriter>(snapshot_config.getSavePath());
+    }
+
     // Link together the pipeline's steps
     segmentation->Observable<std::shared_ptr<SourceInterface>>::addObserver(partition);
     segmentation->Observable<ProcessSourcesEvent>::addObserver(source_grouping);
     partition->addObserver(source_grouping);
     source_grouping->addObserver(deblending);
+    // The snapshot must be written before the measurement threads start working on the sources
+    if (snapshot_writer) {
+      deblending->addObserver(snapshot_writer);
+    }
     deblending->addObserver(measurement);
+    if (snapshot_reader) {
+      snapshot_reader->addObserver(measurement);
+      snapshot_reader->addObserver(progress_mediator->getDeblendingObserver());
+    }
     measurement->addObserver(sorter);
     sorter->addObserver(output);
 
@@ -383,9 +420,17 @@ public:
         detection_image_saturation, interpolation_gap);
     detection_frame->setLabel(boost::filesystem::basename(detection_image_path));
 
-    auto background_analyzer = config_manager.getConfiguration<BackgroundAnalyzerFactory>().createBackgroundAnalyzer();
-    auto background_model = background_analyzer->analyzeBackground(detection_frame->getOriginalImage(), weight_image,
-        ConstantImage<unsigned char>::create(detection_image->getWidth(), detection_image->getHeight(), false), detection_frame->getVarianceThreshold());
+    auto background_model = [&]() -> BackgroundModel {
+      if (snapshot_reader) {
+        return snapshot_reader->readBackground(detection_image->getWidth(), detection_image->getHeight());
+      }
+      auto background_analyzer = config_manager.getConfiguration<BackgroundAnalyzerFactory>().createBackgroundAnalyzer();
+      return background_analyzer->analyzeBackground(detection_frame->getOriginalImage(), weight_image,
+          ConstantImage<unsigned char>::create(detection_image->getWidth(), detection_image->getHeight(), false), detection_frame->getVarianceThreshold());
+    }();
+    if (snapshot_writer) {
+      snapshot_writer->writeBackground(background_model);
+    }
 
     // initial set of the variance and background check images, might be overwritten below
     CheckImages::getInstance().setBackgroundCheckImage(background_model.getLevelMap());
@@ -429,7 +474,16 @@ public:
 
     try {
       // Process the image
-      segmentation->processFrame(detection_frame);
+      if (snapshot_reader) {
+        segmentation->prepareFrame(detection_frame);
+        snapshot_reader->processFrame(detection_frame);
+      }
+      else {
+        segmentation->processFrame(detection_frame);
+      }
+      if (snapshot_writer) {
+        snapshot_writer->close();
+      }
     }
     catch (const std::exception &e) {
       logger.error() << "Failed to process the frame! " << e.what();
@@ -438,6 +492,8 @@ public:
     }
 
     measurement->waitForThreads();
+    logger.debug() << "Peak memory held by the pipeline: "
+                   << memory_governor->getPeak() / (1024 * 1024) << " MB";
 
     CheckImages::getInstance().setFilteredCheckImage(detection_frame->getFilteredImage());
     CheckImages::getInstance().setThresholdedCheckImage(detection_frame->getThresholdedImage());